@@ -0,0 +1,93 @@
+#ifndef CXLTIME_H
+#define CXLTIME_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// cxltime emulates a slow far-memory tier on ordinary DRAM. Accesses to
+// registered regions are detected by sampling and the accessing thread is
+// delayed by the configured extra load latency and bandwidth cap.
+
+#define CXLTIME_MAX_REGIONS 64
+#define CXLTIME_REGION_NAME_LEN 32
+
+// How accesses to far memory are detected
+typedef enum {
+    CXLTIME_MODE_OFF = 0,     // Regions are counted but never delayed
+    CXLTIME_MODE_EPOCH = 1,   // First touch of each page per epoch (page protection)
+    CXLTIME_MODE_PERF = 2     // Sampled cache misses (perf_event_open)
+} cxltime_mode_t;
+
+typedef struct {
+    cxltime_mode_t mode;
+    uint64_t latency_ns;          // Added latency per far-memory access
+    uint64_t bandwidth_mbps;      // Far-memory bandwidth cap in MB/s, 0 = unlimited
+    uint64_t epoch_us;            // EPOCH: pages are re-protected this often
+    uint64_t perf_period;         // PERF: cache misses per sample
+    uint32_t perf_type;           // PERF: perf_event_attr.type
+    uint64_t perf_config;         // PERF: perf_event_attr.config
+    int numa_node;                // Preload shim: numa_alloc_onnode() target emulated as CXL, -1 = none
+    int print_stats;              // Print per-region statistics at exit
+} cxltime_config_t;
+
+// Per-region access counters
+typedef struct {
+    char name[CXLTIME_REGION_NAME_LEN];
+    void* addr;
+    size_t size;
+    uint64_t read_faults;         // EPOCH: first reads of a page in an epoch
+    uint64_t write_faults;        // EPOCH: first writes of a page in an epoch
+    uint64_t samples;             // PERF: sampled misses
+    uint64_t accesses;            // Estimated far-memory accesses
+    uint64_t bytes;               // Estimated far-memory traffic
+    uint64_t delay_ns;            // Total injected delay
+} cxltime_region_stats_t;
+
+// Fill a configuration from CXLTIME_* environment variables
+// (CXLTIME_MODE=off|epoch|perf, CXLTIME_LATENCY_NS, CXLTIME_BANDWIDTH_MBPS,
+// CXLTIME_EPOCH_US, CXLTIME_PERF_PERIOD, CXLTIME_PERF_TYPE, CXLTIME_PERF_CONFIG,
+// CXLTIME_NUMA_NODE, CXLTIME_STATS)
+void cxltime_config_from_env(cxltime_config_t* config);
+
+// Initialization; config == NULL reads the environment. Calling it again is a no-op.
+int cxltime_init(const cxltime_config_t* config);
+void cxltime_finalize(void);
+int cxltime_is_enabled(void);
+const cxltime_config_t* cxltime_get_config(void);
+
+// PERF mode samples per thread: every thread that touches far memory calls this once
+int cxltime_thread_init(void);
+void cxltime_thread_finalize(void);
+
+// Allocator for emulated CXL memory (page-aligned, zeroed, registered)
+void* cxltime_alloc(size_t size, const char* name);
+// Returns -1 if ptr did not come from cxltime_alloc()
+int cxltime_free(void* ptr);
+
+// Register an existing read-write mapping, e.g., a DAX device or a shared file
+int cxltime_register_region(void* addr, size_t size, const char* name);
+int cxltime_unregister_region(void* addr);
+// Register every mapping of a file found in /proc/self/maps; returns the number registered
+int cxltime_register_mapping(const char* path, const char* name);
+
+// Delay the calling thread as if it transferred bytes from far memory
+void cxltime_inject(void* addr, size_t bytes);
+
+// Statistics
+int cxltime_get_region_stats(void* addr, cxltime_region_stats_t* stats);
+void cxltime_print_stats(FILE* out);
+void cxltime_reset_stats(void);
+
+// Calibrated cost of detecting one access, subtracted from the injected latency
+uint64_t cxltime_detection_overhead_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CXLTIME_H
@@ -0,0 +1,455 @@
+#define _GNU_SOURCE
+#include "cxltime_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <linux/perf_event.h>
+
+cxltime_region_t cxltime_regions[CXLTIME_MAX_REGIONS];
+cxltime_config_t cxltime_config;
+size_t cxltime_page_size = 4096;
+
+static pthread_mutex_t region_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t init_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_int initialized = 0;
+
+// Cost of detecting one access, measured at init
+static atomic_uint_fast64_t detection_overhead_ns = 0;
+static atomic_bool calibrating = false;
+
+// Bandwidth cap: far memory is modeled as a single channel, every transfer
+// reserves a slot on this timeline and completes when its slot ends
+static atomic_uint_fast64_t bandwidth_next_free_ns = 0;
+
+static uint64_t env_u64(const char* name, uint64_t def) {
+    const char* value = getenv(name);
+    if (!value || !*value) return def;
+    return strtoull(value, NULL, 0);
+}
+
+void cxltime_config_from_env(cxltime_config_t* config) {
+    memset(config, 0, sizeof(*config));
+
+    config->mode = CXLTIME_MODE_OFF;
+    const char* mode = getenv("CXLTIME_MODE");
+    if (mode) {
+        if (strcasecmp(mode, "epoch") == 0) {
+            config->mode = CXLTIME_MODE_EPOCH;
+        } else if (strcasecmp(mode, "perf") == 0) {
+            config->mode = CXLTIME_MODE_PERF;
+        } else if (strcasecmp(mode, "off") != 0) {
+            fprintf(stderr, "cxltime: unknown CXLTIME_MODE '%s', using off\n", mode);
+        }
+    }
+
+    config->latency_ns = env_u64("CXLTIME_LATENCY_NS", 150);
+    config->bandwidth_mbps = env_u64("CXLTIME_BANDWIDTH_MBPS", 0);
+    config->epoch_us = env_u64("CXLTIME_EPOCH_US", 1000);
+    config->perf_period = env_u64("CXLTIME_PERF_PERIOD", 1000);
+    config->perf_type = (uint32_t)env_u64("CXLTIME_PERF_TYPE", PERF_TYPE_HARDWARE);
+    config->perf_config = env_u64("CXLTIME_PERF_CONFIG", PERF_COUNT_HW_CACHE_MISSES);
+
+    const char* node = getenv("CXLTIME_NUMA_NODE");
+    config->numa_node = (node && *node) ? atoi(node) : -1;
+    config->print_stats = (int)env_u64("CXLTIME_STATS", 0);
+}
+
+static void cxltime_atexit(void) {
+    cxltime_finalize();
+}
+
+static uint64_t calibrate(void) {
+    atomic_store(&calibrating, true);
+    uint64_t overhead = 0;
+    if (cxltime_config.mode == CXLTIME_MODE_EPOCH) {
+        overhead = cxltime_epoch_calibrate();
+    } else if (cxltime_config.mode == CXLTIME_MODE_PERF) {
+        overhead = cxltime_perf_calibrate();
+    }
+    atomic_store(&calibrating, false);
+    return overhead;
+}
+
+int cxltime_init(const cxltime_config_t* config) {
+    if (atomic_load_explicit(&initialized, memory_order_acquire)) return 0;
+
+    pthread_mutex_lock(&init_lock);
+    if (atomic_load(&initialized)) {
+        pthread_mutex_unlock(&init_lock);
+        return 0;
+    }
+
+    if (config) {
+        cxltime_config = *config;
+    } else {
+        cxltime_config_from_env(&cxltime_config);
+    }
+    if (cxltime_config.epoch_us == 0) cxltime_config.epoch_us = 1000;
+    if (cxltime_config.perf_period == 0) cxltime_config.perf_period = 1000;
+
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size > 0) cxltime_page_size = (size_t)page_size;
+
+    int ret = 0;
+    if (cxltime_config.mode == CXLTIME_MODE_EPOCH) {
+        ret = cxltime_epoch_start();
+    } else if (cxltime_config.mode == CXLTIME_MODE_PERF) {
+        ret = cxltime_perf_start();
+    }
+    if (ret != 0) {
+        fprintf(stderr, "cxltime: failed to start %s mode, far-memory delays disabled\n",
+                cxltime_config.mode == CXLTIME_MODE_EPOCH ? "epoch" : "perf");
+        cxltime_config.mode = CXLTIME_MODE_OFF;
+    }
+
+    atomic_store(&detection_overhead_ns, calibrate());
+    atomic_store_explicit(&initialized, 1, memory_order_release);
+    static bool atexit_registered = false;
+    if (!atexit_registered) {
+        atexit(cxltime_atexit);
+        atexit_registered = true;
+    }
+    pthread_mutex_unlock(&init_lock);
+
+    if (cxltime_config.mode != CXLTIME_MODE_OFF) {
+        fprintf(stderr, "cxltime: %s mode, +%lu ns latency, %lu MB/s bandwidth cap, %lu ns detection overhead\n",
+                cxltime_config.mode == CXLTIME_MODE_EPOCH ? "epoch" : "perf",
+                (unsigned long)cxltime_config.latency_ns,
+                (unsigned long)cxltime_config.bandwidth_mbps,
+                (unsigned long)atomic_load(&detection_overhead_ns));
+    }
+    return ret;
+}
+
+void cxltime_finalize(void) {
+    pthread_mutex_lock(&init_lock);
+    if (!atomic_load(&initialized)) {
+        pthread_mutex_unlock(&init_lock);
+        return;
+    }
+
+    if (cxltime_config.mode == CXLTIME_MODE_EPOCH) {
+        cxltime_epoch_stop();
+    } else if (cxltime_config.mode == CXLTIME_MODE_PERF) {
+        cxltime_perf_stop();
+    }
+
+    if (cxltime_config.print_stats) {
+        cxltime_print_stats(stderr);
+    }
+
+    pthread_mutex_lock(&region_lock);
+    for (int i = 0; i < CXLTIME_MAX_REGIONS; i++) {
+        cxltime_region_t* region = &cxltime_regions[i];
+        atomic_store(&region->active, 0);
+    }
+    pthread_mutex_unlock(&region_lock);
+
+    atomic_store(&initialized, 0);
+    pthread_mutex_unlock(&init_lock);
+}
+
+int cxltime_is_enabled(void) {
+    return atomic_load(&initialized) && cxltime_config.mode != CXLTIME_MODE_OFF;
+}
+
+const cxltime_config_t* cxltime_get_config(void) {
+    return &cxltime_config;
+}
+
+uint64_t cxltime_detection_overhead_ns(void) {
+    return atomic_load(&detection_overhead_ns);
+}
+
+int cxltime_thread_init(void) {
+    if (!atomic_load(&initialized) || cxltime_config.mode != CXLTIME_MODE_PERF) return 0;
+    return cxltime_perf_thread_init();
+}
+
+void cxltime_thread_finalize(void) {
+    if (!atomic_load(&initialized) || cxltime_config.mode != CXLTIME_MODE_PERF) return;
+    cxltime_perf_thread_finalize();
+}
+
+// ============================================================================
+// Regions
+// ============================================================================
+
+cxltime_region_t* cxltime_find_region(uintptr_t addr) {
+    for (int i = 0; i < CXLTIME_MAX_REGIONS; i++) {
+        cxltime_region_t* region = &cxltime_regions[i];
+        if (atomic_load_explicit(&region->active, memory_order_acquire) &&
+            addr >= region->start && addr < region->end) {
+            return region;
+        }
+    }
+    return NULL;
+}
+
+// Epoch thread re-protects regions under the same lock as (un)registration
+void cxltime_lock_regions(void) {
+    pthread_mutex_lock(&region_lock);
+}
+
+void cxltime_unlock_regions(void) {
+    pthread_mutex_unlock(&region_lock);
+}
+
+int cxltime_add_region(void* addr, size_t size, const char* name, bool owned) {
+    uintptr_t start = (uintptr_t)addr;
+    if (!addr || size == 0 || (start & (cxltime_page_size - 1)) != 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    uintptr_t end = start + ((size + cxltime_page_size - 1) & ~(cxltime_page_size - 1));
+
+    pthread_mutex_lock(&region_lock);
+
+    cxltime_region_t* slot = NULL;
+    for (int i = 0; i < CXLTIME_MAX_REGIONS; i++) {
+        cxltime_region_t* region = &cxltime_regions[i];
+        if (atomic_load(&region->active)) {
+            if (start < region->end && region->start < end) {
+                pthread_mutex_unlock(&region_lock);
+                errno = EEXIST;
+                return -1;
+            }
+        } else if (!slot) {
+            slot = region;
+        }
+    }
+    if (!slot) {
+        pthread_mutex_unlock(&region_lock);
+        fprintf(stderr, "cxltime: region table full (%d regions)\n", CXLTIME_MAX_REGIONS);
+        errno = ENOSPC;
+        return -1;
+    }
+
+    slot->owned = owned;
+    snprintf(slot->name, sizeof(slot->name), "%s", name ? name : "cxl");
+    slot->start = start;
+    slot->end = end;
+    atomic_store(&slot->prot_size, cxltime_page_size);
+    atomic_store(&slot->read_faults, 0);
+    atomic_store(&slot->write_faults, 0);
+    atomic_store(&slot->samples, 0);
+    atomic_store(&slot->accesses, 0);
+    atomic_store(&slot->bytes, 0);
+    atomic_store(&slot->delay_ns, 0);
+    atomic_store_explicit(&slot->active, 1, memory_order_release);
+
+    if (cxltime_config.mode == CXLTIME_MODE_EPOCH) {
+        cxltime_epoch_protect(slot);
+    }
+
+    pthread_mutex_unlock(&region_lock);
+    return 0;
+}
+
+int cxltime_register_region(void* addr, size_t size, const char* name) {
+    cxltime_init(NULL);
+    return cxltime_add_region(addr, size, name, false);
+}
+
+cxltime_region_t* cxltime_remove_region(void* addr) {
+    pthread_mutex_lock(&region_lock);
+    cxltime_region_t* region = cxltime_find_region((uintptr_t)addr);
+    if (!region || region->start != (uintptr_t)addr) {
+        pthread_mutex_unlock(&region_lock);
+        return NULL;
+    }
+    if (cxltime_config.mode == CXLTIME_MODE_EPOCH) {
+        cxltime_epoch_unprotect(region);
+    }
+    atomic_store_explicit(&region->active, 0, memory_order_release);
+    pthread_mutex_unlock(&region_lock);
+    return region;
+}
+
+int cxltime_unregister_region(void* addr) {
+    return cxltime_remove_region(addr) ? 0 : -1;
+}
+
+int cxltime_register_mapping(const char* path, const char* name) {
+    // /proc/self/maps shows canonical paths
+    char resolved[PATH_MAX];
+    if (realpath(path, resolved)) path = resolved;
+
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps) return -1;
+
+    int registered = 0;
+    char line[4096];
+    while (fgets(line, sizeof(line), maps)) {
+        unsigned long start, end;
+        char perms[8];
+        int path_offset = 0;
+        if (sscanf(line, "%lx-%lx %7s %*s %*s %*s %n", &start, &end, perms, &path_offset) < 3) {
+            continue;
+        }
+        if (path_offset == 0 || perms[0] != 'r' || perms[1] != 'w') continue;
+
+        char* mapped = line + path_offset;
+        mapped[strcspn(mapped, "\n")] = '\0';
+        if (strcmp(mapped, path) != 0) continue;
+
+        if (cxltime_register_region((void*)start, end - start, name ? name : path) == 0) {
+            registered++;
+        }
+    }
+    fclose(maps);
+    return registered;
+}
+
+void* cxltime_alloc(size_t size, const char* name) {
+    cxltime_init(NULL);
+    if (size == 0) return NULL;
+
+    size = (size + cxltime_page_size - 1) & ~(cxltime_page_size - 1);
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) return NULL;
+
+    if (cxltime_add_region(addr, size, name, true) != 0) {
+        munmap(addr, size);
+        return NULL;
+    }
+    return addr;
+}
+
+int cxltime_free(void* ptr) {
+    if (!ptr) return 0;
+
+    pthread_mutex_lock(&region_lock);
+    cxltime_region_t* region = cxltime_find_region((uintptr_t)ptr);
+    bool owned = region && region->owned && region->start == (uintptr_t)ptr;
+    pthread_mutex_unlock(&region_lock);
+    if (!owned) return -1;
+
+    region = cxltime_remove_region(ptr);
+    if (!region) return -1;
+    munmap(ptr, region->end - region->start);
+    return 0;
+}
+
+// ============================================================================
+// Delay injection
+// ============================================================================
+
+uint64_t cxltime_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void cxltime_spin_until(uint64_t deadline_ns) {
+    while (cxltime_now_ns() < deadline_ns) {
+#if defined(__x86_64__) || defined(__i386__)
+        __asm__ __volatile__("pause");
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+}
+
+void cxltime_charge(cxltime_region_t* region, uint64_t accesses,
+                    uint64_t bytes, uint64_t overhead_ns) {
+    if (region) {
+        atomic_fetch_add_explicit(&region->accesses, accesses, memory_order_relaxed);
+        atomic_fetch_add_explicit(&region->bytes, bytes, memory_order_relaxed);
+    }
+    if (cxltime_config.mode == CXLTIME_MODE_OFF || atomic_load(&calibrating)) return;
+
+    uint64_t now = cxltime_now_ns();
+    uint64_t latency = accesses * cxltime_config.latency_ns;
+    uint64_t deadline = now + (latency > overhead_ns ? latency - overhead_ns : 0);
+
+    if (cxltime_config.bandwidth_mbps) {
+        // 1 MB/s moves one byte per microsecond
+        uint64_t transfer_ns = bytes * 1000 / cxltime_config.bandwidth_mbps;
+        uint64_t slot = atomic_load_explicit(&bandwidth_next_free_ns, memory_order_relaxed);
+        uint64_t finish;
+        do {
+            finish = (slot > now ? slot : now) + transfer_ns;
+        } while (!atomic_compare_exchange_weak_explicit(&bandwidth_next_free_ns, &slot, finish,
+                                                        memory_order_relaxed, memory_order_relaxed));
+        if (finish > deadline) deadline = finish;
+    }
+
+    cxltime_spin_until(deadline);
+    if (region) {
+        atomic_fetch_add_explicit(&region->delay_ns, deadline - now, memory_order_relaxed);
+    }
+}
+
+void cxltime_inject(void* addr, size_t bytes) {
+    size_t lines = (bytes + 63) / 64;
+    cxltime_charge(cxltime_find_region((uintptr_t)addr), lines ? lines : 1, bytes, 0);
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+static void copy_stats(cxltime_region_t* region, cxltime_region_stats_t* stats) {
+    memcpy(stats->name, region->name, sizeof(stats->name));
+    stats->addr = (void*)region->start;
+    stats->size = region->end - region->start;
+    stats->read_faults = atomic_load(&region->read_faults);
+    stats->write_faults = atomic_load(&region->write_faults);
+    stats->samples = atomic_load(&region->samples);
+    stats->accesses = atomic_load(&region->accesses);
+    stats->bytes = atomic_load(&region->bytes);
+    stats->delay_ns = atomic_load(&region->delay_ns);
+}
+
+int cxltime_get_region_stats(void* addr, cxltime_region_stats_t* stats) {
+    cxltime_region_t* region = cxltime_find_region((uintptr_t)addr);
+    if (!region || !stats) return -1;
+    copy_stats(region, stats);
+    return 0;
+}
+
+void cxltime_print_stats(FILE* out) {
+    static const char* mode_names[] = {"off", "epoch", "perf"};
+
+    fprintf(out, "\n=== cxltime Statistics (%s, +%lu ns, %lu MB/s) ===\n",
+            mode_names[cxltime_config.mode],
+            (unsigned long)cxltime_config.latency_ns,
+            (unsigned long)cxltime_config.bandwidth_mbps);
+    fprintf(out, "%-20s %10s %12s %12s %10s %12s %10s %10s\n",
+            "Region", "Size(MB)", "ReadFaults", "WriteFaults", "Samples",
+            "Accesses", "Bytes(MB)", "Delay(ms)");
+
+    for (int i = 0; i < CXLTIME_MAX_REGIONS; i++) {
+        cxltime_region_t* region = &cxltime_regions[i];
+        if (!atomic_load(&region->active)) continue;
+
+        cxltime_region_stats_t stats;
+        copy_stats(region, &stats);
+        fprintf(out, "%-20s %10.1f %12lu %12lu %10lu %12lu %10.1f %10.2f\n",
+                stats.name, stats.size / (1024.0 * 1024.0),
+                (unsigned long)stats.read_faults, (unsigned long)stats.write_faults,
+                (unsigned long)stats.samples, (unsigned long)stats.accesses,
+                stats.bytes / (1024.0 * 1024.0), stats.delay_ns / 1e6);
+    }
+}
+
+void cxltime_reset_stats(void) {
+    for (int i = 0; i < CXLTIME_MAX_REGIONS; i++) {
+        cxltime_region_t* region = &cxltime_regions[i];
+        atomic_store(&region->read_faults, 0);
+        atomic_store(&region->write_faults, 0);
+        atomic_store(&region->samples, 0);
+        atomic_store(&region->accesses, 0);
+        atomic_store(&region->bytes, 0);
+        atomic_store(&region->delay_ns, 0);
+    }
+}
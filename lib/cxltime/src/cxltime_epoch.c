@@ -0,0 +1,176 @@
+#define _GNU_SOURCE
+#include "cxltime_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+
+// EPOCH mode: every epoch all regions are set to PROT_NONE. The first read
+// (or write) of a page in an epoch faults, the handler opens the page up
+// again and charges one far-memory access of a full page. Faults are a lower
+// bound on the real miss count, so a short epoch trades overhead for accuracy.
+
+#define CALIBRATION_PAGES 256
+#define HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+static struct sigaction prev_segv;
+static pthread_t epoch_thread;
+static atomic_bool epoch_running = false;
+
+static void chain_segv(int sig, siginfo_t* info, void* uctx) {
+    if (prev_segv.sa_flags & SA_SIGINFO) {
+        if (prev_segv.sa_sigaction) {
+            prev_segv.sa_sigaction(sig, info, uctx);
+            return;
+        }
+    } else if (prev_segv.sa_handler != SIG_DFL && prev_segv.sa_handler != SIG_IGN) {
+        prev_segv.sa_handler(sig);
+        return;
+    }
+
+    // Not ours and nobody else handles it: restore the default action and
+    // let the faulting instruction crash the process as usual
+    signal(SIGSEGV, SIG_DFL);
+}
+
+static bool fault_is_write(void* uctx) {
+#if defined(__x86_64__)
+    const ucontext_t* context = (const ucontext_t*)uctx;
+    return (context->uc_mcontext.gregs[REG_ERR] & 0x2) != 0;
+#else
+    // No portable error code: grant write access and count it as a write
+    (void)uctx;
+    return true;
+#endif
+}
+
+static void segv_handler(int sig, siginfo_t* info, void* uctx) {
+    int saved_errno = errno;
+
+    uintptr_t addr = (uintptr_t)info->si_addr;
+    cxltime_region_t* region = info->si_code == SEGV_ACCERR ? cxltime_find_region(addr) : NULL;
+    if (!region) {
+        errno = saved_errno;
+        chain_segv(sig, info, uctx);
+        return;
+    }
+
+    bool write = fault_is_write(uctx);
+    int prot = write ? PROT_READ | PROT_WRITE : PROT_READ;
+    size_t granularity = atomic_load_explicit(&region->prot_size, memory_order_relaxed);
+    while (mprotect((void*)(addr & ~(granularity - 1)), granularity, prot) != 0) {
+        if (errno != EINVAL || granularity >= HUGE_PAGE_SIZE) {
+            errno = saved_errno;
+            chain_segv(sig, info, uctx);
+            return;
+        }
+        // hugetlbfs mappings only accept huge-page aligned protection changes
+        granularity = HUGE_PAGE_SIZE;
+        atomic_store_explicit(&region->prot_size, granularity, memory_order_relaxed);
+    }
+
+    if (write) {
+        atomic_fetch_add_explicit(&region->write_faults, 1, memory_order_relaxed);
+    } else {
+        atomic_fetch_add_explicit(&region->read_faults, 1, memory_order_relaxed);
+    }
+
+    // The calibrated overhead covers the trap and this handler, so only the
+    // remainder of the latency is spun
+    cxltime_charge(region, 1, granularity, cxltime_detection_overhead_ns());
+    errno = saved_errno;
+}
+
+void cxltime_epoch_protect(cxltime_region_t* region) {
+    mprotect((void*)region->start, region->end - region->start, PROT_NONE);
+}
+
+void cxltime_epoch_unprotect(cxltime_region_t* region) {
+    mprotect((void*)region->start, region->end - region->start, PROT_READ | PROT_WRITE);
+}
+
+static void* epoch_main(void* arg) {
+    (void)arg;
+    struct timespec interval = {
+        .tv_sec = (time_t)(cxltime_config.epoch_us / 1000000),
+        .tv_nsec = (long)(cxltime_config.epoch_us % 1000000) * 1000,
+    };
+
+    while (atomic_load(&epoch_running)) {
+        nanosleep(&interval, NULL);
+
+        cxltime_lock_regions();
+        for (int i = 0; i < CXLTIME_MAX_REGIONS; i++) {
+            cxltime_region_t* region = &cxltime_regions[i];
+            if (atomic_load(&region->active) && atomic_load(&epoch_running)) {
+                cxltime_epoch_protect(region);
+            }
+        }
+        cxltime_unlock_regions();
+    }
+    return NULL;
+}
+
+int cxltime_epoch_start(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = segv_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(SIGSEGV, &sa, &prev_segv) != 0) {
+        perror("cxltime: sigaction");
+        return -1;
+    }
+
+    atomic_store(&epoch_running, true);
+    if (pthread_create(&epoch_thread, NULL, epoch_main, NULL) != 0) {
+        atomic_store(&epoch_running, false);
+        sigaction(SIGSEGV, &prev_segv, NULL);
+        return -1;
+    }
+    return 0;
+}
+
+void cxltime_epoch_stop(void) {
+    if (!atomic_exchange(&epoch_running, false)) return;
+    pthread_join(epoch_thread, NULL);
+
+    cxltime_lock_regions();
+    for (int i = 0; i < CXLTIME_MAX_REGIONS; i++) {
+        cxltime_region_t* region = &cxltime_regions[i];
+        if (atomic_load(&region->active)) {
+            cxltime_epoch_unprotect(region);
+        }
+    }
+    cxltime_unlock_regions();
+
+    sigaction(SIGSEGV, &prev_segv, NULL);
+}
+
+// Average cost of one fault round trip (trap, lookup, mprotect, return)
+uint64_t cxltime_epoch_calibrate(void) {
+    size_t size = CALIBRATION_PAGES * cxltime_page_size;
+    void* scratch = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (scratch == MAP_FAILED) return 0;
+
+    if (cxltime_add_region(scratch, size, "calibration", false) != 0) {
+        munmap(scratch, size);
+        return 0;
+    }
+
+    volatile char* bytes = (volatile char*)scratch;
+    uint64_t start = cxltime_now_ns();
+    for (size_t i = 0; i < CALIBRATION_PAGES; i++) {
+        (void)bytes[i * cxltime_page_size];
+    }
+    uint64_t elapsed = cxltime_now_ns() - start;
+
+    cxltime_remove_region(scratch);
+    munmap(scratch, size);
+    return elapsed / CALIBRATION_PAGES;
+}
@@ -0,0 +1,61 @@
+#ifndef CXLTIME_INTERNAL_H
+#define CXLTIME_INTERNAL_H
+
+#include "cxltime.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Region table entry. Lookups happen in signal handlers, so the table is a
+// fixed array scanned without locks; writers serialize on the region mutex.
+typedef struct {
+    atomic_int active;
+    bool owned;                   // Allocated by cxltime_alloc()
+    char name[CXLTIME_REGION_NAME_LEN];
+    uintptr_t start;
+    uintptr_t end;
+    atomic_size_t prot_size;      // Protection granularity (grows to the huge page size on EINVAL)
+
+    atomic_uint_fast64_t read_faults;
+    atomic_uint_fast64_t write_faults;
+    atomic_uint_fast64_t samples;
+    atomic_uint_fast64_t accesses;
+    atomic_uint_fast64_t bytes;
+    atomic_uint_fast64_t delay_ns;
+} cxltime_region_t;
+
+extern cxltime_region_t cxltime_regions[CXLTIME_MAX_REGIONS];
+extern cxltime_config_t cxltime_config;
+extern size_t cxltime_page_size;
+
+cxltime_region_t* cxltime_find_region(uintptr_t addr);
+// Region table updates without lazy initialization
+int cxltime_add_region(void* addr, size_t size, const char* name, bool owned);
+cxltime_region_t* cxltime_remove_region(void* addr);
+void cxltime_lock_regions(void);
+void cxltime_unlock_regions(void);
+
+// Monotonic clock and busy-wait delay, both async-signal-safe
+uint64_t cxltime_now_ns(void);
+void cxltime_spin_until(uint64_t deadline_ns);
+
+// Charge accesses/bytes to a region and stall the calling thread for the
+// added latency and the bandwidth cap. overhead_ns has already been spent
+// detecting the access and is deducted from the latency.
+void cxltime_charge(cxltime_region_t* region, uint64_t accesses,
+                    uint64_t bytes, uint64_t overhead_ns);
+
+// EPOCH mode (cxltime_epoch.c)
+int cxltime_epoch_start(void);
+void cxltime_epoch_stop(void);
+void cxltime_epoch_protect(cxltime_region_t* region);
+void cxltime_epoch_unprotect(cxltime_region_t* region);
+uint64_t cxltime_epoch_calibrate(void);
+
+// PERF mode (cxltime_perf.c)
+int cxltime_perf_start(void);
+void cxltime_perf_stop(void);
+int cxltime_perf_thread_init(void);
+void cxltime_perf_thread_finalize(void);
+uint64_t cxltime_perf_calibrate(void);
+
+#endif // CXLTIME_INTERNAL_H
@@ -0,0 +1,190 @@
+#define _GNU_SOURCE
+#include "cxltime_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// PERF mode: each thread samples one memory event every perf_period
+// occurrences with the data address attached. Samples that land in a region
+// stand for perf_period far-memory accesses and are charged accordingly.
+// Overflow notifications arrive as a realtime signal on the sampled thread,
+// so the delay is paid by the thread that caused the misses.
+
+#define PERF_DATA_PAGES 8
+#define CALIBRATION_SIGNALS 1000
+
+static int perf_signal = -1;
+static struct sigaction prev_perf_action;
+static pthread_key_t perf_thread_key;
+static bool perf_key_created = false;
+
+static __thread int perf_fd = -1;
+static __thread struct perf_event_mmap_page* perf_page = NULL;
+
+static void ring_copy(void* dst, const uint8_t* data, uint64_t offset, uint64_t mask, size_t len) {
+    uint8_t* out = (uint8_t*)dst;
+    for (size_t i = 0; i < len; i++) {
+        out[i] = data[(offset + i) & mask];
+    }
+}
+
+static void perf_handler(int sig, siginfo_t* info, void* uctx) {
+    (void)sig;
+    (void)info;
+    (void)uctx;
+
+    struct perf_event_mmap_page* page = perf_page;
+    if (!page) return;
+
+    int saved_errno = errno;
+    const uint8_t* data = (const uint8_t*)page + cxltime_page_size;
+    uint64_t mask = PERF_DATA_PAGES * cxltime_page_size - 1;
+    uint64_t head = __atomic_load_n(&page->data_head, __ATOMIC_ACQUIRE);
+    uint64_t tail = page->data_tail;
+    uint64_t period = cxltime_config.perf_period;
+    uint64_t overhead = cxltime_detection_overhead_ns();
+
+    while (tail < head) {
+        struct perf_event_header header;
+        ring_copy(&header, data, tail, mask, sizeof(header));
+        if (header.size == 0) break;
+
+        if (header.type == PERF_RECORD_SAMPLE && header.size >= sizeof(header) + sizeof(uint64_t)) {
+            uint64_t addr;
+            ring_copy(&addr, data, tail + sizeof(header), mask, sizeof(addr));
+            cxltime_region_t* region = addr ? cxltime_find_region((uintptr_t)addr) : NULL;
+            if (region) {
+                atomic_fetch_add_explicit(&region->samples, 1, memory_order_relaxed);
+                cxltime_charge(region, period, period * 64, overhead);
+            }
+        }
+        tail += header.size;
+    }
+
+    __atomic_store_n(&page->data_tail, tail, __ATOMIC_RELEASE);
+    errno = saved_errno;
+}
+
+static void perf_thread_exit(void* arg) {
+    (void)arg;
+    cxltime_perf_thread_finalize();
+}
+
+int cxltime_perf_start(void) {
+    perf_signal = SIGRTMIN + 4;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = perf_handler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    if (sigaction(perf_signal, &sa, &prev_perf_action) != 0) {
+        perror("cxltime: sigaction");
+        return -1;
+    }
+
+    if (!perf_key_created) {
+        if (pthread_key_create(&perf_thread_key, perf_thread_exit) != 0) return -1;
+        perf_key_created = true;
+    }
+
+    // The initializing thread samples too
+    if (cxltime_perf_thread_init() != 0) {
+        sigaction(perf_signal, &prev_perf_action, NULL);
+        return -1;
+    }
+    return 0;
+}
+
+void cxltime_perf_stop(void) {
+    cxltime_perf_thread_finalize();
+
+    // Other threads may still have samplers armed until they exit; drop
+    // their notifications instead of taking the default (fatal) action
+    signal(perf_signal, SIG_IGN);
+}
+
+int cxltime_perf_thread_init(void) {
+    if (perf_fd >= 0) return 0;
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = cxltime_config.perf_type;
+    attr.config = cxltime_config.perf_config;
+    attr.sample_period = cxltime_config.perf_period;
+    attr.sample_type = PERF_SAMPLE_ADDR;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.wakeup_events = 1;
+
+    // Precise events give the exact data address; fall back step by step
+    int fd = -1;
+    for (int precise = 2; precise >= 0 && fd < 0; precise--) {
+        attr.precise_ip = (uint64_t)precise;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    }
+    if (fd < 0) {
+        fprintf(stderr, "cxltime: perf_event_open failed: %s (check /proc/sys/kernel/perf_event_paranoid)\n",
+                strerror(errno));
+        return -1;
+    }
+
+    size_t mmap_size = (1 + PERF_DATA_PAGES) * cxltime_page_size;
+    void* page = mmap(NULL, mmap_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (page == MAP_FAILED) {
+        perror("cxltime: perf mmap");
+        close(fd);
+        return -1;
+    }
+
+    struct f_owner_ex owner = { .type = F_OWNER_TID, .pid = (pid_t)syscall(SYS_gettid) };
+    if (fcntl(fd, F_SETFL, O_ASYNC | O_NONBLOCK) != 0 ||
+        fcntl(fd, F_SETSIG, perf_signal) != 0 ||
+        fcntl(fd, F_SETOWN_EX, &owner) != 0) {
+        perror("cxltime: perf fcntl");
+        munmap(page, mmap_size);
+        close(fd);
+        return -1;
+    }
+
+    perf_page = (struct perf_event_mmap_page*)page;
+    perf_fd = fd;
+    pthread_setspecific(perf_thread_key, (void*)1);
+
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    return 0;
+}
+
+void cxltime_perf_thread_finalize(void) {
+    if (perf_fd < 0) return;
+
+    ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+    struct perf_event_mmap_page* page = perf_page;
+    perf_page = NULL;
+    munmap(page, (1 + PERF_DATA_PAGES) * cxltime_page_size);
+    close(perf_fd);
+    perf_fd = -1;
+    pthread_setspecific(perf_thread_key, NULL);
+}
+
+// Average cost of one notification (signal delivery plus ring drain)
+uint64_t cxltime_perf_calibrate(void) {
+    if (perf_fd < 0) return 0;
+
+    uint64_t start = cxltime_now_ns();
+    for (int i = 0; i < CALIBRATION_SIGNALS; i++) {
+        raise(perf_signal);
+    }
+    return (cxltime_now_ns() - start) / CALIBRATION_SIGNALS;
+}
@@ -0,0 +1,78 @@
+#define _GNU_SOURCE
+#include "cxltime.h"
+#include <stdlib.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <pthread.h>
+
+// LD_PRELOAD shim for unmodified binaries:
+//   - numa_alloc_onnode()/numa_free() on CXLTIME_NUMA_NODE become cxltime regions,
+//     so code that already places data on a CXL NUMA node runs against the emulator
+//   - new threads are registered for PERF sampling
+//
+//   CXLTIME_MODE=epoch CXLTIME_NUMA_NODE=1 LD_PRELOAD=libcxltime_preload.so ./app
+
+typedef void* (*numa_alloc_onnode_fn)(size_t, int);
+typedef void (*numa_free_fn)(void*, size_t);
+typedef int (*pthread_create_fn)(pthread_t*, const pthread_attr_t*, void* (*)(void*), void*);
+
+__attribute__((constructor))
+static void cxltime_preload_init(void) {
+    cxltime_init(NULL);
+}
+
+void* numa_alloc_onnode(size_t size, int node) {
+    cxltime_init(NULL);
+    const cxltime_config_t* config = cxltime_get_config();
+    if (config->numa_node >= 0 && node == config->numa_node) {
+        return cxltime_alloc(size, "numa_alloc_onnode");
+    }
+
+    numa_alloc_onnode_fn next = (numa_alloc_onnode_fn)dlsym(RTLD_NEXT, "numa_alloc_onnode");
+    if (!next) {
+        errno = ENOSYS;
+        return NULL;
+    }
+    return next(size, node);
+}
+
+void numa_free(void* mem, size_t size) {
+    if (cxltime_free(mem) == 0) return;
+
+    numa_free_fn next = (numa_free_fn)dlsym(RTLD_NEXT, "numa_free");
+    if (next) next(mem, size);
+}
+
+typedef struct {
+    void* (*start_routine)(void*);
+    void* arg;
+} thread_start_t;
+
+static void* thread_trampoline(void* arg) {
+    thread_start_t start = *(thread_start_t*)arg;
+    free(arg);
+    cxltime_thread_init();
+    return start.start_routine(start.arg);
+}
+
+int pthread_create(pthread_t* thread, const pthread_attr_t* attr,
+                   void* (*start_routine)(void*), void* arg) {
+    static pthread_create_fn next = NULL;
+    if (!next) {
+        next = (pthread_create_fn)dlsym(RTLD_NEXT, "pthread_create");
+        if (!next) return ENOSYS;
+    }
+
+    if (cxltime_get_config()->mode != CXLTIME_MODE_PERF) {
+        return next(thread, attr, start_routine, arg);
+    }
+
+    thread_start_t* start = malloc(sizeof(*start));
+    if (!start) return EAGAIN;
+    start->start_routine = start_routine;
+    start->arg = arg;
+
+    int ret = next(thread, attr, thread_trampoline, start);
+    if (ret != 0) free(start);
+    return ret;
+}
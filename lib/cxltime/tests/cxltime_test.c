@@ -0,0 +1,158 @@
+/*
+ * cxltime unit test
+ * Checks region bookkeeping, EPOCH-mode fault accounting and that the
+ * injected latency and bandwidth cap show up in wall-clock time.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "cxltime.h"
+
+#define TEST_PAGES 64
+
+static int failures = 0;
+
+#define CHECK(cond, msg) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "FAIL: %s (%s:%d)\n", msg, __FILE__, __LINE__); \
+        failures++; \
+    } else { \
+        printf("  ok: %s\n", msg); \
+    } \
+} while (0)
+
+static inline double get_time_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void test_regions(size_t page_size) {
+    printf("Region table\n");
+
+    char* a = cxltime_alloc(TEST_PAGES * page_size, "a");
+    CHECK(a != NULL, "cxltime_alloc returns memory");
+    CHECK(a[0] == 0 && a[TEST_PAGES * page_size - 1] == 0, "allocation is zeroed");
+
+    cxltime_region_stats_t stats;
+    CHECK(cxltime_get_region_stats(a + page_size, &stats) == 0, "interior address maps to its region");
+    CHECK(strcmp(stats.name, "a") == 0 && stats.addr == a, "region name and base are kept");
+    CHECK(cxltime_register_region(a, page_size, "overlap") != 0, "overlapping registration is rejected");
+
+    void* b = mmap(NULL, page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(cxltime_register_region(b, page_size, "b") == 0, "existing mapping can be registered");
+    CHECK(cxltime_free(b) != 0, "cxltime_free refuses memory it did not allocate");
+    CHECK(cxltime_unregister_region(b) == 0, "unregister");
+    CHECK(cxltime_get_region_stats(b, &stats) != 0, "unregistered region is gone");
+    munmap(b, page_size);
+
+    char path[] = "/tmp/cxltime_test_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK(fd >= 0 && ftruncate(fd, 4 * page_size) == 0, "create backing file");
+    void* file = mmap(NULL, 4 * page_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    CHECK(cxltime_register_mapping(path, "file") == 1, "file mapping found in /proc/self/maps");
+    CHECK(cxltime_get_region_stats((char*)file + 3 * page_size, &stats) == 0, "whole file mapping is tracked");
+    CHECK(cxltime_register_mapping(path, "file") == 0, "already tracked mapping is skipped");
+    cxltime_unregister_region(file);
+    munmap(file, 4 * page_size);
+    close(fd);
+    unlink(path);
+
+    cxltime_inject(a, 256);
+    cxltime_get_region_stats(a, &stats);
+    CHECK(stats.accesses == 4 && stats.bytes == 256, "inject counts cache lines and bytes");
+
+    CHECK(cxltime_free(a) == 0, "cxltime_free");
+    CHECK(cxltime_get_region_stats(a, &stats) != 0, "freed region is gone");
+}
+
+static void test_epoch(size_t page_size) {
+    printf("EPOCH mode\n");
+
+    cxltime_config_t config;
+    cxltime_config_from_env(&config);
+    config.mode = CXLTIME_MODE_EPOCH;
+    config.latency_ns = 20000;
+    config.bandwidth_mbps = 0;
+    config.epoch_us = 200000;  // Long epoch: every page faults once per pass below
+    CHECK(cxltime_init(&config) == 0, "init epoch mode");
+    CHECK(cxltime_is_enabled(), "emulation enabled");
+
+    char* region = cxltime_alloc(TEST_PAGES * page_size, "epoch");
+    CHECK(region != NULL, "alloc under epoch mode");
+
+    double start = get_time_ns();
+    volatile char sink = 0;
+    for (size_t i = 0; i < TEST_PAGES; i++) {
+        sink += region[i * page_size];
+    }
+    double elapsed = get_time_ns() - start;
+    (void)sink;
+
+    cxltime_region_stats_t stats;
+    cxltime_get_region_stats(region, &stats);
+    CHECK(stats.read_faults == TEST_PAGES, "one read fault per page");
+    CHECK(stats.write_faults == 0, "no write faults on a read pass");
+    CHECK(elapsed >= TEST_PAGES * config.latency_ns * 0.9, "read pass pays the added latency");
+
+    for (size_t i = 0; i < TEST_PAGES; i++) {
+        region[i * page_size] = (char)i;
+    }
+    cxltime_get_region_stats(region, &stats);
+    CHECK(stats.write_faults == TEST_PAGES, "first write to a read-only page faults again");
+    CHECK(region[5 * page_size] == 5, "data survives protection changes");
+
+    cxltime_free(region);
+    cxltime_finalize();
+    CHECK(!cxltime_is_enabled(), "finalize disables emulation");
+}
+
+static void test_bandwidth(size_t page_size) {
+    printf("Bandwidth cap\n");
+
+    cxltime_config_t config;
+    cxltime_config_from_env(&config);
+    config.mode = CXLTIME_MODE_EPOCH;
+    config.latency_ns = 0;
+    config.bandwidth_mbps = 100;  // 100 bytes/us: a 4KB page costs ~41us
+    config.epoch_us = 200000;
+    cxltime_init(&config);
+
+    char* region = cxltime_alloc(TEST_PAGES * page_size, "bandwidth");
+    double start = get_time_ns();
+    for (size_t i = 0; i < TEST_PAGES; i++) {
+        region[i * page_size] = 1;
+    }
+    double elapsed = get_time_ns() - start;
+    double expected = TEST_PAGES * page_size * 1000.0 / config.bandwidth_mbps;
+    CHECK(elapsed >= expected * 0.9, "transfers are throttled to the bandwidth cap");
+
+    cxltime_free(region);
+    cxltime_finalize();
+}
+
+int main(void) {
+    size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+
+    cxltime_config_t config;
+    cxltime_config_from_env(&config);
+    config.mode = CXLTIME_MODE_OFF;
+    cxltime_init(&config);
+    test_regions(page_size);
+    cxltime_finalize();
+
+    test_epoch(page_size);
+    test_bandwidth(page_size);
+
+    if (failures) {
+        printf("%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("All cxltime tests passed\n");
+    return 0;
+}
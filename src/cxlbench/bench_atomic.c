@@ -0,0 +1,206 @@
+/*
+ * Atomic round trips and contention on one line of the shared mapping,
+ * between threads and between processes
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <immintrin.h>
+#include <sys/wait.h>
+#include "cxlbench.h"
+
+#define PINGPONG_STOP UINT64_MAX
+
+typedef struct {
+    uint64_t ops;
+    uint64_t failures;
+    double elapsed;
+} __attribute__((aligned(CACHE_LINE_SIZE))) party_result_t;
+
+// Lives at the start of the mapping so that forked processes share it
+typedef struct {
+    uint64_t counter __attribute__((aligned(CACHE_LINE_SIZE)));
+    pthread_barrier_t barrier __attribute__((aligned(CACHE_LINE_SIZE)));
+    party_result_t results[MAX_CPUS];
+} shared_area_t;
+
+typedef enum { OP_PINGPONG, OP_CAS, OP_FETCH_ADD } atomic_op_t;
+
+typedef struct {
+    shared_area_t* area;
+    atomic_op_t op;
+    int index;
+    int cpu;
+} party_t;
+
+/*
+ * Ping-pong: party 0 moves the counter from even to odd, party 1 from odd
+ * to even, each with a CAS. Every round trip moves the line there and back.
+ */
+static void pingpong_initiator(shared_area_t* area, party_result_t* result) {
+    uint64_t value = 0;
+    double start = now_sec();
+    do {
+        for (int i = 0; i < 256; i++) {
+            uint64_t expected = value;
+            __atomic_compare_exchange_n(&area->counter, &expected, value + 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+            while (__atomic_load_n(&area->counter, __ATOMIC_ACQUIRE) != value + 2) {
+                _mm_pause();
+            }
+            value += 2;
+        }
+        result->ops += 256;
+        result->elapsed = now_sec() - start;
+    } while (result->elapsed < g_config.duration);
+
+    __atomic_store_n(&area->counter, PINGPONG_STOP, __ATOMIC_RELEASE);
+}
+
+static void pingpong_responder(shared_area_t* area) {
+    for (;;) {
+        uint64_t value = __atomic_load_n(&area->counter, __ATOMIC_ACQUIRE);
+        if (value == PINGPONG_STOP) break;
+        if (value & 1) {
+            __atomic_compare_exchange_n(&area->counter, &value, value + 1, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+        } else {
+            _mm_pause();
+        }
+    }
+}
+
+static void contend(shared_area_t* area, atomic_op_t op, party_result_t* result) {
+    double start = now_sec();
+    do {
+        for (int i = 0; i < 256; i++) {
+            if (op == OP_FETCH_ADD) {
+                __atomic_fetch_add(&area->counter, 1, __ATOMIC_ACQ_REL);
+            } else {
+                uint64_t value = __atomic_load_n(&area->counter, __ATOMIC_RELAXED);
+                while (!__atomic_compare_exchange_n(&area->counter, &value, value + 1, false,
+                                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+                    result->failures++;
+                }
+            }
+        }
+        result->ops += 256;
+        result->elapsed = now_sec() - start;
+    } while (result->elapsed < g_config.duration);
+}
+
+static void* party_main(void* arg) {
+    party_t* party = (party_t*)arg;
+    party_result_t* result = &party->area->results[party->index];
+
+    pin_to_cpu(party->cpu);
+    pthread_barrier_wait(&party->area->barrier);
+
+    if (party->op != OP_PINGPONG) {
+        contend(party->area, party->op, result);
+    } else if (party->index == 0) {
+        pingpong_initiator(party->area, result);
+    } else {
+        pingpong_responder(party->area);
+    }
+    return NULL;
+}
+
+/* Runs n parties as threads of this process or as forked processes */
+static int run_parties(shared_area_t* area, atomic_op_t op, int n, bool processes) {
+    party_t parties[MAX_CPUS];
+    pthread_barrierattr_t attr;
+
+    memset(area->results, 0, sizeof(party_result_t) * n);
+    area->counter = 0;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, processes ? PTHREAD_PROCESS_SHARED : PTHREAD_PROCESS_PRIVATE);
+    pthread_barrier_init(&area->barrier, &attr, (unsigned)n);
+    pthread_barrierattr_destroy(&attr);
+
+    for (int i = 0; i < n; i++) {
+        parties[i] = (party_t){ .area = area, .op = op, .index = i, .cpu = g_config.cpus[i] };
+    }
+
+    int ret = 0;
+    if (!processes) {
+        ret = run_threads(n, party_main, parties, sizeof(party_t));
+    } else {
+        pid_t pids[MAX_CPUS];
+        fflush(NULL);
+        for (int i = 0; i < n; i++) {
+            pids[i] = fork();
+            if (pids[i] == 0) {
+                party_main(&parties[i]);
+                _exit(0);
+            }
+            if (pids[i] < 0) {
+                perror("fork");
+                // Parties already started would wait at the barrier forever
+                for (int j = 0; j < i; j++) kill(pids[j], SIGKILL);
+                n = i;
+                ret = -1;
+                break;
+            }
+        }
+        for (int i = 0; i < n; i++) {
+            waitpid(pids[i], NULL, 0);
+        }
+    }
+
+    pthread_barrier_destroy(&area->barrier);
+    return ret;
+}
+
+void bench_atomic(bench_region_t* region) {
+    static const char* op_names[] = { "pingpong", "cas", "fetch_add" };
+    shared_area_t* area = (shared_area_t*)region->base;
+
+    fprintf(stderr, "atomic: ping-pong on cpus %d/%d, contention with 1-%d threads/processes\n",
+            g_config.cpus[0], g_config.num_cpus > 1 ? g_config.cpus[1] : -1, g_config.threads);
+
+    for (int processes = 0; processes <= 1; processes++) {
+        const char* parties = processes ? "processes" : "threads";
+
+        if (g_config.num_cpus < 2) {
+            fprintf(stderr, "  ping-pong needs two cpus, skipped\n");
+        } else if (run_parties(area, OP_PINGPONG, 2, processes) == 0) {
+            party_result_t* r = &area->results[0];
+            result_begin("atomic");
+            result_str("op", op_names[OP_PINGPONG]);
+            result_str("parties", parties);
+            result_u64("count", 2);
+            result_u64("round_trips", r->ops);
+            result_double("ns_per_round_trip", r->elapsed * 1e9 / r->ops);
+            result_end();
+        }
+
+        for (int op = OP_CAS; op <= OP_FETCH_ADD; op++) {
+            for (int n = 1; n <= g_config.threads; n = next_thread_count(n)) {
+                if (run_parties(area, (atomic_op_t)op, n, processes) != 0) continue;
+
+                uint64_t ops = 0, failures = 0;
+                double elapsed = 0;
+                for (int i = 0; i < n; i++) {
+                    ops += area->results[i].ops;
+                    failures += area->results[i].failures;
+                    if (area->results[i].elapsed > elapsed) elapsed = area->results[i].elapsed;
+                }
+
+                result_begin("atomic");
+                result_str("op", op_names[op]);
+                result_str("parties", parties);
+                result_u64("count", (uint64_t)n);
+                result_u64("ops", ops);
+                result_double("mops_per_sec", ops / elapsed / 1e6);
+                result_double("failed_cas_per_op", (double)failures / ops);
+                result_end();
+            }
+        }
+    }
+}
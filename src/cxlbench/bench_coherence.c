@@ -0,0 +1,153 @@
+/*
+ * Cache line flush and fence cost
+ *
+ * These are the primitives behind libpgas cxl_flush()/cxl_invalidate(),
+ * Tigon's SCCManager clflush()/clwb() and the litmus tests.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <immintrin.h>
+#include "cxlbench.h"
+
+#define FLUSH_WINDOW_LINES 4096
+
+typedef enum { FLUSH_CLFLUSH, FLUSH_CLFLUSHOPT, FLUSH_CLWB, FLUSH_NONE } flush_op_t;
+
+static const char* flush_op_names[] = { "clflush", "clflushopt", "clwb" };
+
+static volatile uint64_t sink;
+
+static inline void flush_line(flush_op_t op, char* p) {
+    switch (op) {
+        case FLUSH_CLFLUSH:
+            __asm__ volatile("clflush (%0)" :: "r"(p) : "memory");
+            break;
+        case FLUSH_CLFLUSHOPT:
+            __asm__ volatile("clflushopt (%0)" :: "r"(p) : "memory");
+            break;
+        case FLUSH_CLWB:
+            __asm__ volatile("clwb (%0)" :: "r"(p) : "memory");
+            break;
+        case FLUSH_NONE:
+            break;
+    }
+}
+
+/*
+ * One batch: bring `batch` lines into the cache (written or just read),
+ * flush them all and fence once, the way the coherence code does.
+ * Returns the average time of one batch.
+ */
+static double time_batches(char* base, flush_op_t op, bool dirty, size_t batch, uint64_t* batches_out) {
+    size_t next = 0;
+    uint64_t batches = 0, value = 0;
+    double start = now_sec(), elapsed;
+
+    do {
+        for (int r = 0; r < 64; r++) {
+            if (next + batch > FLUSH_WINDOW_LINES) next = 0;
+            char* lines = base + next * CACHE_LINE_SIZE;
+
+            for (size_t i = 0; i < batch; i++) {
+                if (dirty) {
+                    *(volatile uint64_t*)(lines + i * CACHE_LINE_SIZE) = ++value;
+                } else {
+                    value += *(volatile uint64_t*)(lines + i * CACHE_LINE_SIZE);
+                }
+            }
+            for (size_t i = 0; i < batch; i++) {
+                flush_line(op, lines + i * CACHE_LINE_SIZE);
+            }
+            _mm_sfence();
+
+            next += batch;
+        }
+        batches += 64;
+        elapsed = now_sec() - start;
+    } while (elapsed < g_config.duration);
+
+    sink = value;
+    *batches_out = batches;
+    return elapsed / batches;
+}
+
+void bench_flush(bench_region_t* region) {
+    static const size_t batch_sizes[] = { 1, 8, 64, 512 };
+    bool supported[] = { true, region->clflushopt, region->clwb };
+
+    fprintf(stderr, "flush: clflush/clflushopt/clwb, batches of 1-512 lines\n");
+
+    for (int op = FLUSH_CLFLUSH; op <= FLUSH_CLWB; op++) {
+        if (!supported[op]) {
+            fprintf(stderr, "  %s not supported by this CPU, skipped\n", flush_op_names[op]);
+            continue;
+        }
+        for (int dirty = 1; dirty >= 0; dirty--) {
+            for (size_t b = 0; b < sizeof(batch_sizes) / sizeof(batch_sizes[0]); b++) {
+                size_t batch = batch_sizes[b];
+                uint64_t batches;
+
+                // Same loop without the flushes, to report the flush cost alone
+                double base = time_batches(region->base, FLUSH_NONE, dirty, batch, &batches);
+                double total = time_batches(region->base, (flush_op_t)op, dirty, batch, &batches);
+                double cost = total > base ? total - base : 0;
+
+                result_begin("flush");
+                result_str("op", flush_op_names[op]);
+                result_str("line_state", dirty ? "dirty" : "clean");
+                result_u64("batch_lines", batch);
+                result_u64("batches", batches);
+                result_double("ns_per_batch", cost * 1e9);
+                result_double("ns_per_line", cost * 1e9 / batch);
+                result_double("ns_per_batch_with_access", total * 1e9);
+                result_end();
+            }
+        }
+    }
+}
+
+/*
+ * ============================================================================
+ * Fences, on their own and right after a store to the region
+ * ============================================================================
+ */
+typedef enum { FENCE_MFENCE, FENCE_SFENCE, FENCE_LFENCE } fence_op_t;
+
+static const char* fence_op_names[] = { "mfence", "sfence", "lfence" };
+
+static inline void fence(fence_op_t op) {
+    switch (op) {
+        case FENCE_MFENCE: _mm_mfence(); break;
+        case FENCE_SFENCE: _mm_sfence(); break;
+        case FENCE_LFENCE: _mm_lfence(); break;
+    }
+}
+
+void bench_fence(bench_region_t* region) {
+    volatile uint64_t* line = (volatile uint64_t*)region->base;
+
+    fprintf(stderr, "fence: mfence/sfence/lfence\n");
+
+    for (int op = FENCE_MFENCE; op <= FENCE_LFENCE; op++) {
+        for (int after_store = 0; after_store <= 1; after_store++) {
+            uint64_t fences = 0;
+            double start = now_sec(), elapsed;
+            do {
+                for (int i = 0; i < 1024; i++) {
+                    if (after_store) *line = fences + i;
+                    fence((fence_op_t)op);
+                }
+                fences += 1024;
+                elapsed = now_sec() - start;
+            } while (elapsed < g_config.duration);
+
+            result_begin("fence");
+            result_str("op", fence_op_names[op]);
+            result_str("preceded_by", after_store ? "store" : "none");
+            result_u64("fences", fences);
+            result_double("ns_per_fence", elapsed * 1e9 / fences);
+            result_end();
+        }
+    }
+}
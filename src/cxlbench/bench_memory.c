@@ -0,0 +1,205 @@
+/*
+ * Load latency and streaming bandwidth
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <immintrin.h>
+#include "cxlbench.h"
+
+static volatile uint64_t sink;
+
+static uint64_t xorshift64(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+/*
+ * ============================================================================
+ * Pointer chase: one dependent load per cache line, random order
+ * ============================================================================
+ */
+static void build_chain(char* base, size_t lines) {
+    size_t* order = malloc(lines * sizeof(size_t));
+    uint64_t seed = 42;
+
+    for (size_t i = 0; i < lines; i++) {
+        order[i] = i;
+    }
+    for (size_t i = lines - 1; i > 0; i--) {
+        size_t j = xorshift64(&seed) % (i + 1);
+        size_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+    for (size_t i = 0; i < lines; i++) {
+        *(void**)(base + order[i] * CACHE_LINE_SIZE) = base + order[(i + 1) % lines] * CACHE_LINE_SIZE;
+    }
+    free(order);
+}
+
+#define CHASE_CHUNK 4096
+
+void bench_latency(bench_region_t* region) {
+    static const size_t working_sets[] = {
+        16 * KB, 256 * KB, 4 * MB, 32 * MB, 128 * MB, 512 * MB, 2048 * MB,
+    };
+
+    pin_to_cpu(g_config.cpus[0]);
+    fprintf(stderr, "latency: pointer chase on cpu %d\n", g_config.cpus[0]);
+
+    for (size_t w = 0; w < sizeof(working_sets) / sizeof(working_sets[0]); w++) {
+        size_t ws = working_sets[w];
+        if (ws > region->size) break;
+
+        size_t lines = ws / CACHE_LINE_SIZE;
+        build_chain(region->base, lines);
+
+        // Warm up with one lap so that small sets are cache resident
+        void** p = (void**)region->base;
+        for (size_t i = 0; i < lines; i++) {
+            p = (void**)*p;
+        }
+
+        uint64_t loads = 0;
+        double start = now_sec(), elapsed;
+        do {
+            for (int i = 0; i < CHASE_CHUNK; i += 8) {
+                p = (void**)*p; p = (void**)*p; p = (void**)*p; p = (void**)*p;
+                p = (void**)*p; p = (void**)*p; p = (void**)*p; p = (void**)*p;
+            }
+            loads += CHASE_CHUNK;
+            elapsed = now_sec() - start;
+        } while (elapsed < g_config.duration);
+        sink = (uint64_t)(uintptr_t)p;
+
+        result_begin("latency");
+        result_u64("working_set_bytes", ws);
+        result_u64("loads", loads);
+        result_double("ns_per_load", elapsed * 1e9 / loads);
+        result_end();
+    }
+}
+
+/*
+ * ============================================================================
+ * Streaming bandwidth: each thread sweeps its own slice of the region
+ * ============================================================================
+ */
+typedef enum { BW_READ, BW_WRITE, BW_NT_WRITE } bw_mode_t;
+
+static const char* bw_mode_names[] = { "read", "write", "nt_write" };
+
+typedef struct {
+    char* base;
+    size_t size;
+    int cpu;
+    bw_mode_t mode;
+    pthread_barrier_t* barrier;
+    uint64_t bytes;
+    double elapsed;
+} bw_thread_t;
+
+static void sweep_read(char* base, size_t size) {
+    const uint64_t* p = (const uint64_t*)base;
+    size_t n = size / sizeof(uint64_t);
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (size_t i = 0; i < n; i += 4) {
+        s0 += p[i];
+        s1 += p[i + 1];
+        s2 += p[i + 2];
+        s3 += p[i + 3];
+    }
+    sink = s0 + s1 + s2 + s3;
+}
+
+static void sweep_write(char* base, size_t size, uint64_t value) {
+    uint64_t* p = (uint64_t*)base;
+    size_t n = size / sizeof(uint64_t);
+    for (size_t i = 0; i < n; i++) {
+        p[i] = value;
+    }
+}
+
+static void sweep_nt_write(char* base, size_t size, uint64_t value) {
+    __m128i v = _mm_set1_epi64x((long long)value);
+    __m128i* p = (__m128i*)base;
+    size_t n = size / sizeof(__m128i);
+    for (size_t i = 0; i < n; i += 4) {
+        _mm_stream_si128(p + i, v);
+        _mm_stream_si128(p + i + 1, v);
+        _mm_stream_si128(p + i + 2, v);
+        _mm_stream_si128(p + i + 3, v);
+    }
+    _mm_sfence();
+}
+
+static void* bw_thread(void* arg) {
+    bw_thread_t* t = (bw_thread_t*)arg;
+    pin_to_cpu(t->cpu);
+    pthread_barrier_wait(t->barrier);
+
+    uint64_t pass = 0;
+    double start = now_sec();
+    do {
+        switch (t->mode) {
+            case BW_READ:     sweep_read(t->base, t->size); break;
+            case BW_WRITE:    sweep_write(t->base, t->size, pass); break;
+            case BW_NT_WRITE: sweep_nt_write(t->base, t->size, pass); break;
+        }
+        pass++;
+        t->elapsed = now_sec() - start;
+    } while (t->elapsed < g_config.duration);
+    t->bytes = pass * t->size;
+    return NULL;
+}
+
+static void run_bandwidth(bench_region_t* region, bw_mode_t mode, int nthreads) {
+    bw_thread_t threads[MAX_CPUS];
+    pthread_barrier_t barrier;
+    size_t slice = (region->size / nthreads) & ~(size_t)(CACHE_LINE_SIZE - 1);
+
+    pthread_barrier_init(&barrier, NULL, (unsigned)nthreads);
+    for (int i = 0; i < nthreads; i++) {
+        threads[i] = (bw_thread_t){
+            .base = region->base + i * slice,
+            .size = slice,
+            .cpu = g_config.cpus[i],
+            .mode = mode,
+            .barrier = &barrier,
+        };
+    }
+    run_threads(nthreads, bw_thread, threads, sizeof(bw_thread_t));
+    pthread_barrier_destroy(&barrier);
+
+    uint64_t bytes = 0;
+    double elapsed = 0;
+    for (int i = 0; i < nthreads; i++) {
+        bytes += threads[i].bytes;
+        if (threads[i].elapsed > elapsed) elapsed = threads[i].elapsed;
+    }
+
+    result_begin("bandwidth");
+    result_str("mode", bw_mode_names[mode]);
+    result_u64("threads", (uint64_t)nthreads);
+    result_u64("bytes", bytes);
+    // MB/s with MB = 10^6, as reported by MLC
+    result_double("mb_per_sec", bytes / elapsed / 1e6);
+    result_end();
+}
+
+void bench_bandwidth(bench_region_t* region) {
+    fprintf(stderr, "bandwidth: read/write/nt_write with 1-%d threads\n", g_config.threads);
+
+    for (int mode = BW_READ; mode <= BW_NT_WRITE; mode++) {
+        for (int n = 1; n <= g_config.threads; n = next_thread_count(n)) {
+            run_bandwidth(region, (bw_mode_t)mode, n);
+        }
+    }
+}
@@ -0,0 +1,410 @@
+/*
+ * CXL primitive microbenchmarks
+ * Measures load latency, bandwidth, cache flush and fence cost, and atomic
+ * round trips on one shared mapping (anonymous memory, a /dev/shm or DAX
+ * file, a device DAX node, or memory bound to a NUMA node) and prints the
+ * results as JSON.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <cpuid.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include "cxlbench.h"
+
+#ifdef CXLBENCH_WITH_CXLTIME
+#include "cxltime.h"
+#endif
+
+#define DEVDAX_ALIGN (2UL * MB)
+#define MPOL_BIND_MODE 2
+#define MPOL_MF_MOVE_FLAG (1 << 1)
+
+bench_config_t g_config = {
+    .backend = BACKEND_ANON,
+    .path = NULL,
+    .numa_node = -1,
+    .size = 256 * MB,
+    .threads = 4,
+    .num_cpus = 0,
+    .duration = 0.2,
+    .quick = false,
+};
+
+static const char* g_benches = "latency,bandwidth,flush,fence,atomic";
+static const char* g_output = NULL;
+static FILE* g_json = NULL;
+static int g_results = 0;
+static int g_fields = 0;
+
+/*
+ * ============================================================================
+ * JSON output
+ * ============================================================================
+ */
+static void json_string(const char* s) {
+    fputc('"', g_json);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fprintf(g_json, "\\%c", *s);
+        } else if ((unsigned char)*s < 0x20) {
+            fprintf(g_json, "\\u%04x", *s);
+        } else {
+            fputc(*s, g_json);
+        }
+    }
+    fputc('"', g_json);
+}
+
+static void json_key(const char* key) {
+    fprintf(g_json, "%s", g_fields++ ? ", " : "");
+    json_string(key);
+    fprintf(g_json, ": ");
+}
+
+void result_begin(const char* bench) {
+    fprintf(g_json, "%s\n    {", g_results++ ? "," : "");
+    g_fields = 0;
+    result_str("bench", bench);
+}
+
+void result_str(const char* key, const char* value) {
+    json_key(key);
+    json_string(value);
+}
+
+void result_u64(const char* key, uint64_t value) {
+    json_key(key);
+    fprintf(g_json, "%llu", (unsigned long long)value);
+}
+
+void result_double(const char* key, double value) {
+    json_key(key);
+    fprintf(g_json, "%.3f", value);
+}
+
+void result_end(void) {
+    fprintf(g_json, "}");
+    fflush(g_json);
+}
+
+/*
+ * ============================================================================
+ * Threads
+ * ============================================================================
+ */
+int pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+int run_threads(int nthreads, void* (*fn)(void*), void* args, size_t arg_size) {
+    pthread_t threads[MAX_CPUS];
+    int started = 0;
+
+    for (int i = 0; i < nthreads; i++) {
+        if (pthread_create(&threads[i], NULL, fn, (char*)args + i * arg_size) != 0) {
+            fprintf(stderr, "pthread_create failed: %s\n", strerror(errno));
+            break;
+        }
+        started++;
+    }
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return started == nthreads ? 0 : -1;
+}
+
+/*
+ * ============================================================================
+ * Memory under test
+ * ============================================================================
+ */
+static int bind_to_node(void* addr, size_t size, int node) {
+    unsigned long mask[MAX_CPUS / (8 * sizeof(unsigned long))] = {0};
+    if (node < 0 || node >= MAX_CPUS) return -1;
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    return (int)syscall(SYS_mbind, addr, size, MPOL_BIND_MODE, mask, (unsigned long)MAX_CPUS, MPOL_MF_MOVE_FLAG);
+}
+
+static int map_region(bench_region_t* region) {
+    region->fd = -1;
+    region->size = g_config.size;
+    int flags = MAP_SHARED;
+
+    if (g_config.path) {
+        // Files created here are removed again at exit
+        region->fd = open(g_config.path, O_RDWR | O_CREAT | O_EXCL, 0600);
+        region->created = region->fd >= 0;
+        if (region->fd < 0 && errno == EEXIST) {
+            region->fd = open(g_config.path, O_RDWR);
+        }
+        if (region->fd < 0) {
+            fprintf(stderr, "open %s: %s\n", g_config.path, strerror(errno));
+            return -1;
+        }
+
+        struct stat st;
+        fstat(region->fd, &st);
+        if (S_ISCHR(st.st_mode)) {
+            // Device DAX only maps in multiples of its alignment
+            g_config.backend = BACKEND_DEVDAX;
+            region->size = (region->size + DEVDAX_ALIGN - 1) & ~(DEVDAX_ALIGN - 1);
+        } else {
+            g_config.backend = BACKEND_FILE;
+            if ((size_t)st.st_size < region->size && ftruncate(region->fd, (off_t)region->size) != 0) {
+                fprintf(stderr, "ftruncate %s: %s\n", g_config.path, strerror(errno));
+                close(region->fd);
+                if (region->created) unlink(g_config.path);
+                return -1;
+            }
+        }
+    } else {
+        g_config.backend = BACKEND_ANON;
+        // Shared so that forked processes see the same lines
+        flags |= MAP_ANONYMOUS;
+    }
+
+    region->base = mmap(NULL, region->size, PROT_READ | PROT_WRITE, flags, region->fd, 0);
+    if (region->base == MAP_FAILED) {
+        fprintf(stderr, "mmap: %s\n", strerror(errno));
+        if (region->fd >= 0) close(region->fd);
+        if (region->created) unlink(g_config.path);
+        return -1;
+    }
+
+    if (g_config.numa_node >= 0 && bind_to_node(region->base, region->size, g_config.numa_node) != 0) {
+        fprintf(stderr, "Warning: cannot bind to NUMA node %d: %s\n", g_config.numa_node, strerror(errno));
+    }
+
+    // Fault everything in before measuring
+    memset(region->base, 0, region->size);
+
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        region->clflushopt = (ebx >> 23) & 1;
+        region->clwb = (ebx >> 24) & 1;
+    }
+
+#ifdef CXLBENCH_WITH_CXLTIME
+    // CXLTIME_* in the environment turn the mapping into emulated CXL memory
+    cxltime_init(NULL);
+    if (cxltime_register_region(region->base, region->size, "cxlbench") != 0) {
+        fprintf(stderr, "Warning: cxltime could not track the region\n");
+    }
+#endif
+    return 0;
+}
+
+static void unmap_region(bench_region_t* region) {
+#ifdef CXLBENCH_WITH_CXLTIME
+    cxltime_unregister_region(region->base);
+#endif
+    munmap(region->base, region->size);
+    if (region->fd >= 0) close(region->fd);
+    if (region->created) unlink(g_config.path);
+}
+
+/*
+ * ============================================================================
+ * Main
+ * ============================================================================
+ */
+static const char* backend_name(backend_t backend) {
+    switch (backend) {
+        case BACKEND_FILE:   return "file";
+        case BACKEND_DEVDAX: return "devdax";
+        default:             return "anon";
+    }
+}
+
+static int parse_cpus(const char* list) {
+    char* copy = strdup(list);
+    char* save = NULL;
+    g_config.num_cpus = 0;
+
+    for (char* tok = strtok_r(copy, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+        int first, last;
+        int n = sscanf(tok, "%d-%d", &first, &last);
+        if (n < 1 || first < 0) {
+            free(copy);
+            return -1;
+        }
+        if (n == 1) last = first;
+        for (int cpu = first; cpu <= last && g_config.num_cpus < MAX_CPUS; cpu++) {
+            g_config.cpus[g_config.num_cpus++] = cpu;
+        }
+    }
+    free(copy);
+    return g_config.num_cpus > 0 ? 0 : -1;
+}
+
+static void print_usage(const char* prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("Options:\n");
+    printf("  -p, --path PATH     Map PATH (a /dev/shm or DAX file, or /dev/daxX.Y) instead of anonymous memory\n");
+    printf("  -n, --numa NODE     Bind the memory to NUMA node NODE\n");
+    printf("  -s, --size MB       Size of the mapping in MB (default: 256)\n");
+    printf("  -t, --threads N     Max threads for bandwidth and contention tests (default: 4)\n");
+    printf("  -c, --cpus LIST     Cores to pin threads to, e.g. 0-3,8 (default: all)\n");
+    printf("  -b, --bench LIST    Benchmarks to run: latency,bandwidth,flush,fence,atomic (default: all)\n");
+    printf("  -d, --duration MS   Time per measurement in ms (default: 200)\n");
+    printf("  -o, --output FILE   Write JSON to FILE instead of stdout\n");
+    printf("  -q, --quick         Small sizes and short runs, for smoke testing\n");
+    printf("  -h, --help          Show this help\n");
+}
+
+static int parse_args(int argc, char* argv[]) {
+    static struct option long_options[] = {
+        {"path",     required_argument, 0, 'p'},
+        {"numa",     required_argument, 0, 'n'},
+        {"size",     required_argument, 0, 's'},
+        {"threads",  required_argument, 0, 't'},
+        {"cpus",     required_argument, 0, 'c'},
+        {"bench",    required_argument, 0, 'b'},
+        {"duration", required_argument, 0, 'd'},
+        {"output",   required_argument, 0, 'o'},
+        {"quick",    no_argument,       0, 'q'},
+        {"help",     no_argument,       0, 'h'},
+        {0, 0, 0, 0}
+    };
+
+    bool size_set = false, duration_set = false;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:n:s:t:c:b:d:o:qh", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'p':
+                g_config.path = optarg;
+                break;
+            case 'n':
+                g_config.numa_node = atoi(optarg);
+                break;
+            case 's':
+                g_config.size = strtoul(optarg, NULL, 10) * MB;
+                size_set = true;
+                break;
+            case 't':
+                g_config.threads = atoi(optarg);
+                break;
+            case 'c':
+                if (parse_cpus(optarg) != 0) {
+                    fprintf(stderr, "Invalid CPU list: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'b':
+                g_benches = optarg;
+                break;
+            case 'd':
+                g_config.duration = atoi(optarg) / 1000.0;
+                duration_set = true;
+                break;
+            case 'o':
+                g_output = optarg;
+                break;
+            case 'q':
+                g_config.quick = true;
+                break;
+            case 'h':
+                print_usage(argv[0]);
+                exit(0);
+            default:
+                print_usage(argv[0]);
+                return -1;
+        }
+    }
+
+    if (g_config.quick) {
+        if (!size_set) g_config.size = 16 * MB;
+        if (!duration_set) g_config.duration = 0.02;
+    }
+    if (g_config.num_cpus == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < n && cpu < MAX_CPUS; cpu++) {
+            g_config.cpus[g_config.num_cpus++] = (int)cpu;
+        }
+    }
+    if (g_config.threads < 1) g_config.threads = 1;
+    if (g_config.threads > g_config.num_cpus) g_config.threads = g_config.num_cpus;
+    if (g_config.size < 4 * MB) {
+        fprintf(stderr, "Size must be at least 4 MB\n");
+        return -1;
+    }
+    return 0;
+}
+
+static bool bench_selected(const char* name) {
+    size_t len = strlen(name);
+    for (const char* p = g_benches; (p = strstr(p, name)) != NULL; p += len) {
+        bool start = p == g_benches || p[-1] == ',';
+        bool end = p[len] == '\0' || p[len] == ',';
+        if (start && end) return true;
+    }
+    return strcmp(g_benches, "all") == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (parse_args(argc, argv) != 0) {
+        return 1;
+    }
+
+    g_json = stdout;
+    if (g_output) {
+        g_json = fopen(g_output, "w");
+        if (!g_json) {
+            fprintf(stderr, "open %s: %s\n", g_output, strerror(errno));
+            return 1;
+        }
+    }
+
+    bench_region_t region;
+    memset(&region, 0, sizeof(region));
+    if (map_region(&region) != 0) {
+        return 1;
+    }
+
+    fprintf(g_json, "{\n  \"config\": {");
+    g_fields = 0;
+    result_str("backend", backend_name(g_config.backend));
+    result_str("path", g_config.path ? g_config.path : "");
+    json_key("numa_node");
+    fprintf(g_json, "%d", g_config.numa_node);
+    result_u64("size_bytes", region.size);
+    result_u64("threads", (uint64_t)g_config.threads);
+    result_double("duration_ms", g_config.duration * 1000);
+    json_key("clflushopt");
+    fprintf(g_json, "%s", region.clflushopt ? "true" : "false");
+    json_key("clwb");
+    fprintf(g_json, "%s", region.clwb ? "true" : "false");
+#ifdef CXLBENCH_WITH_CXLTIME
+    result_str("cxltime_mode", cxltime_is_enabled() ? "on" : "off");
+#endif
+    fprintf(g_json, "},\n  \"results\": [");
+
+    fprintf(stderr, "cxlbench: %s memory, %zu MB, %d thread(s)\n",
+            backend_name(g_config.backend), region.size / MB, g_config.threads);
+
+    if (bench_selected("latency")) bench_latency(&region);
+    if (bench_selected("bandwidth")) bench_bandwidth(&region);
+    if (bench_selected("flush")) bench_flush(&region);
+    if (bench_selected("fence")) bench_fence(&region);
+    if (bench_selected("atomic")) bench_atomic(&region);
+
+    fprintf(g_json, "\n  ]\n}\n");
+    if (g_json != stdout) fclose(g_json);
+
+    unmap_region(&region);
+    return 0;
+}
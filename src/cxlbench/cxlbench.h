@@ -0,0 +1,73 @@
+#ifndef CXLBENCH_H
+#define CXLBENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+
+#define CACHE_LINE_SIZE 64
+#define KB (1024UL)
+#define MB (1024UL * KB)
+#define MAX_CPUS 256
+
+typedef enum {
+    BACKEND_ANON = 0,   // MAP_SHARED | MAP_ANONYMOUS, optionally bound to a NUMA node
+    BACKEND_FILE,       // regular file, e.g. under /dev/shm or a DAX filesystem
+    BACKEND_DEVDAX,     // device DAX character device, e.g. /dev/dax0.0
+} backend_t;
+
+typedef struct {
+    backend_t backend;
+    const char* path;
+    int numa_node;              // -1: no binding
+    size_t size;                // bytes mapped for the run
+    int threads;                // max threads for bandwidth and contention tests
+    int cpus[MAX_CPUS];         // cores threads are pinned to, in order
+    int num_cpus;
+    double duration;            // seconds per measurement
+    bool quick;
+} bench_config_t;
+
+typedef struct {
+    char* base;
+    size_t size;
+    int fd;
+    bool created;               // path did not exist before the run
+    bool clflushopt;
+    bool clwb;
+} bench_region_t;
+
+extern bench_config_t g_config;
+
+static inline double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 1, 2, 4, ... and finally the configured maximum
+static inline int next_thread_count(int n) {
+    return n < g_config.threads && n * 2 > g_config.threads ? g_config.threads : n * 2;
+}
+
+/* Helpers shared by the benchmarks (cxlbench.c) */
+int pin_to_cpu(int cpu);
+int run_threads(int nthreads, void* (*fn)(void*), void* args, size_t arg_size);
+
+/* JSON results: one object per measurement in the "results" array */
+void result_begin(const char* bench);
+void result_str(const char* key, const char* value);
+void result_u64(const char* key, uint64_t value);
+void result_double(const char* key, double value);
+void result_end(void);
+
+/* Benchmarks */
+void bench_latency(bench_region_t* region);
+void bench_bandwidth(bench_region_t* region);
+void bench_flush(bench_region_t* region);
+void bench_fence(bench_region_t* region);
+void bench_atomic(bench_region_t* region);
+
+#endif // CXLBENCH_H
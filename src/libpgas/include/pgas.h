@@ -92,6 +92,19 @@ int pgas_put(pgas_context_t* ctx, pgas_ptr_t dest, const void* src, size_t size)
 int pgas_get_nb(pgas_context_t* ctx, void* dest, pgas_ptr_t src, size_t size, int* handle);
 int pgas_put_nb(pgas_context_t* ctx, pgas_ptr_t dest, const void* src, size_t size, int* handle);
 
+// Memory access - vectorized operations
+typedef struct {
+    void* dest;            // Local destination buffer
+    pgas_ptr_t src;        // Global source pointer
+    size_t size;           // Bytes to read
+    int status;            // 0 on success, -1 on failure (set by pgas_get_batch)
+} pgas_get_op_t;
+
+// Issue all reads in one pass: local ops are copied directly, remote ops are
+// grouped by owner node and pipelined on that node's connection.
+// Returns the number of failed ops (0 if all succeeded).
+int pgas_get_batch(pgas_context_t* ctx, pgas_get_op_t* ops, size_t count);
+
 // Atomic operations
 uint64_t pgas_atomic_fetch_add(pgas_context_t* ctx, pgas_ptr_t ptr, uint64_t value);
 uint64_t pgas_atomic_fetch_and(pgas_context_t* ctx, pgas_ptr_t ptr, uint64_t value);
@@ -11,6 +11,10 @@
 #include <errno.h>
 #include <pthread.h>
 
+#ifdef PGAS_WITH_CXLTIME
+#include "cxltime.h"
+#endif
+
 // Internal allocator block header
 typedef struct alloc_block {
     size_t size;
@@ -345,6 +349,13 @@ int cxl_map_region(cxl_handle_t* handle, cxl_region_t* region) {
         return -1;
     }
 
+#ifdef PGAS_WITH_CXLTIME
+    // Emulated memory behaves like far memory when CXLTIME_MODE is set
+    if (cxltime_register_region(region->virt_addr, region->size, "pgas_emulated") != 0) {
+        fprintf(stderr, "Warning: cxltime could not track emulated region %p\n", region->virt_addr);
+    }
+#endif
+
     region->is_mapped = true;
     return 0;
 }
@@ -354,6 +365,9 @@ int cxl_unmap_region(cxl_handle_t* handle, cxl_region_t* region) {
     if (!region || !region->is_mapped) return 0;
 
     if (region->virt_addr) {
+#ifdef PGAS_WITH_CXLTIME
+        cxltime_unregister_region(region->virt_addr);
+#endif
         munmap(region->virt_addr, region->size);
         region->virt_addr = NULL;
     }
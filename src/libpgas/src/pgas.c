@@ -13,6 +13,10 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 
+// Max GET requests in flight per peer in pgas_get_batch; bounded so neither
+// side blocks on a full socket buffer before the other starts draining
+#define PGAS_GET_BATCH_WINDOW 64
+
 // Internal communication message types
 typedef enum {
     MSG_GET = 1,
@@ -95,11 +99,15 @@ static internal_stats_t* get_stats(pgas_context_t* ctx) {
 static int comm_init(pgas_context_t* ctx, uint16_t port);
 static void comm_finalize(pgas_context_t* ctx);
 static int comm_connect_peers(pgas_context_t* ctx);
+static int comm_connect_peer(pgas_context_t* ctx, int node);
+static void comm_reset_peer(pgas_context_t* ctx, uint16_t node_id);
 static int comm_send(pgas_context_t* ctx, uint16_t node_id, void* data, size_t len);
 static int comm_recv(pgas_context_t* ctx, uint16_t node_id, void* data, size_t max_len);
 static int comm_send_recv(pgas_context_t* ctx, uint16_t node_id,
                           void* req_data, size_t req_len,
                           void* resp_data, size_t resp_len);
+static int comm_get_pipelined(pgas_context_t* ctx, uint16_t node_id,
+                              pgas_get_op_t* ops, const size_t* idx, size_t n);
 static void* comm_listener_thread(void* arg);
 
 // Memory segment management
@@ -393,6 +401,62 @@ int pgas_put(pgas_context_t* ctx, pgas_ptr_t dest, const void* src, size_t size)
     return 0;
 }
 
+int pgas_get_batch(pgas_context_t* ctx, pgas_get_op_t* ops, size_t count) {
+    internal_stats_t* stats = get_stats(ctx);
+    int failed = 0;
+
+    if (count == 0) return 0;
+
+    size_t* idx = malloc(count * sizeof(size_t));
+    if (!idx) return (int)count;
+
+    // Local ops: plain copies, no messaging
+    for (size_t i = 0; i < count; i++) {
+        ops[i].status = -1;
+        if (!pgas_is_local(ctx, ops[i].src)) continue;
+
+        void* local_ptr = translate_address(ctx, ops[i].src);
+        if (local_ptr) {
+            memcpy(ops[i].dest, local_ptr, ops[i].size);
+            ops[i].status = 0;
+            stats->local_reads++;
+        }
+    }
+
+    // Remote ops: one pipelined exchange per owner node
+    for (uint16_t node = 0; node < ctx->num_nodes; node++) {
+        if (node == ctx->local_node_id) continue;
+
+        size_t n = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (ops[i].src.node_id == node) idx[n++] = i;
+        }
+        if (n == 0) continue;
+
+        for (size_t off = 0; off < n; off += PGAS_GET_BATCH_WINDOW) {
+            size_t window = n - off;
+            if (window > PGAS_GET_BATCH_WINDOW) window = PGAS_GET_BATCH_WINDOW;
+            if (comm_get_pipelined(ctx, node, ops, idx + off, window) < (int)window) {
+                // The window's failed ops are marked and the connection was
+                // reset; fail the rest of this node's ops rather than
+                // retrying on a connection that just misbehaved.
+                for (size_t j = off + window; j < n; j++) ops[idx[j]].status = -1;
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (ops[i].status != 0) {
+            memset(ops[i].dest, 0, ops[i].size);
+            failed++;
+        }
+    }
+
+    free(idx);
+    return failed;
+}
+
 uint64_t pgas_atomic_fetch_add(pgas_context_t* ctx, pgas_ptr_t ptr, uint64_t value) {
     internal_stats_t* stats = get_stats(ctx);
     uint64_t result;
@@ -712,6 +776,19 @@ int pgas_get_tuning(pgas_context_t* ctx, pgas_tuning_t* tuning) {
 }
 
 // Internal functions
+/* send() until the whole buffer is out; a stream socket may accept less. */
+static int send_all(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        ssize_t sent = send(fd, p, len, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return -1;
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return 0;
+}
+
 static int comm_init(pgas_context_t* ctx, uint16_t port) {
     comm_handle_t* comm = calloc(1, sizeof(comm_handle_t));
     if (!comm) return -1;
@@ -835,37 +912,8 @@ static int comm_connect_peers(pgas_context_t* ctx) {
             }
 
             /* Initiate connection to ALL other nodes */
-            int fd = socket(AF_INET, SOCK_STREAM, 0);
-            if (fd < 0) continue;
-
-            /* Set socket timeout */
-            struct timeval tv;
-            tv.tv_sec = 1;
-            tv.tv_usec = 0;
-            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
-
-            struct sockaddr_in addr = {0};
-            addr.sin_family = AF_INET;
-            addr.sin_addr.s_addr = ctx->nodes[i].ip_addr;
-            addr.sin_port = htons(ctx->nodes[i].port);
-
-            if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) {
-                /* Send our node ID so the peer knows who we are */
-                uint32_t my_node_id = my_id;
-                send(fd, &my_node_id, sizeof(my_node_id), 0);
-
-                pthread_mutex_lock(&comm->peer_lock);
-                /* Use this socket for sending requests AND receiving responses */
-                comm->peer_fds[i] = fd;
-                comm->peer_recv_fds[i] = fd;
-                pthread_mutex_unlock(&comm->peer_lock);
-
-                printf("  Connected to node %d (%s:%d)\n",
-                       i, ctx->nodes[i].hostname, ctx->nodes[i].port);
+            if (comm_connect_peer(ctx, i) == 0) {
                 connected++;
-            } else {
-                close(fd);
             }
         }
 
@@ -895,6 +943,75 @@ static int comm_connect_peers(pgas_context_t* ctx) {
     return (connected > 0) ? 0 : -1;
 }
 
+/*
+ * Open the request/response connection to one peer and publish it in
+ * peer_fds. The peer's listener spawns a fresh handler thread per accepted
+ * connection, so this is also how a broken connection is re-established.
+ */
+static int comm_connect_peer(pgas_context_t* ctx, int node) {
+    comm_handle_t* comm = (comm_handle_t*)ctx->comm_handle;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    /* Set socket timeout */
+    struct timeval tv;
+    tv.tv_sec = 1;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = ctx->nodes[node].ip_addr;
+    addr.sin_port = htons(ctx->nodes[node].port);
+
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    /* Send our node ID so the peer knows who we are */
+    uint32_t my_node_id = ctx->local_node_id;
+    if (send_all(fd, &my_node_id, sizeof(my_node_id)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    pthread_mutex_lock(&comm->peer_lock);
+    /* Use this socket for sending requests AND receiving responses */
+    comm->peer_fds[node] = fd;
+    comm->peer_recv_fds[node] = fd;
+    pthread_mutex_unlock(&comm->peer_lock);
+
+    printf("  Connected to node %d (%s:%d)\n",
+           node, ctx->nodes[node].hostname, ctx->nodes[node].port);
+    return 0;
+}
+
+/*
+ * Drop a connection whose request/response stream is out of sync (short
+ * send, short recv or a response for the wrong request). Whatever is still
+ * buffered on it belongs to requests nobody waits for any more, so the only
+ * safe recovery is a new connection. Caller holds recv_locks[node_id].
+ */
+static void comm_reset_peer(pgas_context_t* ctx, uint16_t node_id) {
+    comm_handle_t* comm = (comm_handle_t*)ctx->comm_handle;
+
+    pthread_mutex_lock(&comm->peer_lock);
+    int fd = comm->peer_fds[node_id];
+    comm->peer_fds[node_id] = -1;
+    comm->peer_recv_fds[node_id] = -1;
+    pthread_mutex_unlock(&comm->peer_lock);
+
+    if (fd >= 0) close(fd);
+
+    fprintf(stderr, "pgas: connection to node %u out of sync, reconnecting\n", node_id);
+    if (comm_connect_peer(ctx, node_id) != 0) {
+        fprintf(stderr, "pgas: reconnect to node %u failed\n", node_id);
+    }
+}
+
 /*
  * Send a request and receive the response atomically.
  * This ensures request-response pairing on the same socket.
@@ -908,26 +1025,111 @@ static int comm_send_recv(pgas_context_t* ctx, uint16_t node_id,
         return -1;
     }
 
-    int fd = comm->peer_fds[node_id];
-
     /* Lock the entire send-recv operation for this peer */
     pthread_mutex_lock(&comm->recv_locks[node_id]);
 
+    /* Re-read under the lock: a failed exchange may have replaced the fd */
+    int fd = comm->peer_fds[node_id];
+    if (fd < 0) {
+        pthread_mutex_unlock(&comm->recv_locks[node_id]);
+        return -1;
+    }
+
     /* Send the request */
-    ssize_t sent = send(fd, req_data, req_len, 0);
-    if (sent != (ssize_t)req_len) {
+    if (send_all(fd, req_data, req_len) != 0) {
+        comm_reset_peer(ctx, node_id);
         pthread_mutex_unlock(&comm->recv_locks[node_id]);
         return -1;
     }
 
     /* Receive the response on the SAME socket */
     ssize_t received = recv(fd, resp_data, resp_len, MSG_WAITALL);
+    if (received != (ssize_t)resp_len) {
+        comm_reset_peer(ctx, node_id);
+        received = -1;
+    }
 
     pthread_mutex_unlock(&comm->recv_locks[node_id]);
 
     return (received > 0) ? (int)received : -1;
 }
 
+/*
+ * Pipelined GETs to one peer: send all requests back-to-back, then drain the
+ * responses. The peer's handler thread serves a connection sequentially, so
+ * responses come back in request order. Returns the number of completed ops;
+ * on any stream error the remaining ops are marked failed and the connection
+ * is reset, since their responses may still be in flight on the old socket.
+ */
+static int comm_get_pipelined(pgas_context_t* ctx, uint16_t node_id,
+                              pgas_get_op_t* ops, const size_t* idx, size_t n) {
+    comm_handle_t* comm = (comm_handle_t*)ctx->comm_handle;
+    internal_stats_t* stats = get_stats(ctx);
+
+    if (node_id >= ctx->num_nodes || comm->peer_fds[node_id] < 0) {
+        return -1;
+    }
+
+    comm_message_t* reqs = calloc(n, sizeof(comm_message_t));
+    if (!reqs) return -1;
+
+    size_t max_size = 0;
+    for (size_t i = 0; i < n; i++) {
+        const pgas_get_op_t* op = &ops[idx[i]];
+        reqs[i].header.msg_type = MSG_GET;
+        reqs[i].header.src_node = ctx->local_node_id;
+        reqs[i].header.dst_node = node_id;
+        reqs[i].header.request_id = __sync_fetch_and_add(&comm->next_request_id, 1);
+        reqs[i].ptr = op->src;
+        reqs[i].size = op->size;
+        if (op->size > max_size) max_size = op->size;
+    }
+
+    comm_message_t* resp = malloc(sizeof(comm_message_t) + max_size);
+    if (!resp) {
+        free(reqs);
+        return -1;
+    }
+
+    int completed = 0;
+
+    pthread_mutex_lock(&comm->recv_locks[node_id]);
+
+    int fd = comm->peer_fds[node_id];
+    if (fd >= 0 && send_all(fd, reqs, n * sizeof(comm_message_t)) == 0) {
+        for (size_t i = 0; i < n; i++) {
+            pgas_get_op_t* op = &ops[idx[i]];
+            size_t resp_len = sizeof(comm_message_t) + op->size;
+
+            ssize_t received = recv(fd, resp, resp_len, MSG_WAITALL);
+            if (received != (ssize_t)resp_len ||
+                resp->header.msg_type != MSG_GET_RESP ||
+                resp->header.request_id != reqs[i].header.request_id) {
+                break;
+            }
+
+            memcpy(op->dest, resp->data, op->size);
+            op->status = 0;
+            stats->remote_reads++;
+            stats->bytes_transferred += op->size;
+            completed++;
+        }
+    }
+
+    if ((size_t)completed < n) {
+        for (size_t i = (size_t)completed; i < n; i++) {
+            ops[idx[i]].status = -1;
+        }
+        if (fd >= 0) comm_reset_peer(ctx, node_id);
+    }
+
+    pthread_mutex_unlock(&comm->recv_locks[node_id]);
+
+    free(resp);
+    free(reqs);
+    return completed;
+}
+
 static int comm_send(pgas_context_t* ctx, uint16_t node_id, void* data, size_t len) {
     comm_handle_t* comm = (comm_handle_t*)ctx->comm_handle;
 
@@ -975,7 +1177,7 @@ static void* conn_handler_thread(void* arg) {
     // Handle incoming messages
     comm_message_t msg;
     while (1) {
-        ssize_t r = recv(client_fd, &msg, sizeof(msg), 0);
+        ssize_t r = recv(client_fd, &msg, sizeof(msg), MSG_WAITALL);
         if (r <= 0) break;
 
 
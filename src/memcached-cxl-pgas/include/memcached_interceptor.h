@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include "pgas.h"
 
 #ifdef __cplusplus
@@ -30,6 +31,8 @@ typedef enum {
     MC_OP_UNKNOWN = 255
 } mc_op_type_t;
 
+#define MC_OP_COUNT (MC_OP_STATS + 1)
+
 // Request routing decision
 typedef enum {
     MC_ROUTE_LOCAL = 0,      // Handle locally
@@ -39,6 +42,14 @@ typedef enum {
     MC_ROUTE_REPLICATE = 4   // Replicate to all nodes
 } mc_route_t;
 
+// Where a request was actually served from (statistics breakdown)
+typedef enum {
+    MC_STAT_ROUTE_NEAR_CACHE = 0,  // Local DRAM cache, no CXL access
+    MC_STAT_ROUTE_CXL_LOCAL = 1,   // This node's CXL memory
+    MC_STAT_ROUTE_CXL_REMOTE = 2,  // Another node's CXL memory
+    MC_STAT_ROUTE_COUNT = 3
+} mc_stat_route_t;
+
 // Intercepted request structure
 typedef struct {
     mc_op_type_t op;
@@ -124,14 +135,11 @@ typedef struct {
     void* local_cache;
     size_t local_cache_used;
 
-    // Statistics
-    uint64_t requests_total;
-    uint64_t requests_local;
-    uint64_t requests_remote;
-    uint64_t cache_hits;
-    uint64_t cache_misses;
-    uint64_t cxl_reads;
-    uint64_t cxl_writes;
+    // Statistics: one record per request thread, linked lock-free on first
+    // use and merged by mc_interceptor_get_stats
+    struct mc_thread_stats* thread_stats;
+    uint64_t stats_id;
+    uint64_t next_cas_unique;
 
     // BPF program handles
     void* bpf_skel;
@@ -153,6 +161,21 @@ int mc_interceptor_detach_uprobes(mc_interceptor_t* interceptor);
 mc_route_t mc_determine_route(mc_interceptor_t* interceptor, const mc_request_t* req);
 int mc_handle_request(mc_interceptor_t* interceptor, mc_request_t* req, mc_response_t* resp);
 
+// Multi-key get (`get k1 k2 ... kN`): resps[i] answers reqs[i]. With batching
+// enabled, keys are processed in groups of batch_size; each group's metadata
+// and item reads are issued as one vectorized PGAS batch per owner node.
+int mc_handle_multiget(mc_interceptor_t* interceptor, mc_request_t* reqs,
+                       size_t count, mc_response_t* resps);
+
+// Text-protocol entry point for retrieval commands. Serves the get/gets lines
+// at the front of buf, writing memcached text responses to out. Keys of
+// consecutive commands are coalesced into mc_handle_multiget batches bounded
+// by batch_size and batch_timeout_us. Stops at an incomplete line or the
+// first other command; returns the bytes consumed, or -1 on allocation
+// failure.
+long mc_process_commands(mc_interceptor_t* interceptor, const char* buf, size_t len,
+                         FILE* out);
+
 // Key routing
 uint16_t mc_route_key_to_node(mc_interceptor_t* interceptor, const char* key, size_t key_len);
 uint64_t mc_hash_key(const char* key, size_t key_len);
@@ -179,6 +202,21 @@ int mc_replicate_item(mc_interceptor_t* interceptor, const mc_request_t* req, ui
 int mc_sync_replicas(mc_interceptor_t* interceptor, const char* key, size_t key_len);
 
 // Statistics
+typedef struct {
+    uint64_t count;
+    double avg_latency_us;
+    double p50_latency_us;
+    double p99_latency_us;
+    double p999_latency_us;
+    double max_latency_us;
+} mc_latency_summary_t;
+
+typedef struct {
+    uint64_t cxl_bytes_read;
+    uint64_t cxl_bytes_written;
+    mc_latency_summary_t latency;    // latency.count = requests on this route
+} mc_route_stats_t;
+
 typedef struct {
     uint64_t total_requests;
     uint64_t get_requests;
@@ -192,15 +230,21 @@ typedef struct {
     uint64_t cxl_bytes_written;
     double avg_latency_us;
     double p99_latency_us;
+    mc_latency_summary_t latency;
+    mc_latency_summary_t per_op[MC_OP_COUNT];
+    mc_route_stats_t per_route[MC_STAT_ROUTE_COUNT];
 } mc_interceptor_stats_t;
 
 void mc_interceptor_get_stats(mc_interceptor_t* interceptor, mc_interceptor_stats_t* stats);
 void mc_interceptor_reset_stats(mc_interceptor_t* interceptor);
 void mc_interceptor_print_stats(mc_interceptor_t* interceptor);
+// One JSON object per call, for periodic machine-readable dumps
+void mc_interceptor_dump_stats(mc_interceptor_t* interceptor, FILE* out);
 
 // Utility
 const char* mc_op_to_string(mc_op_type_t op);
 const char* mc_route_to_string(mc_route_t route);
+const char* mc_stat_route_to_string(mc_stat_route_t route);
 
 #ifdef __cplusplus
 }
@@ -32,6 +32,7 @@ void print_usage(const char* prog) {
     printf("  -r, --replicate N       Enable replication with factor N\n");
     printf("  --no-cxl                Disable CXL disaggregation (local only)\n");
     printf("  --stats-interval SEC    Print stats every N seconds (default: 10)\n");
+    printf("  --stats-json FILE       Append a JSON stats record every interval\n");
     printf("  -h, --help              Show this help message\n");
     printf("\n");
     printf("Example:\n");
@@ -54,6 +55,7 @@ int main(int argc, char* argv[]) {
     int replication_factor = 0;
     bool enable_cxl = true;
     int stats_interval = 10;
+    const char* stats_json_path = NULL;
 
     // Parse command line
     static struct option long_options[] = {
@@ -65,12 +67,13 @@ int main(int argc, char* argv[]) {
         {"replicate", required_argument, 0, 'r'},
         {"no-cxl", no_argument, 0, 'n'},
         {"stats-interval", required_argument, 0, 'i'},
+        {"stats-json", required_argument, 0, 'j'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}
     };
 
     int opt;
-    while ((opt = getopt_long(argc, argv, "c:m:p:s:t:r:i:nh", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "c:m:p:s:t:r:i:j:nh", long_options, NULL)) != -1) {
         switch (opt) {
             case 'c':
                 config_file = optarg;
@@ -96,6 +99,9 @@ int main(int argc, char* argv[]) {
             case 'i':
                 stats_interval = atoi(optarg);
                 break;
+            case 'j':
+                stats_json_path = optarg;
+                break;
             case 'h':
             default:
                 print_usage(argv[0]);
@@ -183,6 +189,16 @@ int main(int argc, char* argv[]) {
     }
     printf("\n");
     printf("  Stats interval: %d seconds\n", stats_interval);
+
+    FILE* stats_json = NULL;
+    if (stats_json_path) {
+        stats_json = fopen(stats_json_path, "a");
+        if (!stats_json) {
+            fprintf(stderr, "Warning: Could not open %s for stats output\n", stats_json_path);
+        } else {
+            printf("  Stats JSON: %s\n", stats_json_path);
+        }
+    }
     printf("\nMemcached interception active. Press Ctrl+C to stop.\n\n");
 
     // Main loop
@@ -193,6 +209,9 @@ int main(int argc, char* argv[]) {
 
         if (stats_counter >= stats_interval) {
             mc_interceptor_print_stats(g_interceptor);
+            if (stats_json) {
+                mc_interceptor_dump_stats(g_interceptor, stats_json);
+            }
 
             // Also print PGAS stats
             pgas_stats_t pgas_stats;
@@ -214,6 +233,10 @@ int main(int argc, char* argv[]) {
     // Cleanup
     printf("Printing final statistics...\n");
     mc_interceptor_print_stats(g_interceptor);
+    if (stats_json) {
+        mc_interceptor_dump_stats(g_interceptor, stats_json);
+        fclose(stats_json);
+    }
 
     printf("Cleaning up...\n");
     mc_interceptor_finalize(g_interceptor);
@@ -4,7 +4,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
-#include <pthread.h>
 
 // Hash table parameters
 #define HASH_SEED 0x9747b28c
@@ -16,15 +15,52 @@ typedef struct hash_entry {
     struct hash_entry* next;
 } hash_entry_t;
 
-// Latency tracking
-typedef struct {
-    uint64_t* samples;
-    size_t count;
-    size_t capacity;
-    pthread_mutex_t lock;
-} latency_tracker_t;
+/*
+ * Latency histograms: log-linear (HDR-style) buckets. Values below
+ * 2 * LAT_SUB_BUCKETS ns are exact; above that each power of two is split
+ * into LAT_SUB_BUCKETS linear sub-buckets (~3% relative error). Values are
+ * clamped at 2^LAT_MAX_BITS ns (~68 s).
+ */
+#define LAT_SUB_BUCKET_BITS 5
+#define LAT_SUB_BUCKETS (1 << LAT_SUB_BUCKET_BITS)
+#define LAT_MAX_BITS 36
+#define LAT_NUM_BUCKETS ((LAT_MAX_BITS - LAT_SUB_BUCKET_BITS + 1) << LAT_SUB_BUCKET_BITS)
 
-static latency_tracker_t latency_tracker = {0};
+typedef struct {
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t max_ns;
+    uint64_t buckets[LAT_NUM_BUCKETS];
+} latency_hist_t;
+
+/*
+ * Per-thread statistics. Only the owning thread writes a record, using plain
+ * relaxed load/store pairs (no locked RMW); readers merge all records with
+ * relaxed loads. Records live until mc_interceptor_finalize.
+ */
+typedef struct mc_thread_stats {
+    struct mc_thread_stats* next;
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+    uint64_t bytes_read[MC_STAT_ROUTE_COUNT];
+    uint64_t bytes_written[MC_STAT_ROUTE_COUNT];
+    latency_hist_t op_hist[MC_OP_COUNT];
+    latency_hist_t route_hist[MC_STAT_ROUTE_COUNT];
+} mc_thread_stats_t;
+
+static uint64_t next_stats_id = 1;
+
+static __thread mc_thread_stats_t* tls_stats;
+static __thread uint64_t tls_stats_id;
+
+// Per-key state for one multi-get batch
+typedef struct {
+    uint64_t key_hash;
+    hash_entry_t* entry;     // Newest index entry with a matching hash
+    mc_item_meta_t meta;
+    char* data_buf;          // key + value, filled by the second read pass
+    bool fallback;           // Needs the full chain walk in mc_item_fetch
+} multiget_slot_t;
 
 // MurmurHash3 finalizer
 static inline uint64_t murmur3_fmix64(uint64_t k) {
@@ -36,6 +72,168 @@ static inline uint64_t murmur3_fmix64(uint64_t k) {
     return k;
 }
 
+// Single-writer counter update: no lock prefix on the hot path
+static inline void stat_add(uint64_t* counter, uint64_t value) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value,
+                     __ATOMIC_RELAXED);
+}
+
+static inline uint64_t stat_load(const uint64_t* counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+static inline size_t lat_bucket_index(uint64_t ns) {
+    if (ns < 2 * LAT_SUB_BUCKETS) return (size_t)ns;
+    if (ns >= (1ULL << LAT_MAX_BITS)) ns = (1ULL << LAT_MAX_BITS) - 1;
+
+    int shift = 63 - __builtin_clzll(ns) - LAT_SUB_BUCKET_BITS;
+    return ((size_t)(shift + 1) << LAT_SUB_BUCKET_BITS) +
+           (size_t)((ns >> shift) - LAT_SUB_BUCKETS);
+}
+
+// Highest value that maps to the bucket
+static inline uint64_t lat_bucket_value(size_t idx) {
+    if (idx < 2 * LAT_SUB_BUCKETS) return idx;
+
+    int shift = (int)(idx >> LAT_SUB_BUCKET_BITS) - 1;
+    uint64_t top = (idx & (LAT_SUB_BUCKETS - 1)) + LAT_SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+static inline void lat_hist_record(latency_hist_t* hist, uint64_t ns) {
+    stat_add(&hist->buckets[lat_bucket_index(ns)], 1);
+    stat_add(&hist->count, 1);
+    stat_add(&hist->sum_ns, ns);
+    if (ns > stat_load(&hist->max_ns)) {
+        __atomic_store_n(&hist->max_ns, ns, __ATOMIC_RELAXED);
+    }
+}
+
+static void lat_hist_merge(latency_hist_t* dst, const latency_hist_t* src) {
+    for (size_t i = 0; i < LAT_NUM_BUCKETS; i++) {
+        dst->buckets[i] += stat_load(&src->buckets[i]);
+    }
+    dst->count += stat_load(&src->count);
+    dst->sum_ns += stat_load(&src->sum_ns);
+
+    uint64_t max_ns = stat_load(&src->max_ns);
+    if (max_ns > dst->max_ns) dst->max_ns = max_ns;
+}
+
+static void lat_hist_reset(latency_hist_t* hist) {
+    for (size_t i = 0; i < LAT_NUM_BUCKETS; i++) {
+        __atomic_store_n(&hist->buckets[i], 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&hist->count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->sum_ns, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->max_ns, 0, __ATOMIC_RELAXED);
+}
+
+static uint64_t lat_hist_percentile(const latency_hist_t* hist, double pct) {
+    if (hist->count == 0) return 0;
+
+    uint64_t target = (uint64_t)(pct / 100.0 * hist->count + 0.5);
+    if (target == 0) target = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LAT_NUM_BUCKETS; i++) {
+        seen += hist->buckets[i];
+        if (seen >= target) {
+            uint64_t value = lat_bucket_value(i);
+            return value < hist->max_ns ? value : hist->max_ns;
+        }
+    }
+    return hist->max_ns;
+}
+
+static void lat_hist_summarize(const latency_hist_t* hist, mc_latency_summary_t* out) {
+    out->count = hist->count;
+    if (hist->count == 0) return;
+
+    out->avg_latency_us = (double)hist->sum_ns / hist->count / 1000.0;
+    out->p50_latency_us = lat_hist_percentile(hist, 50.0) / 1000.0;
+    out->p99_latency_us = lat_hist_percentile(hist, 99.0) / 1000.0;
+    out->p999_latency_us = lat_hist_percentile(hist, 99.9) / 1000.0;
+    out->max_latency_us = hist->max_ns / 1000.0;
+}
+
+// Returns this thread's record, registering it on first use
+static mc_thread_stats_t* thread_stats_get(mc_interceptor_t* interceptor) {
+    if (tls_stats && tls_stats_id == interceptor->stats_id) {
+        return tls_stats;
+    }
+
+    mc_thread_stats_t* ts = calloc(1, sizeof(mc_thread_stats_t));
+    if (!ts) return NULL;
+
+    mc_thread_stats_t* head = __atomic_load_n(&interceptor->thread_stats, __ATOMIC_ACQUIRE);
+    do {
+        ts->next = head;
+    } while (!__atomic_compare_exchange_n(&interceptor->thread_stats, &head, ts, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+
+    tls_stats = ts;
+    tls_stats_id = interceptor->stats_id;
+    return ts;
+}
+
+static mc_stat_route_t stat_route_of_ptr(mc_interceptor_t* interceptor, pgas_ptr_t ptr) {
+    return pgas_is_local(interceptor->pgas_ctx, ptr) ?
+           MC_STAT_ROUTE_CXL_LOCAL : MC_STAT_ROUTE_CXL_REMOTE;
+}
+
+static mc_stat_route_t stat_route_of(mc_route_t route) {
+    return (route == MC_ROUTE_LOCAL || route == MC_ROUTE_CXL_LOCAL) ?
+           MC_STAT_ROUTE_CXL_LOCAL : MC_STAT_ROUTE_CXL_REMOTE;
+}
+
+static void record_request(mc_interceptor_t* interceptor, mc_op_type_t op,
+                           mc_stat_route_t route, uint64_t latency_ns) {
+    mc_thread_stats_t* ts = thread_stats_get(interceptor);
+    if (!ts) return;
+
+    if (op < MC_OP_COUNT) {
+        lat_hist_record(&ts->op_hist[op], latency_ns);
+    }
+    lat_hist_record(&ts->route_hist[route], latency_ns);
+}
+
+static void record_lookup(mc_interceptor_t* interceptor, bool hit) {
+    mc_thread_stats_t* ts = thread_stats_get(interceptor);
+    if (!ts) return;
+
+    stat_add(hit ? &ts->cache_hits : &ts->cache_misses, 1);
+}
+
+static void record_bytes(mc_interceptor_t* interceptor, pgas_ptr_t ptr,
+                         size_t size, bool write) {
+    mc_thread_stats_t* ts = thread_stats_get(interceptor);
+    if (!ts) return;
+
+    mc_stat_route_t route = stat_route_of_ptr(interceptor, ptr);
+    stat_add(write ? &ts->bytes_written[route] : &ts->bytes_read[route], size);
+}
+
+// pgas_get/pgas_put with exact byte accounting
+static int mc_cxl_get(mc_interceptor_t* interceptor, void* dest, pgas_ptr_t src, size_t size) {
+    int ret = pgas_get(interceptor->pgas_ctx, dest, src, size);
+    if (ret == 0) record_bytes(interceptor, src, size, false);
+    return ret;
+}
+
+static int mc_cxl_put(mc_interceptor_t* interceptor, pgas_ptr_t dest, const void* src, size_t size) {
+    int ret = pgas_put(interceptor->pgas_ctx, dest, src, size);
+    if (ret == 0) record_bytes(interceptor, dest, size, true);
+    return ret;
+}
+
+static void mc_cxl_get_batch(mc_interceptor_t* interceptor, pgas_get_op_t* ops, size_t count) {
+    pgas_get_batch(interceptor->pgas_ctx, ops, count);
+    for (size_t i = 0; i < count; i++) {
+        if (ops[i].status == 0) record_bytes(interceptor, ops[i].src, ops[i].size, false);
+    }
+}
+
 uint64_t mc_hash_key(const char* key, size_t key_len) {
     uint64_t h = HASH_SEED;
 
@@ -90,11 +288,9 @@ int mc_interceptor_init(mc_interceptor_t** interceptor, pgas_context_t* pgas_ctx
         fprintf(stderr, "Warning: Could not allocate remote hash table\n");
     }
 
-    // Initialize latency tracker
-    latency_tracker.capacity = 10000;
-    latency_tracker.samples = malloc(latency_tracker.capacity * sizeof(uint64_t));
-    latency_tracker.count = 0;
-    pthread_mutex_init(&latency_tracker.lock, NULL);
+    // Per-thread stats records attach lazily; the id keeps a thread from
+    // reusing a record that belonged to an earlier interceptor
+    (*interceptor)->stats_id = __atomic_fetch_add(&next_stats_id, 1, __ATOMIC_RELAXED);
 
     printf("Memcached interceptor initialized:\n");
     printf("  Hash table size: %zu\n", config->hash_table_size);
@@ -134,11 +330,13 @@ void mc_interceptor_finalize(mc_interceptor_t* interceptor) {
         pgas_free(interceptor->pgas_ctx, interceptor->remote_hash_table);
     }
 
-    // Cleanup latency tracker
-    if (latency_tracker.samples) {
-        free(latency_tracker.samples);
+    // Free per-thread stats records
+    mc_thread_stats_t* ts = interceptor->thread_stats;
+    while (ts) {
+        mc_thread_stats_t* next = ts->next;
+        free(ts);
+        ts = next;
     }
-    pthread_mutex_destroy(&latency_tracker.lock);
 
     free(interceptor);
 }
@@ -162,7 +360,6 @@ int mc_handle_request(mc_interceptor_t* interceptor, mc_request_t* req, mc_respo
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
 
-    interceptor->requests_total++;
     memset(resp, 0, sizeof(*resp));
 
     mc_route_t route = mc_determine_route(interceptor, req);
@@ -172,11 +369,7 @@ int mc_handle_request(mc_interceptor_t* interceptor, mc_request_t* req, mc_respo
         case MC_OP_GET:
         case MC_OP_GETS:
             result = mc_item_fetch(interceptor, req->key, req->key_len, resp);
-            if (result == 0 && resp->value != NULL) {
-                interceptor->cache_hits++;
-            } else {
-                interceptor->cache_misses++;
-            }
+            record_lookup(interceptor, result == 0 && resp->value != NULL);
             break;
 
         case MC_OP_SET:
@@ -220,27 +413,358 @@ int mc_handle_request(mc_interceptor_t* interceptor, mc_request_t* req, mc_respo
             result = -1;
     }
 
-    // Track routing stats
-    if (route == MC_ROUTE_LOCAL || route == MC_ROUTE_CXL_LOCAL) {
-        interceptor->requests_local++;
-    } else {
-        interceptor->requests_remote++;
-    }
-
-    // Track latency
+    // Track latency per op and per route
     clock_gettime(CLOCK_MONOTONIC, &end);
     uint64_t latency_ns = (end.tv_sec - start.tv_sec) * 1000000000ULL +
                           (end.tv_nsec - start.tv_nsec);
 
-    pthread_mutex_lock(&latency_tracker.lock);
-    if (latency_tracker.count < latency_tracker.capacity) {
-        latency_tracker.samples[latency_tracker.count++] = latency_ns;
-    }
-    pthread_mutex_unlock(&latency_tracker.lock);
+    record_request(interceptor, req->op, stat_route_of(route), latency_ns);
 
     return result;
 }
 
+/*
+ * One multi-get batch in three passes:
+ *   1. hash every key and probe the local index,
+ *   2. read all candidate metadata in one vectorized batch,
+ *   3. read all key+value blobs in one vectorized batch.
+ * pgas_get_batch groups each pass by owner node and pipelines remote reads,
+ * so a batch costs two round trips per node instead of two per key.
+ */
+static void multiget_batch(mc_interceptor_t* interceptor, mc_request_t* reqs,
+                           size_t count, mc_response_t* resps,
+                           multiget_slot_t* slots, pgas_get_op_t* ops) {
+    size_t nops = 0;
+
+    // Pass 1: index probes
+    for (size_t i = 0; i < count; i++) {
+        multiget_slot_t* slot = &slots[i];
+        memset(&resps[i], 0, sizeof(resps[i]));
+        memset(slot, 0, sizeof(*slot));
+
+        slot->key_hash = mc_hash_key(reqs[i].key, reqs[i].key_len);
+        size_t bucket = slot->key_hash % interceptor->hash_table_size;
+
+        for (hash_entry_t* entry = (hash_entry_t*)interceptor->hash_table[bucket]; entry; entry = entry->next) {
+            if (entry->key_hash == slot->key_hash) {
+                slot->entry = entry;
+                break;
+            }
+        }
+
+        if (slot->entry) {
+            ops[nops].dest = &slot->meta;
+            ops[nops].src = slot->entry->meta_ptr;
+            ops[nops].size = sizeof(slot->meta);
+            nops++;
+        }
+    }
+
+    mc_cxl_get_batch(interceptor, ops, nops);
+
+    // Pass 2: validate metadata, gather data reads. Reuses ops in place; the
+    // write index never passes the read index.
+    time_t now = time(NULL);
+    size_t nread = nops;
+    nops = 0;
+
+    for (size_t i = 0, k = 0; i < count && k < nread; i++) {
+        multiget_slot_t* slot = &slots[i];
+        if (!slot->entry) continue;
+
+        int status = ops[k++].status;
+        if (status != 0) {
+            slot->entry = NULL;
+            continue;
+        }
+
+        if (slot->meta.key_len != reqs[i].key_len || slot->meta.key_hash != slot->key_hash) {
+            slot->fallback = true;
+            continue;
+        }
+
+        if (slot->meta.exptime != 0 && slot->meta.exptime < now) {
+            slot->entry = NULL;
+            continue;
+        }
+
+        size_t data_size = slot->meta.key_len + slot->meta.value_len;
+        slot->data_buf = malloc(data_size);
+        if (!slot->data_buf) {
+            slot->entry = NULL;
+            continue;
+        }
+
+        ops[nops].dest = slot->data_buf;
+        ops[nops].src = slot->meta.data_ptr;
+        ops[nops].size = data_size;
+        nops++;
+    }
+
+    mc_cxl_get_batch(interceptor, ops, nops);
+
+    // Pass 3: assemble responses in request order
+    for (size_t i = 0, k = 0; i < count; i++) {
+        multiget_slot_t* slot = &slots[i];
+        mc_response_t* resp = &resps[i];
+        int result = -1;
+
+        if (slot->data_buf) {
+            int status = ops[k++].status;
+
+            if (status == 0 && memcmp(slot->data_buf, reqs[i].key, reqs[i].key_len) != 0) {
+                slot->fallback = true;
+            } else if (status == 0) {
+                resp->value_len = slot->meta.value_len;
+                resp->value = malloc(slot->meta.value_len);
+                if (resp->value) {
+                    memcpy(resp->value, slot->data_buf + reqs[i].key_len, slot->meta.value_len);
+                    resp->flags = slot->meta.flags;
+                    resp->cas_unique = slot->meta.cas_unique;
+                    resp->success = true;
+                    result = 0;
+                }
+            }
+
+            free(slot->data_buf);
+            slot->data_buf = NULL;
+        }
+
+        // 64-bit hash collision in the index: walk the full chain
+        if (slot->fallback) {
+            result = mc_item_fetch(interceptor, reqs[i].key, reqs[i].key_len, resp);
+        }
+
+        record_lookup(interceptor, result == 0 && resp->value != NULL);
+    }
+}
+
+int mc_handle_multiget(mc_interceptor_t* interceptor, mc_request_t* reqs,
+                       size_t count, mc_response_t* resps) {
+    if (count == 0) return 0;
+
+    if (!interceptor->config.enable_batching) {
+        for (size_t i = 0; i < count; i++) {
+            reqs[i].op = MC_OP_GET;
+            mc_handle_request(interceptor, &reqs[i], &resps[i]);
+        }
+        return 0;
+    }
+
+    size_t batch = interceptor->config.batch_size > 0 ?
+                   (size_t)interceptor->config.batch_size : count;
+    if (batch > count) batch = count;
+
+    multiget_slot_t* slots = malloc(batch * sizeof(multiget_slot_t));
+    pgas_get_op_t* ops = malloc(batch * sizeof(pgas_get_op_t));
+    if (!slots || !ops) {
+        free(slots);
+        free(ops);
+        return -1;
+    }
+
+    for (size_t off = 0; off < count; off += batch) {
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        size_t n = count - off;
+        if (n > batch) n = batch;
+
+        multiget_batch(interceptor, reqs + off, n, resps + off, slots, ops);
+
+        // Keys in a batch complete together; each one saw the batch latency
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        uint64_t latency_ns = (end.tv_sec - start.tv_sec) * 1000000000ULL +
+                              (end.tv_nsec - start.tv_nsec);
+        for (size_t i = off; i < off + n; i++) {
+            mc_route_t route = mc_determine_route(interceptor, &reqs[i]);
+            record_request(interceptor, MC_OP_GET, stat_route_of(route), latency_ns);
+        }
+    }
+
+    free(slots);
+    free(ops);
+    return 0;
+}
+
+/*
+ * Text-protocol front end for retrieval commands. Keys of consecutive
+ * get/gets commands are queued and served through mc_handle_multiget, so a
+ * multi-key get and a pipelined run of single-key gets both take the batched
+ * path. The queue is flushed when it reaches batch_size keys, when
+ * batch_timeout_us has passed since its first key was queued, and at the end
+ * of the buffer.
+ */
+typedef struct {
+    mc_request_t* reqs;
+    mc_response_t* resps;
+    size_t* cmd_end;         // One past each command's last key
+    bool* cmd_cas;           // Command was "gets"
+    size_t num_keys, key_cap;
+    size_t num_cmds, cmd_cap;
+    struct timespec first;   // When the oldest queued command was parsed
+} get_queue_t;
+
+static int get_queue_push_key(get_queue_t* q, const char* key, size_t key_len) {
+    if (q->num_keys == q->key_cap) {
+        size_t cap = q->key_cap ? q->key_cap * 2 : 16;
+        mc_request_t* reqs = realloc(q->reqs, cap * sizeof(mc_request_t));
+        if (!reqs) return -1;
+        q->reqs = reqs;
+        mc_response_t* resps = realloc(q->resps, cap * sizeof(mc_response_t));
+        if (!resps) return -1;
+        q->resps = resps;
+        q->key_cap = cap;
+    }
+
+    mc_request_t* req = &q->reqs[q->num_keys++];
+    memset(req, 0, sizeof(*req));
+    req->op = MC_OP_GET;
+    req->key = (char*)key;
+    req->key_len = key_len;
+    return 0;
+}
+
+static int get_queue_end_cmd(get_queue_t* q, bool cas) {
+    if (q->num_cmds == q->cmd_cap) {
+        size_t cap = q->cmd_cap ? q->cmd_cap * 2 : 8;
+        size_t* cmd_end = realloc(q->cmd_end, cap * sizeof(size_t));
+        if (!cmd_end) return -1;
+        q->cmd_end = cmd_end;
+        bool* cmd_cas = realloc(q->cmd_cas, cap * sizeof(bool));
+        if (!cmd_cas) return -1;
+        q->cmd_cas = cmd_cas;
+        q->cmd_cap = cap;
+    }
+
+    q->cmd_end[q->num_cmds] = q->num_keys;
+    q->cmd_cas[q->num_cmds] = cas;
+    q->num_cmds++;
+    return 0;
+}
+
+static uint64_t elapsed_us(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - since->tv_sec) * 1000000ULL +
+           (now.tv_nsec - since->tv_nsec) / 1000;
+}
+
+// Serve every queued key, then write each command's response in order
+static void get_queue_flush(mc_interceptor_t* interceptor, get_queue_t* q, FILE* out) {
+    if (q->num_cmds == 0) return;
+
+    int result = 0;
+    if (q->num_keys > 0) {
+        result = mc_handle_multiget(interceptor, q->reqs, q->num_keys, q->resps);
+    }
+
+    size_t k = 0;
+    for (size_t c = 0; c < q->num_cmds; c++) {
+        size_t end = q->cmd_end[c];
+
+        if (k == end) {
+            fputs("ERROR\r\n", out);  // get with no keys
+            continue;
+        }
+
+        if (result != 0) {
+            fputs("SERVER_ERROR out of memory\r\n", out);
+            k = end;
+            continue;
+        }
+
+        for (; k < end; k++) {
+            const mc_request_t* req = &q->reqs[k];
+            mc_response_t* resp = &q->resps[k];
+            if (!resp->success || !resp->value) continue;
+
+            fprintf(out, "VALUE %.*s %u %zu", (int)req->key_len, req->key,
+                    resp->flags, resp->value_len);
+            if (q->cmd_cas[c]) fprintf(out, " %llu", (unsigned long long)resp->cas_unique);
+            fputs("\r\n", out);
+            fwrite(resp->value, 1, resp->value_len, out);
+            fputs("\r\n", out);
+
+            free(resp->value);
+            resp->value = NULL;
+        }
+        fputs("END\r\n", out);
+    }
+
+    q->num_keys = 0;
+    q->num_cmds = 0;
+}
+
+long mc_process_commands(mc_interceptor_t* interceptor, const char* buf, size_t len,
+                         FILE* out) {
+    get_queue_t q;
+    memset(&q, 0, sizeof(q));
+
+    size_t batch = interceptor->config.batch_size > 0 ?
+                   (size_t)interceptor->config.batch_size : 1;
+    uint64_t timeout_us = interceptor->config.batch_timeout_us > 0 ?
+                          (uint64_t)interceptor->config.batch_timeout_us : 0;
+
+    size_t pos = 0;
+    long consumed = 0;
+
+    while (pos < len) {
+        const char* line = buf + pos;
+        const char* nl = memchr(line, '\n', len - pos);
+        if (!nl) break;  // Incomplete line: wait for more input
+
+        size_t line_len = (size_t)(nl - line);
+        if (line_len > 0 && line[line_len - 1] == '\r') line_len--;
+
+        size_t cmd_len;
+        bool cas;
+        if (line_len >= 4 && memcmp(line, "gets", 4) == 0 && (line_len == 4 || line[4] == ' ')) {
+            cmd_len = 4;
+            cas = true;
+        } else if (line_len >= 3 && memcmp(line, "get", 3) == 0 &&
+                   (line_len == 3 || line[3] == ' ')) {
+            cmd_len = 3;
+            cas = false;
+        } else {
+            break;  // Not a retrieval command: the caller takes it from here
+        }
+
+        if (q.num_cmds == 0) clock_gettime(CLOCK_MONOTONIC, &q.first);
+
+        for (size_t i = cmd_len; i < line_len;) {
+            while (i < line_len && line[i] == ' ') i++;
+            size_t start = i;
+            while (i < line_len && line[i] != ' ') i++;
+            if (i > start && get_queue_push_key(&q, line + start, i - start) != 0) {
+                consumed = -1;
+                goto out;
+            }
+        }
+        if (get_queue_end_cmd(&q, cas) != 0) {
+            consumed = -1;
+            goto out;
+        }
+
+        pos = (size_t)(nl - buf) + 1;
+
+        if (!interceptor->config.enable_batching || q.num_keys >= batch ||
+            elapsed_us(&q.first) >= timeout_us) {
+            get_queue_flush(interceptor, &q, out);
+        }
+    }
+
+    get_queue_flush(interceptor, &q, out);
+    consumed = (long)pos;
+
+out:
+    free(q.reqs);
+    free(q.resps);
+    free(q.cmd_end);
+    free(q.cmd_cas);
+    return consumed;
+}
+
 int mc_item_store(mc_interceptor_t* interceptor, const mc_request_t* req, pgas_ptr_t* item_ptr) {
     uint64_t key_hash = mc_hash_key(req->key, req->key_len);
     uint16_t target_node = mc_route_key_to_node(interceptor, req->key, req->key_len);
@@ -267,7 +791,7 @@ int mc_item_store(mc_interceptor_t* interceptor, const mc_request_t* req, pgas_p
         .value_len = req->value_len,
         .flags = req->flags,
         .exptime = req->exptime,
-        .cas_unique = __sync_fetch_and_add(&interceptor->requests_total, 0),
+        .cas_unique = __atomic_add_fetch(&interceptor->next_cas_unique, 1, __ATOMIC_RELAXED),
         .data_ptr = data_ptr,
         .owner_node = target_node,
         .is_locked = false,
@@ -275,7 +799,7 @@ int mc_item_store(mc_interceptor_t* interceptor, const mc_request_t* req, pgas_p
     };
 
     // Write metadata
-    pgas_put(interceptor->pgas_ctx, meta_ptr, &meta, sizeof(meta));
+    mc_cxl_put(interceptor, meta_ptr, &meta, sizeof(meta));
 
     // Write key + value data
     char* data_buf = malloc(data_size);
@@ -287,7 +811,7 @@ int mc_item_store(mc_interceptor_t* interceptor, const mc_request_t* req, pgas_p
 
     memcpy(data_buf, req->key, req->key_len);
     memcpy(data_buf + req->key_len, req->value, req->value_len);
-    pgas_put(interceptor->pgas_ctx, data_ptr, data_buf, data_size);
+    mc_cxl_put(interceptor, data_ptr, data_buf, data_size);
     free(data_buf);
 
     // Update local hash table
@@ -305,7 +829,6 @@ int mc_item_store(mc_interceptor_t* interceptor, const mc_request_t* req, pgas_p
     interceptor->hash_table[bucket] = new_entry;
 
     *item_ptr = meta_ptr;
-    interceptor->cxl_writes++;
 
     return 0;
 }
@@ -321,7 +844,7 @@ int mc_item_fetch(mc_interceptor_t* interceptor, const char* key, size_t key_len
         if (entry->key_hash == key_hash) {
             // Found potential match, fetch metadata from CXL
             mc_item_meta_t meta;
-            pgas_get(interceptor->pgas_ctx, &meta, entry->meta_ptr, sizeof(meta));
+            mc_cxl_get(interceptor, &meta, entry->meta_ptr, sizeof(meta));
 
             // Verify key match
             if (meta.key_len == key_len && meta.key_hash == key_hash) {
@@ -336,7 +859,7 @@ int mc_item_fetch(mc_interceptor_t* interceptor, const char* key, size_t key_len
                 char* data_buf = malloc(data_size);
                 if (!data_buf) return -1;
 
-                pgas_get(interceptor->pgas_ctx, data_buf, meta.data_ptr, data_size);
+                mc_cxl_get(interceptor, data_buf, meta.data_ptr, data_size);
 
                 // Verify key
                 if (memcmp(data_buf, key, key_len) != 0) {
@@ -359,7 +882,6 @@ int mc_item_fetch(mc_interceptor_t* interceptor, const char* key, size_t key_len
                 resp->success = true;
 
                 free(data_buf);
-                interceptor->cxl_reads++;
                 return 0;
             }
         }
@@ -380,7 +902,7 @@ int mc_item_delete(mc_interceptor_t* interceptor, const char* key, size_t key_le
         if (entry->key_hash == key_hash) {
             // Fetch metadata to get data pointer
             mc_item_meta_t meta;
-            pgas_get(interceptor->pgas_ctx, &meta, entry->meta_ptr, sizeof(meta));
+            mc_cxl_get(interceptor, &meta, entry->meta_ptr, sizeof(meta));
 
             // Free CXL memory
             pgas_free(interceptor->pgas_ctx, meta.data_ptr);
@@ -409,12 +931,12 @@ int mc_item_touch(mc_interceptor_t* interceptor, const char* key, size_t key_len
         if (entry->key_hash == key_hash) {
             // Update expiration time
             mc_item_meta_t meta;
-            pgas_get(interceptor->pgas_ctx, &meta, entry->meta_ptr, sizeof(meta));
+            mc_cxl_get(interceptor, &meta, entry->meta_ptr, sizeof(meta));
 
             meta.exptime = exptime;
             meta.last_access = time(NULL);
 
-            pgas_put(interceptor->pgas_ctx, entry->meta_ptr, &meta, sizeof(meta));
+            mc_cxl_put(interceptor, entry->meta_ptr, &meta, sizeof(meta));
             return 0;
         }
         entry = entry->next;
@@ -432,13 +954,13 @@ int mc_item_incr_decr(mc_interceptor_t* interceptor, const char* key, size_t key
     while (entry) {
         if (entry->key_hash == key_hash) {
             mc_item_meta_t meta;
-            pgas_get(interceptor->pgas_ctx, &meta, entry->meta_ptr, sizeof(meta));
+            mc_cxl_get(interceptor, &meta, entry->meta_ptr, sizeof(meta));
 
             // Fetch current value
             char* data_buf = malloc(meta.key_len + meta.value_len);
             if (!data_buf) return -1;
 
-            pgas_get(interceptor->pgas_ctx, data_buf, meta.data_ptr, meta.key_len + meta.value_len);
+            mc_cxl_get(interceptor, data_buf, meta.data_ptr, meta.key_len + meta.value_len);
 
             // Parse numeric value
             uint64_t current = 0;
@@ -468,8 +990,8 @@ int mc_item_incr_decr(mc_interceptor_t* interceptor, const char* key, size_t key
             memcpy(data_buf + meta.key_len, new_str, new_len);
             meta.value_len = new_len;
 
-            pgas_put(interceptor->pgas_ctx, meta.data_ptr, data_buf, meta.key_len + new_len);
-            pgas_put(interceptor->pgas_ctx, entry->meta_ptr, &meta, sizeof(meta));
+            mc_cxl_put(interceptor, meta.data_ptr, data_buf, meta.key_len + new_len);
+            mc_cxl_put(interceptor, entry->meta_ptr, &meta, sizeof(meta));
 
             *new_value = current;
             free(data_buf);
@@ -490,7 +1012,7 @@ int mc_item_cas(mc_interceptor_t* interceptor, const mc_request_t* req,
     while (entry) {
         if (entry->key_hash == key_hash) {
             mc_item_meta_t meta;
-            pgas_get(interceptor->pgas_ctx, &meta, entry->meta_ptr, sizeof(meta));
+            mc_cxl_get(interceptor, &meta, entry->meta_ptr, sizeof(meta));
 
             // Check CAS
             if (meta.cas_unique != cas_unique) {
@@ -514,7 +1036,7 @@ int mc_item_cas(mc_interceptor_t* interceptor, const mc_request_t* req,
             char* data_buf = malloc(data_size);
             memcpy(data_buf, req->key, req->key_len);
             memcpy(data_buf + req->key_len, req->value, req->value_len);
-            pgas_put(interceptor->pgas_ctx, new_data_ptr, data_buf, data_size);
+            mc_cxl_put(interceptor, new_data_ptr, data_buf, data_size);
             free(data_buf);
 
             // Update metadata
@@ -523,7 +1045,7 @@ int mc_item_cas(mc_interceptor_t* interceptor, const mc_request_t* req,
             meta.cas_unique++;
             meta.data_ptr = new_data_ptr;
 
-            pgas_put(interceptor->pgas_ctx, entry->meta_ptr, &meta, sizeof(meta));
+            mc_cxl_put(interceptor, entry->meta_ptr, &meta, sizeof(meta));
 
             // Free old data
             pgas_free(interceptor->pgas_ctx, old_data_ptr);
@@ -540,54 +1062,78 @@ int mc_item_cas(mc_interceptor_t* interceptor, const mc_request_t* req,
     return -1;
 }
 
-static int compare_uint64(const void* a, const void* b) {
-    uint64_t va = *(const uint64_t*)a;
-    uint64_t vb = *(const uint64_t*)b;
-    if (va < vb) return -1;
-    if (va > vb) return 1;
-    return 0;
-}
-
 void mc_interceptor_get_stats(mc_interceptor_t* interceptor, mc_interceptor_stats_t* stats) {
     memset(stats, 0, sizeof(*stats));
 
-    stats->total_requests = interceptor->requests_total;
-    stats->local_hits = interceptor->requests_local;
-    stats->remote_hits = interceptor->requests_remote;
-    stats->cache_hits = interceptor->cache_hits;
-    stats->cache_misses = interceptor->cache_misses;
-    stats->cxl_bytes_read = interceptor->cxl_reads * 64;  // Approximate
-    stats->cxl_bytes_written = interceptor->cxl_writes * 64;
+    // Merge per-thread records; writers are never blocked
+    latency_hist_t* merged = calloc(MC_OP_COUNT + MC_STAT_ROUTE_COUNT + 1, sizeof(latency_hist_t));
+    if (!merged) return;
+
+    latency_hist_t* op_hist = merged;
+    latency_hist_t* route_hist = merged + MC_OP_COUNT;
+    latency_hist_t* total_hist = route_hist + MC_STAT_ROUTE_COUNT;
+
+    mc_thread_stats_t* ts = __atomic_load_n(&interceptor->thread_stats, __ATOMIC_ACQUIRE);
+    for (; ts; ts = ts->next) {
+        stats->cache_hits += stat_load(&ts->cache_hits);
+        stats->cache_misses += stat_load(&ts->cache_misses);
 
-    // Calculate latency statistics
-    pthread_mutex_lock(&latency_tracker.lock);
-    if (latency_tracker.count > 0) {
-        uint64_t total = 0;
-        for (size_t i = 0; i < latency_tracker.count; i++) {
-            total += latency_tracker.samples[i];
+        for (int r = 0; r < MC_STAT_ROUTE_COUNT; r++) {
+            stats->per_route[r].cxl_bytes_read += stat_load(&ts->bytes_read[r]);
+            stats->per_route[r].cxl_bytes_written += stat_load(&ts->bytes_written[r]);
+            lat_hist_merge(&route_hist[r], &ts->route_hist[r]);
         }
-        stats->avg_latency_us = (double)total / latency_tracker.count / 1000.0;
 
-        // Calculate p99
-        qsort(latency_tracker.samples, latency_tracker.count, sizeof(uint64_t), compare_uint64);
-        size_t p99_idx = (size_t)(latency_tracker.count * 0.99);
-        stats->p99_latency_us = latency_tracker.samples[p99_idx] / 1000.0;
+        for (int op = 0; op < MC_OP_COUNT; op++) {
+            lat_hist_merge(&op_hist[op], &ts->op_hist[op]);
+        }
+    }
+
+    for (int op = 0; op < MC_OP_COUNT; op++) {
+        lat_hist_merge(total_hist, &op_hist[op]);
+        lat_hist_summarize(&op_hist[op], &stats->per_op[op]);
+    }
+
+    for (int r = 0; r < MC_STAT_ROUTE_COUNT; r++) {
+        lat_hist_summarize(&route_hist[r], &stats->per_route[r].latency);
+        stats->cxl_bytes_read += stats->per_route[r].cxl_bytes_read;
+        stats->cxl_bytes_written += stats->per_route[r].cxl_bytes_written;
     }
-    pthread_mutex_unlock(&latency_tracker.lock);
+
+    lat_hist_summarize(total_hist, &stats->latency);
+
+    stats->total_requests = stats->latency.count;
+    stats->get_requests = op_hist[MC_OP_GET].count + op_hist[MC_OP_GETS].count;
+    stats->set_requests = op_hist[MC_OP_SET].count + op_hist[MC_OP_ADD].count +
+                          op_hist[MC_OP_REPLACE].count + op_hist[MC_OP_APPEND].count +
+                          op_hist[MC_OP_PREPEND].count + op_hist[MC_OP_CAS].count;
+    stats->delete_requests = op_hist[MC_OP_DELETE].count;
+    stats->local_hits = route_hist[MC_STAT_ROUTE_NEAR_CACHE].count +
+                        route_hist[MC_STAT_ROUTE_CXL_LOCAL].count;
+    stats->remote_hits = route_hist[MC_STAT_ROUTE_CXL_REMOTE].count;
+    stats->avg_latency_us = stats->latency.avg_latency_us;
+    stats->p99_latency_us = stats->latency.p99_latency_us;
+
+    free(merged);
 }
 
+// Counts recorded concurrently with a reset may survive it
 void mc_interceptor_reset_stats(mc_interceptor_t* interceptor) {
-    interceptor->requests_total = 0;
-    interceptor->requests_local = 0;
-    interceptor->requests_remote = 0;
-    interceptor->cache_hits = 0;
-    interceptor->cache_misses = 0;
-    interceptor->cxl_reads = 0;
-    interceptor->cxl_writes = 0;
+    mc_thread_stats_t* ts = __atomic_load_n(&interceptor->thread_stats, __ATOMIC_ACQUIRE);
+    for (; ts; ts = ts->next) {
+        __atomic_store_n(&ts->cache_hits, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&ts->cache_misses, 0, __ATOMIC_RELAXED);
+
+        for (int r = 0; r < MC_STAT_ROUTE_COUNT; r++) {
+            __atomic_store_n(&ts->bytes_read[r], 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&ts->bytes_written[r], 0, __ATOMIC_RELAXED);
+            lat_hist_reset(&ts->route_hist[r]);
+        }
 
-    pthread_mutex_lock(&latency_tracker.lock);
-    latency_tracker.count = 0;
-    pthread_mutex_unlock(&latency_tracker.lock);
+        for (int op = 0; op < MC_OP_COUNT; op++) {
+            lat_hist_reset(&ts->op_hist[op]);
+        }
+    }
 }
 
 void mc_interceptor_print_stats(mc_interceptor_t* interceptor) {
@@ -608,11 +1154,76 @@ void mc_interceptor_print_stats(mc_interceptor_t* interceptor) {
            100.0 * stats.cache_hits / (stats.cache_hits + stats.cache_misses) : 0);
     printf("CXL reads: %lu bytes, writes: %lu bytes\n",
            stats.cxl_bytes_read, stats.cxl_bytes_written);
-    printf("Avg latency: %.2f μs, P99: %.2f μs\n",
-           stats.avg_latency_us, stats.p99_latency_us);
+    printf("Avg latency: %.2f μs, P50: %.2f μs, P99: %.2f μs, P99.9: %.2f μs, Max: %.2f μs\n",
+           stats.latency.avg_latency_us, stats.latency.p50_latency_us,
+           stats.latency.p99_latency_us, stats.latency.p999_latency_us,
+           stats.latency.max_latency_us);
+
+    for (int op = 0; op < MC_OP_COUNT; op++) {
+        const mc_latency_summary_t* l = &stats.per_op[op];
+        if (l->count == 0) continue;
+        printf("  %-10s %10lu reqs  avg %.2f μs  p99 %.2f μs\n",
+               mc_op_to_string((mc_op_type_t)op), l->count,
+               l->avg_latency_us, l->p99_latency_us);
+    }
+
+    for (int r = 0; r < MC_STAT_ROUTE_COUNT; r++) {
+        const mc_route_stats_t* rs = &stats.per_route[r];
+        if (rs->latency.count == 0 && rs->cxl_bytes_read == 0 && rs->cxl_bytes_written == 0) {
+            continue;
+        }
+        printf("  %-10s %10lu reqs  avg %.2f μs  p99 %.2f μs  read %lu B  written %lu B\n",
+               mc_stat_route_to_string((mc_stat_route_t)r), rs->latency.count,
+               rs->latency.avg_latency_us, rs->latency.p99_latency_us,
+               rs->cxl_bytes_read, rs->cxl_bytes_written);
+    }
     printf("========================================\n\n");
 }
 
+static void dump_latency(FILE* out, const mc_latency_summary_t* l) {
+    fprintf(out, "{\"count\":%lu,\"avg_us\":%.3f,\"p50_us\":%.3f,"
+                 "\"p99_us\":%.3f,\"p999_us\":%.3f,\"max_us\":%.3f}",
+            l->count, l->avg_latency_us, l->p50_latency_us,
+            l->p99_latency_us, l->p999_latency_us, l->max_latency_us);
+}
+
+void mc_interceptor_dump_stats(mc_interceptor_t* interceptor, FILE* out) {
+    mc_interceptor_stats_t stats;
+    mc_interceptor_get_stats(interceptor, &stats);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    fprintf(out, "{\"timestamp\":%ld.%03ld,\"requests\":%lu,"
+                 "\"cache_hits\":%lu,\"cache_misses\":%lu,"
+                 "\"cxl_bytes_read\":%lu,\"cxl_bytes_written\":%lu,\"latency\":",
+            (long)now.tv_sec, now.tv_nsec / 1000000L, stats.total_requests,
+            stats.cache_hits, stats.cache_misses,
+            stats.cxl_bytes_read, stats.cxl_bytes_written);
+    dump_latency(out, &stats.latency);
+
+    fprintf(out, ",\"ops\":{");
+    bool first = true;
+    for (int op = 0; op < MC_OP_COUNT; op++) {
+        if (stats.per_op[op].count == 0) continue;
+        fprintf(out, "%s\"%s\":", first ? "" : ",", mc_op_to_string((mc_op_type_t)op));
+        dump_latency(out, &stats.per_op[op]);
+        first = false;
+    }
+
+    fprintf(out, "},\"routes\":{");
+    for (int r = 0; r < MC_STAT_ROUTE_COUNT; r++) {
+        const mc_route_stats_t* rs = &stats.per_route[r];
+        fprintf(out, "%s\"%s\":{\"cxl_bytes_read\":%lu,\"cxl_bytes_written\":%lu,\"latency\":",
+                r == 0 ? "" : ",", mc_stat_route_to_string((mc_stat_route_t)r),
+                rs->cxl_bytes_read, rs->cxl_bytes_written);
+        dump_latency(out, &rs->latency);
+        fprintf(out, "}");
+    }
+    fprintf(out, "}}\n");
+    fflush(out);
+}
+
 const char* mc_op_to_string(mc_op_type_t op) {
     static const char* names[] = {
         "GET", "SET", "ADD", "REPLACE", "DELETE",
@@ -637,6 +1248,15 @@ const char* mc_route_to_string(mc_route_t route) {
     }
 }
 
+const char* mc_stat_route_to_string(mc_stat_route_t route) {
+    switch (route) {
+        case MC_STAT_ROUTE_NEAR_CACHE: return "NEAR_CACHE";
+        case MC_STAT_ROUTE_CXL_LOCAL: return "CXL_LOCAL";
+        case MC_STAT_ROUTE_CXL_REMOTE: return "CXL_REMOTE";
+        default: return "UNKNOWN";
+    }
+}
+
 // BPF loading functions (stubs - would need actual bpftime integration)
 int mc_interceptor_load_bpf(mc_interceptor_t* interceptor, const char* memcached_path) {
     (void)interceptor;
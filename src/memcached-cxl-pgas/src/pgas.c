@@ -388,6 +388,18 @@ int pgas_put(pgas_context_t* ctx, pgas_ptr_t dest, const void* src, size_t size)
     return 0;
 }
 
+int pgas_get_batch(pgas_context_t* ctx, pgas_get_op_t* ops, size_t count) {
+    int failed = 0;
+
+    // This transport has no pipelining; issue the reads one by one
+    for (size_t i = 0; i < count; i++) {
+        ops[i].status = pgas_get(ctx, ops[i].dest, ops[i].src, ops[i].size);
+        if (ops[i].status != 0) failed++;
+    }
+
+    return failed;
+}
+
 uint64_t pgas_atomic_fetch_add(pgas_context_t* ctx, pgas_ptr_t ptr, uint64_t value) {
     internal_stats_t* stats = get_stats(ctx);
     uint64_t result;
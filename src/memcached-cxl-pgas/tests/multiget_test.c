@@ -0,0 +1,188 @@
+/*
+ * Multi-get Test for memcached-cxl-pgas
+ *
+ * Drives the text-protocol front end (mc_process_commands) on a single-node
+ * PGAS context and checks that:
+ * - multi-key gets answer keys in request order, skipping misses
+ * - pipelined get/gets commands each get their own END
+ * - batched and unbatched configurations produce identical output
+ * - parsing stops at non-retrieval commands and incomplete lines
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pgas.h"
+#include "memcached_interceptor.h"
+
+static int g_errors = 0;
+
+#define CHECK(cond, ...)                                  \
+    do {                                                  \
+        if (!(cond)) {                                    \
+            printf("  FAIL %s:%d: ", __FILE__, __LINE__); \
+            printf(__VA_ARGS__);                          \
+            printf("\n");                                 \
+            g_errors++;                                   \
+        }                                                 \
+    } while (0)
+
+static const char* create_config(void) {
+    static char config_path[] = "/tmp/mc_multiget_test.conf";
+
+    FILE* f = fopen(config_path, "w");
+    if (f) {
+        fprintf(f, "# Multi-get Test Configuration\n");
+        fprintf(f, "local_node_id=0\n");
+        fprintf(f, "num_nodes=1\n");
+        fprintf(f, "node0=127.0.0.1:5100:0x0:1073741824\n");
+        fclose(f);
+        return config_path;
+    }
+    return NULL;
+}
+
+static mc_interceptor_t* make_interceptor(pgas_context_t* ctx, bool batching, int batch_size) {
+    mc_interceptor_config_t config = {
+        .enable_cxl_disaggregation = true,
+        .local_cache_size = 0,
+        .cxl_memory_size = 1ULL << 20,
+        .enable_batching = batching,
+        .batch_size = batch_size,
+        .batch_timeout_us = 1000000,
+        .consistency_model = PGAS_CONSISTENCY_RELEASE,
+        .hash_table_size = 1024,
+        .hash_seed = 0x9747b28c
+    };
+
+    mc_interceptor_t* interceptor = NULL;
+    if (mc_interceptor_init(&interceptor, ctx, &config) != 0) return NULL;
+    return interceptor;
+}
+
+static void store(mc_interceptor_t* interceptor, const char* key, const char* value,
+                  uint32_t flags) {
+    mc_request_t req = {
+        .op = MC_OP_SET,
+        .key = (char*)key,
+        .key_len = strlen(key),
+        .value = (void*)value,
+        .value_len = strlen(value),
+        .flags = flags
+    };
+    mc_response_t resp;
+    mc_handle_request(interceptor, &req, &resp);
+    CHECK(resp.success, "set %s", key);
+}
+
+// Runs cmds through the front end; returns the output (caller frees)
+static char* run(mc_interceptor_t* interceptor, const char* cmds, long* consumed) {
+    char* out_buf = NULL;
+    size_t out_len = 0;
+    FILE* out = open_memstream(&out_buf, &out_len);
+    *consumed = mc_process_commands(interceptor, cmds, strlen(cmds), out);
+    fclose(out);
+    return out_buf;
+}
+
+static void populate(mc_interceptor_t* interceptor) {
+    // cas_unique is assigned in store order starting at 1
+    store(interceptor, "k0", "zero", 0);
+    store(interceptor, "k1", "one", 1);
+    store(interceptor, "k2", "two", 2);
+    store(interceptor, "k3", "three", 3);
+    store(interceptor, "k5", "five", 5);
+    store(interceptor, "k8", "eight", 8);
+}
+
+static const char* k_pipeline =
+    "get k0 missing k1 k2\r\n"
+    "gets k3 k4\r\n"
+    "get\r\n"
+    "get k8 nope k5 k0 k3 k2 k1\r\n"
+    "get absent\r\n"
+    "set k9 0 0 4\r\n"
+    "nine\r\n";
+
+static const char* k_expected =
+    "VALUE k0 0 4\r\nzero\r\n"
+    "VALUE k1 1 3\r\none\r\n"
+    "VALUE k2 2 3\r\ntwo\r\n"
+    "END\r\n"
+    "VALUE k3 3 5 4\r\nthree\r\n"
+    "END\r\n"
+    "ERROR\r\n"
+    "VALUE k8 8 5\r\neight\r\n"
+    "VALUE k5 5 4\r\nfive\r\n"
+    "VALUE k0 0 4\r\nzero\r\n"
+    "VALUE k3 3 5\r\nthree\r\n"
+    "VALUE k2 2 3\r\ntwo\r\n"
+    "VALUE k1 1 3\r\none\r\n"
+    "END\r\n"
+    "END\r\n";
+
+static void test_pipeline(pgas_context_t* ctx, bool batching, int batch_size) {
+    printf("\n=== Pipelined gets (batching=%d, batch_size=%d) ===\n", batching, batch_size);
+
+    mc_interceptor_t* interceptor = make_interceptor(ctx, batching, batch_size);
+    CHECK(interceptor != NULL, "interceptor init");
+    if (!interceptor) return;
+    populate(interceptor);
+
+    long consumed = 0;
+    char* out = run(interceptor, k_pipeline, &consumed);
+
+    long expected_consumed = (long)(strstr(k_pipeline, "set ") - k_pipeline);
+    CHECK(consumed == expected_consumed, "consumed %ld, expected %ld", consumed,
+          expected_consumed);
+    CHECK(strcmp(out, k_expected) == 0, "output mismatch:\n%s", out);
+    free(out);
+
+    // A trailing partial line is left for the next read
+    out = run(interceptor, "get k1\r\nget k2", &consumed);
+    CHECK(consumed == 8, "consumed %ld with a partial line", consumed);
+    CHECK(strcmp(out, "VALUE k1 1 3\r\none\r\nEND\r\n") == 0, "partial-line output:\n%s", out);
+    free(out);
+
+    mc_interceptor_stats_t stats;
+    mc_interceptor_get_stats(interceptor, &stats);
+    CHECK(stats.cache_hits == 11, "hits %lu", stats.cache_hits);
+    CHECK(stats.cache_misses == 4, "misses %lu", stats.cache_misses);
+
+    mc_interceptor_finalize(interceptor);
+    printf("  Status: %s\n", g_errors == 0 ? "PASSED" : "FAILED");
+}
+
+int main(void) {
+    printf("========================================\n");
+    printf("  Multi-get Test\n");
+    printf("  memcached-cxl-pgas Test Suite\n");
+    printf("========================================\n\n");
+
+    const char* config_file = create_config();
+    if (!config_file) {
+        fprintf(stderr, "Failed to create config\n");
+        return 1;
+    }
+
+    pgas_context_t ctx;
+    if (pgas_init(&ctx, config_file) != 0) {
+        printf("  Note: PGAS init may show warnings for single-node test\n");
+    }
+
+    test_pipeline(&ctx, true, 16);
+    test_pipeline(&ctx, true, 3);
+    test_pipeline(&ctx, true, 1);
+    test_pipeline(&ctx, false, 16);
+
+    pgas_finalize(&ctx);
+
+    if (g_errors == 0) {
+        printf("\n  All tests PASSED\n");
+    } else {
+        printf("\n  Tests FAILED with %d errors\n", g_errors);
+    }
+    return g_errors > 0 ? 1 : 0;
+}
@@ -5,6 +5,7 @@
  * - Local memory allocation and access
  * - PGAS put/get operations
  * - Atomic operations (fetch-add, CAS)
+ * - Vectorized batch get
  * - Memory bandwidth measurements
  *
  * This test validates CXL memory functionality when running
@@ -406,6 +407,75 @@ static test_result_t test_bandwidth(pgas_context_t* ctx) {
     return result;
 }
 
+/*
+ * Test 6: Vectorized get (pgas_get_batch) against scalar puts
+ */
+#define BATCH_GET_OPS 32
+
+static test_result_t test_batch_get(pgas_context_t* ctx) {
+    test_result_t result = {
+        .name = "Self-Loop Batch Get Test",
+        .passed = 0,
+        .errors = 0,
+        .elapsed_sec = 0,
+        .throughput = 0,
+        .throughput_unit = "K batches/sec"
+    };
+
+    int iterations = g_config.iterations / 100;
+    if (iterations < 1) iterations = 1;
+
+    pgas_ptr_t base_ptr = pgas_alloc(ctx, BATCH_GET_OPS * sizeof(uint64_t), PGAS_AFFINITY_LOCAL);
+    if (pgas_ptr_is_null(base_ptr)) {
+        printf("  ERROR: Failed to allocate values\n");
+        result.errors = 1;
+        return result;
+    }
+
+    uint64_t values[BATCH_GET_OPS];
+    pgas_get_op_t ops[BATCH_GET_OPS];
+
+    double start = get_time_sec();
+
+    for (int iter = 0; iter < iterations; iter++) {
+        for (int i = 0; i < BATCH_GET_OPS; i++) {
+            uint64_t write_val = (uint64_t)iter * BATCH_GET_OPS + i;
+            pgas_put(ctx, pgas_ptr_add(base_ptr, i * sizeof(uint64_t)),
+                     &write_val, sizeof(uint64_t));
+        }
+        pgas_fence(ctx, PGAS_CONSISTENCY_SEQ_CST);
+
+        /* Read back in reverse order so dest/src pairing is exercised */
+        for (int i = 0; i < BATCH_GET_OPS; i++) {
+            int slot = BATCH_GET_OPS - 1 - i;
+            values[i] = 0;
+            ops[i].dest = &values[i];
+            ops[i].src = pgas_ptr_add(base_ptr, slot * sizeof(uint64_t));
+            ops[i].size = sizeof(uint64_t);
+        }
+
+        result.errors += pgas_get_batch(ctx, ops, BATCH_GET_OPS);
+
+        for (int i = 0; i < BATCH_GET_OPS; i++) {
+            uint64_t expected = (uint64_t)iter * BATCH_GET_OPS + (BATCH_GET_OPS - 1 - i);
+            if (values[i] != expected) {
+                result.errors++;
+                if (result.errors <= 5) {
+                    printf("  ERROR at iter %d op %d: expected %lu, got %lu\n",
+                           iter, i, expected, values[i]);
+                }
+            }
+        }
+    }
+
+    result.elapsed_sec = get_time_sec() - start;
+    result.throughput = (iterations / result.elapsed_sec) / 1e3;
+    result.passed = (result.errors == 0);
+
+    pgas_free(ctx, base_ptr);
+    return result;
+}
+
 /*
  * Print usage information
  */
@@ -532,7 +602,7 @@ int main(int argc, char* argv[]) {
     printf("  Total nodes: %d\n", pgas_num_nodes(&ctx));
 
     /* Run tests */
-    test_result_t results[5];
+    test_result_t results[6];
     int num_tests = 0;
     int total_errors = 0;
 
@@ -556,6 +626,10 @@ int main(int argc, char* argv[]) {
     print_result(&results[num_tests - 1]);
     total_errors += results[num_tests - 1].errors;
 
+    results[num_tests++] = test_batch_get(&ctx);
+    print_result(&results[num_tests - 1]);
+    total_errors += results[num_tests - 1].errors;
+
     /* Print PGAS stats */
     printf("\n=== PGAS Statistics ===\n");
     pgas_stats_t stats;
@@ -1,160 +1,1324 @@
+// Native open-loop YCSB load generator for memcached.
+//
+// Each worker thread drives its own set of non-blocking connections through
+// epoll and keeps up to --pipeline requests in flight on each of them. With
+// --rate the generator is open-loop: requests are scheduled at fixed (or
+// Poisson) intended start times, and latency is measured from the intended
+// start rather than the actual send, so client-side queueing when the server
+// falls behind is charged to the server (coordinated-omission correction).
+// Without --rate every pipeline is kept full (closed loop).
+//
+// Key choice and operation mixes follow YCSB core workloads A-F, including
+// the zipfian, scrambled-zipfian and latest request distributions and
+// hashed "user<N>" keys. Scans (workload E) become one multi-key get over
+// consecutive records, since memcached has no range reads.
+//
+// Latencies go into per-thread log-linear histograms that are merged at the
+// end; results are printed in YCSB's "[OP], Metric, value" format and can be
+// written as HdrHistogram percentile distributions (.hgrm) with --hdr-out.
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include <fstream>
-#include <iostream>
-#include <regex>
+#include <deque>
+#include <memory>
 #include <string>
 #include <thread>
+#include <vector>
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Configuration
+// ---------------------------------------------------------------------------
+
+enum class Protocol { Text, Binary };
+enum class Distribution { Uniform, Zipfian, ScrambledZipfian, Latest };
+enum OpType { OP_READ = 0, OP_UPDATE, OP_INSERT, OP_SCAN, OP_RMW, OP_COUNT };
+
+const char *const kOpNames[OP_COUNT] = {"READ", "UPDATE", "INSERT", "SCAN", "READ-MODIFY-WRITE"};
+
+struct WorkloadSpec {
+	double read = 0, update = 0, insert = 0, scan = 0, rmw = 0;
+	Distribution distribution = Distribution::ScrambledZipfian;
+};
+
+struct Options {
+	std::string host = "127.0.0.1";
+	int port = 11211;
+	char workload = 'a';
+	Protocol protocol = Protocol::Text;
+	uint64_t record_count = 1000000;
+	uint64_t operation_count = 0;  // 0: run for --duration
+	double duration_sec = 10;
+	double warmup_sec = 0;
+	int threads = 4;
+	int connections = 4;           // per thread
+	int pipeline = 16;             // in-flight requests per connection
+	double rate = 0;               // total target ops/s, 0 = closed loop
+	bool poisson = false;
+	double theta = 0.99;
+	int value_size = 1000;
+	int max_scan_length = 100;
+	bool load = false;
+	bool run = true;
+	std::string distribution;      // override the workload default
+	std::string hdr_out;           // prefix for .hgrm files
+};
+
+WorkloadSpec workload_spec(char workload)
+{
+	WorkloadSpec w;
+	switch (workload) {
+	case 'a':
+		w.read = 0.5;
+		w.update = 0.5;
+		break;
+	case 'b':
+		w.read = 0.95;
+		w.update = 0.05;
+		break;
+	case 'c':
+		w.read = 1.0;
+		break;
+	case 'd':
+		w.read = 0.95;
+		w.insert = 0.05;
+		w.distribution = Distribution::Latest;
+		break;
+	case 'e':
+		w.scan = 0.95;
+		w.insert = 0.05;
+		break;
+	case 'f':
+		w.read = 0.5;
+		w.rmw = 0.5;
+		break;
+	default:
+		fprintf(stderr, "Unknown workload '%c' (expected a-f)\n", workload);
+		exit(EXIT_FAILURE);
+	}
+	return w;
+}
+
+// ---------------------------------------------------------------------------
+// Random numbers and key generation (YCSB-compatible)
+// ---------------------------------------------------------------------------
+
+inline uint64_t now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		       std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+// xoshiro256**: cheap enough to call several times per request
+class Rng {
+    public:
+	explicit Rng(uint64_t seed)
+	{
+		for (auto &word : s_) {
+			seed += 0x9e3779b97f4a7c15ULL;
+			uint64_t z = seed;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			word = z ^ (z >> 31);
+		}
+	}
+
+	uint64_t next()
+	{
+		uint64_t result = rotl(s_[1] * 5, 7) * 9;
+		uint64_t t = s_[1] << 17;
+		s_[2] ^= s_[0];
+		s_[3] ^= s_[1];
+		s_[1] ^= s_[2];
+		s_[0] ^= s_[3];
+		s_[2] ^= t;
+		s_[3] = rotl(s_[3], 45);
+		return result;
+	}
+
+	double next_double() { return (next() >> 11) * 0x1.0p-53; }
+
+	uint64_t uniform(uint64_t n) { return next() % n; }
+
+    private:
+	static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+	uint64_t s_[4];
+};
+
+// YCSB Utils.fnvhash64
+inline uint64_t fnvhash64(uint64_t val)
+{
+	int64_t hashval = static_cast<int64_t>(0xCBF29CE484222325ULL);
+	for (int i = 0; i < 8; i++) {
+		int64_t octet = val & 0xff;
+		val >>= 8;
+		hashval ^= octet;
+		hashval = static_cast<int64_t>(static_cast<uint64_t>(hashval) * 1099511628211ULL);
+	}
+	return static_cast<uint64_t>(hashval < 0 ? -hashval : hashval);
+}
+
+inline int format_key(char *buf, uint64_t keynum)
+{
+	return snprintf(buf, 32, "user%llu", static_cast<unsigned long long>(fnvhash64(keynum)));
+}
+
+// Gray et al. "Quickly generating billion-record synthetic databases", as
+// used by YCSB's ZipfianGenerator and by Tigon's common/Zipf.h. The item
+// count may grow (latest distribution); zeta is then extended incrementally.
+class ZipfianGenerator {
+    public:
+	ZipfianGenerator(uint64_t items, double theta, double zetan = 0)
+		: items_(items), theta_(theta)
+	{
+		alpha_ = 1.0 / (1.0 - theta_);
+		zeta2_ = zeta(0, 2, 0);
+		zetan_ = zetan > 0 ? zetan : zeta(0, items_, 0);
+		update_eta();
+	}
+
+	uint64_t next(Rng &rng) { return next(rng, items_); }
+
+	uint64_t next(Rng &rng, uint64_t items)
+	{
+		if (items > items_) {
+			zetan_ = zeta(items_, items, zetan_);
+			items_ = items;
+			update_eta();
+		}
+
+		double u = rng.next_double();
+		double uz = u * zetan_;
+		if (uz < 1.0)
+			return 0;
+		if (uz < 1.0 + std::pow(0.5, theta_))
+			return 1;
+		uint64_t v = static_cast<uint64_t>(items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+		return std::min(v, items_ - 1);
+	}
+
+    private:
+	double zeta(uint64_t from, uint64_t to, double initial) const
+	{
+		double sum = initial;
+		for (uint64_t i = from; i < to; i++) {
+			sum += 1.0 / std::pow(static_cast<double>(i + 1), theta_);
+		}
+		return sum;
+	}
+
+	void update_eta()
+	{
+		eta_ = (1.0 - std::pow(2.0 / items_, 1.0 - theta_)) / (1.0 - zeta2_ / zetan_);
+	}
+
+	uint64_t items_;
+	double theta_;
+	double alpha_;
+	double zeta2_;
+	double zetan_;
+	double eta_;
+};
+
+// YCSB ScrambledZipfianGenerator constants: zipfian over 10^10 items with
+// theta 0.99, hashed down to the record count
+constexpr uint64_t kScrambledItemCount = 10000000000ULL;
+constexpr double kScrambledZetan = 26.46902820178302;
+
+class KeyChooser {
+    public:
+	KeyChooser(Distribution dist, uint64_t records, double theta)
+		: dist_(dist), records_(records)
+	{
+		switch (dist_) {
+		case Distribution::Zipfian:
+		case Distribution::Latest:
+			zipf_.reset(new ZipfianGenerator(records_, theta));
+			break;
+		case Distribution::ScrambledZipfian:
+			if (theta == 0.99) {
+				zipf_.reset(new ZipfianGenerator(kScrambledItemCount, theta, kScrambledZetan));
+			} else {
+				zipf_.reset(new ZipfianGenerator(records_, theta));
+			}
+			break;
+		case Distribution::Uniform:
+			break;
+		}
+	}
+
+	// inserted: records that exist right now (grows under inserts)
+	uint64_t next(Rng &rng, uint64_t inserted)
+	{
+		switch (dist_) {
+		case Distribution::Uniform:
+			return rng.uniform(inserted);
+		case Distribution::Zipfian:
+			return zipf_->next(rng, inserted) % inserted;
+		case Distribution::ScrambledZipfian:
+			return fnvhash64(zipf_->next(rng)) % inserted;
+		case Distribution::Latest:
+			return inserted - 1 - zipf_->next(rng, inserted);
+		}
+		return 0;
+	}
+
+    private:
+	Distribution dist_;
+	uint64_t records_;
+	std::unique_ptr<ZipfianGenerator> zipf_;
+};
+
+// ---------------------------------------------------------------------------
+// Latency histogram (HDR-style log-linear buckets, ~0.8% relative error)
+// ---------------------------------------------------------------------------
+
+class LatencyHistogram {
+    public:
+	static constexpr int kSubBucketBits = 7;
+	static constexpr uint64_t kSubBuckets = 1ULL << kSubBucketBits;
+	static constexpr int kMaxBits = 40;  // ~18 minutes in ns
+	static constexpr size_t kNumBuckets = static_cast<size_t>(kMaxBits - kSubBucketBits + 1)
+					      << kSubBucketBits;
+
+	LatencyHistogram() : buckets_(kNumBuckets, 0) {}
+
+	void record(uint64_t ns)
+	{
+		buckets_[index(ns)]++;
+		count_++;
+		sum_ += ns;
+		sum_sq_ += static_cast<double>(ns) * ns;
+		max_ = std::max(max_, ns);
+	}
+
+	void merge(const LatencyHistogram &other)
+	{
+		for (size_t i = 0; i < kNumBuckets; i++) {
+			buckets_[i] += other.buckets_[i];
+		}
+		count_ += other.count_;
+		sum_ += other.sum_;
+		sum_sq_ += other.sum_sq_;
+		max_ = std::max(max_, other.max_);
+	}
+
+	uint64_t count() const { return count_; }
+	uint64_t max() const { return max_; }
+	double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0; }
+
+	double stddev() const
+	{
+		if (count_ == 0)
+			return 0;
+		double m = mean();
+		return std::sqrt(std::max(0.0, sum_sq_ / count_ - m * m));
+	}
+
+	uint64_t percentile(double pct) const
+	{
+		if (count_ == 0)
+			return 0;
+		uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(pct / 100.0 * count_)));
+		uint64_t seen = 0;
+		for (size_t i = 0; i < kNumBuckets; i++) {
+			seen += buckets_[i];
+			if (seen >= target)
+				return std::min(value_at(i), max_);
+		}
+		return max_;
+	}
+
+	// HdrHistogram outputPercentileDistribution format, values in us
+	void write_hgrm(FILE *out) const
+	{
+		fprintf(out, "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+		uint64_t seen = 0;
+		for (size_t i = 0; i < kNumBuckets; i++) {
+			if (buckets_[i] == 0)
+				continue;
+			seen += buckets_[i];
+			double pct = static_cast<double>(seen) / count_;
+			if (pct < 1.0) {
+				fprintf(out, "%12.3f %2.12f %10llu %14.2f\n", std::min(value_at(i), max_) / 1000.0, pct,
+					static_cast<unsigned long long>(seen), 1.0 / (1.0 - pct));
+			} else {
+				fprintf(out, "%12.3f %2.12f %10llu\n", max_ / 1000.0, pct,
+					static_cast<unsigned long long>(seen));
+			}
+		}
+		fprintf(out, "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean() / 1000.0, stddev() / 1000.0);
+		fprintf(out, "#[Max     = %12.3f, Total count    = %12llu]\n", max_ / 1000.0,
+			static_cast<unsigned long long>(count_));
+		fprintf(out, "#[Buckets = %12d, SubBuckets     = %12llu]\n", kMaxBits - kSubBucketBits + 1,
+			static_cast<unsigned long long>(kSubBuckets));
+	}
+
+    private:
+	static size_t index(uint64_t ns)
+	{
+		if (ns < 2 * kSubBuckets)
+			return static_cast<size_t>(ns);
+		if (ns >= (1ULL << kMaxBits))
+			ns = (1ULL << kMaxBits) - 1;
+		int shift = 63 - __builtin_clzll(ns) - kSubBucketBits;
+		return (static_cast<size_t>(shift + 1) << kSubBucketBits) + static_cast<size_t>((ns >> shift) - kSubBuckets);
+	}
+
+	// Highest value that maps to bucket idx
+	static uint64_t value_at(size_t idx)
+	{
+		if (idx < 2 * kSubBuckets)
+			return idx;
+		int shift = static_cast<int>(idx >> kSubBucketBits) - 1;
+		uint64_t top = (idx & (kSubBuckets - 1)) + kSubBuckets;
+		return ((top + 1) << shift) - 1;
+	}
+
+	std::vector<uint64_t> buckets_;
+	uint64_t count_ = 0;
+	uint64_t sum_ = 0;
+	double sum_sq_ = 0;
+	uint64_t max_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// memcached protocol encoding/decoding
+// ---------------------------------------------------------------------------
+
+namespace binproto {
+constexpr uint8_t kMagicRequest = 0x80;
+constexpr uint8_t kMagicResponse = 0x81;
+constexpr uint8_t kGet = 0x00;
+constexpr uint8_t kSet = 0x01;
+constexpr uint8_t kNoop = 0x0a;
+constexpr uint8_t kGetQ = 0x09;
+constexpr size_t kHeaderSize = 24;
+
+struct Header {
+	uint8_t magic;
+	uint8_t opcode;
+	uint16_t key_length;
+	uint8_t extras_length;
+	uint8_t data_type;
+	uint16_t status;  // vbucket id in requests
+	uint32_t body_length;
+	uint32_t opaque;
+	uint64_t cas;
+} __attribute__((packed));
+
+static_assert(sizeof(Header) == kHeaderSize, "binary protocol header is 24 bytes");
+
+inline void append_request(std::string &out, uint8_t opcode, const char *key, size_t key_len,
+			   const char *extras, size_t extras_len, const char *value, size_t value_len)
+{
+	Header h = {};
+	h.magic = kMagicRequest;
+	h.opcode = opcode;
+	h.key_length = htons(static_cast<uint16_t>(key_len));
+	h.extras_length = static_cast<uint8_t>(extras_len);
+	h.body_length = htonl(static_cast<uint32_t>(extras_len + key_len + value_len));
+	out.append(reinterpret_cast<const char *>(&h), sizeof(h));
+	out.append(extras, extras_len);
+	out.append(key, key_len);
+	out.append(value, value_len);
+}
+} // namespace binproto
+
+struct Request {
+	uint64_t intended_ns;  // open-loop schedule (== sent_ns in closed loop)
+	uint64_t sent_ns;
+	uint64_t keynum;
+	OpType op;
+	bool is_write;         // SET part of an op (RMW second half, update, insert)
+	bool measured;         // false during warmup and for load-phase inserts
+};
+
+enum class ParseResult { NeedMore, Done, Error };
+
+struct Connection {
+	int fd = -1;
+	std::string out;
+	size_t out_off = 0;
+	std::vector<char> in;
+	size_t in_begin = 0;
+	size_t in_end = 0;
+	std::deque<Request> inflight;
+	bool want_write = false;
+	uint32_t scan_hits = 0;
+
+	Connection() : in(1 << 16) {}
+};
+
+class ProtocolCodec {
+    public:
+	ProtocolCodec(Protocol protocol, int value_size)
+		: protocol_(protocol), value_(value_size, 'x')
+	{
+	}
+
+	void encode_get(std::string &out, const char *key, int key_len) const
+	{
+		if (protocol_ == Protocol::Text) {
+			out.append("get ", 4);
+			out.append(key, key_len);
+			out.append("\r\n", 2);
+		} else {
+			binproto::append_request(out, binproto::kGet, key, key_len, nullptr, 0, nullptr, 0);
+		}
+	}
+
+	// Text: "get k1 k2 ...". Binary: GETQ per key, NOOP as terminator.
+	void encode_multiget(std::string &out, uint64_t first, int count) const
+	{
+		char key[32];
+		if (protocol_ == Protocol::Text) {
+			out.append("get", 3);
+			for (int i = 0; i < count; i++) {
+				int len = format_key(key, first + i);
+				out.push_back(' ');
+				out.append(key, len);
+			}
+			out.append("\r\n", 2);
+		} else {
+			for (int i = 0; i < count; i++) {
+				int len = format_key(key, first + i);
+				binproto::append_request(out, binproto::kGetQ, key, len, nullptr, 0, nullptr, 0);
+			}
+			binproto::append_request(out, binproto::kNoop, nullptr, 0, nullptr, 0, nullptr, 0);
+		}
+	}
+
+	void encode_set(std::string &out, const char *key, int key_len) const
+	{
+		if (protocol_ == Protocol::Text) {
+			char hdr[64];
+			int n = snprintf(hdr, sizeof(hdr), " 0 0 %zu\r\n", value_.size());
+			out.append("set ", 4);
+			out.append(key, key_len);
+			out.append(hdr, n);
+			out.append(value_);
+			out.append("\r\n", 2);
+		} else {
+			uint32_t extras[2] = {0, 0};  // flags, exptime
+			binproto::append_request(out, binproto::kSet, key, key_len,
+						 reinterpret_cast<const char *>(extras), sizeof(extras),
+						 value_.data(), value_.size());
+		}
+	}
+
+	// Consumes one complete response for req from buf[begin, end); returns
+	// the bytes consumed through *used. *hit is set for reads that found data.
+	ParseResult parse(const Request &req, bool multi, const char *buf, size_t len, size_t *used,
+			  bool *hit) const
+	{
+		return protocol_ == Protocol::Text ? parse_text(req, multi, buf, len, used, hit)
+						   : parse_binary(multi, buf, len, used, hit);
+	}
+
+    private:
+	static const char *find_crlf(const char *p, const char *end)
+	{
+		for (; p + 1 < end; p++) {
+			if (p[0] == '\r' && p[1] == '\n')
+				return p;
+		}
+		return nullptr;
+	}
+
+	ParseResult parse_text(const Request &req, bool multi, const char *buf, size_t len, size_t *used,
+			       bool *hit) const
+	{
+		(void)multi;
+		const char *p = buf;
+		const char *end = buf + len;
+		*hit = false;
 
-// 用于管理系统进程的类
-class ProcessManager {
-private:
-    int memcached_pid = -1;
-    int ycsb_pid = -1;
-    std::string latency_file = "latency_output.txt";
-
-public:
-    // 启动memcached进程 (使用system而不是fork)
-    bool start_memcached() {
-        std::cout << "启动memcached服务..." << std::endl;
-
-        // 将命令放入后台运行并保存PID
-        std::string cmd = "memcached -p 11211 -u try > /dev/null 2>&1 & echo $!";
-        FILE *pipe = popen(cmd.c_str(), "r");
-        if (!pipe) {
-            std::cerr << "无法执行memcached命令" << std::endl;
-            return false;
-        }
-
-        char buffer[128];
-        std::string result = "";
-        while (!feof(pipe)) {
-            if (fgets(buffer, 128, pipe) != NULL)
-                result += buffer;
-        }
-        pclose(pipe);
-
-        memcached_pid = std::stoi(result);
-        std::cout << "memcached进程已启动，PID: " << memcached_pid << std::endl;
-
-        // 等待服务启动
-        std::this_thread::sleep_for(std::chrono::seconds(2));
-        return true;
-    }
-
-    // 运行YCSB客户端
-    bool run_ycsb() {
-        std::cout << "启动YCSB客户端..." << std::endl;
-
-        // 切换到YCSB目录
-        chdir("../workloads/YCSB");
-
-        // 运行YCSB并重定向输出到文件
-        std::string cmd = "./bin/ycsb run memcached -s -P ./workloads/workloadb -p "
-                          "memcached.hosts=127.0.0.1 > " +
-                          latency_file + " 2>&1 & echo $!";
-        FILE *pipe = popen(cmd.c_str(), "r");
-        if (!pipe) {
-            std::cerr << "无法执行YCSB命令" << std::endl;
-            return false;
-        }
-
-        char buffer[128];
-        std::string result = "";
-        while (!feof(pipe)) {
-            if (fgets(buffer, 128, pipe) != NULL)
-                result += buffer;
-        }
-        pclose(pipe);
-
-        ycsb_pid = std::stoi(result);
-        std::cout << "YCSB进程已启动，PID: " << ycsb_pid << std::endl;
-        return true;
-    }
-
-    // 等待YCSB完成
-    bool wait_for_ycsb() {
-        if (ycsb_pid <= 0)
-            return false;
-
-        std::cout << "等待YCSB客户端完成..." << std::endl;
-
-        std::string cmd = "ps -p " + std::to_string(ycsb_pid) + " > /dev/null 2>&1";
-        while (system(cmd.c_str()) == 0) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-        }
-
-        std::cout << "YCSB客户端已完成" << std::endl;
-        return true;
-    }
-
-    // 解析延迟结果
-    void parse_latency_results() {
-        std::cout << "\n--- 延迟结果 ---\n";
-
-        std::ifstream file(latency_file);
-        if (!file.is_open()) {
-            std::cerr << "无法打开文件: " << latency_file << std::endl;
-            return;
-        }
-
-        std::string line;
-        std::regex latency_pattern("(AverageLatency|PercentileLatency)");
-
-        while (std::getline(file, line)) {
-            if (std::regex_search(line, latency_pattern)) {
-                std::cout << line << std::endl;
-            }
-        }
-
-        file.close();
-    }
-
-    // 停止memcached进程
-    void stop_memcached() {
-        if (memcached_pid <= 0)
-            return;
-
-        std::cout << "停止memcached服务 (PID: " << memcached_pid << ")..." << std::endl;
-        std::string cmd = "kill " + std::to_string(memcached_pid);
-        system(cmd.c_str());
-
-        // 确认进程已终止
-        cmd = "ps -p " + std::to_string(memcached_pid) + " > /dev/null 2>&1";
-        while (system(cmd.c_str()) == 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        }
-
-        std::cout << "memcached服务已停止" << std::endl;
-    }
-
-    // 清理资源
-    ~ProcessManager() { stop_memcached(); }
+		if (req.is_write) {
+			const char *eol = find_crlf(p, end);
+			if (!eol)
+				return ParseResult::NeedMore;
+			*used = eol + 2 - buf;
+			return std::strncmp(p, "STORED", 6) == 0 ? ParseResult::Done : ParseResult::Error;
+		}
+
+		// VALUE <key> <flags> <bytes> [<cas>]\r\n<data>\r\n ... END\r\n
+		for (;;) {
+			const char *eol = find_crlf(p, end);
+			if (!eol)
+				return ParseResult::NeedMore;
+			size_t line_len = eol - p;
+
+			if (line_len == 3 && std::memcmp(p, "END", 3) == 0) {
+				*used = eol + 2 - buf;
+				return ParseResult::Done;
+			}
+			if (line_len < 6 || std::memcmp(p, "VALUE ", 6) != 0) {
+				*used = eol + 2 - buf;
+				return ParseResult::Error;
+			}
+
+			// <bytes> is the fourth token
+			const char *tok = p;
+			for (int spaces = 0; spaces < 3 && tok < eol; tok++) {
+				if (*tok == ' ')
+					spaces++;
+			}
+			size_t bytes = std::strtoull(tok, nullptr, 10);
+			const char *next = eol + 2 + bytes + 2;
+			if (next > end)
+				return ParseResult::NeedMore;
+			*hit = true;
+			p = next;
+		}
+	}
+
+	ParseResult parse_binary(bool multi, const char *buf, size_t len, size_t *used, bool *hit) const
+	{
+		size_t off = 0;
+		*hit = false;
+
+		for (;;) {
+			if (len - off < binproto::kHeaderSize)
+				return ParseResult::NeedMore;
+
+			binproto::Header h;
+			std::memcpy(&h, buf + off, sizeof(h));
+			size_t total = binproto::kHeaderSize + ntohl(h.body_length);
+			if (len - off < total)
+				return ParseResult::NeedMore;
+			if (h.magic != binproto::kMagicResponse) {
+				*used = off + total;
+				return ParseResult::Error;
+			}
+
+			off += total;
+			bool ok = ntohs(h.status) == 0;
+
+			if (!multi) {
+				*used = off;
+				*hit = ok && h.opcode == binproto::kGet;
+				// A GET miss (KEY_ENOENT) is a valid answer, not an error
+				return ok || h.opcode == binproto::kGet ? ParseResult::Done : ParseResult::Error;
+			}
+			if (h.opcode == binproto::kNoop) {
+				*used = off;
+				return ParseResult::Done;
+			}
+			*hit = *hit || ok;
+		}
+	}
+
+	Protocol protocol_;
+	std::string value_;
 };
 
-int main(int argc, char *argv[]) {
-    ProcessManager pm;
+// ---------------------------------------------------------------------------
+// Worker threads
+// ---------------------------------------------------------------------------
+
+struct alignas(64) ThreadStats {
+	LatencyHistogram corrected[OP_COUNT];    // from intended start
+	LatencyHistogram uncorrected[OP_COUNT];  // from actual send
+	std::atomic<uint64_t> completed{0};
+	uint64_t read_misses = 0;
+	uint64_t errors = 0;
+};
+
+struct SharedState {
+	const Options *opts;
+	WorkloadSpec spec;
+	ProtocolCodec *codec;
+	sockaddr_storage addr;
+	socklen_t addr_len;
+	std::atomic<uint64_t> inserted;      // next key number to insert
+	std::atomic<uint64_t> acknowledged;  // keys below this have been stored
+	std::atomic<bool> stop{false};
+	uint64_t measure_start_ns = 0;   // end of warmup
+};
+
+class Worker {
+    public:
+	Worker(SharedState *shared, ThreadStats *stats, int id, bool load_phase, uint64_t load_begin,
+	       uint64_t load_end)
+		: shared_(shared), opts_(*shared->opts), stats_(stats), rng_(0x5eed0000ULL + id),
+		  keys_(shared->spec.distribution, opts_.record_count, opts_.theta), load_phase_(load_phase),
+		  load_next_(load_begin), load_end_(load_end)
+	{
+		if (!load_phase_) {
+			int threads = std::max(1, opts_.threads);
+			if (opts_.operation_count > 0) {
+				quota_ = opts_.operation_count / threads +
+					 (static_cast<uint64_t>(id) < opts_.operation_count % threads ? 1 : 0);
+			}
+			if (opts_.rate > 0) {
+				interarrival_ns_ = 1e9 * threads / opts_.rate;
+			}
+		}
+	}
+
+	~Worker()
+	{
+		for (auto &conn : conns_) {
+			if (conn.fd >= 0)
+				close(conn.fd);
+		}
+		if (epfd_ >= 0)
+			close(epfd_);
+	}
+
+	bool connect_all()
+	{
+		epfd_ = epoll_create1(0);
+		if (epfd_ < 0)
+			return false;
+
+		conns_.resize(opts_.connections);
+		for (size_t i = 0; i < conns_.size(); i++) {
+			int fd = socket(shared_->addr.ss_family, SOCK_STREAM, 0);
+			if (fd < 0)
+				return false;
+			if (connect(fd, reinterpret_cast<sockaddr *>(&shared_->addr), shared_->addr_len) != 0) {
+				perror("connect");
+				close(fd);
+				return false;
+			}
+			int one = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+			fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+			conns_[i].fd = fd;
+
+			epoll_event ev = {};
+			ev.events = EPOLLIN;
+			ev.data.u64 = i;
+			epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev);
+		}
+		return true;
+	}
+
+	void run()
+	{
+		uint64_t start = now_ns();
+		next_intended_ = start;
+		std::vector<epoll_event> events(conns_.size());
+
+		while (!finished()) {
+			uint64_t now = now_ns();
+			issue(now);
+			flush();
+
+			int timeout_ms = 1;
+			if (interarrival_ns_ > 0 && !issuing_done()) {
+				// Busy-poll when the next arrival is under a millisecond away
+				timeout_ms = next_intended_ <= now + 1000000 ? 0 : 1;
+			}
+			int n = epoll_wait(epfd_, events.data(), static_cast<int>(events.size()), timeout_ms);
+			for (int i = 0; i < n; i++) {
+				Connection &conn = conns_[events[i].data.u64];
+				if (events[i].events & EPOLLOUT)
+					flush_one(conn);
+				if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+					if (!receive(conn)) {
+						stats_->errors += conn.inflight.size();
+						conn.inflight.clear();
+						close(conn.fd);
+						conn.fd = -1;
+					}
+				}
+			}
+		}
+	}
+
+    private:
+	bool issuing_done() const
+	{
+		if (load_phase_)
+			return load_next_ >= load_end_;
+		if (shared_->stop.load(std::memory_order_relaxed))
+			return true;
+		return quota_ > 0 && issued_ >= quota_;
+	}
+
+	bool finished() const
+	{
+		if (!issuing_done())
+			return false;
+		for (const auto &conn : conns_) {
+			if (conn.fd >= 0 && !conn.inflight.empty())
+				return false;
+		}
+		return true;
+	}
+
+	Connection *next_connection()
+	{
+		for (size_t tries = 0; tries < conns_.size(); tries++) {
+			Connection &conn = conns_[rr_];
+			rr_ = (rr_ + 1) % conns_.size();
+			if (conn.fd >= 0 && conn.inflight.size() < static_cast<size_t>(opts_.pipeline))
+				return &conn;
+		}
+		return nullptr;
+	}
+
+	void issue(uint64_t now)
+	{
+		if (interarrival_ns_ > 0) {
+			// Open loop: everything due by now is issued. If all pipelines are
+			// full the schedule keeps advancing, and the wait is charged to
+			// the requests when they complete.
+			while (!issuing_done() && next_intended_ <= now) {
+				Connection *conn = next_connection();
+				if (!conn)
+					break;
+				issue_one(*conn, next_intended_, now);
+				next_intended_ += opts_.poisson ? static_cast<uint64_t>(-std::log(1.0 - rng_.next_double()) *
+										      interarrival_ns_)
+								: static_cast<uint64_t>(interarrival_ns_);
+			}
+		} else {
+			Connection *conn;
+			while (!issuing_done() && (conn = next_connection()) != nullptr) {
+				issue_one(*conn, now, now);
+			}
+		}
+	}
+
+	OpType choose_op()
+	{
+		const WorkloadSpec &w = shared_->spec;
+		double r = rng_.next_double();
+		if ((r -= w.read) < 0)
+			return OP_READ;
+		if ((r -= w.update) < 0)
+			return OP_UPDATE;
+		if ((r -= w.insert) < 0)
+			return OP_INSERT;
+		if ((r -= w.scan) < 0)
+			return OP_SCAN;
+		return OP_RMW;
+	}
+
+	void issue_one(Connection &conn, uint64_t intended, uint64_t now)
+	{
+		char key[32];
+		Request req = {};
+		req.intended_ns = intended;
+		req.sent_ns = now;
+		req.measured = !load_phase_ && now >= shared_->measure_start_ns;
+
+		if (load_phase_) {
+			req.op = OP_INSERT;
+			req.is_write = true;
+			req.keynum = load_next_++;
+			shared_->codec->encode_set(conn.out, key, format_key(key, req.keynum));
+			conn.inflight.push_back(req);
+			return;
+		}
+
+		issued_++;
+		req.op = choose_op();
+		// Only choose among acknowledged inserts (YCSB's AcknowledgedCounterGenerator)
+		// so the latest distribution does not read keys still in flight
+		uint64_t existing = shared_->acknowledged.load(std::memory_order_relaxed);
+
+		switch (req.op) {
+		case OP_INSERT:
+			req.keynum = shared_->inserted.fetch_add(1, std::memory_order_relaxed);
+			req.is_write = true;
+			shared_->codec->encode_set(conn.out, key, format_key(key, req.keynum));
+			break;
+		case OP_UPDATE:
+			req.keynum = keys_.next(rng_, existing);
+			req.is_write = true;
+			shared_->codec->encode_set(conn.out, key, format_key(key, req.keynum));
+			break;
+		case OP_SCAN: {
+			req.keynum = keys_.next(rng_, existing);
+			uint64_t len = 1 + rng_.uniform(opts_.max_scan_length);
+			len = std::min<uint64_t>(len, existing - req.keynum);
+			shared_->codec->encode_multiget(conn.out, req.keynum, static_cast<int>(len));
+			break;
+		}
+		case OP_READ:
+		case OP_RMW:
+		default:
+			req.keynum = keys_.next(rng_, existing);
+			shared_->codec->encode_get(conn.out, key, format_key(key, req.keynum));
+			break;
+		}
+		conn.inflight.push_back(req);
+	}
+
+	void flush()
+	{
+		for (auto &conn : conns_) {
+			if (conn.fd >= 0 && conn.out_off < conn.out.size() && !conn.want_write)
+				flush_one(conn);
+		}
+	}
+
+	void flush_one(Connection &conn)
+	{
+		while (conn.out_off < conn.out.size()) {
+			ssize_t n = send(conn.fd, conn.out.data() + conn.out_off, conn.out.size() - conn.out_off,
+					 MSG_NOSIGNAL);
+			if (n < 0) {
+				if (errno == EAGAIN || errno == EWOULDBLOCK)
+					break;
+				return;
+			}
+			conn.out_off += n;
+		}
+
+		bool pending = conn.out_off < conn.out.size();
+		if (!pending) {
+			conn.out.clear();
+			conn.out_off = 0;
+		}
+		if (pending != conn.want_write) {
+			epoll_event ev = {};
+			ev.events = pending ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+			ev.data.u64 = &conn - conns_.data();
+			epoll_ctl(epfd_, EPOLL_CTL_MOD, conn.fd, &ev);
+			conn.want_write = pending;
+		}
+	}
+
+	bool receive(Connection &conn)
+	{
+		for (;;) {
+			if (conn.in_begin == conn.in_end) {
+				conn.in_begin = conn.in_end = 0;
+			} else if (conn.in_end == conn.in.size()) {
+				if (conn.in_begin > 0) {
+					std::memmove(conn.in.data(), conn.in.data() + conn.in_begin, conn.in_end - conn.in_begin);
+					conn.in_end -= conn.in_begin;
+					conn.in_begin = 0;
+				} else {
+					conn.in.resize(conn.in.size() * 2);
+				}
+			}
+
+			ssize_t n = recv(conn.fd, conn.in.data() + conn.in_end, conn.in.size() - conn.in_end, 0);
+			if (n == 0)
+				return false;
+			if (n < 0)
+				return errno == EAGAIN || errno == EWOULDBLOCK;
+			conn.in_end += n;
+			consume(conn);
+		}
+	}
+
+	void consume(Connection &conn)
+	{
+		uint64_t now = 0;
+		while (!conn.inflight.empty()) {
+			Request &req = conn.inflight.front();
+			size_t used = 0;
+			bool hit = false;
+			ParseResult r = shared_->codec->parse(req, req.op == OP_SCAN && !req.is_write,
+							      conn.in.data() + conn.in_begin, conn.in_end - conn.in_begin,
+							      &used, &hit);
+			if (r == ParseResult::NeedMore)
+				return;
+			conn.in_begin += used;
+			if (now == 0)
+				now = now_ns();
+
+			if (r == ParseResult::Error) {
+				stats_->errors++;
+			} else if (!req.is_write && !hit) {
+				stats_->read_misses++;
+			}
+
+			// RMW: the write goes out after the read completes, keeping the
+			// original intended start so the whole op is measured end to end
+			if (req.op == OP_RMW && !req.is_write) {
+				Request write = req;
+				write.is_write = true;
+				char key[32];
+				shared_->codec->encode_set(conn.out, key, format_key(key, write.keynum));
+				conn.inflight.push_back(write);
+				conn.inflight.pop_front();
+				continue;
+			}
+
+			if (req.op == OP_INSERT && !load_phase_)
+				acknowledge(req.keynum);
+
+			if (req.measured) {
+				stats_->corrected[req.op].record(now - req.intended_ns);
+				stats_->uncorrected[req.op].record(now - req.sent_ns);
+			}
+			stats_->completed.fetch_add(1, std::memory_order_relaxed);
+			conn.inflight.pop_front();
+		}
+	}
+
+	// Inserts complete out of order across threads; the watermark only
+	// advances, which can briefly expose a key whose SET is still in flight
+	void acknowledge(uint64_t keynum)
+	{
+		uint64_t cur = shared_->acknowledged.load(std::memory_order_relaxed);
+		while (keynum + 1 > cur &&
+		       !shared_->acknowledged.compare_exchange_weak(cur, keynum + 1, std::memory_order_relaxed)) {
+		}
+	}
+
+	SharedState *shared_;
+	const Options &opts_;
+	ThreadStats *stats_;
+	Rng rng_;
+	KeyChooser keys_;
+	bool load_phase_;
+	uint64_t load_next_;
+	uint64_t load_end_;
+	uint64_t quota_ = 0;
+	uint64_t issued_ = 0;
+	double interarrival_ns_ = 0;
+	uint64_t next_intended_ = 0;
+	int epfd_ = -1;
+	size_t rr_ = 0;
+	std::vector<Connection> conns_;
+};
+
+// ---------------------------------------------------------------------------
+// Driver
+// ---------------------------------------------------------------------------
+
+double run_phase(SharedState &shared, std::vector<std::unique_ptr<ThreadStats>> &stats, bool load_phase)
+{
+	const Options &opts = *shared.opts;
+	std::vector<std::unique_ptr<Worker>> workers;
+	stats.clear();
+
+	for (int t = 0; t < opts.threads; t++) {
+		stats.emplace_back(new ThreadStats());
+		uint64_t begin = opts.record_count * t / opts.threads;
+		uint64_t end = opts.record_count * (t + 1) / opts.threads;
+		workers.emplace_back(new Worker(&shared, stats.back().get(), t, load_phase, begin, end));
+		if (!workers.back()->connect_all()) {
+			fprintf(stderr, "Failed to connect to %s:%d\n", opts.host.c_str(), opts.port);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	shared.stop.store(false);
+	uint64_t start = now_ns();
+	shared.measure_start_ns = load_phase ? start : start + static_cast<uint64_t>(opts.warmup_sec * 1e9);
+
+	std::vector<std::thread> threads;
+	for (auto &w : workers) {
+		threads.emplace_back([&w] { w->run(); });
+	}
+
+	// Progress once a second; also enforces --duration for the run phase
+	std::atomic<bool> done{false};
+	std::thread monitor([&] {
+		uint64_t last = 0;
+		uint64_t last_ns = start;
+		while (!done.load()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			uint64_t now = now_ns();
+			if (!load_phase && opts.operation_count == 0 &&
+			    now - start >= static_cast<uint64_t>((opts.warmup_sec + opts.duration_sec) * 1e9)) {
+				shared.stop.store(true);
+			}
+			if (now - last_ns >= 1000000000ULL) {
+				uint64_t total = 0;
+				for (auto &s : stats)
+					total += s->completed.load(std::memory_order_relaxed);
+				fprintf(stderr, "%s %6.1f sec: %llu operations; %.0f current ops/sec\n",
+					load_phase ? "[LOAD]" : "[RUN]", (now - start) / 1e9,
+					static_cast<unsigned long long>(total), (total - last) * 1e9 / (now - last_ns));
+				last = total;
+				last_ns = now;
+			}
+		}
+	});
+
+	for (auto &t : threads)
+		t.join();
+	done.store(true);
+	monitor.join();
+
+	uint64_t end = now_ns();
+	return (end - std::max(start, shared.measure_start_ns)) / 1e9;
+}
+
+void report(const Options &opts, std::vector<std::unique_ptr<ThreadStats>> &stats, double runtime_sec)
+{
+	LatencyHistogram corrected[OP_COUNT];
+	LatencyHistogram uncorrected[OP_COUNT];
+	uint64_t misses = 0, errors = 0, total = 0;
+
+	for (auto &s : stats) {
+		for (int op = 0; op < OP_COUNT; op++) {
+			corrected[op].merge(s->corrected[op]);
+			uncorrected[op].merge(s->uncorrected[op]);
+		}
+		misses += s->read_misses;
+		errors += s->errors;
+	}
+	for (int op = 0; op < OP_COUNT; op++)
+		total += corrected[op].count();
+
+	printf("[OVERALL], RunTime(ms), %.0f\n", runtime_sec * 1000);
+	printf("[OVERALL], Throughput(ops/sec), %.2f\n", runtime_sec > 0 ? total / runtime_sec : 0.0);
+	if (opts.rate > 0)
+		printf("[OVERALL], TargetThroughput(ops/sec), %.2f\n", opts.rate);
+	printf("[OVERALL], ReadMisses, %llu\n", static_cast<unsigned long long>(misses));
+	printf("[OVERALL], Errors, %llu\n", static_cast<unsigned long long>(errors));
+
+	auto print_op = [](const char *name, const LatencyHistogram &h) {
+		printf("[%s], Operations, %llu\n", name, static_cast<unsigned long long>(h.count()));
+		printf("[%s], AverageLatency(us), %.3f\n", name, h.mean() / 1000.0);
+		printf("[%s], MinLatency(us), %.3f\n", name, h.percentile(0) / 1000.0);
+		printf("[%s], MaxLatency(us), %.3f\n", name, h.max() / 1000.0);
+		printf("[%s], 50thPercentileLatency(us), %.3f\n", name, h.percentile(50) / 1000.0);
+		printf("[%s], 95thPercentileLatency(us), %.3f\n", name, h.percentile(95) / 1000.0);
+		printf("[%s], 99thPercentileLatency(us), %.3f\n", name, h.percentile(99) / 1000.0);
+		printf("[%s], 99.9PercentileLatency(us), %.3f\n", name, h.percentile(99.9) / 1000.0);
+		printf("[%s], 99.99PercentileLatency(us), %.3f\n", name, h.percentile(99.99) / 1000.0);
+	};
+
+	for (int op = 0; op < OP_COUNT; op++) {
+		if (corrected[op].count() == 0)
+			continue;
+		print_op(kOpNames[op], corrected[op]);
+		if (opts.rate > 0) {
+			std::string name = std::string(kOpNames[op]) + "-UNCORRECTED";
+			print_op(name.c_str(), uncorrected[op]);
+		}
+
+		if (!opts.hdr_out.empty()) {
+			std::string path = opts.hdr_out + "." + kOpNames[op] + ".hgrm";
+			FILE *f = fopen(path.c_str(), "w");
+			if (f) {
+				corrected[op].write_hgrm(f);
+				fclose(f);
+			} else {
+				fprintf(stderr, "Cannot write %s\n", path.c_str());
+			}
+		}
+	}
+}
+
+void print_usage(const char *prog)
+{
+	printf("Usage: %s [options]\n\n", prog);
+	printf("Open-loop YCSB load generator for memcached\n\n");
+	printf("Options:\n");
+	printf("  -H, --host HOST          Server host (default: 127.0.0.1)\n");
+	printf("  -p, --port PORT          Server port (default: 11211)\n");
+	printf("  -w, --workload {a..f}    YCSB core workload (default: a)\n");
+	printf("  -B, --binary             Use the binary protocol (default: text)\n");
+	printf("  -r, --records N          Record count (default: 1000000)\n");
+	printf("  -n, --operations N       Operations to run (default: use --duration)\n");
+	printf("  -d, --duration SEC       Run time when --operations is 0 (default: 10)\n");
+	printf("      --warmup SEC         Unmeasured warmup before --duration (default: 0)\n");
+	printf("  -t, --threads N          Worker threads (default: 4)\n");
+	printf("  -c, --connections N      Connections per thread (default: 4)\n");
+	printf("  -P, --pipeline N         In-flight requests per connection (default: 16)\n");
+	printf("  -R, --rate OPS           Open-loop target ops/s in total (default: closed loop)\n");
+	printf("      --poisson            Exponential inter-arrival times in open loop\n");
+	printf("      --distribution D     uniform|zipfian|scrambled|latest (default: per workload)\n");
+	printf("      --theta T            Zipfian constant (default: 0.99)\n");
+	printf("      --value-size BYTES   Value size (default: 1000)\n");
+	printf("      --max-scan N         Max scan length for workload e (default: 100)\n");
+	printf("  -l, --load               Insert all records before running\n");
+	printf("      --load-only          Insert all records and exit\n");
+	printf("  -o, --hdr-out PREFIX     Write PREFIX.<OP>.hgrm latency distributions\n");
+	printf("  -h, --help               Show this help message\n");
+}
+
+Options parse_args(int argc, char *argv[])
+{
+	enum { OPT_WARMUP = 256, OPT_POISSON, OPT_DIST, OPT_THETA, OPT_VALUE, OPT_SCAN, OPT_LOAD_ONLY };
+	static const option long_options[] = {
+		{"host", required_argument, nullptr, 'H'},
+		{"port", required_argument, nullptr, 'p'},
+		{"workload", required_argument, nullptr, 'w'},
+		{"binary", no_argument, nullptr, 'B'},
+		{"records", required_argument, nullptr, 'r'},
+		{"operations", required_argument, nullptr, 'n'},
+		{"duration", required_argument, nullptr, 'd'},
+		{"warmup", required_argument, nullptr, OPT_WARMUP},
+		{"threads", required_argument, nullptr, 't'},
+		{"connections", required_argument, nullptr, 'c'},
+		{"pipeline", required_argument, nullptr, 'P'},
+		{"rate", required_argument, nullptr, 'R'},
+		{"poisson", no_argument, nullptr, OPT_POISSON},
+		{"distribution", required_argument, nullptr, OPT_DIST},
+		{"theta", required_argument, nullptr, OPT_THETA},
+		{"value-size", required_argument, nullptr, OPT_VALUE},
+		{"max-scan", required_argument, nullptr, OPT_SCAN},
+		{"load", no_argument, nullptr, 'l'},
+		{"load-only", no_argument, nullptr, OPT_LOAD_ONLY},
+		{"hdr-out", required_argument, nullptr, 'o'},
+		{"help", no_argument, nullptr, 'h'},
+		{nullptr, 0, nullptr, 0},
+	};
+
+	Options opts;
+	int opt;
+	while ((opt = getopt_long(argc, argv, "H:p:w:Br:n:d:t:c:P:R:lo:h", long_options, nullptr)) != -1) {
+		switch (opt) {
+		case 'H':
+			opts.host = optarg;
+			break;
+		case 'p':
+			opts.port = atoi(optarg);
+			break;
+		case 'w':
+			opts.workload = static_cast<char>(tolower(optarg[0]));
+			break;
+		case 'B':
+			opts.protocol = Protocol::Binary;
+			break;
+		case 'r':
+			opts.record_count = strtoull(optarg, nullptr, 10);
+			break;
+		case 'n':
+			opts.operation_count = strtoull(optarg, nullptr, 10);
+			break;
+		case 'd':
+			opts.duration_sec = atof(optarg);
+			break;
+		case OPT_WARMUP:
+			opts.warmup_sec = atof(optarg);
+			break;
+		case 't':
+			opts.threads = atoi(optarg);
+			break;
+		case 'c':
+			opts.connections = atoi(optarg);
+			break;
+		case 'P':
+			opts.pipeline = atoi(optarg);
+			break;
+		case 'R':
+			opts.rate = atof(optarg);
+			break;
+		case OPT_POISSON:
+			opts.poisson = true;
+			break;
+		case OPT_DIST:
+			opts.distribution = optarg;
+			break;
+		case OPT_THETA:
+			opts.theta = atof(optarg);
+			break;
+		case OPT_VALUE:
+			opts.value_size = atoi(optarg);
+			break;
+		case OPT_SCAN:
+			opts.max_scan_length = atoi(optarg);
+			break;
+		case 'l':
+			opts.load = true;
+			break;
+		case OPT_LOAD_ONLY:
+			opts.load = true;
+			opts.run = false;
+			break;
+		case 'o':
+			opts.hdr_out = optarg;
+			break;
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			exit(opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+	}
+
+	if (opts.threads < 1 || opts.connections < 1 || opts.pipeline < 1 || opts.record_count == 0 ||
+	    opts.max_scan_length < 1 || opts.value_size < 0) {
+		fprintf(stderr, "Invalid arguments\n");
+		exit(EXIT_FAILURE);
+	}
+	return opts;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+	Options opts = parse_args(argc, argv);
+
+	SharedState shared;
+	shared.opts = &opts;
+	shared.spec = workload_spec(opts.workload);
+	shared.inserted.store(opts.record_count);
+	shared.acknowledged.store(opts.record_count);
+
+	if (!opts.distribution.empty()) {
+		if (opts.distribution == "uniform")
+			shared.spec.distribution = Distribution::Uniform;
+		else if (opts.distribution == "zipfian")
+			shared.spec.distribution = Distribution::Zipfian;
+		else if (opts.distribution == "scrambled")
+			shared.spec.distribution = Distribution::ScrambledZipfian;
+		else if (opts.distribution == "latest")
+			shared.spec.distribution = Distribution::Latest;
+		else {
+			fprintf(stderr, "Unknown distribution: %s\n", opts.distribution.c_str());
+			return EXIT_FAILURE;
+		}
+	}
 
-    // 1. 启动memcached
-    if (!pm.start_memcached()) {
-        std::cerr << "启动memcached失败，退出程序" << std::endl;
-        return EXIT_FAILURE;
-    }
+	addrinfo hints = {};
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo *res = nullptr;
+	std::string port = std::to_string(opts.port);
+	if (getaddrinfo(opts.host.c_str(), port.c_str(), &hints, &res) != 0 || !res) {
+		fprintf(stderr, "Cannot resolve %s\n", opts.host.c_str());
+		return EXIT_FAILURE;
+	}
+	std::memcpy(&shared.addr, res->ai_addr, res->ai_addrlen);
+	shared.addr_len = res->ai_addrlen;
+	freeaddrinfo(res);
 
-    // 2. 运行YCSB客户端
-    if (!pm.run_ycsb()) {
-        std::cerr << "启动YCSB客户端失败，退出程序" << std::endl;
-        return EXIT_FAILURE;
-    }
+	ProtocolCodec codec(opts.protocol, opts.value_size);
+	shared.codec = &codec;
 
-    // 3. 等待YCSB客户端完成
-    pm.wait_for_ycsb();
+	std::vector<std::unique_ptr<ThreadStats>> stats;
 
-    // 4. 解析延迟结果
-    pm.parse_latency_results();
+	if (opts.load) {
+		double secs = run_phase(shared, stats, true);
+		uint64_t errors = 0;
+		for (auto &s : stats)
+			errors += s->errors;
+		printf("[LOAD], RunTime(ms), %.0f\n", secs * 1000);
+		printf("[LOAD], Throughput(ops/sec), %.2f\n", secs > 0 ? opts.record_count / secs : 0.0);
+		printf("[LOAD], Errors, %llu\n", static_cast<unsigned long long>(errors));
+	}
 
-    // 5. ProcessManager的析构函数会自动停止memcached
+	if (opts.run) {
+		double secs = run_phase(shared, stats, false);
+		report(opts, stats, secs);
+	}
 
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+	return EXIT_SUCCESS;
+}
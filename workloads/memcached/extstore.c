@@ -11,11 +11,15 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/uio.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include "extstore.h"
 
 // TODO: better if an init option turns this on/off.
@@ -65,6 +69,7 @@ typedef struct _store_page {
     unsigned int bucket; /* which bucket the page is linked into */
     unsigned int free_bucket; /* which bucket this page returns to when freed */
     int fd;
+    char *base; /* page start within a mapped file, NULL if using fd IO */
     unsigned short id;
     bool active; /* actively being written to */
     bool closed; /* closed and draining before free */
@@ -167,6 +172,7 @@ static uint64_t _next_version(store_engine *e) {
 
 static void *extstore_io_thread(void *arg);
 static void *extstore_maint_thread(void *arg);
+static void _read_mapped(store_engine *e, obj_io *io);
 
 /* Copies stats internal to engine and computes any derived values */
 void extstore_get_stats(void *ptr, struct extstore_stats *st) {
@@ -224,6 +230,9 @@ const char *extstore_err(enum extstore_res res) {
         case EXTSTORE_INIT_OPEN_FAIL:
             rv = "failed to open file";
             break;
+        case EXTSTORE_INIT_MMAP_FAIL:
+            rv = "failed to mmap file";
+            break;
         case EXTSTORE_INIT_THREAD_FAIL:
             break;
     }
@@ -287,11 +296,38 @@ void *extstore_init(struct extstore_conf_file *fh, struct extstore_conf *cf,
             free(e);
             return NULL;
         }
-        if (ftruncate(f->fd, 0) < 0) {
+        // DAX character devices (ie; /dev/dax0.0 on a CXL memory expander)
+        // can't be truncated or read through the page cache; they are always
+        // mapped. Regular files are mapped only if asked to.
+        struct stat sb;
+        if (fstat(f->fd, &sb) < 0) {
             *res = EXTSTORE_INIT_OPEN_FAIL;
             free(e);
             return NULL;
         }
+        size_t map_len = (size_t)f->page_count * e->page_size;
+        if (!S_ISCHR(sb.st_mode)) {
+            if (ftruncate(f->fd, 0) < 0 ||
+                    (cf->mmap && ftruncate(f->fd, map_len) < 0)) {
+                *res = EXTSTORE_INIT_OPEN_FAIL;
+                free(e);
+                return NULL;
+            }
+        }
+        f->base = NULL;
+        if (cf->mmap || S_ISCHR(sb.st_mode)) {
+            void *base = mmap(NULL, map_len, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, f->fd, 0);
+            if (base == MAP_FAILED) {
+                *res = EXTSTORE_INIT_MMAP_FAIL;
+#ifdef EXTSTORE_DEBUG
+                perror("extstore mmap");
+#endif
+                free(e);
+                return NULL;
+            }
+            f->base = base;
+        }
 
         temp_page_count += f->page_count;
         f->offset = 0;
@@ -331,6 +367,7 @@ void *extstore_init(struct extstore_conf_file *fh, struct extstore_conf *cf,
         pthread_mutex_init(&e->pages[i].mutex, NULL);
         e->pages[i].id = i;
         e->pages[i].fd = f->fd;
+        e->pages[i].base = f->base ? f->base + f->offset : NULL;
         e->pages[i].free_bucket = f->free_bucket;
         e->pages[i].offset = f->offset;
         e->pages[i].free = true;
@@ -473,21 +510,13 @@ static void _allocate_wbuf(store_engine *e, store_page *p) {
     }
 }
 
-/* callback after wbuf is flushed. can only remove wbuf's from the head onward
- * if successfully flushed, which complicates this routine. each callback
- * attempts to free the wbuf stack, which is finally done when the head wbuf's
- * callback happens.
- * It's rare flushes would happen out of order.
+/* marks a wbuf as written out and returns it (and its IO, if one was used)
+ * to the engine.
+ * call with *p locked. locks *e
  */
-static void _wbuf_cb(void *ep, obj_io *io, int ret) {
-    store_engine *e = (store_engine *)ep;
-    store_page *p = &e->pages[io->page_id];
-    _store_wbuf *w = (_store_wbuf *) io->data;
-
-    // TODO: Examine return code. Not entirely sure how to handle errors.
-    // Naive first-pass should probably cause the page to close/free.
+static void _wbuf_flushed(store_engine *e, store_page *p, _store_wbuf *w,
+        obj_io *io) {
     w->flushed = true;
-    pthread_mutex_lock(&p->mutex);
     assert(p->wbuf != NULL && p->wbuf == w);
     assert(p->written == w->offset);
     p->written += w->size;
@@ -501,25 +530,80 @@ static void _wbuf_cb(void *ep, obj_io *io, int ret) {
     w->next = e->wbuf_stack;
     e->wbuf_stack = w;
     // also return the IO we just used.
-    io->next = e->io_stack;
-    e->io_stack = io;
+    if (io) {
+        io->next = e->io_stack;
+        e->io_stack = io;
+    }
     pthread_mutex_unlock(&e->mutex);
+}
+
+/* callback after wbuf is flushed. can only remove wbuf's from the head onward
+ * if successfully flushed, which complicates this routine. each callback
+ * attempts to free the wbuf stack, which is finally done when the head wbuf's
+ * callback happens.
+ * It's rare flushes would happen out of order.
+ */
+static void _wbuf_cb(void *ep, obj_io *io, int ret) {
+    store_engine *e = (store_engine *)ep;
+    store_page *p = &e->pages[io->page_id];
+    _store_wbuf *w = (_store_wbuf *) io->data;
+
+    // TODO: Examine return code. Not entirely sure how to handle errors.
+    // Naive first-pass should probably cause the page to close/free.
+    pthread_mutex_lock(&p->mutex);
+    _wbuf_flushed(e, p, w, io);
     pthread_mutex_unlock(&p->mutex);
 }
 
+/* Copies a full wbuf into a mapped page. Streaming (non-temporal) stores keep
+ * megabytes of cold data from flushing the cache on the way out, and the
+ * fence orders them ahead of the page's written offset moving forward, which
+ * is what lets readers go to the mapping.
+ */
+static void _copy_to_map(char *dst, const char *src, size_t len) {
+#ifdef __SSE2__
+    if (((uintptr_t)dst & 15) == 0) {
+        size_t x;
+        for (x = 0; x + 64 <= len; x += 64) {
+            __m128i a = _mm_loadu_si128((const __m128i *)(src + x));
+            __m128i b = _mm_loadu_si128((const __m128i *)(src + x + 16));
+            __m128i c = _mm_loadu_si128((const __m128i *)(src + x + 32));
+            __m128i d = _mm_loadu_si128((const __m128i *)(src + x + 48));
+            _mm_stream_si128((__m128i *)(dst + x), a);
+            _mm_stream_si128((__m128i *)(dst + x + 16), b);
+            _mm_stream_si128((__m128i *)(dst + x + 32), c);
+            _mm_stream_si128((__m128i *)(dst + x + 48), d);
+        }
+        if (x < len)
+            memcpy(dst + x, src + x, len - x);
+        _mm_sfence();
+        return;
+    }
+#endif
+    memcpy(dst, src, len);
+    __sync_synchronize();
+}
+
 /* Wraps pages current wbuf in an io and submits to IO thread.
+ * Mapped pages are written directly instead, completing before return.
  * Called with p locked, locks e.
  */
 static void _submit_wbuf(store_engine *e, store_page *p) {
-    _store_wbuf *w;
+    _store_wbuf *w = p->wbuf;
+
+    // zero out the end of the wbuf to allow blind readback of data.
+    memset(w->buf + (w->size - w->free), 0, w->free);
+
+    if (p->base) {
+        _copy_to_map(p->base + w->offset, w->buf, w->size);
+        _wbuf_flushed(e, p, w, NULL);
+        return;
+    }
+
     pthread_mutex_lock(&e->mutex);
     obj_io *io = e->io_stack;
     e->io_stack = io->next;
     pthread_mutex_unlock(&e->mutex);
-    w = p->wbuf;
-
-    // zero out the end of the wbuf to allow blind readback of data.
-    memset(w->buf + (w->size - w->free), 0, w->free);
 
     io->next = NULL;
     io->mode = OBJ_IO_WRITE;
@@ -575,7 +659,9 @@ int extstore_write_request(void *ptr, unsigned int bucket,
     // if io won't fit, submit IO for wbuf and find new one.
     if (p->wbuf && p->wbuf->free < io->len && !p->wbuf->full) {
         _submit_wbuf(e, p);
-        p->wbuf->full = true;
+        // mapped pages flush inline and have already released the wbuf.
+        if (p->wbuf)
+            p->wbuf->full = true;
     }
 
     if (!p->wbuf && p->allocated < e->page_size) {
@@ -619,7 +705,8 @@ void extstore_write(void *ptr, obj_io *io) {
 }
 
 /* engine submit function; takes engine, item_io stack.
- * lock io_thread context and add stack?
+ * reads against mapped pages are copied out and called back right here.
+ * lock io_thread context and add the rest of the stack?
  * signal io thread to wake.
  * return success.
  */
@@ -629,12 +716,28 @@ int extstore_submit(void *ptr, obj_io *io) {
     unsigned int depth = 0;
     obj_io *tio = io;
     obj_io *tail = NULL;
+    io = NULL;
     while (tio != NULL) {
-        tail = tio; // keep updating potential tail.
-        depth++;
-        tio = tio->next;
+        // note next before the callback in case the obj_io gets reused.
+        obj_io *next = tio->next;
+        if (tio->mode == OBJ_IO_READ && e->pages[tio->page_id].base) {
+            _read_mapped(e, tio);
+        } else {
+            tio->next = NULL;
+            if (tail) {
+                tail->next = tio;
+            } else {
+                io = tio;
+            }
+            tail = tio; // keep updating potential tail.
+            depth++;
+        }
+        tio = next;
     }
 
+    if (io == NULL)
+        return 0;
+
     store_io_thread *t = _get_io_thread(e);
     pthread_mutex_lock(&t->mutex);
 
@@ -721,6 +824,46 @@ void extstore_close_page(void *ptr, unsigned int page_id, uint64_t page_version)
     pthread_mutex_unlock(&p->mutex);
 }
 
+char *extstore_page_pin(void *ptr, unsigned int page_id, uint64_t page_version) {
+    store_engine *e = (store_engine *)ptr;
+    store_page *p = &e->pages[page_id];
+    char *base = NULL;
+
+    pthread_mutex_lock(&p->mutex);
+    if (p->base && !p->free && !p->closed && p->version == page_version) {
+        p->refcount++;
+        base = p->base;
+    }
+    pthread_mutex_unlock(&p->mutex);
+    return base;
+}
+
+void extstore_page_unpin(void *ptr, unsigned int page_id) {
+    store_engine *e = (store_engine *)ptr;
+    store_page *p = &e->pages[page_id];
+
+    pthread_mutex_lock(&p->mutex);
+    assert(p->refcount > 0);
+    p->refcount--;
+    pthread_mutex_unlock(&p->mutex);
+}
+
+// copies an object out of a contiguous buffer into the io's buffer or iovecs.
+static inline int _read_from_buf(const char *src, obj_io *io) {
+    if (io->iov == NULL) {
+        memcpy(io->buf, src, io->len);
+    } else {
+        int x;
+        // need to loop fill iovecs
+        for (x = 0; x < io->iovcnt; x++) {
+            struct iovec *iov = &io->iov[x];
+            memcpy(iov->iov_base, src, iov->iov_len);
+            src += iov->iov_len;
+        }
+    }
+    return io->len;
+}
+
 /* Finds an attached wbuf that can satisfy the read.
  * Since wbufs can potentially be flushed to disk out of order, they are only
  * removed as the head of the list successfully flushes to disk.
@@ -731,19 +874,46 @@ static inline int _read_from_wbuf(store_page *p, obj_io *io) {
     _store_wbuf *wbuf = p->wbuf;
     assert(wbuf != NULL);
     assert(io->offset < p->written + wbuf->size);
-    if (io->iov == NULL) {
-        memcpy(io->buf, wbuf->buf + (io->offset - wbuf->offset), io->len);
-    } else {
-        int x;
-        unsigned int off = io->offset - wbuf->offset;
-        // need to loop fill iovecs
-        for (x = 0; x < io->iovcnt; x++) {
-            struct iovec *iov = &io->iov[x];
-            memcpy(iov->iov_base, wbuf->buf + off, iov->iov_len);
-            off += iov->iov_len;
+    return _read_from_buf(wbuf->buf + (io->offset - wbuf->offset), io);
+}
+
+/* Serves a read from a mapped page in the submitting thread, with the same
+ * validity checks as the IO thread. The page is only referenced, not locked,
+ * while copying so large reads don't stall writers to the same page.
+ * The callback runs inline.
+ */
+static void _read_mapped(store_engine *e, obj_io *io) {
+    store_page *p = &e->pages[io->page_id];
+    int ret;
+    bool pinned = false;
+
+    pthread_mutex_lock(&p->mutex);
+    if (!p->free && !p->closed && p->version == io->page_version) {
+        if (p->active && io->offset >= p->written) {
+            ret = _read_from_wbuf(p, io);
+        } else {
+            p->refcount++;
+            pinned = true;
         }
+        STAT_L(e);
+        e->stats.bytes_read += io->len;
+        e->stats.objects_read++;
+        STAT_UL(e);
+    } else {
+        ret = -2;
+    }
+    pthread_mutex_unlock(&p->mutex);
+
+    if (pinned) {
+        ret = _read_from_buf(p->base + io->offset, io);
+    }
+
+    io->cb(e, io, ret);
+    if (pinned) {
+        pthread_mutex_lock(&p->mutex);
+        p->refcount--;
+        pthread_mutex_unlock(&p->mutex);
     }
-    return io->len;
 }
 
 /* engine IO thread; takes engine context
@@ -50,6 +50,7 @@ struct extstore_conf {
     unsigned int wbuf_count; // this might get locked to "2 per active page"
     unsigned int io_threadcount;
     unsigned int io_depth; // with normal I/O, hits locks less. req'd for AIO
+    bool mmap; // map files into memory; reads and flushes skip the IO threads
 };
 
 struct extstore_conf_file {
@@ -57,6 +58,7 @@ struct extstore_conf_file {
     char *file;
     int fd; // internal usage
     uint64_t offset; // internal usage
+    char *base; // internal usage: mapping, if byte-addressable
     unsigned int bucket; // free page bucket
     unsigned int free_bucket; // specialized free bucket
     struct extstore_conf_file *next;
@@ -97,6 +99,7 @@ enum extstore_res {
     EXTSTORE_INIT_TOO_MANY_PAGES,
     EXTSTORE_INIT_OOM,
     EXTSTORE_INIT_OPEN_FAIL,
+    EXTSTORE_INIT_MMAP_FAIL,
     EXTSTORE_INIT_THREAD_FAIL
 };
 
@@ -118,5 +121,12 @@ void extstore_get_stats(void *ptr, struct extstore_stats *st);
 void extstore_get_page_data(void *ptr, struct extstore_stats *st);
 void extstore_run_maint(void *ptr);
 void extstore_close_page(void *ptr, unsigned int page_id, uint64_t page_version);
+/* For pages backed by a mapping (ext_mmap or a DAX device), returns a pointer
+ * to the page's contents and holds a reference so the page can't be freed.
+ * Returns NULL if the page isn't mapped or the version has moved on.
+ * Must be paired with extstore_page_unpin().
+ */
+char *extstore_page_pin(void *ptr, unsigned int page_id, uint64_t page_version);
+void extstore_page_unpin(void *ptr, unsigned int page_id);
 
 #endif
@@ -48,15 +48,25 @@ typedef struct {
     uint64_t hits_to_warm;
     uint64_t hits_to_cold;
     uint64_t hits_to_temp;
+    uint64_t moves_to_cxl;   /* COLD tail demoted into the CXL tier */
+    uint64_t moves_from_cxl; /* CXL hits promoted back to WARM */
+    uint64_t cxl_evicted;
+    uint64_t cxl_reclaimed;
     uint64_t mem_requested;
     rel_time_t evicted_time;
 } itemstats_t;
 
-static item *heads[LARGEST_ID];
-static item *tails[LARGEST_ID];
+/* Items living in the CXL tier get one extra queue per slab class, placed
+ * after the regular LRUs. They keep COLD_LRU in slabs_clsid, so the COLD
+ * lock for their class guards this queue too. */
+#define CXL_LRU_ID(clsid) (LARGEST_ID + (clsid))
+#define NUM_LRU_QUEUES (LARGEST_ID + MAX_NUMBER_OF_SLAB_CLASSES)
+
+static item *heads[NUM_LRU_QUEUES];
+static item *tails[NUM_LRU_QUEUES];
 static itemstats_t itemstats[LARGEST_ID];
-static unsigned int sizes[LARGEST_ID];
-static uint64_t sizes_bytes[LARGEST_ID];
+static unsigned int sizes[NUM_LRU_QUEUES];
+static uint64_t sizes_bytes[NUM_LRU_QUEUES];
 static unsigned int *stats_sizes_hist = NULL;
 static uint64_t stats_sizes_cas_min = 0;
 static int stats_sizes_buckets = 0;
@@ -417,12 +427,18 @@ void do_item_link_fixup(item *it) {
     return;
 }
 
+/* Queue an item is linked into: its LRU, or its class's CXL queue */
+static inline unsigned int item_queue_id(item *it) {
+    return slabs_is_cxl(it) ? CXL_LRU_ID(ITEM_clsid(it)) : it->slabs_clsid;
+}
+
 static void do_item_link_q(item *it) { /* item is the new head */
     item **head, **tail;
+    unsigned int qid = item_queue_id(it);
     assert((it->it_flags & ITEM_SLABBED) == 0);
 
-    head = &heads[it->slabs_clsid];
-    tail = &tails[it->slabs_clsid];
+    head = &heads[qid];
+    tail = &tails[qid];
     assert(it != *head);
     assert((*head && *tail) || (*head == 0 && *tail == 0));
     it->prev = 0;
@@ -430,15 +446,15 @@ static void do_item_link_q(item *it) { /* item is the new head */
     if (it->next) it->next->prev = it;
     *head = it;
     if (*tail == 0) *tail = it;
-    sizes[it->slabs_clsid]++;
+    sizes[qid]++;
 #ifdef EXTSTORE
     if (it->it_flags & ITEM_HDR) {
-        sizes_bytes[it->slabs_clsid] += (ITEM_ntotal(it) - it->nbytes) + sizeof(item_hdr);
+        sizes_bytes[qid] += (ITEM_ntotal(it) - it->nbytes) + sizeof(item_hdr);
     } else {
-        sizes_bytes[it->slabs_clsid] += ITEM_ntotal(it);
+        sizes_bytes[qid] += ITEM_ntotal(it);
     }
 #else
-    sizes_bytes[it->slabs_clsid] += ITEM_ntotal(it);
+    sizes_bytes[qid] += ITEM_ntotal(it);
 #endif
 
     return;
@@ -459,8 +475,9 @@ static void item_link_q_warm(item *it) {
 
 static void do_item_unlink_q(item *it) {
     item **head, **tail;
-    head = &heads[it->slabs_clsid];
-    tail = &tails[it->slabs_clsid];
+    unsigned int qid = item_queue_id(it);
+    head = &heads[qid];
+    tail = &tails[qid];
 
     if (*head == it) {
         assert(it->prev == 0);
@@ -475,15 +492,15 @@ static void do_item_unlink_q(item *it) {
 
     if (it->next) it->next->prev = it->prev;
     if (it->prev) it->prev->next = it->next;
-    sizes[it->slabs_clsid]--;
+    sizes[qid]--;
 #ifdef EXTSTORE
     if (it->it_flags & ITEM_HDR) {
-        sizes_bytes[it->slabs_clsid] -= (ITEM_ntotal(it) - it->nbytes) + sizeof(item_hdr);
+        sizes_bytes[qid] -= (ITEM_ntotal(it) - it->nbytes) + sizeof(item_hdr);
     } else {
-        sizes_bytes[it->slabs_clsid] -= ITEM_ntotal(it);
+        sizes_bytes[qid] -= ITEM_ntotal(it);
     }
 #else
-    sizes_bytes[it->slabs_clsid] -= ITEM_ntotal(it);
+    sizes_bytes[qid] -= ITEM_ntotal(it);
 #endif
 
     return;
@@ -558,6 +575,117 @@ void do_item_remove(item *it) {
     }
 }
 
+/* Swap a linked item for new_it, a copy of it in the other memory tier.
+ * Unlike do_item_replace() the CAS is kept, since the value didn't change.
+ * Requires the item lock; queue linking is left to the caller since the
+ * demotion path already holds the LRU lock. it loses its hash reference
+ * but the caller's own reference keeps it alive. */
+static void do_item_tier_swap(item *it, item *new_it, const uint32_t hv) {
+    memcpy(new_it, it, ITEM_ntotal(it));
+    new_it->prev = 0;
+    new_it->next = 0;
+    new_it->h_next = 0;
+    new_it->refcount = 1; /* hash table's reference */
+
+    assoc_delete(ITEM_key(it), it->nkey, hv);
+    assoc_insert(new_it, hv);
+    it->it_flags &= ~ITEM_LINKED;
+    refcount_decr(it);
+}
+
+/* Move a hit CXL item back into DRAM at the head of WARM. If the class has
+ * no free DRAM chunk, pulling the COLD tail demotes one to make room.
+ * Returns false (item stays in CXL) if nothing could be freed. */
+static bool do_item_promote(item *it) {
+    unsigned int id = ITEM_clsid(it);
+    size_t ntotal = ITEM_ntotal(it);
+    uint32_t hv = hash(ITEM_key(it), it->nkey);
+    item *new_it = slabs_alloc(ntotal, id, 0);
+
+    if (new_it == NULL) {
+        lru_pull_tail(id, COLD_LRU, 0, LRU_PULL_EVICT, 0, NULL);
+        new_it = slabs_alloc(ntotal, id, SLABS_ALLOC_NO_NEWPAGE);
+        if (new_it == NULL)
+            return false;
+    }
+
+    item_unlink_q(it);
+    do_item_tier_swap(it, new_it, hv);
+    new_it->slabs_clsid = id | WARM_LRU;
+    new_it->it_flags &= ~ITEM_ACTIVE;
+    new_it->time = current_time;
+    pthread_mutex_lock(&lru_locks[new_it->slabs_clsid]);
+    do_item_link_q(new_it);
+    itemstats[id|COLD_LRU].moves_from_cxl++;
+    pthread_mutex_unlock(&lru_locks[new_it->slabs_clsid]);
+    return true;
+}
+
+/* CALLED WITH the COLD LRU lock for clsid held.
+ * Frees a chunk in the CXL tier by dropping the tail of the class's CXL
+ * queue, preferring expired items. Returns the number of items removed. */
+static int do_cxl_pull_tail(const unsigned int clsid) {
+    unsigned int qid = CXL_LRU_ID(clsid);
+    unsigned int id = clsid | COLD_LRU;
+    item *search, *next_it;
+    void *hold_lock;
+    int tries = 5;
+
+    for (search = tails[qid]; tries > 0 && search != NULL; tries--, search = next_it) {
+        next_it = search->prev;
+        uint32_t hv = hash(ITEM_key(search), search->nkey);
+        if ((hold_lock = item_trylock(hv)) == NULL)
+            continue;
+        if (refcount_incr(search) != 2) {
+            /* Busy; a reader is copying it out. Try the next one. */
+            refcount_decr(search);
+            item_trylock_unlock(hold_lock);
+            continue;
+        }
+
+        if ((search->exptime != 0 && search->exptime < current_time)
+            || item_is_flushed(search)) {
+            itemstats[id].cxl_reclaimed++;
+        } else {
+            itemstats[id].cxl_evicted++;
+            LOGGER_LOG(NULL, LOG_EVICTIONS, LOGGER_EVICTION, search);
+        }
+        do_item_unlink_nolock(search, hv);
+        do_item_remove(search);
+        item_trylock_unlock(hold_lock);
+        return 1;
+    }
+    return 0;
+}
+
+/* CALLED WITH the COLD LRU lock and the item lock held, it referenced.
+ * Copies a COLD tail item into the CXL tier instead of evicting it. The
+ * copy goes to the head of the class's CXL queue; the CXL tail makes room
+ * if needed. */
+static bool do_item_demote(item *it, const uint32_t hv) {
+    unsigned int clsid = ITEM_clsid(it);
+    size_t ntotal = ITEM_ntotal(it);
+    item *new_it;
+
+    if (it->it_flags & (ITEM_CHUNKED|ITEM_HDR))
+        return false;
+
+    new_it = slabs_alloc_cxl(ntotal, clsid);
+    if (new_it == NULL && do_cxl_pull_tail(clsid) > 0) {
+        new_it = slabs_alloc_cxl(ntotal, clsid);
+    }
+    if (new_it == NULL)
+        return false;
+
+    do_item_unlink_q(it);
+    do_item_tier_swap(it, new_it, hv);
+    new_it->slabs_clsid = clsid | COLD_LRU;
+    new_it->it_flags &= ~ITEM_ACTIVE;
+    do_item_link_q(new_it);
+    itemstats[clsid|COLD_LRU].moves_to_cxl++;
+    return true;
+}
+
 /* Bump the last accessed time, or relink if we're in compat mode */
 void do_item_update(item *it) {
     MEMCACHED_ITEM_UPDATE(ITEM_key(it), it->nkey, it->nbytes);
@@ -566,7 +694,15 @@ void do_item_update(item *it) {
     if (settings.lru_segmented) {
         assert((it->it_flags & ITEM_SLABBED) == 0);
         if ((it->it_flags & ITEM_LINKED) != 0) {
-            if (ITEM_lruid(it) == COLD_LRU && (it->it_flags & ITEM_ACTIVE)) {
+            if (ITEM_lruid(it) == COLD_LRU && (it->it_flags & ITEM_ACTIVE)
+                    && slabs_is_cxl(it)) {
+                if (!do_item_promote(it)) {
+                    it->time = current_time;
+                    it->it_flags &= ~ITEM_ACTIVE;
+                    item_unlink_q(it);
+                    item_link_q(it);
+                }
+            } else if (ITEM_lruid(it) == COLD_LRU && (it->it_flags & ITEM_ACTIVE)) {
                 it->time = current_time;
                 item_unlink_q(it);
                 it->slabs_clsid = ITEM_clsid(it);
@@ -582,8 +718,10 @@ void do_item_update(item *it) {
 
         if ((it->it_flags & ITEM_LINKED) != 0) {
             it->time = current_time;
-            item_unlink_q(it);
-            item_link_q(it);
+            if (!slabs_is_cxl(it) || !do_item_promote(it)) {
+                item_unlink_q(it);
+                item_link_q(it);
+            }
         }
     }
 }
@@ -712,6 +850,10 @@ void item_stats_totals(ADD_STAT add_stats, void *c) {
             totals.moves_to_warm += itemstats[i].moves_to_warm;
             totals.moves_within_lru += itemstats[i].moves_within_lru;
             totals.direct_reclaims += itemstats[i].direct_reclaims;
+            totals.moves_to_cxl += itemstats[i].moves_to_cxl;
+            totals.moves_from_cxl += itemstats[i].moves_from_cxl;
+            totals.cxl_evicted += itemstats[i].cxl_evicted;
+            totals.cxl_reclaimed += itemstats[i].cxl_reclaimed;
             pthread_mutex_unlock(&lru_locks[i]);
         }
     }
@@ -745,6 +887,16 @@ void item_stats_totals(ADD_STAT add_stats, void *c) {
         APPEND_STAT("lru_bumps_dropped", "%llu",
                     (unsigned long long)lru_total_bumps_dropped());
     }
+    if (settings.cxl_path != NULL) {
+        APPEND_STAT("moves_to_cxl", "%llu",
+                    (unsigned long long)totals.moves_to_cxl);
+        APPEND_STAT("moves_from_cxl", "%llu",
+                    (unsigned long long)totals.moves_from_cxl);
+        APPEND_STAT("cxl_evictions", "%llu",
+                    (unsigned long long)totals.cxl_evicted);
+        APPEND_STAT("cxl_reclaimed", "%llu",
+                    (unsigned long long)totals.cxl_reclaimed);
+    }
 }
 
 void item_stats(ADD_STAT add_stats, void *c) {
@@ -761,6 +913,7 @@ void item_stats(ADD_STAT add_stats, void *c) {
         unsigned int age_hot = 0;
         unsigned int age_warm = 0;
         unsigned int lru_size_map[4];
+        unsigned int size_cxl = 0;
         const char *fmt = "items:%d:%s";
         char key_str[STAT_KEY_LEN];
         char val_str[STAT_VAL_LEN];
@@ -783,9 +936,19 @@ void item_stats(ADD_STAT add_stats, void *c) {
             totals.moves_to_warm += itemstats[i].moves_to_warm;
             totals.moves_within_lru += itemstats[i].moves_within_lru;
             totals.direct_reclaims += itemstats[i].direct_reclaims;
+            totals.moves_to_cxl += itemstats[i].moves_to_cxl;
+            totals.moves_from_cxl += itemstats[i].moves_from_cxl;
+            totals.cxl_evicted += itemstats[i].cxl_evicted;
+            totals.cxl_reclaimed += itemstats[i].cxl_reclaimed;
             totals.mem_requested += sizes_bytes[i];
             size += sizes[i];
             lru_size_map[x] = sizes[i];
+            if (lru_type_map[x] == COLD_LRU) {
+                /* CXL queue is guarded by the COLD lock */
+                totals.mem_requested += sizes_bytes[CXL_LRU_ID(n)];
+                size_cxl = sizes[CXL_LRU_ID(n)];
+                size += size_cxl;
+            }
             if (lru_type_map[x] == COLD_LRU && tails[i] != NULL) {
                 age = current_time - tails[i]->time;
             } else if (lru_type_map[x] == HOT_LRU && tails[i] != NULL) {
@@ -874,6 +1037,17 @@ void item_stats(ADD_STAT add_stats, void *c) {
                                 "%llu", (unsigned long long)totals.hits_to_temp);
 
         }
+        if (settings.cxl_path != NULL) {
+            APPEND_NUM_FMT_STAT(fmt, n, "number_cxl", "%u", size_cxl);
+            APPEND_NUM_FMT_STAT(fmt, n, "moves_to_cxl",
+                                "%llu", (unsigned long long)totals.moves_to_cxl);
+            APPEND_NUM_FMT_STAT(fmt, n, "moves_from_cxl",
+                                "%llu", (unsigned long long)totals.moves_from_cxl);
+            APPEND_NUM_FMT_STAT(fmt, n, "cxl_evicted",
+                                "%llu", (unsigned long long)totals.cxl_evicted);
+            APPEND_NUM_FMT_STAT(fmt, n, "cxl_reclaimed",
+                                "%llu", (unsigned long long)totals.cxl_reclaimed);
+        }
     }
 
     /* getting here means both ascii and binary terminators fit */
@@ -1215,7 +1389,13 @@ int lru_pull_tail(const int orig_id, const int cur_lru,
                 break;
             case COLD_LRU:
                 it = search; /* No matter what, we're stopping */
-                if (flags & LRU_PULL_EVICT) {
+                if ((flags & (LRU_PULL_EVICT|LRU_PULL_DEMOTE))
+                        && settings.cxl_path != NULL
+                        && do_item_demote(search, hv)) {
+                    removed++;
+                } else if (flags & LRU_PULL_DEMOTE) {
+                    /* Only wanted to make room in DRAM; leave it be. */
+                } else if (flags & LRU_PULL_EVICT) {
                     if (settings.evict_to_free == 0) {
                         /* Don't think we need a counter for this. It'll OOM.  */
                         break;
@@ -1453,6 +1633,18 @@ static int lru_maintainer_juggle(const int slabs_clsid) {
             break;
         did_moves++;
     }
+
+    /* Once DRAM is full, keep half a page of chunks free by demoting the
+     * COLD tail ahead of need, so sets rarely copy into CXL inline. */
+    if (settings.cxl_path != NULL) {
+        bool mem_full = false;
+        unsigned int chunks_free = slabs_available_chunks(slabs_clsid, &mem_full, NULL);
+        for (i = 0; mem_full && chunks_free + i < chunks_perslab / 2 && i < 500; i++) {
+            if (lru_pull_tail(slabs_clsid, COLD_LRU, 0, LRU_PULL_DEMOTE, 0, NULL) <= 0)
+                break;
+            did_moves++;
+        }
+    }
     return did_moves;
 }
 
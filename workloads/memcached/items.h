@@ -38,6 +38,7 @@ void *item_lru_bump_buf_create(void);
 #define LRU_PULL_EVICT 1
 #define LRU_PULL_CRAWL_BLOCKS 2
 #define LRU_PULL_RETURN_ITEM 4 /* fill info struct if available */
+#define LRU_PULL_DEMOTE 8 /* move COLD tail to the CXL tier, never evict */
 
 struct lru_pull_tail_return {
     item *it;
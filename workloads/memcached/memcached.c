@@ -292,6 +292,8 @@ static void settings_init(void) {
 #endif
     settings.num_napi_ids = 0;
     settings.memory_file = NULL;
+    settings.cxl_path = NULL;
+    settings.cxl_size = 0;
 #ifdef SOCK_COOKIE_ID
     settings.sock_cookie_id = 0;
 #endif
@@ -2000,6 +2002,7 @@ void process_stat_settings(ADD_STAT add_stats, void *c) {
     APPEND_STAT("ext_max_frag", "%.2f", settings.ext_max_frag);
     APPEND_STAT("slab_automove_freeratio", "%.3f", settings.slab_automove_freeratio);
     APPEND_STAT("ext_drop_unread", "%s", settings.ext_drop_unread ? "yes" : "no");
+    APPEND_STAT("ext_mmap", "%s", settings.ext_mmap ? "yes" : "no");
 #endif
 #ifdef TLS
     APPEND_STAT("ssl_enabled", "%s", settings.ssl_enabled ? "yes" : "no");
@@ -2020,6 +2023,8 @@ void process_stat_settings(ADD_STAT add_stats, void *c) {
 #endif
     APPEND_STAT("num_napi_ids", "%s", settings.num_napi_ids);
     APPEND_STAT("memory_file", "%s", settings.memory_file);
+    APPEND_STAT("cxl_path", "%s", settings.cxl_path ? settings.cxl_path : "NULL");
+    APPEND_STAT("cxl_size", "%llu", (unsigned long long)settings.cxl_size);
     APPEND_STAT("client_flags_size", "%d", sizeof(client_flags_t));
 }
 
@@ -4138,7 +4143,10 @@ static void usage(void) {
            "   - no_hashexpand:       disables hash table expansion (dangerous)\n"
            "   - modern:              enables options which will be default in future.\n"
            "                          currently: nothing\n"
-           "   - no_modern:           uses defaults of previous major version (1.4.x)\n",
+           "   - no_modern:           uses defaults of previous major version (1.4.x)\n"
+           "   - cxl_path:            DAX device or file for a CXL slab tier. COLD items are\n"
+           "                          demoted into it instead of evicted, and promoted\n"
+           "                          back on hit. ie: cxl_path=/dev/dax0.0:16G\n",
            settings.slab_chunk_size_max / (1 << 10), settings.logger_watcher_buf_size / (1 << 10),
            settings.logger_buf_size / (1 << 10));
     verify_default("tail_repair_time", settings.tail_repair_time == TAIL_REPAIR_TIME_DEFAULT);
@@ -4169,6 +4177,8 @@ static void usage(void) {
            "   - ext_item_age:        store items idle at least this long (seconds, default: no age limit)\n"
            "   - ext_low_ttl:         consider TTLs lower than this specially (default: %u)\n"
            "   - ext_drop_unread:     don't re-write unread values during compaction (default: %s)\n"
+           "   - ext_mmap:            map ext_path files and read them without the IO\n"
+           "                          threads. always on for DAX devices (default: %s)\n"
            "   - ext_recache_rate:    recache an item every N accesses (default: %u)\n"
            "   - ext_compact_under:   compact when fewer than this many free pages\n"
            "                          (default: 1/4th of the assigned storage)\n"
@@ -4180,7 +4190,8 @@ static void usage(void) {
            "                          (see doc/storage.txt for more info, default: %.3f)\n",
            settings.ext_page_size / (1 << 20), settings.ext_wbuf_size / (1 << 20), settings.ext_io_threadcount,
            settings.ext_item_size, settings.ext_low_ttl,
-           flag_enabled_disabled(settings.ext_drop_unread), settings.ext_recache_rate,
+           flag_enabled_disabled(settings.ext_drop_unread),
+           flag_enabled_disabled(settings.ext_mmap), settings.ext_recache_rate,
            settings.ext_max_frag, settings.ext_max_sleep, settings.slab_automove_freeratio);
     verify_default("ext_item_age", settings.ext_item_age == UINT_MAX);
 #endif
@@ -4829,6 +4840,7 @@ int main (int argc, char **argv) {
         DROP_PRIVILEGES,
         RESP_OBJ_MEM_LIMIT,
         READ_BUF_MEM_LIMIT,
+        CXL_PATH,
 #ifdef TLS
         SSL_CERT,
         SSL_KEY,
@@ -4892,6 +4904,7 @@ int main (int argc, char **argv) {
         [DROP_PRIVILEGES] = "drop_privileges",
         [RESP_OBJ_MEM_LIMIT] = "resp_obj_mem_limit",
         [READ_BUF_MEM_LIMIT] = "read_buf_mem_limit",
+        [CXL_PATH] = "cxl_path",
 #ifdef TLS
         [SSL_CERT] = "ssl_chain_cert",
         [SSL_KEY] = "ssl_key",
@@ -5652,6 +5665,38 @@ int main (int argc, char **argv) {
                 }
                 settings.read_buf_mem_limit *= 1024 * 1024; /* megabytes */
                 break;
+            case CXL_PATH: {
+                char *sep = subopts_value ? strrchr(subopts_value, ':') : NULL;
+                char *unit = NULL;
+                unsigned long long size;
+                if (sep == NULL || sep == subopts_value) {
+                    fprintf(stderr, "must supply size to cxl_path, ie: cxl_path=/dev/dax0.0:16G (M|G|T supported)\n");
+                    return 1;
+                }
+                *sep = '\0';
+                size = strtoull(sep + 1, &unit, 10);
+                switch (tolower(*unit)) {
+                    case 'm':
+                        size <<= 20;
+                        break;
+                    case 'g':
+                        size <<= 30;
+                        break;
+                    case 't':
+                        size <<= 40;
+                        break;
+                    default:
+                        size = 0;
+                        break;
+                }
+                if (size < (unsigned long long)settings.slab_page_size) {
+                    fprintf(stderr, "cxl_path size must be at least one slab page, ie: cxl_path=/mnt/cxl/slabs:16G\n");
+                    return 1;
+                }
+                settings.cxl_path = strdup(subopts_value);
+                settings.cxl_size = size;
+                break;
+            }
 #ifdef PROXY
             case PROXY_CONFIG:
                 if (subopts_value == NULL) {
@@ -6044,6 +6089,15 @@ int main (int argc, char **argv) {
 #endif
     slabs_init(settings.maxbytes, settings.factor, preallocate,
             use_slab_sizes ? slab_sizes : NULL, mem_base, reuse_mem);
+    if (settings.cxl_path != NULL) {
+        if (settings.memory_file != NULL) {
+            fprintf(stderr, "cxl_path cannot be combined with a restartable memory file\n");
+            exit(EX_USAGE);
+        }
+        if (!slabs_cxl_init(settings.cxl_path, settings.cxl_size)) {
+            exit(EXIT_FAILURE);
+        }
+    }
 #ifdef EXTSTORE
     if (storage_enabled) {
         storage = storage_init(storage_cf);
@@ -522,6 +522,7 @@ struct settings {
     double ext_max_frag; /* ideal maximum page fragmentation */
     double slab_automove_freeratio; /* % of memory to hold free as buffer */
     bool ext_drop_unread; /* skip unread items during compaction */
+    bool ext_mmap; /* map ext_path files; reads skip the IO threads */
     /* start flushing to extstore after memory below this */
     unsigned int ext_global_pool_min;
 #endif
@@ -542,6 +543,8 @@ struct settings {
 #endif
     int num_napi_ids;   /* maximum number of NAPI IDs */
     char *memory_file;  /* warm restart memory file path */
+    char *cxl_path;     /* DAX device or file backing the CXL slab tier */
+    size_t cxl_size;    /* bytes of cxl_path to map */
 #ifdef PROXY
     bool proxy_enabled;
     bool proxy_uring; /* if the proxy should use io_uring */
@@ -22,6 +22,7 @@
 #include <signal.h>
 #include <assert.h>
 #include <pthread.h>
+#include <unistd.h>
 
 //#define DEBUG_SLAB_MOVER
 /* powers-of-N allocation structures */
@@ -50,6 +51,15 @@ static int power_largest;
 static void *mem_base = NULL;
 static void *mem_current = NULL;
 static size_t mem_avail = 0;
+
+/* CXL tier: a second page pool mapped from a DAX device (or a plain file as
+ * a stand-in). Its pages are carved into per-class freelists like DRAM pages
+ * but never enter slab_list, so the page mover only ever moves DRAM pages.
+ * Items land here when demoted from the COLD LRU; see items.c */
+static slabclass_t cxlclass[MAX_NUMBER_OF_SLAB_CLASSES];
+static char *cxl_base = NULL;
+static size_t cxl_limit = 0;
+static size_t cxl_malloced = 0;
 #ifdef EXTSTORE
 static void *storage  = NULL;
 #endif
@@ -504,7 +514,7 @@ static void do_slabs_free(void *ptr, const size_t size, unsigned int id) {
         return;
 
     MEMCACHED_SLABS_FREE(size, id, ptr);
-    p = &slabclass[id];
+    p = slabs_is_cxl(ptr) ? &cxlclass[id] : &slabclass[id];
 
     it = (item *)ptr;
     if ((it->it_flags & ITEM_CHUNKED) == 0) {
@@ -596,6 +606,13 @@ static void do_slabs_stats(ADD_STAT add_stats, void *c) {
                     (unsigned long long)thread_stats.slab_stats[i].cas_badval);
             APPEND_NUM_STAT(i, "touch_hits", "%llu",
                     (unsigned long long)thread_stats.slab_stats[i].touch_hits);
+            if (cxl_base != NULL) {
+                slabclass_t *cp = &cxlclass[i];
+                APPEND_NUM_STAT(i, "cxl_total_pages", "%u", cp->slabs);
+                APPEND_NUM_STAT(i, "cxl_used_chunks", "%u",
+                                cp->slabs*perslab - cp->sl_curr);
+                APPEND_NUM_STAT(i, "cxl_free_chunks", "%u", cp->sl_curr);
+            }
             total++;
         }
     }
@@ -604,6 +621,10 @@ static void do_slabs_stats(ADD_STAT add_stats, void *c) {
 
     APPEND_STAT("active_slabs", "%d", total);
     APPEND_STAT("total_malloced", "%llu", (unsigned long long)mem_malloced);
+    if (cxl_base != NULL) {
+        APPEND_STAT("cxl_total_malloced", "%llu", (unsigned long long)cxl_malloced);
+        APPEND_STAT("cxl_limit_maxbytes", "%llu", (unsigned long long)cxl_limit);
+    }
     add_stats(NULL, 0, NULL, 0, c);
 }
 
@@ -669,6 +690,100 @@ void slabs_free(void *ptr, size_t size, unsigned int id) {
     pthread_mutex_unlock(&slabs_lock);
 }
 
+/* Maps the CXL tier. A regular file is sized to fit; DAX character devices
+ * are mapped as-is. Only called during init. */
+bool slabs_cxl_init(const char *path, const size_t limit) {
+    struct stat st;
+    int i;
+    int fd = open(path, O_RDWR|O_CREAT, S_IRWXU);
+    if (fd < 0) {
+        perror("failed to open cxl_path");
+        return false;
+    }
+    if (fstat(fd, &st) != 0) {
+        perror("failed to stat cxl_path");
+        close(fd);
+        return false;
+    }
+    if (S_ISREG(st.st_mode) && (size_t)st.st_size < limit &&
+            ftruncate(fd, limit) != 0) {
+        perror("failed to size cxl_path");
+        close(fd);
+        return false;
+    }
+
+    void *base = mmap(NULL, limit, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror("failed to mmap cxl_path");
+        return false;
+    }
+
+    memset(cxlclass, 0, sizeof(cxlclass));
+    for (i = POWER_SMALLEST; i <= power_largest; i++) {
+        cxlclass[i].size = slabclass[i].size;
+        cxlclass[i].perslab = slabclass[i].perslab;
+    }
+    cxl_base = base;
+    cxl_limit = limit;
+    cxl_malloced = 0;
+    return true;
+}
+
+bool slabs_is_cxl(const void *ptr) {
+    return cxl_base != NULL && (const char *)ptr >= cxl_base
+        && (const char *)ptr < cxl_base + cxl_limit;
+}
+
+/* CXL pages are handed out once and stay with their class. */
+static int do_slabs_newslab_cxl(const unsigned int id) {
+    slabclass_t *p = &cxlclass[id];
+    size_t len = settings.slab_page_size;
+    char *ptr;
+    int x;
+
+    if (cxl_malloced + len > cxl_limit)
+        return 0;
+
+    ptr = cxl_base + cxl_malloced;
+    cxl_malloced += len;
+    memset(ptr, 0, len);
+    for (x = 0; x < p->perslab; x++) {
+        do_slabs_free(ptr, 0, id);
+        ptr += p->size;
+    }
+    p->slabs++;
+    return 1;
+}
+
+/* Allocates a chunk from the CXL tier, for demoting an item of class id.
+ * Never evicts: returns NULL when the class is out of CXL chunks and the
+ * tier has no unassigned pages left. */
+void *slabs_alloc_cxl(const size_t size, unsigned int id) {
+    slabclass_t *p;
+    item *it = NULL;
+
+    if (cxl_base == NULL || id < POWER_SMALLEST || id > power_largest)
+        return NULL;
+
+    pthread_mutex_lock(&slabs_lock);
+    p = &cxlclass[id];
+    assert(size <= p->size);
+    if (p->sl_curr == 0) {
+        do_slabs_newslab_cxl(id);
+    }
+    if (p->sl_curr != 0) {
+        it = (item *)p->slots;
+        p->slots = it->next;
+        if (it->next) it->next->prev = 0;
+        it->it_flags &= ~ITEM_SLABBED;
+        it->refcount = 1;
+        p->sl_curr--;
+    }
+    pthread_mutex_unlock(&slabs_lock);
+    return it;
+}
+
 void slabs_stats(ADD_STAT add_stats, void *c) {
     pthread_mutex_lock(&slabs_lock);
     do_slabs_stats(add_stats, c);
@@ -28,6 +28,12 @@ void *slabs_alloc(const size_t size, unsigned int id, unsigned int flags);
 /** Free previously allocated object */
 void slabs_free(void *ptr, size_t size, unsigned int id);
 
+/** CXL memory tier. cxl_init maps path (DAX device or file) as a second
+    page pool; items demoted from the COLD LRU are copied into it. */
+bool slabs_cxl_init(const char *path, const size_t limit);
+bool slabs_is_cxl(const void *ptr);
+void *slabs_alloc_cxl(const size_t size, unsigned int id);
+
 /** Adjust global memory limit up or down */
 bool slabs_adjust_mem_limit(size_t new_mem_limit);
 
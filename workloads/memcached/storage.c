@@ -976,8 +976,19 @@ static void *storage_compact_thread(void *arg) {
         }
 
         if (compacting) {
+            char *page = NULL;
             pthread_mutex_lock(&wrap.lock);
-            if (page_offset < page_size && !wrap.done && !wrap.submitted) {
+            if (page_offset < page_size && !wrap.done && !wrap.submitted
+                    && (page = extstore_page_pin(storage, page_id, page_version)) != NULL) {
+                // Mapped pages are walked in place; no readback copy.
+                LOGGER_LOG(l, LOG_SYSEVENTS, LOGGER_COMPACT_READ_START,
+                        NULL, page_id, page_offset);
+                storage_compact_readback(storage, l, drop_unread,
+                        page + page_offset, page_id, page_version, page_offset,
+                        settings.ext_wbuf_size);
+                extstore_page_unpin(storage, page_id);
+                page_offset += settings.ext_wbuf_size;
+            } else if (page_offset < page_size && !wrap.done && !wrap.submitted) {
                 wrap.io.page_version = page_version;
                 wrap.io.page_id = page_id;
                 wrap.io.offset = page_offset;
@@ -986,7 +997,11 @@ static void *storage_compact_thread(void *arg) {
                 wrap.submitted = true;
                 wrap.miss = false;
 
+                // reads from mapped pages call back inline, which takes the
+                // lock.
+                pthread_mutex_unlock(&wrap.lock);
                 extstore_submit(storage, &wrap.io);
+                pthread_mutex_lock(&wrap.lock);
             } else if (wrap.miss) {
                 LOGGER_LOG(l, LOG_SYSEVENTS, LOGGER_COMPACT_ABORT,
                         NULL, page_id);
@@ -1167,6 +1182,7 @@ void *storage_init_config(struct settings *s) {
     s->ext_recache_rate = 2000;
     s->ext_max_frag = 0.8;
     s->ext_drop_unread = false;
+    s->ext_mmap = false;
     s->ext_wbuf_size = 1024 * 1024 * 4;
     s->ext_compact_under = 0;
     s->ext_drop_under = 0;
@@ -1205,6 +1221,7 @@ int storage_read_config(void *conf, char **subopt) {
         EXT_MAX_SLEEP,
         EXT_MAX_FRAG,
         EXT_DROP_UNREAD,
+        EXT_MMAP,
         SLAB_AUTOMOVE_FREERATIO, // FIXME: move this back?
     };
 
@@ -1223,6 +1240,7 @@ int storage_read_config(void *conf, char **subopt) {
         [EXT_MAX_SLEEP] = "ext_max_sleep",
         [EXT_MAX_FRAG] = "ext_max_frag",
         [EXT_DROP_UNREAD] = "ext_drop_unread",
+        [EXT_MMAP] = "ext_mmap",
         [SLAB_AUTOMOVE_FREERATIO] = "slab_automove_freeratio",
         NULL
     };
@@ -1368,6 +1386,10 @@ int storage_read_config(void *conf, char **subopt) {
         case EXT_DROP_UNREAD:
             settings.ext_drop_unread = true;
             break;
+        case EXT_MMAP:
+            settings.ext_mmap = true;
+            ext_cf->mmap = true;
+            break;
         case EXT_PATH:
             if (subopts_value) {
                 struct extstore_conf_file *tmp = storage_conf_parse(subopts_value, ext_cf->page_size);
@@ -0,0 +1,73 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use Test::More;
+use FindBin qw($Bin);
+use lib "$Bin/lib";
+use MemcachedTest;
+
+# A plain file stands in for a DAX device.
+my $cxl_file = "/tmp/memcached-cxl-tier.$$";
+END { unlink $cxl_file if defined $cxl_file; }
+
+my $server = new_memcached("-m 8 -o lru_maintainer,lru_crawler,cxl_path=$cxl_file:64M");
+my $sock = $server->sock;
+my $value = "C"x1000;
+my $count = 20000;
+
+# Far more than fits in 8MB of DRAM.
+for my $key (1 .. $count) {
+    print $sock "set cxl$key 0 0 1000 noreply\r\n$value\r\n";
+}
+print $sock "set cxlsync 0 0 2\r\nok\r\n";
+is(scalar <$sock>, "STORED\r\n", "stored past the DRAM limit");
+
+my $stats = mem_stats($sock);
+isnt($stats->{moves_to_cxl}, 0, "cold items demoted to the CXL tier");
+is($stats->{evictions}, 0, "nothing evicted while the CXL tier has room");
+is($stats->{curr_items}, $count + 1, "all items still present");
+
+my $slabs = mem_stats($sock, "slabs");
+ok($slabs->{cxl_total_malloced} > 0, "CXL pages in use");
+is($slabs->{cxl_limit_maxbytes}, 64 * 1024 * 1024, "CXL tier size reported");
+
+my $missing = 0;
+for my $key (1 .. $count) {
+    print $sock "get cxl$key\r\n";
+    my $line = scalar <$sock>;
+    if ($line =~ /^VALUE/) {
+        my $data = scalar <$sock>;
+        $missing++ if $data ne "$value\r\n";
+        $line = scalar <$sock>;
+    } else {
+        $missing++;
+    }
+}
+is($missing, 0, "every item readable from either tier");
+
+# The oldest key lives in CXL by now. Two hits mark it active, and the LRU
+# maintainer moves it back to DRAM without touching its CAS.
+print $sock "gets cxl1\r\n";
+my $line = scalar <$sock>;
+my ($cas) = $line =~ /^VALUE cxl1 0 1000 (\d+)/;
+ok(defined $cas, "got cas for demoted item");
+scalar <$sock>;
+scalar <$sock>;
+$stats = mem_stats($sock);
+my $promoted = $stats->{moves_from_cxl};
+mem_get_is($sock, "cxl1", $value);
+
+for (1 .. 5) {
+    $stats = mem_stats($sock);
+    last if $stats->{moves_from_cxl} > $promoted;
+    sleep 1;
+}
+ok($stats->{moves_from_cxl} > $promoted, "hit item promoted from CXL");
+mem_get_is($sock, "cxl1", $value);
+print $sock "gets cxl1\r\n";
+like(scalar <$sock>, qr/^VALUE cxl1 0 1000 $cas\r\n/, "cas kept across promotion");
+scalar <$sock>;
+scalar <$sock>;
+
+done_testing();
@@ -0,0 +1,98 @@
+#!/usr/bin/env perl
+
+use strict;
+use warnings;
+use Test::More;
+use FindBin qw($Bin);
+use lib "$Bin/lib";
+use MemcachedTest;
+use Data::Dumper qw/Dumper/;
+
+my $ext_path;
+
+if (!supports_extstore()) {
+    plan skip_all => 'extstore not enabled';
+    exit 0;
+}
+
+$ext_path = "/tmp/extstore-mmap.$$";
+
+my $server = new_memcached("-m 64 -U 0 -o ext_mmap,ext_page_size=8,ext_wbuf_size=2,ext_threads=1,ext_io_depth=2,ext_item_size=512,ext_item_age=2,ext_recache_rate=10000,ext_max_frag=0.9,ext_path=$ext_path:64m,slab_automove=0,ext_compact_under=6,ext_max_sleep=100000");
+my $sock = $server->sock;
+
+{
+    my $stats = mem_stats($sock, ' settings');
+    is($stats->{ext_mmap}, 'yes', 'ext_mmap enabled');
+}
+
+is(-s $ext_path, 64 * 1024 * 1024, 'mapped file sized up front');
+
+my $value;
+{
+    my @chars = ("C".."Z");
+    for (1 .. 20000) {
+        $value .= $chars[rand @chars];
+    }
+}
+
+# fill the pages, then delete every other key so compaction has work to do.
+{
+    my $keycount = 1500;
+    for (1 .. $keycount) {
+        print $sock "set mfoo$_ 0 0 20000 noreply\r\n$value\r\n";
+    }
+    wait_ext_flush($sock);
+
+    my $stats = mem_stats($sock);
+    cmp_ok($stats->{extstore_objects_written}, '>', 0, 'objects written to mapped pages');
+    cmp_ok($stats->{extstore_page_allocs}, '>', 1, 'several pages allocated');
+
+    mem_get_is($sock, "mfoo2", $value, 'read back from mapped page');
+    $stats = mem_stats($sock);
+    cmp_ok($stats->{get_extstore}, '>', 0, 'fetched from extstore');
+    cmp_ok($stats->{extstore_bytes_read}, '>=', length($value), 'bytes read from mapping');
+    is($stats->{badcrc_from_extstore}, 0, 'no bad crcs');
+
+    for (1 .. $keycount) {
+        next if $_ % 2 == 0;
+        print $sock "delete mfoo$_ noreply\r\n";
+    }
+    # wait for the compactor to rescue live items from fragmented pages.
+    for (1 .. 30) {
+        $stats = mem_stats($sock);
+        last if $stats->{extstore_compact_rescues} > 0;
+        sleep 1;
+    }
+    cmp_ok($stats->{extstore_compact_rescues}, '>', 0, 'compacted in place');
+
+    my $hits = 0;
+    for (1 .. $keycount) {
+        next if $_ % 2 != 0;
+        print $sock "get mfoo$_\r\n";
+        my $line = scalar <$sock>;
+        if ($line =~ /^VALUE/) {
+            my $data = scalar <$sock>;
+            $hits++ if $data eq "$value\r\n";
+            $line = scalar <$sock>;
+        }
+        is($line, "END\r\n", "end of get mfoo$_") if $line ne "END\r\n";
+    }
+    cmp_ok($hits, '>', 0, 'live items readable after compaction');
+    $stats = mem_stats($sock);
+    is($stats->{badcrc_from_extstore}, 0, 'still no bad crcs');
+}
+
+# chunked items are read into an iovec straight from the mapping.
+{
+    my $big = "x" x (700 * 1024);
+    print $sock "set bigfoo 0 0 " . length($big) . "\r\n$big\r\n";
+    is(scalar <$sock>, "STORED\r\n", 'stored chunked item');
+    wait_ext_flush($sock);
+    mem_get_is($sock, "bigfoo", $big, 'chunked item read back');
+}
+
+done_testing();
+
+END {
+    unlink $ext_path if $ext_path;
+}
@@ -0,0 +1,151 @@
+//
+// Point lookup / range scan microbenchmark for the CXL B+-tree
+//
+
+#include "benchmark/tpcc/Schema.h"
+#include "core/CXLTable.h"
+#include "common/CXLMemory.h"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+DEFINE_int32(warehouses, 2, "number of warehouses whose order lines are loaded");
+DEFINE_int32(orders, 3000, "orders per district");
+DEFINE_int32(lines, 10, "order lines per order");
+DEFINE_int32(threads, 1, "number of lookup/scan threads");
+DEFINE_int32(ops, 1000000, "operations per thread and workload");
+DEFINE_int32(scan_len, 10, "order lines visited per range scan");
+DEFINE_bool(btree_prefetch, false, "prefetch nodes during descent");
+DEFINE_string(tree, "both", "tree to run: heads, baseline, both");
+DEFINE_string(cxl_backend, "ivshmem", "cxlalloc backend (mmap, shm, ivshmem, dax)");
+DEFINE_string(cxl_memory_resource, "SS", "file or device path backing the CXL heap");
+
+// ./bench_btree --logtostderr=1 --cxl_backend=mmap --cxl_memory_resource=/dev/shm/cxl --threads=4
+
+bool do_tid_check = false;
+
+using namespace star;
+using order_line = tpcc::order_line;
+
+// orders keys exactly like order_line::KeyComparator but exposes no key prefix,
+// so nodes are searched the way they were before key heads existed
+struct BaselineKeyComparator {
+	int operator()(const order_line::key &a, const order_line::key &b) const
+	{
+		return order_line::KeyComparator()(a, b);
+	}
+};
+
+template <class KeyComparator> class TreeBench {
+    public:
+	using Table = CXLTableBTreeOLC<order_line::key, KeyComparator>;
+	using Tree = typename Table::CXLBTree;
+	using Value = typename Table::BTreeOLCValue;
+
+	explicit TreeBench(const std::string &name)
+		: name(name)
+	{
+	}
+
+	void run()
+	{
+		// trees are never torn down (~BPlusTree is not implemented)
+		Tree &tree = *new Tree();
+
+		auto begin = std::chrono::steady_clock::now();
+		uint64_t rows = 0;
+		for (int w = 1; w <= FLAGS_warehouses; w++) {
+			for (int d = 1; d <= DISTRICT_PER_WAREHOUSE; d++) {
+				for (int o = 1; o <= FLAGS_orders; o++) {
+					for (int l = 1; l <= FLAGS_lines; l++) {
+						Value value;
+						value.row = reinterpret_cast<void *>(rows + 1);
+						value.is_valid.store(true);
+						CHECK(tree.insert(order_line::key(w, d, o, l), value));
+						rows++;
+					}
+				}
+			}
+		}
+		report("load", rows, begin);
+
+		run_threads("point lookup", [&](std::mt19937_64 &rng) {
+			Value value;
+			CHECK(tree.lookup(random_key(rng, true), value));
+		});
+
+		run_threads("range scan", [&](std::mt19937_64 &rng) {
+			order_line::key start = random_key(rng, false);
+			int visited = 0;
+			tree.scanForUpdate(start, [&](const order_line::key &key, Value &value, bool last) {
+				return ++visited >= FLAGS_scan_len || last;
+			});
+		});
+
+		LOG(INFO) << name << ": " << tree.getNumInnerNodes() << " inner nodes, " << tree.getNumLeafNodes() << " leaves ("
+			  << Tree::BTreeLeaf::maxEntries << " entries per leaf, " << Tree::BTreeInner::maxEntries << " per inner node)";
+	}
+
+    private:
+	order_line::key random_key(std::mt19937_64 &rng, bool any_line)
+	{
+		int w = rng() % FLAGS_warehouses + 1;
+		int d = rng() % DISTRICT_PER_WAREHOUSE + 1;
+		int o = rng() % FLAGS_orders + 1;
+		int l = any_line ? rng() % FLAGS_lines + 1 : 1;
+		return order_line::key(w, d, o, l);
+	}
+
+	template <class Op> void run_threads(const std::string &workload, Op op)
+	{
+		std::vector<std::thread> threads;
+
+		auto begin = std::chrono::steady_clock::now();
+		for (int i = 0; i < FLAGS_threads; i++) {
+			threads.emplace_back([&, i]() {
+				std::mt19937_64 rng(i + 1);
+				for (int j = 0; j < FLAGS_ops; j++)
+					op(rng);
+			});
+		}
+		for (auto &t : threads)
+			t.join();
+		report(workload, static_cast<uint64_t>(FLAGS_ops) * FLAGS_threads, begin);
+	}
+
+	void report(const std::string &workload, uint64_t ops, std::chrono::steady_clock::time_point begin)
+	{
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		LOG(INFO) << name << " " << workload << ": " << ops << " ops in " << seconds << " s, " << ops / seconds / 1e6 << " Mops/s, "
+			  << seconds * 1e9 * FLAGS_threads / ops << " ns/op";
+	}
+
+	std::string name;
+};
+
+int main(int argc, char *argv[])
+{
+	google::InitGoogleLogging(argv[0]);
+	google::InstallFailureSignalHandler();
+	google::ParseCommandLineFlags(&argc, &argv, true);
+
+	Context context;
+	context.cxl_backend = FLAGS_cxl_backend;
+	context.cxl_memory_resource = FLAGS_cxl_memory_resource;
+	cxl_memory.init(context);
+	cxl_memory.init_cxlalloc_for_given_thread(1, 0, 1, 0);
+
+	btreeolc_cxl::EnableNodePrefetch = FLAGS_btree_prefetch;
+
+	if (FLAGS_tree == "heads" || FLAGS_tree == "both")
+		TreeBench<order_line::KeyComparator>("heads").run();
+	if (FLAGS_tree == "baseline" || FLAGS_tree == "both")
+		TreeBench<BaselineKeyComparator>("baseline").run();
+
+	return 0;
+}
@@ -15,6 +15,9 @@ void check_context(star::tatp::Context &context)
         // CXL transport supports single consumer only
         if (context.use_cxl_transport == true)
                 DCHECK(context.io_thread_num == 1);
+
+        // a hand-off scans the partition's indexes without latching them, which is unsafe under concurrent inserts and deletes
+        CHECK(context.repartition_interval == 0) << "TATP inserts and deletes rows; repartitioning is not supported";
 }
 
 int main(int argc, char *argv[])
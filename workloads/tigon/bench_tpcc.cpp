@@ -18,6 +18,12 @@ void check_context(star::tpcc::Context &context)
         // CXL transport supports single consumer only
         if (context.use_cxl_transport == true)
                 DCHECK(context.io_thread_num == 1);
+
+        // a hand-off scans the partition's indexes without latching them, which is unsafe under concurrent inserts and deletes
+        CHECK(context.repartition_interval == 0) << "TPC-C inserts rows; repartitioning is not supported";
+
+        // Aria transactions support neither inserts nor scans
+        CHECK(context.protocol != "AriaPasha") << "TPC-C inserts and scans rows; AriaPasha supports YCSB rmw only";
 }
 
 int main(int argc, char *argv[])
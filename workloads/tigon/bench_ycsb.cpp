@@ -26,6 +26,15 @@ void check_context(star::ycsb::Context &context)
         // CXL transport supports single consumer only
         if (context.use_cxl_transport == true)
                 DCHECK(context.io_thread_num == 1);
+
+        // a hand-off scans the partition's indexes without latching them, which is unsafe under concurrent inserts and deletes
+        if (context.repartition_interval > 0)
+                CHECK(context.workloadType == star::ycsb::YCSBWorkloadType::RMW || context.workloadType == star::ycsb::YCSBWorkloadType::SCAN)
+                        << "repartitioning supports the rmw and scan queries only";
+
+        // Aria transactions support neither inserts nor scans
+        if (context.protocol == "AriaPasha")
+                CHECK(context.workloadType == star::ycsb::YCSBWorkloadType::RMW) << "AriaPasha supports the rmw query only";
 }
 
 int main(int argc, char *argv[])
@@ -8,6 +8,7 @@
 #include "benchmark/smallbank/Random.h"
 #include "benchmark/smallbank/Schema.h"
 #include "common/Operation.h"
+#include "common/TableCheckpoint.h"
 #include "common/ThreadPool.h"
 #include "core/Macros.h"
 #include "core/Partitioner.h"
@@ -82,6 +83,25 @@ class Database {
 			  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count() << " milliseconds.";
 	}
 
+	// one snapshot file per partition this host loads, holding all of its tables
+	std::vector<TableCheckpoint::File> get_checkpoint_files(std::size_t partitionNum, Partitioner *partitioner)
+	{
+		std::vector<TableCheckpoint::File> files;
+
+		for (auto partitionID = 0u; partitionID < partitionNum; partitionID++) {
+			if (partitioner->is_partition_replicated_on_me(partitionID) == false) {
+				continue;
+			}
+			TableCheckpoint::File file;
+			file.name = "partition_" + std::to_string(partitionID);
+			for (auto &tables : tbl_vecs) {
+				file.tables.push_back(tables[partitionID]);
+			}
+			files.push_back(file);
+		}
+		return files;
+	}
+
 	void initialize(const Context &context)
 	{
 		if (context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_OFF || context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_ON) {
@@ -101,16 +121,16 @@ class Database {
 			auto savingsTableID = smallbank::savings::tableID;
 			if (context.protocol == "Sundial") {
 				tbl_savings_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncSundial> >(savingsTableID, partitionID));
+					make_hash_table<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncSundial>(context.hash_index, savingsTableID, partitionID));
                         } else if (context.protocol == "SundialPasha") {
                                 tbl_savings_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncSundialPasha> >(savingsTableID, partitionID));
+					make_hash_table<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncSundialPasha>(context.hash_index, savingsTableID, partitionID));
                         } else if (context.protocol == "TwoPL") {
                                 tbl_savings_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncTwoPL> >(savingsTableID, partitionID));
+					make_hash_table<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncTwoPL>(context.hash_index, savingsTableID, partitionID));
                         } else if (context.protocol == "TwoPLPasha") {
                                 tbl_savings_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncTwoPLPasha> >(savingsTableID, partitionID));
+					make_hash_table<997, smallbank::savings::key, smallbank::savings::value, smallbank::savings::KeyComparator, smallbank::savings::ValueComparator, MetaInitFuncTwoPLPasha>(context.hash_index, savingsTableID, partitionID));
 			} else if (context.protocol != "HStore") {
 				CHECK(0);
 			} else {
@@ -121,16 +141,16 @@ class Database {
 			auto checkingTableID = smallbank::checking::tableID;
 			if (context.protocol == "Sundial") {
 				tbl_checking_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncSundial> >(checkingTableID, partitionID));
+					make_hash_table<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncSundial>(context.hash_index, checkingTableID, partitionID));
                         } else if (context.protocol == "SundialPasha") {
                                 tbl_checking_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncSundialPasha> >(checkingTableID, partitionID));
+					make_hash_table<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncSundialPasha>(context.hash_index, checkingTableID, partitionID));
                         } else if (context.protocol == "TwoPL") {
                                 tbl_checking_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncTwoPL> >(checkingTableID, partitionID));
+					make_hash_table<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncTwoPL>(context.hash_index, checkingTableID, partitionID));
                         } else if (context.protocol == "TwoPLPasha") {
                                 tbl_checking_vec.push_back(
-					std::make_unique<TableHashMap<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncTwoPLPasha> >(checkingTableID, partitionID));
+					make_hash_table<997, smallbank::checking::key, smallbank::checking::value, smallbank::checking::KeyComparator, smallbank::checking::ValueComparator, MetaInitFuncTwoPLPasha>(context.hash_index, checkingTableID, partitionID));
 			} else if (context.protocol != "HStore") {
 				CHECK(0);
 			} else {
@@ -146,9 +166,26 @@ class Database {
 		std::transform(tbl_savings_vec.begin(), tbl_savings_vec.end(), std::back_inserter(tbl_vecs[0]), tFunc);
 		std::transform(tbl_checking_vec.begin(), tbl_checking_vec.end(), std::back_inserter(tbl_vecs[1]), tFunc);
 
-		using std::placeholders::_1;
-		initTables("savings", [&context, this](std::size_t partitionID) { savingsInit(context, partitionID); }, partitionNum, threadsNum, partitioner.get());
-		initTables("checking", [&context, this](std::size_t partitionID) { checkingInit(context, partitionID); }, partitionNum, threadsNum, partitioner.get());
+		TableCheckpoint checkpoint(context.table_checkpoint_path, context.table_checkpoint_threads != 0 ? context.table_checkpoint_threads : threadsNum,
+					   "smallbank partitions=" + std::to_string(partitionNum) + " accounts=" + std::to_string(context.accountsPerPartition),
+					   coordinator_id);
+		auto checkpoint_files = get_checkpoint_files(partitionNum, partitioner.get());
+		if (context.table_checkpoint_path != "" && checkpoint.is_complete(checkpoint_files)) {
+			checkpoint.restore(checkpoint_files);
+			return;
+		}
+
+		// a partition loads all of its tables in one go, so the threads do not wait for each other after every table
+		initTables("partition",
+			   [&context, this](std::size_t partitionID) {
+				   savingsInit(context, partitionID);
+				   checkingInit(context, partitionID);
+			   },
+			   partitionNum, threadsNum, partitioner.get());
+
+		if (context.table_checkpoint_path != "") {
+			checkpoint.save(checkpoint_files);
+		}
 	}
 
 	void apply_operation(const Operation &operation)
@@ -198,7 +235,7 @@ class Database {
                                         sizeof(CCHashTable) * partitionNum, CXLMemory::INDEX_ALLOCATION));
                         for (int i = 0; i < partitionNum; i++) {
                                 auto cxl_table = &savings_cxl_hashtables[i];
-                                new(cxl_table) CCHashTable(cxl_hashtable_bkt_cnt);
+                                new(cxl_table) CCHashTable(context.accountsPerPartition);
                                 cxl_table_ptrs[savingsTableID * partitionNum + i] = reinterpret_cast<void *>(cxl_table);
                                 cxl_tbl_vecs[savingsTableID][i] = new CXLTableHashMap<savings::key>(cxl_table, savingsTableID, i);
                         }
@@ -209,7 +246,7 @@ class Database {
                                         sizeof(CCHashTable) * partitionNum, CXLMemory::INDEX_ALLOCATION));
                         for (int i = 0; i < partitionNum; i++) {
                                 auto cxl_table = &checking_cxl_hashtables[i];
-                                new(cxl_table) CCHashTable(cxl_hashtable_bkt_cnt);
+                                new(cxl_table) CCHashTable(context.accountsPerPartition);
                                 cxl_table_ptrs[checkingTableID * partitionNum + i] = reinterpret_cast<void *>(cxl_table);
                                 cxl_tbl_vecs[checkingTableID][i] = new CXLTableHashMap<checking::key>(cxl_table, checkingTableID, i);
                         }
@@ -269,18 +306,18 @@ class Database {
 		std::size_t partitionNum = context.partition_num;
 		std::size_t totalAccounts = accountsPerPartition * partitionNum;
 
-                for (auto i = partitionID * accountsPerPartition; i < (partitionID + 1) * accountsPerPartition; i++) {
-                        savings::key key(i);
-                        savings::value value(1000000000ull);    // same as Motor
+                auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+                        *static_cast<savings::key *>(key_ptr) = savings::key(partitionID * accountsPerPartition + row);
+                        *static_cast<savings::value *>(value_ptr) = savings::value(1000000000ull);    // same as Motor
+                };
 
-                        bool success = table->insert(&key, &value);
-                        CHECK(success == true);
-                }
+                bool success = table->bulk_insert(accountsPerPartition, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 savings::key max_key(UINT64_MAX);
                 savings::value dummy_value;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -293,18 +330,18 @@ class Database {
 		std::size_t partitionNum = context.partition_num;
 		std::size_t totalAccounts = accountsPerPartition * partitionNum;
 
-                for (auto i = partitionID * accountsPerPartition; i < (partitionID + 1) * accountsPerPartition; i++) {
-                        checking::key key(i);
-                        checking::value value(1000000000ull);    // same as Motor
+                auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+                        *static_cast<checking::key *>(key_ptr) = checking::key(partitionID * accountsPerPartition + row);
+                        *static_cast<checking::value *>(value_ptr) = checking::value(1000000000ull);    // same as Motor
+                };
 
-                        bool success = table->insert(&key, &value);
-                        CHECK(success == true);
-                }
+                bool success = table->bulk_insert(accountsPerPartition, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 checking::key max_key(UINT64_MAX);
                 checking::value dummy_value;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -313,8 +350,6 @@ class Database {
         std::atomic<uint64_t> global_total_commit{ 0 };
 
     private:
-        static constexpr uint64_t cxl_hashtable_bkt_cnt = 500000;
-
 	std::vector<ThreadPool *> threadpools;
 	WALLogger *checkpoint_file_writer = nullptr;
 
@@ -8,6 +8,7 @@
 #include "benchmark/tatp/Random.h"
 #include "benchmark/tatp/Schema.h"
 #include "common/Operation.h"
+#include "common/TableCheckpoint.h"
 #include "common/ThreadPool.h"
 #include "core/Macros.h"
 #include "core/Partitioner.h"
@@ -84,6 +85,25 @@ class Database {
 			  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count() << " milliseconds.";
 	}
 
+	// one snapshot file per partition this host loads, holding all of its tables
+	std::vector<TableCheckpoint::File> get_checkpoint_files(std::size_t partitionNum, Partitioner *partitioner)
+	{
+		std::vector<TableCheckpoint::File> files;
+
+		for (auto partitionID = 0u; partitionID < partitionNum; partitionID++) {
+			if (partitioner->is_partition_replicated_on_me(partitionID) == false) {
+				continue;
+			}
+			TableCheckpoint::File file;
+			file.name = "partition_" + std::to_string(partitionID);
+			for (auto &tables : tbl_vecs) {
+				file.tables.push_back(tables[partitionID]);
+			}
+			files.push_back(file);
+		}
+		return files;
+	}
+
 	void initialize(const Context &context)
 	{
 		if (context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_OFF || context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_ON) {
@@ -103,16 +123,16 @@ class Database {
 			auto subscriberTableID = tatp::subscriber::tableID;
 			if (context.protocol == "Sundial") {
 				tbl_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncSundial> >(subscriberTableID, partitionID));
+					make_hash_table<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncSundial>(context.hash_index, subscriberTableID, partitionID));
                         } else if (context.protocol == "SundialPasha") {
                                 tbl_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncSundialPasha> >(subscriberTableID, partitionID));
+					make_hash_table<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncSundialPasha>(context.hash_index, subscriberTableID, partitionID));
                         } else if (context.protocol == "TwoPL") {
                                 tbl_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncTwoPL> >(subscriberTableID, partitionID));
+					make_hash_table<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncTwoPL>(context.hash_index, subscriberTableID, partitionID));
                         } else if (context.protocol == "TwoPLPasha") {
                                 tbl_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncTwoPLPasha> >(subscriberTableID, partitionID));
+					make_hash_table<997, tatp::subscriber::key, tatp::subscriber::value, tatp::subscriber::KeyComparator, tatp::subscriber::ValueComparator, MetaInitFuncTwoPLPasha>(context.hash_index, subscriberTableID, partitionID));
 			} else if (context.protocol != "HStore") {
 				CHECK(0);
 			} else {
@@ -123,16 +143,16 @@ class Database {
                         auto sec_subscriberTableID = tatp::sec_subscriber::tableID;
 			if (context.protocol == "Sundial") {
 				tbl_sec_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncSundial> >(sec_subscriberTableID, partitionID));
+					make_hash_table<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncSundial>(context.hash_index, sec_subscriberTableID, partitionID));
                         } else if (context.protocol == "SundialPasha") {
                                 tbl_sec_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncSundialPasha> >(sec_subscriberTableID, partitionID));
+					make_hash_table<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncSundialPasha>(context.hash_index, sec_subscriberTableID, partitionID));
                         } else if (context.protocol == "TwoPL") {
                                 tbl_sec_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncTwoPL> >(sec_subscriberTableID, partitionID));
+					make_hash_table<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncTwoPL>(context.hash_index, sec_subscriberTableID, partitionID));
                         } else if (context.protocol == "TwoPLPasha") {
                                 tbl_sec_subscriber_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncTwoPLPasha> >(sec_subscriberTableID, partitionID));
+					make_hash_table<997, tatp::sec_subscriber::key, tatp::sec_subscriber::value, tatp::sec_subscriber::KeyComparator, tatp::sec_subscriber::ValueComparator, MetaInitFuncTwoPLPasha>(context.hash_index, sec_subscriberTableID, partitionID));
 			} else if (context.protocol != "HStore") {
 				CHECK(0);
 			} else {
@@ -143,16 +163,16 @@ class Database {
                         auto accessInfoTableID = tatp::access_info::tableID;
 			if (context.protocol == "Sundial") {
 				tbl_access_info_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncSundial> >(accessInfoTableID, partitionID));
+					make_hash_table<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncSundial>(context.hash_index, accessInfoTableID, partitionID));
                         } else if (context.protocol == "SundialPasha") {
                                 tbl_access_info_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncSundialPasha> >(accessInfoTableID, partitionID));
+					make_hash_table<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncSundialPasha>(context.hash_index, accessInfoTableID, partitionID));
                         } else if (context.protocol == "TwoPL") {
                                 tbl_access_info_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncTwoPL> >(accessInfoTableID, partitionID));
+					make_hash_table<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncTwoPL>(context.hash_index, accessInfoTableID, partitionID));
                         } else if (context.protocol == "TwoPLPasha") {
                                 tbl_access_info_vec.push_back(
-					std::make_unique<TableHashMap<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncTwoPLPasha> >(accessInfoTableID, partitionID));
+					make_hash_table<997, tatp::access_info::key, tatp::access_info::value, tatp::access_info::KeyComparator, tatp::access_info::ValueComparator, MetaInitFuncTwoPLPasha>(context.hash_index, accessInfoTableID, partitionID));
 			} else if (context.protocol != "HStore") {
 				CHECK(0);
 			} else {
@@ -173,10 +193,27 @@ class Database {
                 std::transform(tbl_sec_subscriber_vec.begin(), tbl_sec_subscriber_vec.end(), std::back_inserter(tbl_vecs[1]), tFunc);
                 std::transform(tbl_access_info_vec.begin(), tbl_access_info_vec.end(), std::back_inserter(tbl_vecs[2]), tFunc);
 
-		using std::placeholders::_1;
-		initTables("subscriber", [&context, this](std::size_t partitionID) { subscriberInit(context, partitionID); }, partitionNum, threadsNum, partitioner.get());
-                initTables("sec_subscriber", [&context, this](std::size_t partitionID) { secSubscriberInit(context, partitionID); }, partitionNum, threadsNum, partitioner.get());
-                initTables("access_info", [&context, this](std::size_t partitionID) { accessInfoInit(context, partitionID); }, partitionNum, threadsNum, partitioner.get());
+		TableCheckpoint checkpoint(context.table_checkpoint_path, context.table_checkpoint_threads != 0 ? context.table_checkpoint_threads : threadsNum,
+					   "tatp partitions=" + std::to_string(partitionNum) + " subscribers=" + std::to_string(context.numSubScriberPerPartition),
+					   coordinator_id);
+		auto checkpoint_files = get_checkpoint_files(partitionNum, partitioner.get());
+		if (context.table_checkpoint_path != "" && checkpoint.is_complete(checkpoint_files)) {
+			checkpoint.restore(checkpoint_files);
+			return;
+		}
+
+		// a partition loads all of its tables in one go, so the threads do not wait for each other after every table
+		initTables("partition",
+			   [&context, this](std::size_t partitionID) {
+				   subscriberInit(context, partitionID);
+				   secSubscriberInit(context, partitionID);
+				   accessInfoInit(context, partitionID);
+			   },
+			   partitionNum, threadsNum, partitioner.get());
+
+		if (context.table_checkpoint_path != "") {
+			checkpoint.save(checkpoint_files);
+		}
 	}
 
 	void apply_operation(const Operation &operation)
@@ -227,7 +264,7 @@ class Database {
                                         sizeof(CCHashTable) * partitionNum, CXLMemory::INDEX_ALLOCATION));
                         for (int i = 0; i < partitionNum; i++) {
                                 auto cxl_table = &subscriber_cxl_hashtables[i];
-                                new(cxl_table) CCHashTable(cxl_hashtable_bkt_cnt);
+                                new(cxl_table) CCHashTable(context.numSubScriberPerPartition);
                                 cxl_table_ptrs[subscriberTableID * partitionNum + i] = reinterpret_cast<void *>(cxl_table);
                                 cxl_tbl_vecs[subscriberTableID][i] = new CXLTableHashMap<subscriber::key>(cxl_table, subscriberTableID, i);
                         }
@@ -239,7 +276,7 @@ class Database {
                                         sizeof(CCHashTable) * partitionNum, CXLMemory::INDEX_ALLOCATION));
                         for (int i = 0; i < partitionNum; i++) {
                                 auto cxl_table = &sec_subscriber_cxl_hashtables[i];
-                                new(cxl_table) CCHashTable(cxl_hashtable_bkt_cnt);
+                                new(cxl_table) CCHashTable(context.numSubScriberPerPartition);
                                 cxl_table_ptrs[secSubscriberTableID * partitionNum + i] = reinterpret_cast<void *>(cxl_table);
                                 cxl_tbl_vecs[secSubscriberTableID][i] = new CXLTableHashMap<sec_subscriber::key>(cxl_table, secSubscriberTableID, i);
                         }
@@ -251,7 +288,8 @@ class Database {
                                         sizeof(CCHashTable) * partitionNum, CXLMemory::INDEX_ALLOCATION));
                         for (int i = 0; i < partitionNum; i++) {
                                 auto cxl_table = &access_info_cxl_hashtables[i];
-                                new(cxl_table) CCHashTable(cxl_hashtable_bkt_cnt);
+                                // up to one row per AI_TYPE (1-4) for each subscriber
+                                new(cxl_table) CCHashTable(context.numSubScriberPerPartition * 4);
                                 cxl_table_ptrs[accessInfoTableID * partitionNum + i] = reinterpret_cast<void *>(cxl_table);
                                 cxl_tbl_vecs[accessInfoTableID][i] = new CXLTableHashMap<access_info::key>(cxl_table, accessInfoTableID, i);
                         }
@@ -320,11 +358,13 @@ class Database {
 		std::size_t numSubScriberPerPartition = context.numSubScriberPerPartition;
 		std::size_t partitionNum = context.partition_num;
 
-                for (auto i = partitionID * numSubScriberPerPartition; i < (partitionID + 1) * numSubScriberPerPartition; i++) {
+                auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+                        auto i = partitionID * numSubScriberPerPartition + row;
                         DCHECK(context.getPartitionID(i) == partitionID);
 
-                        subscriber::key key(i);
-                        subscriber::value value;
+                        subscriber::key &key = *static_cast<subscriber::key *>(key_ptr);
+                        key = subscriber::key(i);
+                        subscriber::value &value = *static_cast<subscriber::value *>(value_ptr);
 
                         std::stringstream sub_nbr;
                         sub_nbr << std::setw(15) << std::setfill('0') << i;
@@ -335,15 +375,15 @@ class Database {
                         value.BYTES.assign(random.a_string(SUBSCRIBER_BYTES_SIZE, SUBSCRIBER_BYTES_SIZE));
                         value.MSC_LOCATION = random.uniform_dist(0, UINT32_MAX);
                         value.VLR_LOCATION = random.uniform_dist(0, UINT32_MAX);
+                };
 
-                        bool success = table->insert(&key, &value);
-                        CHECK(success == true);
-                }
+                bool success = table->bulk_insert(numSubScriberPerPartition, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 subscriber::key max_key(UINT32_MAX);
                 subscriber::value dummy_value;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -355,21 +395,22 @@ class Database {
 		std::size_t numSubScriberPerPartition = context.numSubScriberPerPartition;
 		std::size_t partitionNum = context.partition_num;
 
-                for (auto i = partitionID * numSubScriberPerPartition; i < (partitionID + 1) * numSubScriberPerPartition; i++) {
+                auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+                        auto i = partitionID * numSubScriberPerPartition + row;
                         DCHECK(context.getPartitionID(i) == partitionID);
 
-                        sec_subscriber::key key;
+                        sec_subscriber::key &key = *static_cast<sec_subscriber::key *>(key_ptr);
 
                         std::stringstream sub_nbr;
                         sub_nbr << std::setw(15) << std::setfill('0') << i;
                         key.SUB_NBR.assign(sub_nbr.str());
 
-                        sec_subscriber::value value;
+                        sec_subscriber::value &value = *static_cast<sec_subscriber::value *>(value_ptr);
                         value.S_ID = i;
+                };
 
-                        bool success = table->insert(&key, &value);
-                        CHECK(success == true);
-                }
+                bool success = table->bulk_insert(numSubScriberPerPartition, row_generator);
+                CHECK(success == true);
 
                 // secondary subscriber does not need a max key
                 // // insert a max key that represents the upper bound (for next-key locking)
@@ -392,47 +433,52 @@ class Database {
 		std::size_t numSubScriberPerPartition = context.numSubScriberPerPartition;
 		std::size_t partitionNum = context.partition_num;
 
-                for (auto i = partitionID * numSubScriberPerPartition; i < (partitionID + 1) * numSubScriberPerPartition; i++) {
+                // uint64_t record_num = random.uniform_dist(1, 4);
+                uint64_t record_num = 4;        // FIXME: TATP may fail a search, but our system currently does not support failed search
+                std::vector<uint8_t> used_ai_types;
+
+                // rows of a subscriber come out in random AI_TYPE order, bulk_insert sorts them
+                auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+                        auto i = partitionID * numSubScriberPerPartition + row / record_num;
                         DCHECK(context.getPartitionID(i) == partitionID);
 
-                        // uint64_t record_num = random.uniform_dist(1, 4);
-                        uint64_t record_num = 4;        // FIXME: TATP may fail a search, but our system currently does not support failed search
-                        std::vector<uint8_t> used_ai_types;
-                        for (auto j = 0; j < record_num; j++) {
-                                access_info::key key;
-                                key.S_ID = i;
-
-                                uint64_t unique_ai_type = 0;
-                                while (true) {
-                                        unique_ai_type = random.uniform_dist(1, 4);
-                                        bool used = false;
-                                        for (auto k = 0; k < used_ai_types.size(); k++) {
-                                                if (unique_ai_type == used_ai_types[k]) {
-                                                        used = true;
-                                                }
-                                        }
-                                        if (used == false) {
-                                                used_ai_types.push_back(unique_ai_type);
-                                                key.AI_TYPE = unique_ai_type;
-                                                break;
+                        if (row % record_num == 0) {
+                                used_ai_types.clear();
+                        }
+
+                        access_info::key &key = *static_cast<access_info::key *>(key_ptr);
+                        key.S_ID = i;
+
+                        uint64_t unique_ai_type = 0;
+                        while (true) {
+                                unique_ai_type = random.uniform_dist(1, 4);
+                                bool used = false;
+                                for (auto k = 0; k < used_ai_types.size(); k++) {
+                                        if (unique_ai_type == used_ai_types[k]) {
+                                                used = true;
                                         }
                                 }
+                                if (used == false) {
+                                        used_ai_types.push_back(unique_ai_type);
+                                        key.AI_TYPE = unique_ai_type;
+                                        break;
+                                }
+                        }
 
-                                access_info::value value;
-                                value.DATA_1 = random.uniform_dist(0, 255);
-                                value.DATA_2 = random.uniform_dist(0, 255);
-                                value.DATA_3.assign(random.a_string(ACCESS_INFO_DATA_3_SIZE, ACCESS_INFO_DATA_3_SIZE));
-                                value.DATA_4.assign(random.a_string(ACCESS_INFO_DATA_4_SIZE, ACCESS_INFO_DATA_4_SIZE));
+                        access_info::value &value = *static_cast<access_info::value *>(value_ptr);
+                        value.DATA_1 = random.uniform_dist(0, 255);
+                        value.DATA_2 = random.uniform_dist(0, 255);
+                        value.DATA_3.assign(random.a_string(ACCESS_INFO_DATA_3_SIZE, ACCESS_INFO_DATA_3_SIZE));
+                        value.DATA_4.assign(random.a_string(ACCESS_INFO_DATA_4_SIZE, ACCESS_INFO_DATA_4_SIZE));
+                };
 
-                                bool success = table->insert(&key, &value);
-                                CHECK(success == true);
-                        }
-                }
+                bool success = table->bulk_insert(numSubScriberPerPartition * record_num, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 access_info::key max_key(UINT32_MAX, UINT8_MAX);
                 access_info::value dummy_value;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -441,8 +487,6 @@ class Database {
         std::atomic<uint64_t> global_total_commit{ 0 };
 
     private:
-        static constexpr uint64_t cxl_hashtable_bkt_cnt = 500000;
-
 	std::vector<ThreadPool *> threadpools;
 	WALLogger *checkpoint_file_writer = nullptr;
 
@@ -16,6 +16,7 @@
 #include "benchmark/tpcc/Random.h"
 #include "benchmark/tpcc/Schema.h"
 #include "common/Operation.h"
+#include "common/TableCheckpoint.h"
 #include "common/ThreadPool.h"
 #include "common/WALLogger.h"
 #include "common/Time.h"
@@ -150,6 +151,33 @@ class Database {
 			  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count() << " milliseconds.";
 	}
 
+	// one snapshot file per partition this host loads, holding all of its tables but item
+	std::vector<TableCheckpoint::File> get_checkpoint_files(std::size_t partitionNum, Partitioner *partitioner)
+	{
+		std::vector<TableCheckpoint::File> files;
+
+		for (auto partitionID = 0u; partitionID < partitionNum; partitionID++) {
+			if (partitioner->is_partition_replicated_on_me(partitionID) == false) {
+				continue;
+			}
+			TableCheckpoint::File file;
+			file.name = "partition_" + std::to_string(partitionID);
+			for (auto &tables : tbl_vecs) {
+				if (tables.front() != tbl_item_vec[0].get()) {
+					file.tables.push_back(tables[partitionID]);
+				}
+			}
+			files.push_back(file);
+		}
+
+		// item is not partitioned, every host loads it
+		TableCheckpoint::File file;
+		file.name = "item";
+		file.tables.push_back(tbl_item_vec[0].get());
+		files.push_back(file);
+		return files;
+	}
+
 	void initialize(const Context &context)
 	{
 		if (context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_OFF || context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_ON) {
@@ -254,23 +282,23 @@ class Database {
 			auto customerNameIdxTableID = customer_name_idx::tableID;
 			if (context.protocol == "Sundial") {
 				tbl_customer_name_idx_vec.push_back(
-					std::make_unique<TableHashMap<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncSundial> >(
+					make_hash_table<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncSundial>(context.hash_index,
 						customerNameIdxTableID, partitionID));
                         } else if (context.protocol == "SundialPasha") {
 				tbl_customer_name_idx_vec.push_back(
-					std::make_unique<TableHashMap<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncSundialPasha> >(
+					make_hash_table<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncSundialPasha>(context.hash_index,
 						customerNameIdxTableID, partitionID));
                         } else if (context.protocol == "TwoPL") {
 				tbl_customer_name_idx_vec.push_back(
-					std::make_unique<TableHashMap<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncTwoPL> >(
+					make_hash_table<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncTwoPL>(context.hash_index,
 						customerNameIdxTableID, partitionID));
                         } else if (context.protocol == "TwoPLPasha") {
 				tbl_customer_name_idx_vec.push_back(
-					std::make_unique<TableHashMap<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncTwoPLPasha> >(
+					make_hash_table<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator, MetaInitFuncTwoPLPasha>(context.hash_index,
 						customerNameIdxTableID, partitionID));
 			} else {
 				tbl_customer_name_idx_vec.push_back(
-					std::make_unique<TableHashMap<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator> >(customerNameIdxTableID, partitionID));
+					make_hash_table<997, customer_name_idx::key, customer_name_idx::value, customer_name_idx::KeyComparator, customer_name_idx::ValueComparator>(context.hash_index, customerNameIdxTableID, partitionID));
 			}
 
 			auto historyTableID = history::tableID;
@@ -474,35 +502,37 @@ class Database {
 		DLOG(INFO) << "hash tables created in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count()
 			   << " milliseconds.";
 
-		using std::placeholders::_1;
-		initTables(
-			"warehouse", [this](std::size_t partitionID) { warehouseInit(partitionID); }, partitionNum, threadsNum, partitioner.get());
-		initTables(
-			"district", [this](std::size_t partitionID) { districtInit(partitionID); }, partitionNum, threadsNum, partitioner.get());
-		initTables(
-			"customer", [this](std::size_t partitionID) { customerInit(partitionID); }, partitionNum, threadsNum, partitioner.get());
-		initTables(
-			"customer_name_idx", [this](std::size_t partitionID) { customerNameIdxInit(partitionID); }, partitionNum, threadsNum,
-			partitioner.get());
-		initTables("history",
-			   [this](std::size_t partitionID) { historyInit(partitionID); },
-			   partitionNum, threadsNum, partitioner.get());
-		initTables("new_order",
-			   [this](std::size_t partitionID) { newOrderInit(partitionID); },
-			   partitionNum, threadsNum, partitioner.get());
-		initTables("order",
-			   [this](std::size_t partitionID) { orderInit(partitionID); },
-			   partitionNum, threadsNum, partitioner.get());
-                initTables("order_cust",
-			   [this](std::size_t partitionID) { orderCustInit(partitionID); },
-			   partitionNum, threadsNum, partitioner.get());
-		initTables("order_line",
-			   [this](std::size_t partitionID) { orderLineInit(partitionID); },
-			   partitionNum, threadsNum, partitioner.get());
+		TableCheckpoint checkpoint(context.table_checkpoint_path, context.table_checkpoint_threads != 0 ? context.table_checkpoint_threads : threadsNum,
+					   "tpcc partitions=" + std::to_string(partitionNum),
+					   coordinator_id);
+		auto checkpoint_files = get_checkpoint_files(partitionNum, partitioner.get());
+		if (context.table_checkpoint_path != "" && checkpoint.is_complete(checkpoint_files)) {
+			checkpoint.restore(checkpoint_files);
+			return;
+		}
+
+		// a partition loads all of its tables in one go, so the threads do not wait for each other after every table
 		initTables(
 			"item", [this](std::size_t partitionID) { itemInit(partitionID); }, 1, 1, nullptr);
 		initTables(
-			"stock", [this](std::size_t partitionID) { stockInit(partitionID); }, partitionNum, threadsNum, partitioner.get());
+			"partition",
+			[this](std::size_t partitionID) {
+				warehouseInit(partitionID);
+				districtInit(partitionID);
+				customerInit(partitionID);
+				customerNameIdxInit(partitionID);
+				historyInit(partitionID);
+				newOrderInit(partitionID);
+				orderInit(partitionID);
+				orderCustInit(partitionID);
+				orderLineInit(partitionID);
+				stockInit(partitionID);
+			},
+			partitionNum, threadsNum, partitioner.get());
+
+		if (context.table_checkpoint_path != "") {
+			checkpoint.save(checkpoint_files);
+		}
 	}
 
         void check_consistency(const Context &context)
@@ -1200,55 +1230,56 @@ class Database {
 		// For each row in the WAREHOUSE table, 10 rows in the DISTRICT table
 		// For each row in the DISTRICT table, 3,000 rows in the CUSTOMER table
 
-		for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
-			for (int j = 1; j <= CUSTOMER_PER_DISTRICT; j++) {
-				customer::key key;
-				key.C_W_ID = partitionID + 1;
-				key.C_D_ID = i;
-				key.C_ID = j;
-
-				customer::value value;
-				value.C_MIDDLE.assign("OE");
-				value.C_FIRST.assign(random.a_string(8, 16));
-				value.C_STREET_1.assign(random.a_string(10, 20));
-				value.C_STREET_2.assign(random.a_string(10, 20));
-				value.C_CITY.assign(random.a_string(10, 20));
-				value.C_STATE.assign(random.a_string(2, 2));
-				value.C_ZIP.assign(random.rand_zip());
-				value.C_PHONE.assign(random.n_string(16, 16));
-				value.C_SINCE = Time::now();
-				value.C_CREDIT_LIM = 50000;
-				value.C_DISCOUNT = static_cast<float>(random.uniform_dist(0, 5000)) / 10000;
-				value.C_BALANCE = -10;
-				value.C_YTD_PAYMENT = 10;
-				value.C_PAYMENT_CNT = 1;
-				value.C_DELIVERY_CNT = 1;
-				value.C_DATA.assign(random.a_string(300, 500));
-
-				int last_name;
-
-				if (j <= 1000) {
-					last_name = j - 1;
-				} else {
-					last_name = random.non_uniform_distribution(255, 0, 999);
-				}
-
-				value.C_LAST.assign(random.rand_last_name(last_name));
+		auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+			int i = row / CUSTOMER_PER_DISTRICT + 1;
+			int j = row % CUSTOMER_PER_DISTRICT + 1;
+
+			customer::key &key = *static_cast<customer::key *>(key_ptr);
+			key.C_W_ID = partitionID + 1;
+			key.C_D_ID = i;
+			key.C_ID = j;
+
+			customer::value &value = *static_cast<customer::value *>(value_ptr);
+			value.C_MIDDLE.assign("OE");
+			value.C_FIRST.assign(random.a_string(8, 16));
+			value.C_STREET_1.assign(random.a_string(10, 20));
+			value.C_STREET_2.assign(random.a_string(10, 20));
+			value.C_CITY.assign(random.a_string(10, 20));
+			value.C_STATE.assign(random.a_string(2, 2));
+			value.C_ZIP.assign(random.rand_zip());
+			value.C_PHONE.assign(random.n_string(16, 16));
+			value.C_SINCE = Time::now();
+			value.C_CREDIT_LIM = 50000;
+			value.C_DISCOUNT = static_cast<float>(random.uniform_dist(0, 5000)) / 10000;
+			value.C_BALANCE = -10;
+			value.C_YTD_PAYMENT = 10;
+			value.C_PAYMENT_CNT = 1;
+			value.C_DELIVERY_CNT = 1;
+			value.C_DATA.assign(random.a_string(300, 500));
+
+			int last_name;
+
+			if (j <= 1000) {
+				last_name = j - 1;
+			} else {
+				last_name = random.non_uniform_distribution(255, 0, 999);
+			}
 
-				// For 10% of the rows, selected at random , C_CREDIT = "BC"
+			value.C_LAST.assign(random.rand_last_name(last_name));
 
-				int x = random.uniform_dist(1, 10);
+			// For 10% of the rows, selected at random , C_CREDIT = "BC"
 
-				if (x == 1) {
-					value.C_CREDIT.assign("BC");
-				} else {
-					value.C_CREDIT.assign("GC");
-				}
+			int x = random.uniform_dist(1, 10);
 
-				bool success = table->insert(&key, &value);
-                                CHECK(success == true);
+			if (x == 1) {
+				value.C_CREDIT.assign("BC");
+			} else {
+				value.C_CREDIT.assign("GC");
 			}
-		}
+		};
+
+		bool success = table->bulk_insert(DISTRICT_PER_WAREHOUSE * CUSTOMER_PER_DISTRICT, row_generator);
+                CHECK(success == true);
 	}
 
 	void customerNameIdxInit(std::size_t partitionID)
@@ -1298,25 +1329,26 @@ class Database {
 		// For each row in the DISTRICT table, 3,000 rows in the CUSTOMER table
 		// For each row in the CUSTOMER table, 1 row in the HISTORY table
 
-		for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
-			for (int j = 1; j <= CUSTOMER_PER_DISTRICT; j++) {
-				history::key key;
+		auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+			int i = row / CUSTOMER_PER_DISTRICT + 1;
+			int j = row % CUSTOMER_PER_DISTRICT + 1;
 
-				key.H_W_ID = partitionID + 1;
-				key.H_D_ID = i;
-				key.H_C_W_ID = partitionID + 1;
-				key.H_C_D_ID = i;
-				key.H_C_ID = j;
-				key.H_DATE = Time::now();
+			history::key &key = *static_cast<history::key *>(key_ptr);
 
-				history::value value;
-				value.H_AMOUNT = 10;
-				value.H_DATA.assign(random.a_string(12, 24));
+			key.H_W_ID = partitionID + 1;
+			key.H_D_ID = i;
+			key.H_C_W_ID = partitionID + 1;
+			key.H_C_D_ID = i;
+			key.H_C_ID = j;
+			key.H_DATE = Time::now();
 
-				bool success = table->insert(&key, &value);
-                                CHECK(success == true);
-			}
-		}
+			history::value &value = *static_cast<history::value *>(value_ptr);
+			value.H_AMOUNT = 10;
+			value.H_DATA.assign(random.a_string(12, 24));
+		};
+
+		bool success = table->bulk_insert(DISTRICT_PER_WAREHOUSE * CUSTOMER_PER_DISTRICT, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 history::key max_key;
@@ -1327,7 +1359,7 @@ class Database {
                 max_key.H_C_D_ID = INT32_MAX;
                 max_key.H_C_ID = INT32_MAX;
                 max_key.H_DATE = INT64_MAX;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -1341,19 +1373,15 @@ class Database {
 		// For each row in the ORDER table from 2101 to 3000, 1 row in the NEW_ORDER
 		// table
 
-		for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
-			for (int j = 2101; j <= 3000; j++) {
-				new_order::key key;
-				key.NO_W_ID = partitionID + 1;
-				key.NO_D_ID = i;
-				key.NO_O_ID = j;
+		auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+			new_order::key &key = *static_cast<new_order::key *>(key_ptr);
+			key.NO_W_ID = partitionID + 1;
+			key.NO_D_ID = row / 900 + 1;
+			key.NO_O_ID = row % 900 + 2101;
+		};
 
-				new_order::value value;
-
-				bool success = table->insert(&key, &value);
-                                CHECK(success == true);
-			}
-		}
+		bool success = table->bulk_insert(DISTRICT_PER_WAREHOUSE * 900, row_generator);
+                CHECK(success == true);
 
                 // test correctness
                 for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
@@ -1389,7 +1417,7 @@ class Database {
                 max_key.NO_W_ID = INT32_MAX;
                 max_key.NO_D_ID = INT32_MAX;
                 max_key.NO_O_ID = INT32_MAX;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -1407,31 +1435,34 @@ class Database {
 			perm.push_back(i);
 		}
 
-		for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
-			std::shuffle(perm.begin(), perm.end(), std::default_random_engine());
+		auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+			int i = row / ORDER_PER_DISTRICT + 1;
+			int j = row % ORDER_PER_DISTRICT + 1;
 
-			for (int j = 1; j <= ORDER_PER_DISTRICT; j++) {
-				order::key key;
-				key.O_W_ID = partitionID + 1;
-				key.O_D_ID = i;
-				key.O_ID = j;
-
-				order::value value;
-				value.O_C_ID = perm[j - 1];
-				value.O_ENTRY_D = Time::now();
-				value.O_OL_CNT = random.uniform_dist(MIN_ORDER_LINE_PER_ORDER, MAX_ORDER_LINE_PER_ORDER);
-				value.O_ALL_LOCAL = true;
-
-				if (key.O_ID < 2101) {
-					value.O_CARRIER_ID = random.uniform_dist(1, 10);
-				} else {
-					value.O_CARRIER_ID = 0;
-				}
+			if (j == 1) {
+				std::shuffle(perm.begin(), perm.end(), std::default_random_engine());
+			}
 
-				bool success = table->insert(&key, &value);
-                                CHECK(success == true);
+			order::key &key = *static_cast<order::key *>(key_ptr);
+			key.O_W_ID = partitionID + 1;
+			key.O_D_ID = i;
+			key.O_ID = j;
+
+			order::value &value = *static_cast<order::value *>(value_ptr);
+			value.O_C_ID = perm[j - 1];
+			value.O_ENTRY_D = Time::now();
+			value.O_OL_CNT = random.uniform_dist(MIN_ORDER_LINE_PER_ORDER, MAX_ORDER_LINE_PER_ORDER);
+			value.O_ALL_LOCAL = true;
+
+			if (key.O_ID < 2101) {
+				value.O_CARRIER_ID = random.uniform_dist(1, 10);
+			} else {
+				value.O_CARRIER_ID = 0;
 			}
-		}
+		};
+
+		bool success = table->bulk_insert(DISTRICT_PER_WAREHOUSE * ORDER_PER_DISTRICT, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 order::key max_key;
@@ -1439,7 +1470,7 @@ class Database {
                 max_key.O_W_ID = INT32_MAX;
                 max_key.O_D_ID = INT32_MAX;
                 max_key.O_ID = INT32_MAX;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -1453,27 +1484,29 @@ class Database {
 
                 ITable *order_table = find_table(order::tableID, partitionID);
 
-                for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
-                        for (int j = 1; j <= ORDER_PER_DISTRICT; j++) {
-                                order::key order_key;
-				order_key.O_W_ID = partitionID + 1;
-				order_key.O_D_ID = i;
-				order_key.O_ID = j;
+                // rows come out in order-id order, bulk_insert sorts them by customer
+                auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+                        order::key order_key;
+                        order_key.O_W_ID = partitionID + 1;
+                        order_key.O_D_ID = row / ORDER_PER_DISTRICT + 1;
+                        order_key.O_ID = row % ORDER_PER_DISTRICT + 1;
 
-                                // no concurrent write, it is ok to read without validation on
-				// MetaDataType
-				const order::value &order_value = *static_cast<order::value *>(order_table->search_value(&order_key));
+                        // no concurrent write, it is ok to read without validation on
+                        // MetaDataType
+                        const order::value &order_value = *static_cast<order::value *>(order_table->search_value(&order_key));
 
-                                order_customer::key order_cust_key;
-                                order_cust_key.O_W_ID = order_key.O_W_ID;
-                                order_cust_key.O_D_ID = order_key.O_D_ID;
-                                order_cust_key.O_C_ID = order_value.O_C_ID;
-                                order_cust_key.O_ID = order_key.O_ID;
+                        order_customer::key &order_cust_key = *static_cast<order_customer::key *>(key_ptr);
+                        order_cust_key.O_W_ID = order_key.O_W_ID;
+                        order_cust_key.O_D_ID = order_key.O_D_ID;
+                        order_cust_key.O_C_ID = order_value.O_C_ID;
+                        order_cust_key.O_ID = order_key.O_ID;
 
-                                bool success = table->insert(&order_cust_key, &order_value);
-                                CHECK(success == true);
-                        }
-                }
+                        // same fields as order::value
+                        *static_cast<order_customer::value *>(value_ptr) = *reinterpret_cast<const order_customer::value *>(&order_value);
+                };
+
+                bool success = table->bulk_insert(DISTRICT_PER_WAREHOUSE * ORDER_PER_DISTRICT, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 order_customer::key max_key;
@@ -1482,7 +1515,7 @@ class Database {
                 max_key.O_D_ID = INT32_MAX;
                 max_key.O_C_ID = INT32_MAX;
                 max_key.O_ID = INT32_MAX;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 
                 // test correctness
@@ -1522,43 +1555,62 @@ class Database {
 
 		ITable *order_table = find_table(order::tableID, partitionID);
 
-		for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
-			order::key order_key;
-			order_key.O_W_ID = partitionID + 1;
+		order::key order_key;
+		order_key.O_W_ID = partitionID + 1;
+
+		// no concurrent write, it is ok to read without validation on
+		// MetaDataType
+		auto find_order = [&](int i, int j) -> const order::value & {
 			order_key.O_D_ID = i;
+			order_key.O_ID = j;
+			return *static_cast<order::value *>(order_table->search_value(&order_key));
+		};
 
+		std::size_t row_count = 0;
+		for (int i = 1; i <= DISTRICT_PER_WAREHOUSE; i++) {
 			for (int j = 1; j <= ORDER_PER_DISTRICT; j++) {
-				order_key.O_ID = j;
+				row_count += find_order(i, j).O_OL_CNT;
+			}
+		}
 
-				// no concurrent write, it is ok to read without validation on
-				// MetaDataType
-				const order::value &order_value = *static_cast<order::value *>(order_table->search_value(&order_key));
-
-				for (int k = 1; k <= order_value.O_OL_CNT; k++) {
-					order_line::key key;
-					key.OL_W_ID = partitionID + 1;
-					key.OL_D_ID = i;
-					key.OL_O_ID = j;
-					key.OL_NUMBER = k;
-
-					order_line::value value;
-					value.OL_I_ID = random.uniform_dist(1, 100000);
-					value.OL_SUPPLY_W_ID = partitionID + 1;
-					value.OL_QUANTITY = 5;
-					value.OL_DIST_INFO.assign(random.a_string(24, 24));
-
-					if (key.OL_O_ID < 2101) {
-						value.OL_DELIVERY_D = order_value.O_ENTRY_D;
-						value.OL_AMOUNT = 0;
-					} else {
-						value.OL_DELIVERY_D = 0;
-						value.OL_AMOUNT = static_cast<float>(random.uniform_dist(1, 999999)) / 100;
-					}
-					bool success = table->insert(&key, &value);
-                                        CHECK(success == true);
+		// the order line being generated is ol_number of order o_id in district d_id
+		int d_id = 1, o_id = 0, ol_number = 0;
+		const order::value *order_value = nullptr;
+
+		auto row_generator = [&](std::size_t, void *key_ptr, void *value_ptr) {
+			while (order_value == nullptr || ol_number == order_value->O_OL_CNT) {
+				if (++o_id > ORDER_PER_DISTRICT) {
+					d_id++;
+					o_id = 1;
 				}
+				order_value = &find_order(d_id, o_id);
+				ol_number = 0;
 			}
-		}
+			ol_number++;
+
+			order_line::key &key = *static_cast<order_line::key *>(key_ptr);
+			key.OL_W_ID = partitionID + 1;
+			key.OL_D_ID = d_id;
+			key.OL_O_ID = o_id;
+			key.OL_NUMBER = ol_number;
+
+			order_line::value &value = *static_cast<order_line::value *>(value_ptr);
+			value.OL_I_ID = random.uniform_dist(1, 100000);
+			value.OL_SUPPLY_W_ID = partitionID + 1;
+			value.OL_QUANTITY = 5;
+			value.OL_DIST_INFO.assign(random.a_string(24, 24));
+
+			if (key.OL_O_ID < 2101) {
+				value.OL_DELIVERY_D = order_value->O_ENTRY_D;
+				value.OL_AMOUNT = 0;
+			} else {
+				value.OL_DELIVERY_D = 0;
+				value.OL_AMOUNT = static_cast<float>(random.uniform_dist(1, 999999)) / 100;
+			}
+		};
+
+		bool success = table->bulk_insert(row_count, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 order_line::key max_key;
@@ -1567,7 +1619,7 @@ class Database {
                 max_key.OL_D_ID = INT32_MAX;
                 max_key.OL_O_ID = INT32_MAX;
                 max_key.OL_NUMBER = INT8_MAX;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 
                 // test correctness
@@ -1605,11 +1657,11 @@ class Database {
 
 		// 100,000 rows in the ITEM table
 
-		for (int i = 1; i <= ITEM_NUM; i++) {
-			item::key key;
-			key.I_ID = i;
+		auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+			item::key &key = *static_cast<item::key *>(key_ptr);
+			key.I_ID = row + 1;
 
-			item::value value;
+			item::value &value = *static_cast<item::value *>(value_ptr);
 			value.I_IM_ID = random.uniform_dist(1, 10000);
 			value.I_NAME.assign(random.a_string(14, 24));
 			value.I_PRICE = random.uniform_dist(1, 100);
@@ -1630,16 +1682,16 @@ class Database {
 			}
 
 			value.I_DATA.assign(i_data);
+		};
 
-			bool success = table->insert(&key, &value);
-                        CHECK(success == true);
-		}
+		bool success = table->bulk_insert(ITEM_NUM, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 item::key max_key;
                 item::value dummy_value;
                 max_key.I_ID = INT32_MAX;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -1652,12 +1704,12 @@ class Database {
 
 		// For each row in the WAREHOUSE table, 100,000 rows in the STOCK table
 
-		for (int i = 1; i <= STOCK_PER_WAREHOUSE; i++) {
-			stock::key key;
+		auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+			stock::key &key = *static_cast<stock::key *>(key_ptr);
 			key.S_W_ID = partitionID + 1; // partition_id from 0, W_ID from 1
-			key.S_I_ID = i;
+			key.S_I_ID = row + 1;
 
-			stock::value value;
+			stock::value &value = *static_cast<stock::value *>(value_ptr);
 
 			value.S_QUANTITY = random.uniform_dist(10, 100);
 			value.S_DIST_01.assign(random.a_string(24, 24));
@@ -1690,10 +1742,10 @@ class Database {
 			}
 
 			value.S_DATA.assign(s_data);
+		};
 
-			bool success = table->insert(&key, &value);
-                        CHECK(success == true);
-		}
+		bool success = table->bulk_insert(STOCK_PER_WAREHOUSE, row_generator);
+                CHECK(success == true);
 	}
 
     public:
@@ -8,6 +8,7 @@
 #include "benchmark/ycsb/Random.h"
 #include "benchmark/ycsb/Schema.h"
 #include "common/Operation.h"
+#include "common/TableCheckpoint.h"
 #include "common/ThreadPool.h"
 #include "core/Macros.h"
 #include "core/Partitioner.h"
@@ -82,6 +83,25 @@ class Database {
 			  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count() << " milliseconds.";
 	}
 
+	// one snapshot file per partition this host loads, holding all of its tables
+	std::vector<TableCheckpoint::File> get_checkpoint_files(std::size_t partitionNum, Partitioner *partitioner)
+	{
+		std::vector<TableCheckpoint::File> files;
+
+		for (auto partitionID = 0u; partitionID < partitionNum; partitionID++) {
+			if (partitioner->is_partition_replicated_on_me(partitionID) == false) {
+				continue;
+			}
+			TableCheckpoint::File file;
+			file.name = "partition_" + std::to_string(partitionID);
+			for (auto &tables : tbl_vecs) {
+				file.tables.push_back(tables[partitionID]);
+			}
+			files.push_back(file);
+		}
+		return files;
+	}
+
 	void initialize(const Context &context)
 	{
 		if (context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_OFF || context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_ON) {
@@ -111,7 +131,7 @@ class Database {
                                 tbl_ycsb_vec.push_back(
 					std::make_unique<TableBTreeOLC<ycsb::key, ycsb::value, ycsb::KeyComparator, ycsb::ValueComparator, MetaInitFuncTwoPLPasha> >(ycsbTableID, partitionID));
 			} else if (context.protocol != "HStore") {
-				tbl_ycsb_vec.push_back(std::make_unique<TableHashMap<997, ycsb::key, ycsb::value, ycsb::KeyComparator, ycsb::ValueComparator> >(ycsbTableID, partitionID));
+				tbl_ycsb_vec.push_back(make_hash_table<997, ycsb::key, ycsb::value, ycsb::KeyComparator, ycsb::ValueComparator>(context.hash_index, ycsbTableID, partitionID));
 			} else {
 				if (context.lotus_checkpoint == COW_ON_CHECKPOINT_OFF_LOGGING_ON ||
 				    context.lotus_checkpoint == COW_ON_CHECKPOINT_ON_LOGGING_OFF ||
@@ -130,9 +150,23 @@ class Database {
 
 		std::transform(tbl_ycsb_vec.begin(), tbl_ycsb_vec.end(), std::back_inserter(tbl_vecs[0]), tFunc);
 
+		TableCheckpoint checkpoint(context.table_checkpoint_path, context.table_checkpoint_threads != 0 ? context.table_checkpoint_threads : threadsNum,
+					   "ycsb partitions=" + std::to_string(partitionNum) + " keys=" + std::to_string(context.keysPerPartition) +
+					   " strategy=" + std::to_string(static_cast<int>(context.strategy)),
+					   coordinator_id);
+		auto checkpoint_files = get_checkpoint_files(partitionNum, partitioner.get());
+		if (context.table_checkpoint_path != "" && checkpoint.is_complete(checkpoint_files)) {
+			checkpoint.restore(checkpoint_files);
+			return;
+		}
+
 		using std::placeholders::_1;
 		initTables(
 			"ycsb", [&context, this](std::size_t partitionID) { ycsbInit(context, partitionID); }, partitionNum, threadsNum, partitioner.get());
+
+		if (context.table_checkpoint_path != "") {
+			checkpoint.save(checkpoint_files);
+		}
 	}
 
 	void apply_operation(const Operation &operation)
@@ -271,58 +305,41 @@ class Database {
 		std::size_t partitionNum = context.partition_num;
 		std::size_t totalKeys = keysPerPartition * partitionNum;
 
-		if (context.strategy == PartitionStrategy::RANGE) {
-			// use range partitioning
-
-			for (auto i = partitionID * keysPerPartition; i < (partitionID + 1) * keysPerPartition; i++) {
-				DCHECK(context.getPartitionID(i) == partitionID);
-
-				ycsb::key key(i);
-				ycsb::value value;
-				value.Y_F01.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F02.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F03.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F04.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F05.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F06.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F07.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F08.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F09.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F10.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-
-				bool success = table->insert(&key, &value);
-                                CHECK(success == true);
-			}
-
-		} else {
-			// use round-robin hash partitioning
-
-			for (auto i = partitionID; i < totalKeys; i += partitionNum) {
-				DCHECK(context.getPartitionID(i) == partitionID);
-
-				ycsb::key key(i);
-				ycsb::value value;
-				value.Y_F01.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F02.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F03.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F04.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F05.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F06.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F07.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F08.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F09.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-				value.Y_F10.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
-
-				bool success = table->insert(&key, &value);
-                                CHECK(success == true);
+		// the keys of a partition are increasing under both range and round-robin hash partitioning
+		auto row_generator = [&](std::size_t row, void *key_ptr, void *value_ptr) {
+			std::size_t i;
+			if (context.strategy == PartitionStrategy::RANGE) {
+				// use range partitioning
+				i = partitionID * keysPerPartition + row;
+			} else {
+				// use round-robin hash partitioning
+				i = partitionID + row * partitionNum;
 			}
-		}
+			DCHECK(i < totalKeys);
+			DCHECK(context.getPartitionID(i) == partitionID);
+
+			*static_cast<ycsb::key *>(key_ptr) = ycsb::key(i);
+			ycsb::value &value = *static_cast<ycsb::value *>(value_ptr);
+			value.Y_F01.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F02.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F03.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F04.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F05.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F06.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F07.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F08.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F09.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+			value.Y_F10.assign(random.a_string(YCSB_FIELD_SIZE, YCSB_FIELD_SIZE));
+		};
+
+		bool success = table->bulk_insert(keysPerPartition, row_generator);
+                CHECK(success == true);
 
                 // insert a max key that represents the upper bound (for next-key locking)
                 ycsb::key max_key;
                 ycsb::value dummy_value;
                 max_key.Y_KEY = INT32_MAX;
-                bool success = table->insert(&max_key, &dummy_value);
+                success = table->insert(&max_key, &dummy_value);
                 CHECK(success == true);
 	}
 
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "stdint.h"
+#include <atomic>
+#include <immintrin.h>
 #include "common/CXLMemory.h"
+#include "common/CXL_EBR.h"
 #include "common/CCSet.h"
 
 #include "atomic_offset_ptr.hpp"
@@ -10,33 +13,129 @@
 namespace star
 {
 
+/*
+ * Open-addressed hash index living in CXL memory and shared by all hosts.
+ *
+ * Buckets are exactly one cache line: a seqlock word, one tag byte per slot,
+ * the slots themselves (pointers to CCNode) and the head of an overflow
+ * chain. A key probes at most max_probe buckets linearly from its home
+ * bucket and stops at the first bucket that still has a never-used slot. If
+ * the whole probe window is taken, the node is chained off its home bucket
+ * instead, like the per-bucket lists of the chained table this replaced, so
+ * a table that was sized too small degrades rather than fails.
+ *
+ * Writers (insert/remove) serialize on the seqlock of the key's *home*
+ * bucket, even when the node sits in a later bucket. Readers never write to
+ * CXL: they snapshot the home seqlock, walk the probe sequence (and the home
+ * overflow chain if the window was full) and validate the snapshot
+ * afterwards, so a lookup costs shared cache-line reads only.
+ *
+ * Slots are claimed with a CAS on their tag since writers with different
+ * homes can probe into the same bucket. Nodes whose row set becomes empty
+ * are unlinked and reclaimed through CXL_EBR; optimistic readers that still
+ * hold the pointer are covered by the epoch they entered. A freed slot
+ * becomes a tombstone, which the next insert probing through it reuses.
+ */
 class CCHashTable {
     public:
-	CCHashTable(uint64_t bucket_cnt)
-                : bucket_cnt(bucket_cnt)
+        static constexpr uint64_t slots_per_bucket = 5;
+        static constexpr uint64_t max_probe = 8;        // buckets probed before overflowing
+
+        // tag values below tag_min are reserved
+        static constexpr uint8_t tag_empty = 0;         // never used; ends a probe sequence
+        static constexpr uint8_t tag_tombstone = 1;     // reclaimed node; reusable
+        static constexpr uint8_t tag_busy = 2;          // claimed by an in-flight insert
+        static constexpr uint8_t tag_min = 3;
+
+        // size for 'expected_keys' distinct keys at no more than 75% slot load
+	CCHashTable(uint64_t expected_keys)
+                : bucket_cnt((expected_keys * 4 / 3 + slots_per_bucket - 1) / slots_per_bucket + 1)
         {
-                buckets = reinterpret_cast<CCBucket *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(CCBucket) * bucket_cnt, 
+                // over-allocate so that buckets start on a cache line
+                char *raw = reinterpret_cast<char *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(CCBucket) * this->bucket_cnt + 64,
                         CXLMemory::INDEX_ALLOCATION));
-                for (int i = 0; i < bucket_cnt; i++)
+                buckets = reinterpret_cast<CCBucket *>((reinterpret_cast<uintptr_t>(raw) + 63) & ~static_cast<uintptr_t>(63));
+                for (uint64_t i = 0; i < this->bucket_cnt; i++)
                         new(&buckets[i]) CCBucket();
         }
 
 	char *search(uint64_t key)
         {
-                CCBucket *cur_bkt = &buckets[hash(key)];
-	        return cur_bkt->search(key);
+                uint64_t h = hash(key);
+                CCBucket *home = &buckets[h % bucket_cnt];
+                uint8_t tag = get_tag(h);
+
+                while (true) {
+                        uint64_t version = home->read_begin();
+                        uint64_t row_cnt = 0;
+                        char *ret = nullptr;
+                        CCNode *node = find_node(h, tag, key);
+
+                        // note that empty nodes may linger until they are unlinked
+                        if (node != nullptr) {
+                                row_cnt = node->rows.size();
+                                if (row_cnt > 0)
+                                        ret = node->rows.get_element(0);
+                        }
+                        if (home->read_validate(version) == true) {
+                                CHECK(row_cnt <= 1);
+                                return ret;
+                        }
+                }
         }
 
 	bool insert(uint64_t key, char *row)
         {
-                CCBucket *cur_bkt = &buckets[hash(key)];
-                return cur_bkt->insert(key, row);
+                uint64_t h = hash(key);
+                CCBucket *home = &buckets[h % bucket_cnt];
+                uint8_t tag = get_tag(h);
+                CCNode *node = nullptr;
+                bool ret = false;
+
+                home->write_lock();
+                node = find_node(h, tag, key);
+                if (node == nullptr) {
+                        node = reinterpret_cast<CCNode *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(CCNode),
+                                CXLMemory::INDEX_ALLOCATION));
+                        new(node) CCNode(key);
+                        ret = node->rows.insert(row);   // insert row into node
+                        DCHECK(ret == true);
+                        link_node(h, tag, node);        // publish the node
+                } else {
+                        // TODO. should differentiate between unique vs. nonunique indexes.
+                        ret = node->rows.insert(row);   // insert can fail if the row already exists
+                }
+                home->write_unlock();
+                return ret;
         }
 
 	bool remove(uint64_t key, char *row)
         {
-                CCBucket *cur_bkt = &buckets[hash(key)];
-                return cur_bkt->remove(key, row);
+                uint64_t h = hash(key);
+                CCBucket *home = &buckets[h % bucket_cnt];
+                uint8_t tag = get_tag(h);
+                CCBucket *bkt = nullptr;
+                uint64_t slot = 0;
+                bool ret = false;
+
+                home->write_lock();
+                CCNode *node = find_node(h, tag, key, &bkt, &slot);
+                if (node != nullptr) {
+                        ret = node->rows.remove(row);   // remove row from node
+
+                        // unlink and reclaim empty nodes. without EBR (e.g., during
+                        // loading) we keep them around to stay safe for readers.
+                        if (node->rows.empty() == true && global_ebr_meta != nullptr) {
+                                if (bkt != nullptr)
+                                        unlink_slot(bkt, slot);
+                                else
+                                        unlink_overflow(home, node);
+                                cxl_memory.cxlalloc_free_wrapper(node, sizeof(CCNode), CXLMemory::INDEX_FREE);
+                                global_ebr_meta->add_retired_object(node, sizeof(CCNode), CXLMemory::INDEX_FREE);
+                        }
+                }
+                home->write_unlock();
+                return ret;
         }
 
     private:
@@ -45,99 +144,178 @@ class CCHashTable {
 		CCNode(uint64_t key)
                 {
                         this->key = key;
-                        next = nullptr;
                         rows.clear();
                 }
 
 		uint64_t key;
                 CCSet rows;
-                boost::interprocess::offset_ptr<CCNode> next;
+                AtomicOffsetPtr<CCNode> next;   // overflow chain only
 	};
 
-	class CCBucket {
-	    public:
+	struct alignas(64) CCBucket {
                 CCBucket()
                 {
-                        first_node = nullptr;
-                        pthread_spin_init(&latch, PTHREAD_PROCESS_SHARED);
+                        for (uint64_t i = 0; i < slots_per_bucket; i++)
+                                tags[i].store(tag_empty, std::memory_order_relaxed);
                 }
 
-		char *search(uint64_t key)
+                // seqlock: odd while a writer whose home is this bucket is active
+                uint64_t read_begin()
                 {
-                        CCNode *node = nullptr;
-                        char *ret = nullptr;
-
-                        pthread_spin_lock(&latch);
-                        node = find_node(key);
-                        // note that we never delete the node
-                        // so we need to check if it is empty
-                        if (node != nullptr && node->rows.empty() == false) {
-                                CHECK(node->rows.size() == 1);
-                                ret = node->rows.get_element(0);
+                        uint64_t v = version.load(std::memory_order_acquire);
+                        while (v & 1) {
+                                _mm_pause();
+                                v = version.load(std::memory_order_acquire);
                         }
-                        pthread_spin_unlock(&latch);
-                        return ret;
+                        return v;
                 }
 
-		bool insert(uint64_t key, char *row)
+                bool read_validate(uint64_t v)
                 {
-                        CCNode *node = nullptr;
-                        bool ret = false;
-
-                        pthread_spin_lock(&latch);
-                        node = find_node(key);
-                        if (node == nullptr) {
-                                node = reinterpret_cast<CCNode *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(CCNode), 
-                                        CXLMemory::INDEX_ALLOCATION));
-                                new(node) CCNode(key);
-                                ret = node->rows.insert(row);   // insert row into node
-                                DCHECK(ret == true);
-                                node->next = first_node.get();  // insert node into bucket head
-                                first_node = node;
-                        } else {
-                                // TODO. should differentiate between unique vs. nonunique indexes.
-                                ret = node->rows.insert(row);   // insert can fail if the row already exists
-                        }
-                        pthread_spin_unlock(&latch);
-                        return ret;
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        return version.load(std::memory_order_relaxed) == v;
                 }
 
-		bool remove(uint64_t key, char *row)
+                void write_lock()
                 {
-                        CCNode *node = nullptr;
-                        bool ret = false;
-
-                        pthread_spin_lock(&latch);
-                        node = find_node(key);
-                        if (node != nullptr)
-                                ret = node->rows.remove(row);   // remove row from node
-                        // note that we do not delete the node
-                        // this avoids frequent alloc & free
-                        pthread_spin_unlock(&latch);
-                        return ret;
+                        uint64_t v = version.load(std::memory_order_relaxed);
+                        while (true) {
+                                if ((v & 1) == 0 &&
+                                    version.compare_exchange_weak(v, v + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                                        break;
+                                _mm_pause();
+                                v = version.load(std::memory_order_relaxed);
+                        }
+                        // the odd version must be visible before any slot or node update
+                        std::atomic_thread_fence(std::memory_order_release);
                 }
 
-	    private:
-                CCNode *find_node(uint64_t key)
+                void write_unlock()
                 {
-                        CCNode *cur_node = first_node.get();
+                        version.fetch_add(1, std::memory_order_release);
+                }
 
-                        while (cur_node != nullptr) {
-                                if (cur_node->key == key) {
-                                        return cur_node;
+                std::atomic<uint64_t> version{ 0 };
+                std::atomic<uint8_t> tags[slots_per_bucket];
+                uint8_t padding[8 - slots_per_bucket];
+                AtomicOffsetPtr<CCNode> slots[slots_per_bucket];
+                AtomicOffsetPtr<CCNode> overflow;       // nodes whose home is this bucket
+	};
+        static_assert(sizeof(CCBucket) == 64, "CCBucket must fill exactly one cache line");
+
+        uint64_t probe_len() const
+        {
+                return bucket_cnt < max_probe ? bucket_cnt : max_probe;
+        }
+
+        // walks the probe sequence of 'h', then the home overflow chain. safe for
+        // both optimistic readers and writers holding the home bucket's lock.
+        // '*bkt_out' is nullptr for a node found on the overflow chain.
+        CCNode *find_node(uint64_t h, uint8_t tag, uint64_t key, CCBucket **bkt_out = nullptr, uint64_t *slot_out = nullptr)
+        {
+                uint64_t idx = h % bucket_cnt;
+                CCBucket *home = &buckets[idx];
+
+                for (uint64_t probed = 0; probed < probe_len(); probed++) {
+                        CCBucket *bkt = &buckets[idx];
+                        bool seen_empty = false;
+
+                        for (uint64_t i = 0; i < slots_per_bucket; i++) {
+                                uint8_t cur_tag = bkt->tags[i].load(std::memory_order_acquire);
+                                if (cur_tag == tag) {
+                                        CCNode *node = bkt->slots[i].load(std::memory_order_acquire);
+                                        if (node != nullptr && node->key == key) {
+                                                if (bkt_out != nullptr) {
+                                                        *bkt_out = bkt;
+                                                        *slot_out = i;
+                                                }
+                                                return node;
+                                        }
+                                } else if (cur_tag == tag_empty) {
+                                        seen_empty = true;
                                 }
-                                cur_node = cur_node->next.get();
                         }
-                        return nullptr;
+                        // slots never go back to empty, so nothing with this home
+                        // was placed past here or overflowed
+                        if (seen_empty == true)
+                                return nullptr;
+                        idx = idx + 1 == bucket_cnt ? 0 : idx + 1;
                 }
 
-		boost::interprocess::offset_ptr<CCNode> first_node;
-		pthread_spinlock_t latch;
-	};
+                for (CCNode *node = home->overflow.load(std::memory_order_acquire); node != nullptr;
+                     node = node->next.load(std::memory_order_acquire)) {
+                        if (node->key == key) {
+                                if (bkt_out != nullptr)
+                                        *bkt_out = nullptr;
+                                return node;
+                        }
+                }
+                return nullptr;
+        }
+
+        // call with the home bucket of 'h' locked
+        void link_node(uint64_t h, uint8_t tag, CCNode *node)
+        {
+                uint64_t idx = h % bucket_cnt;
+                CCBucket *home = &buckets[idx];
+
+                for (uint64_t probed = 0; probed < probe_len(); probed++) {
+                        CCBucket *bkt = &buckets[idx];
+
+                        for (uint64_t i = 0; i < slots_per_bucket; i++) {
+                                uint8_t cur_tag = bkt->tags[i].load(std::memory_order_relaxed);
+                                if (cur_tag != tag_empty && cur_tag != tag_tombstone)
+                                        continue;
+                                if (bkt->tags[i].compare_exchange_strong(cur_tag, tag_busy, std::memory_order_acq_rel) == false)
+                                        continue;
+                                bkt->slots[i].store(node, std::memory_order_release);
+                                bkt->tags[i].store(tag, std::memory_order_release);
+                                return;
+                        }
+                        idx = idx + 1 == bucket_cnt ? 0 : idx + 1;
+                }
+
+                // probe window is full: push onto the home overflow chain
+                node->next.store(home->overflow.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                home->overflow.store(node, std::memory_order_release);
+        }
+
+        // call with the home bucket of the node locked
+        void unlink_slot(CCBucket *bkt, uint64_t slot)
+        {
+                bkt->slots[slot].store(nullptr, std::memory_order_relaxed);
+                bkt->tags[slot].store(tag_tombstone, std::memory_order_release);
+        }
+
+        // call with 'home' locked
+        void unlink_overflow(CCBucket *home, CCNode *node)
+        {
+                AtomicOffsetPtr<CCNode> *link = &home->overflow;
+                CCNode *cur = link->load(std::memory_order_relaxed);
+
+                while (cur != node) {
+                        DCHECK(cur != nullptr);
+                        link = &cur->next;
+                        cur = link->load(std::memory_order_relaxed);
+                }
+                // readers still on 'node' can follow its next pointer until it is reclaimed
+                link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+        }
+
+	static uint64_t hash(uint64_t key)
+        {
+                // murmur3 finalizer; the low bits pick the bucket, the top byte the tag
+                key ^= key >> 33;
+                key *= 0xff51afd7ed558ccdULL;
+                key ^= key >> 33;
+                key *= 0xc4ceb9fe1a85ec53ULL;
+                key ^= key >> 33;
+                return key;
+        }
 
-	uint64_t hash(uint64_t key)
+        static uint8_t get_tag(uint64_t h)
         {
-                return (key ^ (key / bucket_cnt)) % bucket_cnt;
+                return tag_min + (h >> 56) % (256 - tag_min);
         }
 
 	boost::interprocess::offset_ptr<CCBucket> buckets;
@@ -0,0 +1,269 @@
+//
+// Variable-length MPSC ring buffer for the CXL transport
+//
+
+#pragma once
+
+#include "common/Message.h"
+#include "common/CXLMemory.h"
+#include <boost/interprocess/offset_ptr.hpp>
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <xmmintrin.h>
+#include <glog/logging.h>
+
+namespace star
+{
+
+/*
+ * Unlike MPSCRingBuffer, which copies every send into a fixed-size entry, this
+ * ring is a byte stream of variable-length records:
+ *
+ * | record header (one cache line) | payload (rounded up to cache lines) |
+ *
+ * Producers reserve a record with a CAS on the tail, write the payload in
+ * place and publish it with one release store to the header. A record that
+ * would straddle the end of the ring is preceded by a padding record, so the
+ * consumer always sees a contiguous payload it can parse directly in CXL
+ * memory and hands the space back with release().
+ *
+ * head and tail are byte positions that only grow; the ring index is the
+ * position modulo the capacity. A record header may land on a line that held
+ * payload in the previous lap, so the consumer resets the header word of
+ * every line it hands back; a header that is not yet written reads as FREE.
+ */
+class CXLBatchRingBuffer {
+    public:
+        static constexpr uint64_t cacheline_size = 64;
+
+        struct RecordHeader {
+                enum : uint32_t { FREE = 0, READY = 1, PADDING = 2 };
+
+                std::atomic<uint32_t> state;
+                uint32_t size;          // payload bytes
+        };
+
+        CXLBatchRingBuffer(uint64_t capacity)
+                : capacity(round_up(capacity, cacheline_size))
+                , tail(0)
+                , head(0)
+        {
+                CHECK(this->capacity >= 2 * cacheline_size);
+                LOG(INFO) << "variable-length ringbuffer capacity: " << this->capacity;
+                buffer = reinterpret_cast<char *>(cxl_memory.cxlalloc_malloc_wrapper(this->capacity, CXLMemory::TRANSPORT_ALLOCATION));
+                for (uint64_t off = 0; off < this->capacity; off += cacheline_size) {
+                        RecordHeader *header = get_header(off);
+                        header->state.store(RecordHeader::FREE, std::memory_order_relaxed);
+                        header->size = 0;
+                }
+        }
+
+        uint64_t get_capacity()
+        {
+                return capacity;
+        }
+
+        // largest payload a single record can carry; anything larger might
+        // not fit between the tail and the end of the ring in an empty ring
+        uint64_t get_max_payload_size()
+        {
+                return capacity / 2 - cacheline_size;
+        }
+
+        /*
+         * Reserves a record for a payload of 'size' bytes and returns where to
+         * build it, or nullptr if the ring is full. The record becomes visible
+         * to the consumer only after publish().
+         */
+        char *reserve(uint64_t size)
+        {
+                uint64_t record_size = get_record_size(size);
+                uint64_t cur_tail = tail.load(std::memory_order_relaxed);
+                uint64_t padding = 0;
+
+                CHECK(size <= get_max_payload_size());
+
+                while (true) {
+                        uint64_t off = cur_tail % capacity;
+                        padding = off + record_size > capacity ? capacity - off : 0;
+                        if (cur_tail + padding + record_size - head.load(std::memory_order_acquire) > capacity)
+                                return nullptr;
+                        if (tail.compare_exchange_weak(cur_tail, cur_tail + padding + record_size, std::memory_order_acq_rel))
+                                break;
+                }
+
+                if (padding > 0) {
+                        RecordHeader *pad = get_header(cur_tail % capacity);
+                        pad->size = padding - cacheline_size;
+                        pad->state.store(RecordHeader::PADDING, std::memory_order_release);
+                        cur_tail += padding;
+                }
+
+                RecordHeader *header = get_header(cur_tail % capacity);
+                header->size = size;
+                return reinterpret_cast<char *>(header) + cacheline_size;
+        }
+
+        // makes a reserved record visible to the consumer
+        void publish(char *payload)
+        {
+                RecordHeader *header = reinterpret_cast<RecordHeader *>(payload - cacheline_size);
+
+                clwb(payload, header->size);
+                header->state.store(RecordHeader::READY, std::memory_order_release);
+        }
+
+        /*
+         * Returns the payload of the oldest published record in place. The
+         * record stays valid until release(); peek() keeps returning it.
+         */
+        bool peek(const char *&payload, uint64_t &size)
+        {
+                uint64_t cur_head = head.load(std::memory_order_relaxed);
+
+                while (true) {
+                        RecordHeader *header = get_header(cur_head % capacity);
+                        uint32_t state = header->state.load(std::memory_order_acquire);
+
+                        if (state == RecordHeader::FREE)
+                                return false;
+
+                        if (state == RecordHeader::PADDING) {
+                                cur_head = free_record(cur_head, header->size);
+                                continue;
+                        }
+
+                        payload = reinterpret_cast<char *>(header) + cacheline_size;
+                        size = header->size;
+                        clflush(payload, size);
+                        return true;
+                }
+        }
+
+        // hands the record returned by peek() back to the producers
+        void release()
+        {
+                uint64_t cur_head = head.load(std::memory_order_relaxed);
+                RecordHeader *header = get_header(cur_head % capacity);
+
+                DCHECK(header->state.load() == RecordHeader::READY);
+                free_record(cur_head, header->size);
+        }
+
+    private:
+        // returns the head position after the record at 'pos'
+        uint64_t free_record(uint64_t pos, uint64_t size)
+        {
+                uint64_t off = pos % capacity;
+                uint64_t record_size = get_record_size(size);
+
+                for (uint64_t line = off; line < off + record_size; line += cacheline_size) {
+                        get_header(line)->state.store(RecordHeader::FREE, std::memory_order_relaxed);
+                }
+                head.store(pos + record_size, std::memory_order_release);
+                return pos + record_size;
+        }
+
+        static uint64_t round_up(uint64_t num, uint64_t multiple)
+        {
+                return (num + multiple - 1) / multiple * multiple;
+        }
+
+        static uint64_t get_record_size(uint64_t size)
+        {
+                return cacheline_size + round_up(size, cacheline_size);
+        }
+
+        RecordHeader *get_header(uint64_t off)
+        {
+                return reinterpret_cast<RecordHeader *>(buffer.get() + off);
+        }
+
+        inline void clflush(const void *addr, uint64_t len)
+        {
+                for (uint64_t ptr = (uint64_t)addr & ~(cacheline_size - 1); ptr < (uint64_t)addr + len; ptr += cacheline_size) {
+                        _mm_clflushopt((void *)ptr);
+                }
+
+                // make sure clflush completes before reading the payload
+                _mm_sfence();
+        }
+
+        inline void clwb(const void *addr, uint64_t len)
+        {
+                for (uint64_t ptr = (uint64_t)addr & ~(cacheline_size - 1); ptr < (uint64_t)addr + len; ptr += cacheline_size) {
+                        _mm_clwb((void *)ptr);
+                }
+
+                // make sure the payload is written back before it is published
+                _mm_sfence();
+        }
+
+        uint64_t capacity;
+
+        // producers and the consumer spin on different cache lines
+        alignas(cacheline_size) std::atomic<uint64_t> tail;
+        alignas(cacheline_size) std::atomic<uint64_t> head;
+        alignas(cacheline_size) boost::interprocess::offset_ptr<char> buffer;
+};
+
+/*
+ * Receive side of a CXLBatchRingBuffer. A record carries a batch of
+ * serialized messages; each one is parsed straight out of CXL memory and the
+ * record is released as soon as its last message has been taken.
+ */
+class CXLBatchReader {
+    public:
+        CXLBatchReader(CXLBatchRingBuffer &cxl_ringbuffer)
+                : cxl_ringbuffer(&cxl_ringbuffer)
+        {
+        }
+
+        std::unique_ptr<Message> next_message()
+        {
+                if (record == nullptr) {
+                        if (cxl_ringbuffer->peek(record, record_size) == false)
+                                return nullptr;
+                        bytes_read = 0;
+                        records_read++;
+                }
+
+                // read header and deadbeef
+                auto header = *reinterpret_cast<const Message::header_type *>(record + bytes_read);
+                auto deadbeef = *reinterpret_cast<const Message::deadbeef_type *>(record + bytes_read + sizeof(header));
+
+                // check deadbeef
+                DCHECK(deadbeef == Message::DEADBEEF);
+                auto message = std::make_unique<Message>();
+                auto length = Message::get_message_length(header);
+                message->resize(length);
+
+                // the only copy on the receive path: CXL -> message
+                DCHECK(bytes_read + length <= record_size);
+                std::memcpy(message->get_raw_ptr(), record + bytes_read, length);
+                bytes_read += length;
+
+                if (bytes_read == record_size) {
+                        cxl_ringbuffer->release();
+                        record = nullptr;
+                }
+
+                return message;
+        }
+
+        std::size_t get_read_call_cnt()
+        {
+                return records_read;
+        }
+
+    private:
+        CXLBatchRingBuffer *cxl_ringbuffer;
+        const char *record{ nullptr };
+        uint64_t record_size{ 0 };
+        uint64_t bytes_read{ 0 };
+        std::size_t records_read{ 0 };
+};
+
+}
@@ -12,6 +12,10 @@
 #include "cxlalloc.h"
 #include <glog/logging.h>
 
+#ifdef TIGON_WITH_CXLTIME
+#include "cxltime.h"
+#endif
+
 namespace star
 {
 
@@ -45,6 +49,7 @@ class CXLMemory {
         static constexpr uint64_t cxl_lru_trackers_root_index = 2;
         static constexpr uint64_t cxl_global_epoch_root_index = 3;
         static constexpr uint64_t cxl_global_ebr_meta_root_index = 4;
+        static constexpr uint64_t cxl_aria_batch_root_index = 5;
 
         void init(Context context)
         {
@@ -73,6 +78,15 @@ class CXLMemory {
                           << ") on host " << host_id
                           << ": backend=" << backend
                           << " resource=" << resource;
+
+#ifdef TIGON_WITH_CXLTIME
+                // the mapped file stands in for CXL memory; CXLTIME_MODE decides how slow it is
+                if (effective_backend == "mmap") {
+                        int registered = cxltime_register_mapping(resource.c_str(), "cxlalloc");
+                        CHECK(cxltime_thread_init() == 0);
+                        LOG(INFO) << "cxltime tracking " << registered << " new mapping(s) of " << resource;
+                }
+#endif
         }
 
         // backward compatibility
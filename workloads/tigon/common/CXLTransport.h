@@ -5,11 +5,14 @@
 #pragma once
 
 #include <atomic>
+#include <vector>
 #include <glog/logging.h>
+#include <xmmintrin.h>
 
 #include "cxlalloc.h"
 #include "common/Message.h"
 #include "common/MPSCRingBuffer.h"
+#include "common/CXLBatchRingBuffer.h"
 
 namespace star
 {
@@ -20,23 +23,83 @@ class CXLTransport {
                 : cxl_ringbuffers(cxl_ringbuffers)
         {}
 
+        CXLTransport(CXLBatchRingBuffer *cxl_batch_ringbuffers)
+                : cxl_batch_ringbuffers(cxl_batch_ringbuffers)
+        {}
+
         void send(Message *message)
         {
                 auto dest_node_id = message->get_dest_node_id();
                 auto message_length = message->get_message_length();
 
+                if (cxl_batch_ringbuffers != nullptr) {
+                        char *payload = reserve(dest_node_id, message_length);
+                        memcpy(payload, message->get_raw_ptr(), message_length);
+                        cxl_batch_ringbuffers[dest_node_id].publish(payload);
+                        return;
+                }
+
                 uint64_t bytes_sent = 0;
                 bytes_sent = cxl_ringbuffers[dest_node_id].send(message->get_raw_ptr(), message_length);
                 CHECK(bytes_sent == message_length);
         }
 
+        /*
+         * Sends several messages to the same node as one record. With the
+         * variable-length ring they are serialized directly into CXL memory,
+         * skipping the GrouppedMessage staging copy.
+         */
+        void send_batch(uint64_t dest_node_id, const std::vector<Message *> &messages)
+        {
+                if (cxl_batch_ringbuffers == nullptr) {
+                        for (auto message : messages)
+                                send(message);
+                        return;
+                }
+
+                auto &ringbuffer = cxl_batch_ringbuffers[dest_node_id];
+                std::size_t i = 0;
+                while (i < messages.size()) {
+                        // as many messages as fit into one record
+                        uint64_t batch_size = messages[i]->get_message_length();
+                        std::size_t j = i + 1;
+                        while (j < messages.size() && batch_size + messages[j]->get_message_length() <= ringbuffer.get_max_payload_size()) {
+                                batch_size += messages[j]->get_message_length();
+                                j++;
+                        }
+
+                        char *payload = reserve(dest_node_id, batch_size);
+                        uint64_t offset = 0;
+                        for (; i < j; i++) {
+                                memcpy(payload + offset, messages[i]->get_raw_ptr(), messages[i]->get_message_length());
+                                offset += messages[i]->get_message_length();
+                        }
+                        ringbuffer.publish(payload);
+                }
+        }
+
         uint64_t recv(uint64_t src_node_id, char *buffer, uint64_t buffer_size)
         {
+                CHECK(cxl_ringbuffers != nullptr);
                 return cxl_ringbuffers[src_node_id].recv(buffer, buffer_size);
         }
 
+        CXLBatchRingBuffer *get_batch_ringbuffers()
+        {
+                return cxl_batch_ringbuffers;
+        }
+
     private:
+        char *reserve(uint64_t dest_node_id, uint64_t size)
+        {
+                char *payload = nullptr;
+                while ((payload = cxl_batch_ringbuffers[dest_node_id].reserve(size)) == nullptr)
+                        _mm_pause();
+                return payload;
+        }
+
         MPSCRingBuffer *cxl_ringbuffers = nullptr;
+        CXLBatchRingBuffer *cxl_batch_ringbuffers = nullptr;
 };
 
 extern CXLTransport *cxl_transport;
@@ -8,4 +8,13 @@ namespace star
 
 CXL_EBR *global_ebr_meta = nullptr;
 
+uint64_t ebr_retire_dram_object()
+{
+        if (global_ebr_meta == nullptr)
+                return ~0ull;
+
+        global_ebr_meta->note_retired_dram_object();
+        return global_ebr_meta->get_global_epoch();
+}
+
 } // namespace star
@@ -47,6 +47,9 @@ class CXL_EBR {
 
                 std::vector<retired_object> retired_objects[max_epoch];
 
+                // objects retired in the current local epoch that their owner frees itself, see note_retired_dram_object()
+                uint64_t retired_dram_objects;
+
                 // statistics
                 Percentile<uint64_t> garbage_size;
                 uint64_t max_garbage_size;
@@ -77,6 +80,7 @@ class CXL_EBR {
                 for (uint64_t i = 0; i < max_epoch; i++) {
                         local_ebr_meta.retired_objects[i].clear();
                 }
+                local_ebr_meta.retired_dram_objects = 0;
 
                 local_ebr_meta.garbage_size.clear();
                 local_ebr_meta.max_garbage_size = 0;
@@ -99,6 +103,31 @@ class CXL_EBR {
                 cur_retired_object_list.push_back(object);
         }
 
+        // counts a DRAM object towards advancing the global epoch; its owner frees it once
+        // get_global_epoch() is two epochs past the epoch it was retired in
+        void note_retired_dram_object()
+        {
+                get_local_ebr_meta().retired_dram_objects++;
+        }
+
+        uint64_t get_global_epoch()
+        {
+                return global_epoch.load(std::memory_order_acquire);
+        }
+
+        // false if enter_critical_section() would neither move the local epoch nor try to advance the global one
+        bool should_enter_critical_section()
+        {
+                EBRMetaLocal &local_ebr_meta = get_local_ebr_meta();
+                EBRMetaCXL &cxl_ebr_meta = cxl_ebr_meta_vec[local_ebr_meta.coordinator_id][local_ebr_meta.thread_id];
+                uint64_t cur_local_epoch = cxl_ebr_meta.local_epoch.load(std::memory_order_acquire);
+
+                if (global_epoch.load(std::memory_order_acquire) != cur_local_epoch) {
+                        return true;
+                }
+                return local_ebr_meta.retired_objects[cur_local_epoch % max_epoch].size() + local_ebr_meta.retired_dram_objects >= epoch_advance_threshold;
+        }
+
         void enter_critical_section()
         {
                 EBRMetaLocal &local_ebr_meta = get_local_ebr_meta();
@@ -115,7 +144,7 @@ class CXL_EBR {
                         std::vector<retired_object> &cur_retired_object_list = local_ebr_meta.retired_objects[cur_local_epoch % max_epoch];
 
                         // try to advance the global epoch
-                        if (cur_retired_object_list.size() >= epoch_advance_threshold) {
+                        if (cur_retired_object_list.size() + local_ebr_meta.retired_dram_objects >= epoch_advance_threshold) {
                                 bool advance_global_ebr = true;
 
                                 // check if all other threads have entered the current epoch
@@ -146,6 +175,7 @@ class CXL_EBR {
                 if (cur_local_epoch < cur_global_epoch) {
                         CHECK(cur_local_epoch == cur_global_epoch - 1);
                         cxl_ebr_meta.local_epoch.store(cur_global_epoch, std::memory_order_release);
+                        local_ebr_meta.retired_dram_objects = 0;
                 }
 
                 // now it is time to reclaim garbage in local_epoch - 2
@@ -205,4 +235,8 @@ class CXL_EBR {
 
 extern CXL_EBR *global_ebr_meta;
 
+// for DRAM structures that free their own garbage: counts one retired object and returns
+// the global epoch, or ~0 without EBR metadata; the object may be freed once the epoch is 2 higher
+uint64_t ebr_retire_dram_object();
+
 } // namespace star
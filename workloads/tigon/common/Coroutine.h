@@ -0,0 +1,76 @@
+//
+// Stackful coroutines for interleaving transactions on a worker thread
+//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ucontext.h>
+
+#include "glog/logging.h"
+
+namespace star
+{
+
+/*
+ * A coroutine runs its body on its own stack. resume() switches into the
+ * body until it calls yield() or returns; yield() switches back to the
+ * caller of resume(). Transactions keep their state on the stack across a
+ * yield, so the protocols need no change to be suspended at a remote wait.
+ */
+class Coroutine {
+    public:
+	static constexpr std::size_t default_stack_size = 1024 * 1024;
+
+	explicit Coroutine(std::function<void()> body, std::size_t stack_size = default_stack_size)
+		: body(std::move(body))
+		, stack(new char[stack_size])
+	{
+		CHECK(getcontext(&callee) == 0);
+		callee.uc_stack.ss_sp = stack.get();
+		callee.uc_stack.ss_size = stack_size;
+		callee.uc_link = &caller;
+
+		// makecontext only passes int arguments
+		auto self = reinterpret_cast<uintptr_t>(this);
+		makecontext(&callee, reinterpret_cast<void (*)()>(&Coroutine::trampoline), 2, static_cast<uint32_t>(self >> 32),
+			    static_cast<uint32_t>(self));
+	}
+
+	Coroutine(const Coroutine &) = delete;
+	Coroutine &operator=(const Coroutine &) = delete;
+
+	void resume()
+	{
+		DCHECK(finished == false);
+		CHECK(swapcontext(&caller, &callee) == 0);
+	}
+
+	void yield()
+	{
+		CHECK(swapcontext(&callee, &caller) == 0);
+	}
+
+	bool is_finished() const
+	{
+		return finished;
+	}
+
+    private:
+	static void trampoline(uint32_t high, uint32_t low)
+	{
+		auto self = reinterpret_cast<Coroutine *>((static_cast<uintptr_t>(high) << 32) | low);
+		self->body();
+		self->finished = true;
+		// returning switches to uc_link, i.e., the last caller of resume()
+	}
+
+    private:
+	std::function<void()> body;
+	std::unique_ptr<char[]> stack;
+	ucontext_t caller, callee;
+	bool finished = false;
+};
+} // namespace star
@@ -64,6 +64,12 @@ template <std::size_t N, class KeyType, class ValueType> class HashMap {
 		_map([](std::unordered_map<KeyType, ValueType> &map) { map.clear(); });
 	}
 
+	// makes room for 'count' keys in total, assuming they spread evenly over the stripes
+	void reserve(std::size_t count)
+	{
+		_map([count](std::unordered_map<KeyType, ValueType> &map) { map.reserve(count / N + 1); });
+	}
+
 	void iterate_non_const(std::function<void(const KeyType &, ValueType &)> processor, std::function<void()> unlock_processor)
 	{
 		std::vector<std::size_t> bucket_counts(N);
@@ -225,7 +231,9 @@ template <class KeyType, class ValueType> class UnsafeHashMap {
 
 	void iterate(std::function<void(const KeyType &, const ValueType &)> processor)
 	{
-		CHECK(false);
+		for (const auto &it : map) {
+			processor(it.first, it.second);
+		}
 	}
 
     private:
@@ -0,0 +1,536 @@
+//
+// Lock-free-read open-addressing hash map for DRAM tables
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include <immintrin.h>
+#include <glog/logging.h>
+
+#include "SpinLock.h"
+
+namespace star
+{
+
+// see common/CXL_EBR.h, which cannot be included here (it depends on core/Context.h, which includes the tables)
+uint64_t ebr_retire_dram_object();
+
+/*
+ * Drop-in alternative to HashMap (N stripes of std::unordered_map behind
+ * spinlocks), with the same bucket layout as CCHashTable:
+ *
+ * Buckets are one cache line holding a seqlock word, a word of one-byte key
+ * tags and six slots pointing to nodes. A key probes buckets linearly from
+ * its home bucket and stops at the first bucket that still has a never-used
+ * slot; the tags of a bucket are matched against the key's tag with one SSE
+ * compare.
+ *
+ * Lookups take no lock and write nothing: they snapshot the home bucket's
+ * seqlock, probe and validate. Writers serialize on the seqlock of the home
+ * bucket and claim slots with a CAS on the tag word.
+ *
+ * Rows live in nodes that never move, so references returned by operator[]
+ * and search() stay valid across resizes (tables hand out pointers to their
+ * rows). Growing the map only rehashes tags and node pointers into a table
+ * twice as large. Removed nodes and replaced bucket arrays are retired with
+ * the global EBR epoch and freed once it has advanced twice, i.e. after
+ * every worker has finished the transactions that could still see them.
+ * Without EBR metadata they are kept until destruction.
+ *
+ * N is the initial number of buckets (rounded up to a power of two).
+ */
+template <std::size_t N, class KeyType, class ValueType> class OpenHashMap {
+    public:
+	using hasher = std::hash<KeyType>;
+
+        static constexpr uint64_t slots_per_bucket = 6;
+
+        // tag values below tag_min are reserved
+        static constexpr uint8_t tag_empty = 0;         // never used; ends a probe sequence
+        static constexpr uint8_t tag_tombstone = 1;     // removed node; reusable
+        static constexpr uint8_t tag_busy = 2;          // claimed by an in-flight insert
+        static constexpr uint8_t tag_min = 3;
+
+        OpenHashMap()
+        {
+                uint64_t bucket_cnt = 1;
+                while (bucket_cnt < N)
+                        bucket_cnt <<= 1;
+                array_.store(new BucketArray(bucket_cnt), std::memory_order_release);
+        }
+
+        ~OpenHashMap()
+        {
+                free_nodes(array_.load());
+                for (auto &retired : retired_nodes_)
+                        delete retired.second;
+                for (auto &retired : retired_arrays_)
+                        delete retired.second;
+                delete array_.load();
+        }
+
+        OpenHashMap(const OpenHashMap &) = delete;
+        OpenHashMap &operator=(const OpenHashMap &) = delete;
+
+	bool remove(const KeyType &key)
+	{
+                uint64_t h = hash(key);
+                uint8_t tag = get_tag(h);
+                Bucket *bkt = nullptr;
+                uint64_t slot = 0;
+
+                BucketArray *arr = lock_home(h);
+                Bucket *home = arr->home(h);
+                Node *node = arr->find(h, tag, key, &bkt, &slot);
+                if (node != nullptr) {
+                        bkt->slots[slot].store(nullptr, std::memory_order_relaxed);
+                        bkt->set_tag(slot, tag_tombstone);
+                        size_.fetch_sub(1, std::memory_order_relaxed);
+                }
+                home->write_unlock();
+
+                if (node == nullptr)
+                        return false;
+
+                // callers may still hold references to the row
+                retired_lock_.lock();
+                retire(retired_nodes_, node, last_node_reclaim_epoch_);
+                retired_lock_.unlock();
+                return true;
+	}
+
+        ValueType *search(const KeyType &key)
+        {
+                uint64_t h = hash(key);
+                Node *node = find_optimistic(h, get_tag(h), key);
+                return node == nullptr ? nullptr : &node->value;
+        }
+
+	bool contains(const KeyType &key)
+	{
+                return search(key) != nullptr;
+	}
+
+	bool insert(const KeyType &key, const ValueType &value)
+	{
+                bool inserted = false;
+                insert_node(key, [&]() { return new Node(key, value); }, inserted);
+                return inserted;
+	}
+
+	ValueType &operator[](const KeyType &key)
+	{
+                ValueType *value = search(key);
+                if (value != nullptr)
+                        return *value;
+
+                bool inserted = false;
+                return insert_node(key, [&]() { return new Node(key); }, inserted)->value;
+	}
+
+	std::size_t size()
+	{
+		return size_.load(std::memory_order_relaxed);
+	}
+
+        // not safe against concurrent accesses
+	void clear()
+	{
+                BucketArray *arr = array_.load();
+                free_nodes(arr);
+                for (uint64_t i = 0; i < arr->bucket_cnt; i++)
+                        new(&arr->buckets[i]) Bucket();
+                arr->used.store(0);
+                size_.store(0);
+	}
+
+        // sizes the bucket array for 'count' keys in total, so that inserting them never grows it
+        void reserve(std::size_t count)
+        {
+                std::lock_guard<std::mutex> guard(resize_mutex_);
+
+                BucketArray *arr = array_.load(std::memory_order_acquire);
+                uint64_t bucket_cnt = arr->bucket_cnt;
+                while (bucket_cnt * slots_per_bucket * 3 / 4 < count)
+                        bucket_cnt <<= 1;
+                if (bucket_cnt != arr->bucket_cnt)
+                        rehash(arr, bucket_cnt);
+        }
+
+	void iterate_non_const(std::function<void(const KeyType &, ValueType &)> processor, std::function<void()> unlock_processor)
+	{
+                for_each_node([&](Node *node) { processor(node->key, node->value); }, unlock_processor);
+	}
+
+	void iterate(std::function<void(const KeyType &, const ValueType &)> processor, std::function<void()> unlock_processor)
+	{
+                for_each_node([&](Node *node) { processor(node->key, node->value); }, unlock_processor);
+	}
+
+    private:
+        struct Node {
+                Node(const KeyType &key)
+                        : key(key)
+                        , value()
+                {
+                }
+
+                Node(const KeyType &key, const ValueType &value)
+                        : key(key)
+                        , value(value)
+                {
+                }
+
+                uint64_t hash{ 0 };
+                KeyType key;
+                ValueType value;
+        };
+
+	struct alignas(64) Bucket {
+                // seqlock: odd while a writer whose home is this bucket is active
+                uint64_t read_begin()
+                {
+                        uint64_t v = version.load(std::memory_order_acquire);
+                        while (v & 1) {
+                                _mm_pause();
+                                v = version.load(std::memory_order_acquire);
+                        }
+                        return v;
+                }
+
+                bool read_validate(uint64_t v)
+                {
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        return version.load(std::memory_order_relaxed) == v;
+                }
+
+                void write_lock()
+                {
+                        uint64_t v = version.load(std::memory_order_relaxed);
+                        while (true) {
+                                if ((v & 1) == 0 &&
+                                    version.compare_exchange_weak(v, v + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                                        break;
+                                _mm_pause();
+                                v = version.load(std::memory_order_relaxed);
+                        }
+                        // the odd version must be visible before any slot or node update
+                        std::atomic_thread_fence(std::memory_order_release);
+                }
+
+                void write_unlock()
+                {
+                        version.fetch_add(1, std::memory_order_release);
+                }
+
+                // bit i is set if the tag of slot i equals 'tag'
+                static uint32_t match(uint64_t tag_word, uint8_t tag)
+                {
+                        __m128i tags = _mm_cvtsi64_si128(static_cast<long long>(tag_word));
+                        __m128i eq = _mm_cmpeq_epi8(tags, _mm_set1_epi8(static_cast<char>(tag)));
+                        return _mm_movemask_epi8(eq) & ((1u << slots_per_bucket) - 1);
+                }
+
+                // moves slot i from empty or tombstone to busy
+                bool claim(uint64_t i, uint8_t &old_tag)
+                {
+                        uint64_t w = tags.load(std::memory_order_relaxed);
+                        while (true) {
+                                old_tag = (w >> (i * 8)) & 0xff;
+                                if (old_tag != tag_empty && old_tag != tag_tombstone)
+                                        return false;
+                                uint64_t new_w = (w & ~(0xffull << (i * 8))) | (static_cast<uint64_t>(tag_busy) << (i * 8));
+                                if (tags.compare_exchange_weak(w, new_w, std::memory_order_acq_rel, std::memory_order_relaxed))
+                                        return true;
+                        }
+                }
+
+                void set_tag(uint64_t i, uint8_t tag)
+                {
+                        uint64_t w = tags.load(std::memory_order_relaxed);
+                        while (true) {
+                                uint64_t new_w = (w & ~(0xffull << (i * 8))) | (static_cast<uint64_t>(tag) << (i * 8));
+                                if (tags.compare_exchange_weak(w, new_w, std::memory_order_release, std::memory_order_relaxed))
+                                        return;
+                        }
+                }
+
+                std::atomic<uint64_t> version{ 0 };
+                std::atomic<uint64_t> tags{ 0 };       // byte i is the tag of slot i
+                std::atomic<Node *> slots[slots_per_bucket] = {};
+	};
+        static_assert(sizeof(Bucket) == 64, "Bucket must fill exactly one cache line");
+
+        struct BucketArray {
+                BucketArray(uint64_t bucket_cnt)
+                        : bucket_cnt(bucket_cnt)
+                        , max_used(bucket_cnt * slots_per_bucket * 3 / 4)
+                {
+                        CHECK((bucket_cnt & (bucket_cnt - 1)) == 0);
+                        CHECK(posix_memalign(reinterpret_cast<void **>(&buckets), sizeof(Bucket), sizeof(Bucket) * bucket_cnt) == 0);
+                        for (uint64_t i = 0; i < bucket_cnt; i++)
+                                new(&buckets[i]) Bucket();
+                }
+
+                ~BucketArray()
+                {
+                        free(buckets);
+                }
+
+                Bucket *home(uint64_t h)
+                {
+                        return &buckets[h & (bucket_cnt - 1)];
+                }
+
+                // walks the probe sequence of 'h'. safe for both optimistic
+                // readers and writers holding the home bucket's lock.
+                Node *find(uint64_t h, uint8_t tag, const KeyType &key, Bucket **bkt_out = nullptr, uint64_t *slot_out = nullptr)
+                {
+                        uint64_t idx = h & (bucket_cnt - 1);
+
+                        for (uint64_t probed = 0; probed < bucket_cnt; probed++) {
+                                Bucket *bkt = &buckets[idx];
+                                uint64_t tag_word = bkt->tags.load(std::memory_order_acquire);
+
+                                for (uint32_t m = Bucket::match(tag_word, tag); m != 0; m &= m - 1) {
+                                        uint64_t i = __builtin_ctz(m);
+                                        Node *node = bkt->slots[i].load(std::memory_order_acquire);
+                                        if (node != nullptr && node->hash == h && node->key == key) {
+                                                if (bkt_out != nullptr) {
+                                                        *bkt_out = bkt;
+                                                        *slot_out = i;
+                                                }
+                                                return node;
+                                        }
+                                }
+                                if (Bucket::match(tag_word, tag_empty) != 0)
+                                        return nullptr;
+                                idx = (idx + 1) & (bucket_cnt - 1);
+                        }
+                        return nullptr;
+                }
+
+                // call with the home bucket of 'node' locked; returns false if the array is full
+                bool link(uint8_t tag, Node *node)
+                {
+                        uint64_t idx = node->hash & (bucket_cnt - 1);
+
+                        for (uint64_t probed = 0; probed < bucket_cnt; probed++) {
+                                Bucket *bkt = &buckets[idx];
+
+                                for (uint64_t i = 0; i < slots_per_bucket; i++) {
+                                        uint8_t old_tag;
+                                        if (bkt->claim(i, old_tag) == false)
+                                                continue;
+                                        if (old_tag == tag_empty)
+                                                used.fetch_add(1, std::memory_order_relaxed);
+                                        bkt->slots[i].store(node, std::memory_order_release);
+                                        bkt->set_tag(i, tag);
+                                        return true;
+                                }
+                                idx = (idx + 1) & (bucket_cnt - 1);
+                        }
+                        return false;
+                }
+
+                Bucket *buckets{ nullptr };
+                uint64_t bucket_cnt;
+                uint64_t max_used;                      // grow beyond this many non-empty slots
+                std::atomic<uint64_t> used{ 0 };        // non-empty slots, including tombstones
+        };
+
+        Node *find_optimistic(uint64_t h, uint8_t tag, const KeyType &key)
+        {
+                while (true) {
+                        // reload the array on every retry; a resize keeps the old one locked until the new one is published
+                        BucketArray *arr = array_.load(std::memory_order_acquire);
+                        Bucket *home = arr->home(h);
+                        uint64_t version = home->version.load(std::memory_order_acquire);
+                        if (version & 1) {
+                                _mm_pause();
+                                continue;
+                        }
+                        Node *node = arr->find(h, tag, key);
+                        if (home->read_validate(version) == true)
+                                return node;
+                }
+        }
+
+        // locks the home bucket of 'h' in the current array
+        BucketArray *lock_home(uint64_t h)
+        {
+                while (true) {
+                        BucketArray *arr = array_.load(std::memory_order_acquire);
+                        Bucket *home = arr->home(h);
+                        home->write_lock();
+                        if (array_.load(std::memory_order_acquire) == arr)
+                                return arr;
+                        home->write_unlock();
+                }
+        }
+
+        template <class NewNodeFunc> Node *insert_node(const KeyType &key, NewNodeFunc new_node, bool &inserted)
+        {
+                uint64_t h = hash(key);
+                uint8_t tag = get_tag(h);
+
+                while (true) {
+                        BucketArray *arr = array_.load(std::memory_order_acquire);
+                        if (arr->used.load(std::memory_order_relaxed) >= arr->max_used) {
+                                grow(arr);
+                                continue;
+                        }
+
+                        arr = lock_home(h);
+                        Bucket *home = arr->home(h);
+                        Node *node = arr->find(h, tag, key);
+                        if (node != nullptr) {
+                                home->write_unlock();
+                                inserted = false;
+                                return node;
+                        }
+
+                        node = new_node();
+                        node->hash = h;
+                        if (arr->link(tag, node) == false) {
+                                home->write_unlock();
+                                delete node;
+                                grow(arr);
+                                continue;
+                        }
+                        home->write_unlock();
+
+                        size_.fetch_add(1, std::memory_order_relaxed);
+                        inserted = true;
+                        return node;
+                }
+        }
+
+        // doubles the bucket array unless someone else already replaced 'arr'
+        void grow(BucketArray *arr)
+        {
+                std::lock_guard<std::mutex> guard(resize_mutex_);
+
+                if (array_.load(std::memory_order_acquire) != arr)
+                        return;
+                rehash(arr, arr->bucket_cnt * 2);
+        }
+
+        // moves everything in 'arr' to a new array of 'bucket_cnt' buckets; call with resize_mutex_ held
+        void rehash(BucketArray *arr, uint64_t bucket_cnt)
+        {
+                // writers hold at most one bucket lock and never wait for another
+                for (uint64_t i = 0; i < arr->bucket_cnt; i++)
+                        arr->buckets[i].write_lock();
+
+                BucketArray *new_arr = new BucketArray(bucket_cnt);
+                for (uint64_t i = 0; i < arr->bucket_cnt; i++) {
+                        Bucket *bkt = &arr->buckets[i];
+                        uint64_t tag_word = bkt->tags.load(std::memory_order_relaxed);
+                        for (uint64_t j = 0; j < slots_per_bucket; j++) {
+                                uint8_t tag = (tag_word >> (j * 8)) & 0xff;
+                                if (tag < tag_min)
+                                        continue;
+                                bool ok = new_arr->link(tag, bkt->slots[j].load(std::memory_order_relaxed));
+                                CHECK(ok == true);
+                        }
+                }
+                array_.store(new_arr, std::memory_order_release);
+                retire(retired_arrays_, arr, last_array_reclaim_epoch_);
+
+                // waiters re-check the array after they get the lock
+                for (uint64_t i = 0; i < arr->bucket_cnt; i++)
+                        arr->buckets[i].write_unlock();
+        }
+
+        template <class Func> void for_each_node(Func func, std::function<void()> &unlock_processor)
+        {
+                BucketArray *arr = array_.load(std::memory_order_acquire);
+
+                for (uint64_t i = 0; i < arr->bucket_cnt; i++) {
+                        Bucket *bkt = &arr->buckets[i];
+                        uint64_t tag_word = bkt->tags.load(std::memory_order_acquire);
+                        for (uint64_t j = 0; j < slots_per_bucket; j++) {
+                                if (((tag_word >> (j * 8)) & 0xff) < tag_min)
+                                        continue;
+                                Node *node = bkt->slots[j].load(std::memory_order_acquire);
+                                if (node != nullptr)
+                                        func(node);
+                        }
+                        unlock_processor();
+                }
+        }
+
+        static constexpr uint64_t no_epoch = ~0ull;
+
+        // queues 'ptr' for deletion, and deletes what earlier epochs retired
+        // if the global epoch moved since the last call; call with the list's lock held
+        template <class T> static void retire(std::vector<std::pair<uint64_t, T *> > &retired, T *ptr, uint64_t &last_reclaim_epoch)
+        {
+                uint64_t epoch = ebr_retire_dram_object();
+                retired.emplace_back(epoch, ptr);
+                if (epoch == no_epoch || epoch == last_reclaim_epoch)
+                        return;
+                last_reclaim_epoch = epoch;
+
+                // workers still in a transaction from before the epoch moved twice announce at least retired epoch + 1
+                auto it = std::partition(retired.begin(), retired.end(), [&](const std::pair<uint64_t, T *> &r) {
+                        return r.first == no_epoch || r.first + 2 > epoch;
+                });
+                for (auto i = it; i != retired.end(); i++)
+                        delete i->second;
+                retired.erase(it, retired.end());
+        }
+
+        void free_nodes(BucketArray *arr)
+        {
+                for (uint64_t i = 0; i < arr->bucket_cnt; i++) {
+                        Bucket *bkt = &arr->buckets[i];
+                        uint64_t tag_word = bkt->tags.load(std::memory_order_relaxed);
+                        for (uint64_t j = 0; j < slots_per_bucket; j++) {
+                                if (((tag_word >> (j * 8)) & 0xff) >= tag_min)
+                                        delete bkt->slots[j].load(std::memory_order_relaxed);
+                        }
+                }
+        }
+
+	uint64_t hash(const KeyType &key)
+        {
+                // murmur3 finalizer on top of std::hash, which is the identity for
+                // integers; the low bits pick the bucket, the top byte the tag
+                uint64_t h = hasher_(key);
+                h ^= h >> 33;
+                h *= 0xff51afd7ed558ccdULL;
+                h ^= h >> 33;
+                h *= 0xc4ceb9fe1a85ec53ULL;
+                h ^= h >> 33;
+                return h;
+        }
+
+        static uint8_t get_tag(uint64_t h)
+        {
+                return tag_min + (h >> 56) % (256 - tag_min);
+        }
+
+    private:
+	hasher hasher_;
+        std::atomic<BucketArray *> array_{ nullptr };
+        std::atomic<std::size_t> size_{ 0 };
+
+        // (global EBR epoch at retirement, object)
+        std::mutex resize_mutex_;
+        std::vector<std::pair<uint64_t, BucketArray *> > retired_arrays_;
+        uint64_t last_array_reclaim_epoch_{ 0 };
+
+        SpinLock retired_lock_;
+        std::vector<std::pair<uint64_t, Node *> > retired_nodes_;
+        uint64_t last_node_reclaim_epoch_{ 0 };
+};
+
+} // namespace star
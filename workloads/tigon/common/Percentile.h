@@ -5,76 +5,151 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
+#include <memory>
+#include <type_traits>
+#include <vector>
 #include <glog/logging.h>
 
-#include "Random.h"
 // The nearest-rank method
 // https://en.wikipedia.org/wiki/Percentile
 
 namespace star
 {
 extern bool warmed_up;
+
+/*
+ * Fixed-memory log-linear histogram (in the spirit of HdrHistogram).
+ *
+ * Values below 2^kSubBucketBits get a bucket each; every larger power-of-two
+ * range is split into 2^(kSubBucketBits - 1) equal buckets, so a reported
+ * percentile is within ~1.6% of the true value. Negative values are counted as
+ * 0 and floating-point values are recorded in units of 1/kFloatScale.
+ *
+ * add() is meant for a single thread (the owner of the instance) and does not
+ * use atomic read-modify-writes. nth(), avg(), merge() and copies may run on
+ * any other thread at the same time and see the samples recorded so far, so
+ * per-thread instances can be merged and reported while a run is going on.
+ */
 template <class T> class Percentile {
     public:
+	using element_type = T;
+
+	static constexpr int kSubBucketBits = 6;
+	static constexpr uint64_t kSubBucketCount = 1ull << kSubBucketBits;
+	static constexpr uint64_t kSubBucketHalf = kSubBucketCount / 2;
+	static constexpr uint64_t kBucketCount = (64 - kSubBucketBits + 2) * kSubBucketHalf;
+	static constexpr double kFloatScale = 1024.0;
+
 	Percentile()
-		: rand((uint64_t)this)
+		: counts_(new std::atomic<uint64_t>[kBucketCount]())
 	{
 	}
-	using element_type = T;
+
+	Percentile(const Percentile &other)
+		: Percentile()
+	{
+		merge(other);
+	}
+
+	Percentile &operator=(const Percentile &other)
+	{
+		if (this != &other) {
+			clear();
+			merge(other);
+		}
+		return *this;
+	}
+
 	void add(const element_type &value)
 	{
-		if (warmed_up == false || rand.uniform_dist(0, 100) > 10) // record 2% of the data
+		if (warmed_up == false)
 			return;
-		isSorted_ = false;
-		data_.push_back(value);
-		sum += value;
+		record(value);
 	}
 
 	void add(const std::vector<element_type> &v)
 	{
-		isSorted_ = false;
-		std::copy(v.begin(), v.end(), std::back_inserter(data_));
+		for (auto &value : v)
+			record(value);
+	}
+
+	// adds the samples of another instance, e.g., a per-thread one
+	void merge(const Percentile &other)
+	{
+		for (uint64_t i = 0; i < kBucketCount; i++) {
+			uint64_t n = other.counts_[i].load(std::memory_order_relaxed);
+			if (n != 0)
+				counts_[i].store(counts_[i].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+		}
+		count_.store(count_.load(std::memory_order_relaxed) + other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		sum_.store(sum_.load(std::memory_order_relaxed) + other.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		max_.store(std::max(max_.load(std::memory_order_relaxed), other.max_.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+	}
+
+	// removes the samples of an earlier copy of this instance, leaving only
+	// what was recorded since (max() keeps covering the whole history)
+	void subtract(const Percentile &earlier)
+	{
+		for (uint64_t i = 0; i < kBucketCount; i++) {
+			uint64_t n = earlier.counts_[i].load(std::memory_order_relaxed);
+			if (n != 0)
+				counts_[i].store(counts_[i].load(std::memory_order_relaxed) - n, std::memory_order_relaxed);
+		}
+		count_.store(count_.load(std::memory_order_relaxed) - earlier.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		sum_.store(sum_.load(std::memory_order_relaxed) - earlier.sum_.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	}
 
 	void clear()
 	{
-		isSorted_ = true;
-		data_.clear();
+		for (uint64_t i = 0; i < kBucketCount; i++)
+			counts_[i].store(0, std::memory_order_relaxed);
+		count_.store(0, std::memory_order_relaxed);
+		sum_.store(0, std::memory_order_relaxed);
+		max_.store(0, std::memory_order_relaxed);
 	}
 
-	auto size()
+	std::size_t size() const
 	{
-		return data_.size();
+		return count_.load(std::memory_order_relaxed);
 	}
 
-	element_type avg()
+	element_type avg() const
 	{
-		return sum / (size() + 0.1);
+		return sum_.load(std::memory_order_relaxed) / (size() + 0.1);
 	}
 
-	element_type nth(double n)
+	element_type max() const
 	{
-		if (data_.size() == 0) {
-			return 0;
-		}
-		checkSort();
-		DCHECK(n > 0 && n <= 100);
-		auto sz = size();
-		auto i = static_cast<decltype(sz)>(ceil(n / 100 * sz)) - 1;
-		DCHECK(i >= 0 && i < size());
-		return data_[i];
+		return to_value(max_.load(std::memory_order_relaxed));
 	}
 
-	void save_cdf(const std::string &path)
+	element_type nth(double n) const
 	{
-		if (data_.size() == 0) {
-			return;
+		DCHECK(n > 0 && n <= 100);
+		uint64_t total = 0;
+		for (uint64_t i = 0; i < kBucketCount; i++)
+			total += counts_[i].load(std::memory_order_relaxed);
+		if (total == 0) {
+			return 0;
 		}
-		checkSort();
 
-		if (path.empty()) {
+		uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(ceil(n / 100 * total)));
+		uint64_t seen = 0;
+		for (uint64_t i = 0; i < kBucketCount; i++) {
+			seen += counts_[i].load(std::memory_order_relaxed);
+			if (seen >= rank)
+				return to_value(representative(i));
+		}
+		return max();
+	}
+
+	void save_cdf(const std::string &path) const
+	{
+		if (size() == 0 || path.empty()) {
 			return;
 		}
 
@@ -83,35 +158,79 @@ template <class T> class Percentile {
 
 		cdf << "value\tcdf" << std::endl;
 
-		// output ~ 1k rows
-		auto step_size = std::max(1, int(data_.size() * 0.99 / 1000));
-
-		std::vector<element_type> cdf_result;
-
-		for (auto i = 0u; i < 0.99 * data_.size(); i += step_size) {
-			cdf_result.push_back(data_[i]);
-		}
-
-		for (auto i = 0u; i < cdf_result.size(); i++) {
-			cdf << cdf_result[i] << "\t" << 1.0 * (i + 1) / cdf_result.size() << std::endl;
+		// one row per non-empty bucket up to the 99th percentile
+		uint64_t total = 0;
+		for (uint64_t i = 0; i < kBucketCount; i++)
+			total += counts_[i].load(std::memory_order_relaxed);
+		uint64_t limit = std::max<uint64_t>(1, static_cast<uint64_t>(ceil(0.99 * total)));
+
+		uint64_t seen = 0;
+		for (uint64_t i = 0; i < kBucketCount && seen < limit; i++) {
+			uint64_t n = counts_[i].load(std::memory_order_relaxed);
+			if (n == 0)
+				continue;
+			seen = std::min(seen + n, limit);
+			cdf << to_value(representative(i)) << "\t" << 1.0 * seen / limit << std::endl;
 		}
 
 		cdf.close();
 	}
 
     private:
-	void checkSort()
+	void record(const element_type &value)
 	{
-		if (!isSorted_) {
-			std::sort(data_.begin(), data_.end());
-			isSorted_ = true;
-		}
+		uint64_t v = to_raw(value);
+		uint64_t i = bucket_of(v);
+
+		counts_[i].store(counts_[i].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		if (v > max_.load(std::memory_order_relaxed))
+			max_.store(v, std::memory_order_relaxed);
+	}
+
+	static uint64_t bucket_of(uint64_t v)
+	{
+		if (v < kSubBucketCount)
+			return v;
+		int shift = 63 - __builtin_clzll(v) - kSubBucketBits + 1;
+		return shift * kSubBucketHalf + (v >> shift);
+	}
+
+	// midpoint of the values that map to bucket i, capped at the largest sample
+	uint64_t representative(uint64_t i) const
+	{
+		if (i < kSubBucketCount)
+			return i;
+		int shift = i / kSubBucketHalf - 1;
+		uint64_t lower = (i - shift * kSubBucketHalf) << shift;
+		return std::min<uint64_t>(lower + ((1ull << shift) - 1) / 2, max_.load(std::memory_order_relaxed));
+	}
+
+	template <class U = element_type> static typename std::enable_if<std::is_floating_point<U>::value, uint64_t>::type to_raw(const U &value)
+	{
+		return value > 0 ? static_cast<uint64_t>(std::llround(value * kFloatScale)) : 0;
+	}
+
+	template <class U = element_type> static typename std::enable_if<!std::is_floating_point<U>::value, uint64_t>::type to_raw(const U &value)
+	{
+		return value > 0 ? static_cast<uint64_t>(value) : 0;
+	}
+
+	template <class U = element_type> static typename std::enable_if<std::is_floating_point<U>::value, U>::type to_value(uint64_t raw)
+	{
+		return raw / kFloatScale;
+	}
+
+	template <class U = element_type> static typename std::enable_if<!std::is_floating_point<U>::value, U>::type to_value(uint64_t raw)
+	{
+		return static_cast<U>(raw);
 	}
 
     private:
-	Random rand;
-	bool isSorted_ = true;
-	std::vector<element_type> data_;
-	element_type sum = 0;
+	std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+	std::atomic<uint64_t> count_{ 0 };
+	std::atomic<element_type> sum_{ 0 };
+	std::atomic<uint64_t> max_{ 0 };
 };
-} // namespace star
\ No newline at end of file
+} // namespace star
@@ -0,0 +1,417 @@
+//
+// Parallel table snapshots, so that hosts restart without running the loaders
+//
+
+#pragma once
+
+#include <glog/logging.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef TIGON_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+#include "common/WALLogger.h"
+#include "core/Table.h"
+
+namespace star
+{
+
+/*
+ * A snapshot is a directory of files, usually one per partition. A file holds
+ * the rows of a fixed list of tables:
+ *
+ * block 0:  TableCheckpointFileHeader, describes the tables and row counts
+ * chunk*:   TableCheckpointChunkHeader + rows of one table, compressed with
+ *           zlib when built with TIGON_WITH_ZLIB, padded to block_size
+ *
+ * A row is the raw key followed by the raw value. Files are written under a
+ * temporary name with O_DIRECT and renamed once synced, so a file that exists
+ * is complete; the headers are checksummed, as the chunks' payloads are.
+ */
+struct TableCheckpointFileHeader {
+        static constexpr uint64_t file_magic = 0x54474350544b3031ull;   // "TGCPTK01"
+        static constexpr std::size_t max_tables = 64;
+
+        struct TableEntry {
+                uint32_t table_id;
+                uint32_t partition_id;
+                uint32_t key_size;
+                uint32_t value_size;
+                uint64_t row_count;
+        };
+
+        uint64_t magic;
+        uint64_t fingerprint;   // of the benchmark configuration the rows were loaded with
+        uint64_t table_count;
+        uint64_t chunk_count;
+        uint64_t checksum;      // over the header with this field zeroed
+        TableEntry tables[max_tables];
+};
+
+struct TableCheckpointChunkHeader {
+        static constexpr uint64_t chunk_magic = 0x54474350544b4348ull;  // "TGCPTKCH"
+
+        enum : uint32_t {
+                STORED = 0,
+                ZLIB = 1
+        };
+
+        uint64_t magic;
+        uint32_t table_index;   // into TableCheckpointFileHeader::tables
+        uint32_t codec;
+        uint64_t row_count;
+        uint64_t raw_size;      // rows before compression
+        uint64_t stored_size;   // payload bytes, excluding header and padding
+        uint64_t checksum;      // over the payload
+};
+
+class TableCheckpoint {
+    public:
+        static constexpr std::size_t block_size = 4096;
+        static constexpr std::size_t chunk_raw_size = 1024 * 1024;
+
+        struct File {
+                std::string name;
+                std::vector<ITable *> tables;
+        };
+
+        TableCheckpoint(const std::string &path, std::size_t thread_num, const std::string &configuration, std::size_t coordinator_id)
+                : path(path)
+                , thread_num(std::max<std::size_t>(1, thread_num))
+                , fingerprint(WALStreamBlockHeader::compute_checksum(configuration.data(), configuration.size()))
+                , coordinator_id(coordinator_id)
+        {
+                static_assert(sizeof(TableCheckpointFileHeader) <= block_size, "file header must fit in a block");
+        }
+
+        // true if every file exists and was written from the same tables and configuration
+        bool is_complete(const std::vector<File> &files)
+        {
+                std::atomic<bool> complete{ true };
+                for_each_file(files, [&](const File &file) {
+                        TableCheckpointFileHeader header;
+                        if (read_file_header(file, header) == false) {
+                                complete.store(false);
+                        }
+                });
+                return complete.load();
+        }
+
+        void save(const std::vector<File> &files)
+        {
+                auto now = std::chrono::steady_clock::now();
+                std::atomic<uint64_t> bytes{ 0 };
+
+                mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+                for_each_file(files, [&](const File &file) { bytes.fetch_add(save_file(file)); });
+
+                LOG(INFO) << "table checkpoint: saved " << files.size() << " files (" << bytes.load() / (1024 * 1024) << " MB) to " << path << " in "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count() << " milliseconds.";
+        }
+
+        // the caller checks is_complete() first; a corrupted chunk is fatal since the tables are already partially filled
+        void restore(const std::vector<File> &files)
+        {
+                auto now = std::chrono::steady_clock::now();
+                std::atomic<uint64_t> rows{ 0 };
+
+                for_each_file(files, [&](const File &file) { rows.fetch_add(restore_file(file)); });
+
+                LOG(INFO) << "table checkpoint: restored " << rows.load() << " rows from " << files.size() << " files in " << path << " in "
+                          << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - now).count() << " milliseconds.";
+        }
+
+    private:
+        template <class Func> void for_each_file(const std::vector<File> &files, Func func)
+        {
+                std::vector<std::thread> threads;
+                // threads beyond the file count would get nothing to do
+                auto used_threads = std::min(thread_num, files.size());
+
+                for (auto t = 0u; t < used_threads; t++) {
+                        threads.emplace_back([&, t]() {
+                                for (auto i = t; i < files.size(); i += used_threads) {
+                                        func(files[i]);
+                                }
+                        });
+                }
+                for (auto &thread : threads) {
+                        thread.join();
+                }
+        }
+
+        std::string get_filename(const File &file) const
+        {
+                return path + "/" + file.name + ".ckpt";
+        }
+
+        static std::size_t align_up(std::size_t size)
+        {
+                return (size + block_size - 1) / block_size * block_size;
+        }
+
+        // O_DIRECT is not supported everywhere, e.g. on tmpfs
+        static int open_direct(const std::string &filename, int flags)
+        {
+                int fd = open(filename.c_str(), flags | O_DIRECT, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+                if (fd < 0 && errno == EINVAL) {
+                        fd = open(filename.c_str(), flags, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+                }
+                return fd;
+        }
+
+        static uint64_t header_checksum(const TableCheckpointFileHeader &header)
+        {
+                TableCheckpointFileHeader copy = header;
+                copy.checksum = 0;
+                return WALStreamBlockHeader::compute_checksum(reinterpret_cast<const char *>(&copy), sizeof(copy));
+        }
+
+        bool read_file_header(const File &file, TableCheckpointFileHeader &header)
+        {
+                std::string filename = get_filename(file);
+                int fd = open_direct(filename, O_RDONLY);
+                if (fd < 0) {
+                        return false;
+                }
+
+                char *block = nullptr;
+                CHECK(posix_memalign((void **)&block, block_size, block_size) == 0);
+                bool ok = pread(fd, block, block_size, 0) == (ssize_t)block_size;
+                memcpy(&header, block, sizeof(header));
+                free(block);
+                close(fd);
+
+                if (ok == false || header.magic != TableCheckpointFileHeader::file_magic || header.table_count != file.tables.size() ||
+                    header.checksum != header_checksum(header)) {
+                        LOG(WARNING) << "table checkpoint: " << filename << " is not a valid snapshot";
+                        return false;
+                }
+                if (header.fingerprint != fingerprint) {
+                        LOG(WARNING) << "table checkpoint: " << filename << " was written with another configuration";
+                        return false;
+                }
+                for (auto i = 0u; i < file.tables.size(); i++) {
+                        const auto &entry = header.tables[i];
+                        ITable *table = file.tables[i];
+                        if (entry.table_id != table->tableID() || entry.partition_id != table->partitionID() || entry.key_size != table->key_size() ||
+                            entry.value_size != table->value_size()) {
+                                LOG(WARNING) << "table checkpoint: " << filename << " holds other tables";
+                                return false;
+                        }
+                }
+                return true;
+        }
+
+        // returns the file size
+        uint64_t save_file(const File &file)
+        {
+                CHECK(file.tables.size() <= TableCheckpointFileHeader::max_tables);
+
+                std::string filename = get_filename(file);
+                // hosts replicating the same partition may write the same file concurrently
+                std::string tmp_filename = filename + ".tmp." + std::to_string(coordinator_id);
+                int fd = open_direct(tmp_filename, O_WRONLY | O_CREAT | O_TRUNC);
+                CHECK(fd >= 0) << "cannot open " << tmp_filename;
+
+                std::string raw;
+                raw.reserve(chunk_raw_size);
+                char *staging = nullptr;
+                const std::size_t staging_size = align_up(sizeof(TableCheckpointChunkHeader) + max_stored_size());
+                CHECK(posix_memalign((void **)&staging, block_size, staging_size) == 0);
+
+                TableCheckpointFileHeader header;
+                memset(&header, 0, sizeof(header));
+                header.magic = TableCheckpointFileHeader::file_magic;
+                header.fingerprint = fingerprint;
+                header.table_count = file.tables.size();
+
+                uint64_t offset = block_size;
+                for (auto i = 0u; i < file.tables.size(); i++) {
+                        ITable *table = file.tables[i];
+                        auto &entry = header.tables[i];
+                        entry.table_id = table->tableID();
+                        entry.partition_id = table->partitionID();
+                        entry.key_size = table->key_size();
+                        entry.value_size = table->value_size();
+                        entry.row_count = 0;
+                        CHECK(entry.key_size + entry.value_size <= chunk_raw_size);
+
+                        uint64_t chunk_rows = 0;
+                        auto flush_chunk = [&]() {
+                                if (chunk_rows == 0) {
+                                        return;
+                                }
+                                offset += write_chunk(fd, offset, staging, i, chunk_rows, raw);
+                                header.chunk_count++;
+                                entry.row_count += chunk_rows;
+                                chunk_rows = 0;
+                                raw.clear();
+                        };
+                        auto dump_processor = [&](const void *key, const void *value) {
+                                if (raw.size() + entry.key_size + entry.value_size > chunk_raw_size) {
+                                        flush_chunk();
+                                }
+                                raw.append(static_cast<const char *>(key), entry.key_size);
+                                raw.append(static_cast<const char *>(value), entry.value_size);
+                                chunk_rows++;
+                        };
+
+                        table->turn_on_cow();
+                        table->dump_copy(dump_processor, []() {});
+                        flush_chunk();
+                        CHECK(table->cow_dump_finished());
+                        table->turn_off_cow()();
+                }
+
+                header.checksum = header_checksum(header);
+                memset(staging, 0, block_size);
+                memcpy(staging, &header, sizeof(header));
+                CHECK(pwrite(fd, staging, block_size, 0) == (ssize_t)block_size) << "cannot write " << tmp_filename;
+                CHECK(fdatasync(fd) == 0);
+                close(fd);
+                free(staging);
+
+                CHECK(rename(tmp_filename.c_str(), filename.c_str()) == 0) << "cannot rename " << tmp_filename;
+                return offset;
+        }
+
+        static std::size_t max_stored_size()
+        {
+#ifdef TIGON_WITH_ZLIB
+                return std::max<std::size_t>(chunk_raw_size, compressBound(chunk_raw_size));
+#else
+                return chunk_raw_size;
+#endif
+        }
+
+        // returns the bytes written
+        std::size_t write_chunk(int fd, uint64_t offset, char *staging, uint32_t table_index, uint64_t row_count, const std::string &raw)
+        {
+                TableCheckpointChunkHeader chunk;
+                char *payload = staging + sizeof(chunk);
+
+                chunk.magic = TableCheckpointChunkHeader::chunk_magic;
+                chunk.table_index = table_index;
+                chunk.codec = TableCheckpointChunkHeader::STORED;
+                chunk.row_count = row_count;
+                chunk.raw_size = raw.size();
+                chunk.stored_size = raw.size();
+#ifdef TIGON_WITH_ZLIB
+                uLongf compressed_size = max_stored_size();
+                if (compress2(reinterpret_cast<Bytef *>(payload), &compressed_size, reinterpret_cast<const Bytef *>(raw.data()), raw.size(),
+                              Z_BEST_SPEED) == Z_OK &&
+                    compressed_size < raw.size()) {
+                        chunk.codec = TableCheckpointChunkHeader::ZLIB;
+                        chunk.stored_size = compressed_size;
+                }
+#endif
+                if (chunk.codec == TableCheckpointChunkHeader::STORED) {
+                        memcpy(payload, raw.data(), raw.size());
+                }
+                chunk.checksum = WALStreamBlockHeader::compute_checksum(payload, chunk.stored_size);
+                memcpy(staging, &chunk, sizeof(chunk));
+
+                std::size_t used = sizeof(chunk) + chunk.stored_size;
+                std::size_t size = align_up(used);
+                memset(staging + used, 0, size - used);
+                CHECK(pwrite(fd, staging, size, offset) == (ssize_t)size) << "cannot write table checkpoint chunk";
+                return size;
+        }
+
+        // returns the number of restored rows
+        uint64_t restore_file(const File &file)
+        {
+                TableCheckpointFileHeader header;
+                std::string filename = get_filename(file);
+                CHECK(read_file_header(file, header)) << "cannot restore from " << filename;
+
+                int fd = open_direct(filename, O_RDONLY);
+                CHECK(fd >= 0) << "cannot open " << filename;
+                posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+                char *staging = nullptr;
+                const std::size_t staging_size = align_up(sizeof(TableCheckpointChunkHeader) + max_stored_size());
+                CHECK(posix_memalign((void **)&staging, block_size, staging_size) == 0);
+                std::string raw(chunk_raw_size, '\0');
+
+                std::vector<uint64_t> row_counts(header.table_count, 0);
+                uint64_t offset = block_size;
+                for (auto c = 0u; c < header.chunk_count; c++) {
+                        CHECK(pread(fd, staging, block_size, offset) == (ssize_t)block_size) << filename << " is truncated";
+
+                        TableCheckpointChunkHeader chunk;
+                        memcpy(&chunk, staging, sizeof(chunk));
+                        CHECK(chunk.magic == TableCheckpointChunkHeader::chunk_magic && chunk.table_index < header.table_count &&
+                              chunk.raw_size <= chunk_raw_size && chunk.stored_size <= max_stored_size())
+                                << filename << " has a corrupted chunk at offset " << offset;
+
+                        std::size_t size = align_up(sizeof(chunk) + chunk.stored_size);
+                        if (size > block_size) {
+                                CHECK(pread(fd, staging + block_size, size - block_size, offset + block_size) == (ssize_t)(size - block_size))
+                                        << filename << " is truncated";
+                        }
+                        offset += size;
+
+                        const char *payload = staging + sizeof(chunk);
+                        CHECK(WALStreamBlockHeader::compute_checksum(payload, chunk.stored_size) == chunk.checksum)
+                                << filename << " has a corrupted chunk at offset " << offset - size;
+
+                        const char *rows = payload;
+                        if (chunk.codec == TableCheckpointChunkHeader::ZLIB) {
+#ifdef TIGON_WITH_ZLIB
+                                uLongf raw_size = chunk_raw_size;
+                                CHECK(uncompress(reinterpret_cast<Bytef *>(&raw[0]), &raw_size, reinterpret_cast<const Bytef *>(payload), chunk.stored_size) ==
+                                              Z_OK &&
+                                      raw_size == chunk.raw_size)
+                                        << filename << " has a corrupted chunk at offset " << offset - size;
+                                rows = raw.data();
+#else
+                                LOG(FATAL) << filename << " is compressed, rebuild with zlib";
+#endif
+                        } else {
+                                CHECK(chunk.codec == TableCheckpointChunkHeader::STORED && chunk.stored_size == chunk.raw_size);
+                        }
+
+                        ITable *table = file.tables[chunk.table_index];
+                        const auto &entry = header.tables[chunk.table_index];
+                        const std::size_t row_size = entry.key_size + entry.value_size;
+                        CHECK(chunk.raw_size == chunk.row_count * row_size) << filename << " has a corrupted chunk at offset " << offset - size;
+                        table->bulk_insert(chunk.row_count, [&](std::size_t r, void *key, void *value) {
+                                const char *row = rows + r * row_size;
+                                memcpy(key, row, entry.key_size);
+                                memcpy(value, row + entry.key_size, entry.value_size);
+                        });
+                        row_counts[chunk.table_index] += chunk.row_count;
+                }
+
+                free(staging);
+                close(fd);
+
+                uint64_t total_rows = 0;
+                for (auto i = 0u; i < header.table_count; i++) {
+                        CHECK(row_counts[i] == header.tables[i].row_count) << filename << " misses rows of table " << header.tables[i].table_id;
+                        total_rows += row_counts[i];
+                }
+                return total_rows;
+        }
+
+        std::string path;
+        std::size_t thread_num;
+        uint64_t fingerprint;
+        std::size_t coordinator_id;
+};
+
+} // namespace star
@@ -13,6 +13,10 @@
 #include <stdio.h>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <vector>
+#include <unistd.h>
 
 #include "common/Percentile.h"
 #include "common/LockfreeQueue.h"
@@ -364,8 +368,12 @@ class GroupCommitLogger : public WALLogger {
 struct LogBuffer {
         static constexpr uint64_t max_buffer_size = 1024 * 1024 * 4;
 
+        // every record is prefixed with its size so that logs can be replayed
+        using RecordSizeType = uint32_t;
+
         char buffer[max_buffer_size];
         uint64_t size = 0;
+        uint64_t epoch = 0;     // global epoch all records in this buffer were written in
 
         // statistics
         std::vector<uint64_t> txn_start_times;
@@ -393,10 +401,12 @@ class PashaGroupCommitLoggerSlave : public WALLogger {
 	std::size_t write(const char *str, long size, bool persist, std::chrono::steady_clock::time_point txn_start_time, std::function<void()> on_blocking = []() {}) override
 	{
                 uint64_t cur_epoch = cxl_global_epoch->load();
+                LogBuffer::RecordSizeType record_size = size;
 
                 CHECK(cur_log_buffer != nullptr);
+                CHECK(sizeof(record_size) + size <= LogBuffer::max_buffer_size);
 
-                if (((cur_log_buffer->size + size) > LogBuffer::max_buffer_size) || (cur_epoch > last_epoch)) {
+                if (((cur_log_buffer->size + sizeof(record_size) + size) > LogBuffer::max_buffer_size) || (cur_epoch > last_epoch)) {
                         if (cur_log_buffer->size > 0) {
                                 log_buffer_queue.push(cur_log_buffer);
                                 cur_log_buffer = new LogBuffer;
@@ -404,7 +414,10 @@ class PashaGroupCommitLoggerSlave : public WALLogger {
                         }
                         last_epoch = cur_epoch;
                 }
+                cur_log_buffer->epoch = last_epoch;
 
+                memcpy(&cur_log_buffer->buffer[cur_log_buffer->size], &record_size, sizeof(record_size));
+                cur_log_buffer->size += sizeof(record_size);
                 memcpy(&cur_log_buffer->buffer[cur_log_buffer->size], str, size);
                 cur_log_buffer->size += size;
 
@@ -585,6 +598,297 @@ class PashaGroupCommitLogger : public WALLogger {
         std::atomic<bool> &stopFlag;
 };
 
+/*
+ * Block format of the per-worker WAL streams written by PashaEpochWALLogger.
+ * Every sealed LogBuffer becomes one block: this header followed by the
+ * buffer's size-prefixed records, padded to the O_DIRECT block size.
+ */
+struct WALStreamBlockHeader {
+        static constexpr uint64_t block_magic = 0x57414c53544d3031ull;  // "WALSTM01"
+
+        uint64_t magic;
+        uint64_t epoch;
+        uint64_t size;          // payload bytes, excluding header and padding
+        uint64_t checksum;      // over the payload
+
+        static uint64_t compute_checksum(const char *data, uint64_t size)
+        {
+                uint64_t h = 0xcbf29ce484222325ull;
+                uint64_t i = 0;
+                for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+                        uint64_t w;
+                        memcpy(&w, data + i, sizeof(w));
+                        h = (h ^ w) * 0x100000001b3ull;
+                }
+                for (; i < size; i++)
+                        h = (h ^ static_cast<uint8_t>(data[i])) * 0x100000001b3ull;
+                return h;
+        }
+};
+
+/*
+ * Silo-style parallel WAL: every worker keeps logging into its own
+ * PashaGroupCommitLoggerSlave, but each worker's buffers go to a separate
+ * log file and several flusher threads write the files in parallel with
+ * O_DIRECT, one fdatasync per file per epoch.
+ *
+ * The logger thread only advances cxl_global_epoch, sleeping until the next
+ * epoch boundary, and wakes the flushers up afterwards. A file is durable up
+ * to the epoch before the newest block it has on disk since the worker seals
+ * its buffer on every epoch change; the database is durable up to the
+ * minimum of that over all files, see get_durable_epoch().
+ */
+class PashaEpochWALLogger : public WALLogger {
+    public:
+        static constexpr std::size_t block_size = 4096;
+        static constexpr std::size_t max_io_size = LogBuffer::max_buffer_size * 2;
+
+	PashaEpochWALLogger(const std::string &filename, std::vector<LockfreeLogBufferQueue *> *log_buffer_queues_ptr,
+                          std::atomic<uint64_t> *cxl_global_epoch, std::atomic<bool> &stopFlag,
+                          std::size_t flusher_num, std::size_t group_commit_latency = 10)
+		: WALLogger(filename, 0)
+                , log_buffer_queues(*log_buffer_queues_ptr)
+                , cxl_global_epoch(cxl_global_epoch)
+                , flusher_num(std::max<std::size_t>(1, std::min(flusher_num, log_buffer_queues_ptr->size())))
+                , group_commit_latency_us(group_commit_latency)
+                , streams(log_buffer_queues_ptr->size())
+                , stopFlag(stopFlag)
+	{
+                for (auto i = 0u; i < streams.size(); i++) {
+                        std::string stream_filename = get_stream_filename(filename, i);
+                        streams[i].fd = open(stream_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT,
+                                             S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH);
+                        CHECK(streams[i].fd >= 0) << "cannot open " << stream_filename;
+                        CHECK(posix_memalign((void **)&streams[i].staging, block_size, max_io_size) == 0);
+                }
+	}
+
+	~PashaEpochWALLogger() override
+	{
+                for (auto &stream : streams) {
+                        free(stream.staging);
+                }
+	}
+
+        static std::string get_stream_filename(const std::string &filename, std::size_t stream_id)
+        {
+                return filename + "_stream_" + std::to_string(stream_id) + ".log";
+        }
+
+        void start()
+        {
+                LOG(INFO) << "epoch logger started with " << flusher_num << " flushers for " << streams.size() << " streams";
+
+                std::vector<std::thread> flusher_threads;
+                for (auto i = 0u; i < flusher_num; i++) {
+                        flusher_threads.emplace_back(&PashaEpochWALLogger::flusher_loop, this, i);
+                }
+
+                auto next_epoch_time = std::chrono::steady_clock::now();
+                while (stopFlag.load() == false) {
+                        next_epoch_time += std::chrono::microseconds(group_commit_latency_us);
+                        std::this_thread::sleep_until(next_epoch_time);
+
+                        this->cxl_global_epoch->fetch_add(1);
+                        {
+                                std::lock_guard<std::mutex> g(epoch_mutex);
+                                epoch_generation++;
+                        }
+                        epoch_cv.notify_all();
+                }
+
+                {
+                        std::lock_guard<std::mutex> g(epoch_mutex);
+                        epoch_generation++;
+                }
+                epoch_cv.notify_all();
+                for (auto &t : flusher_threads) {
+                        t.join();
+                }
+        }
+
+	std::size_t write(const char *str, long size, bool persist, std::chrono::steady_clock::time_point txn_start_time, std::function<void()> on_blocking = []() {}) override
+	{
+                CHECK(0);
+	}
+
+	void sync(std::size_t lsn, std::function<void()> on_blocking = []() {}) override
+	{
+		CHECK(0);
+	}
+
+	void close() override
+	{
+                for (auto &stream : streams) {
+                        fdatasync(stream.fd);
+                        int err = ::close(stream.fd);
+                        CHECK(err == 0);
+                }
+	}
+
+        uint64_t get_global_epoch() override
+        {
+                return cxl_global_epoch->load();
+        }
+
+        uint64_t get_durable_epoch()
+        {
+                uint64_t durable_epoch = std::numeric_limits<uint64_t>::max();
+                for (auto &stream : streams) {
+                        uint64_t newest_epoch = stream.newest_durable_epoch.load(std::memory_order_acquire);
+                        durable_epoch = std::min(durable_epoch, newest_epoch == 0 ? 0 : newest_epoch - 1);
+                }
+                return durable_epoch;
+        }
+
+        void print_sync_stats() override
+	{
+                std::lock_guard<std::mutex> g(stats_mutex);
+
+                LOG(INFO) << "Group Commit Stats: "
+                          << txn_latency.nth(50) << " us (50%) " << txn_latency.nth(75) << " us (75%) "
+                          << txn_latency.nth(95) << " us (95%) " << txn_latency.nth(99) << " us (99%) "
+			  << txn_latency.avg() << " us (avg)"
+                          << " committed_txn_cnt " << committed_txn_cnt;
+
+                LOG(INFO) << "Disk Sync Stats: "
+                          << disk_sync_latency.nth(50) << " us (50%) " << disk_sync_latency.nth(75) << " us (75%) "
+                          << disk_sync_latency.nth(95) << " us (95%) " << disk_sync_latency.nth(99) << " us (99%) "
+			  << disk_sync_latency.avg() << " us (avg)"
+                          << " disk_sync_cnt " << disk_sync_cnt
+                          << " disk_sync_size " << disk_sync_size
+                          << " current global epoch " << this->cxl_global_epoch->load()
+                          << " durable epoch " << get_durable_epoch();
+	}
+
+    private:
+        struct Stream {
+                int fd{ -1 };
+                char *staging{ nullptr };
+                std::atomic<uint64_t> newest_durable_epoch{ 0 };
+        };
+
+        void flusher_loop(std::size_t flusher_id)
+        {
+                uint64_t seen_generation = 0;
+
+                while (true) {
+                        bool stopping = false;
+                        {
+                                std::unique_lock<std::mutex> lock(epoch_mutex);
+                                epoch_cv.wait(lock, [&]() { return epoch_generation != seen_generation; });
+                                seen_generation = epoch_generation;
+                                stopping = stopFlag.load();
+                        }
+
+                        for (auto i = flusher_id; i < streams.size(); i += flusher_num) {
+                                flush_stream(i);
+                        }
+
+                        if (stopping == true) {
+                                break;
+                        }
+                }
+        }
+
+        // writes out every sealed buffer of one stream, then syncs the file once
+        void flush_stream(std::size_t stream_id)
+        {
+                Stream &stream = streams[stream_id];
+                LockfreeLogBufferQueue *queue = log_buffer_queues[stream_id];
+                std::vector<uint64_t> txn_start_times;
+                uint64_t staged = 0, flushed_bytes = 0, newest_epoch = 0;
+
+                if (queue->empty() == true) {
+                        return;
+                }
+
+                auto sync_start_time = std::chrono::steady_clock::now();
+                while (queue->empty() == false) {
+                        LogBuffer *log_buffer = queue->front();
+                        CHECK(log_buffer != nullptr);
+                        queue->pop();
+
+                        uint64_t block_bytes = round_up(sizeof(WALStreamBlockHeader) + log_buffer->size, block_size);
+                        if (staged + block_bytes > max_io_size) {
+                                write_staged(stream, staged);
+                                flushed_bytes += staged;
+                                staged = 0;
+                        }
+
+                        WALStreamBlockHeader header;
+                        header.magic = WALStreamBlockHeader::block_magic;
+                        header.epoch = log_buffer->epoch;
+                        header.size = log_buffer->size;
+                        header.checksum = WALStreamBlockHeader::compute_checksum(log_buffer->buffer, log_buffer->size);
+                        memcpy(stream.staging + staged, &header, sizeof(header));
+                        memcpy(stream.staging + staged + sizeof(header), log_buffer->buffer, log_buffer->size);
+                        memset(stream.staging + staged + sizeof(header) + log_buffer->size, 0, block_bytes - sizeof(header) - log_buffer->size);
+                        staged += block_bytes;
+
+                        newest_epoch = std::max(newest_epoch, log_buffer->epoch);
+                        txn_start_times.insert(txn_start_times.end(), log_buffer->txn_start_times.begin(), log_buffer->txn_start_times.end());
+                        delete log_buffer;
+                }
+                write_staged(stream, staged);
+                flushed_bytes += staged;
+                fdatasync(stream.fd);
+                auto sync_end_time = std::chrono::steady_clock::now();
+
+                stream.newest_durable_epoch.store(newest_epoch, std::memory_order_release);
+
+                std::lock_guard<std::mutex> g(stats_mutex);
+
+                // collect disk sync stats
+                disk_sync_latency.add(std::chrono::duration_cast<std::chrono::microseconds>(sync_end_time - sync_start_time).count());
+                disk_sync_cnt++;
+                disk_sync_size += flushed_bytes;
+
+                // calculate transaction latency and collect stats
+                committed_txn_cnt += txn_start_times.size();
+                auto now = Time::now();
+                for (auto start_time : txn_start_times) {
+                        txn_latency.add((now - start_time) / 1000);
+                }
+        }
+
+        void write_staged(Stream &stream, uint64_t staged)
+        {
+                uint64_t written = 0;
+                while (written < staged) {
+                        ssize_t ret = ::write(stream.fd, stream.staging + written, staged - written);
+                        CHECK(ret > 0) << "WAL stream write failed: " << strerror(errno);
+                        written += ret;
+                }
+        }
+
+        static std::size_t round_up(std::size_t num, std::size_t multiple)
+        {
+                return (num + multiple - 1) / multiple * multiple;
+        }
+
+	std::vector<LockfreeLogBufferQueue *> &log_buffer_queues;
+        std::atomic<uint64_t> *cxl_global_epoch{ nullptr };
+        std::size_t flusher_num{ 1 };
+	std::size_t group_commit_latency_us{ 0 };
+
+        std::vector<Stream> streams;
+
+        // statistics, shared by all flushers
+        std::mutex stats_mutex;
+        uint64_t disk_sync_cnt{ 0 };
+        uint64_t disk_sync_size{ 0 };
+        Percentile<uint64_t> disk_sync_latency;
+        uint64_t committed_txn_cnt{ 0 };
+        Percentile<uint64_t> txn_latency;
+
+        std::mutex epoch_mutex;
+        std::condition_variable epoch_cv;
+        uint64_t epoch_generation{ 0 };
+
+        std::atomic<bool> &stopFlag;
+};
+
 class SimpleWALLogger : public WALLogger {
     public:
 	SimpleWALLogger(const std::string &filename, std::size_t emulated_persist_latency = 0, std::size_t block_size = 4096)
@@ -0,0 +1,301 @@
+//
+// Parallel recovery from the per-worker WAL streams of PashaEpochWALLogger
+//
+
+#pragma once
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/Encoder.h"
+#include "common/WALLogger.h"
+#include "core/Table.h"
+
+namespace star
+{
+
+/*
+ * Binary redo record. Protocols that want their logs to be replayable
+ * encode every record with these helpers instead of free-form text.
+ *
+ * data record:   type(1) table_id(4) partition_id(4) epoch_version(8) key_size(4) value_size(4) key value
+ * commit record: type(1) commit_tid(8)
+ */
+class WALRedoRecord {
+    public:
+        enum : uint8_t {
+                UPDATE = 0,
+                INSERT = 1,
+                DELETE = 2,
+                COMMIT = 3
+        };
+
+        static std::string encode(uint8_t type, uint32_t table_id, uint32_t partition_id, uint64_t epoch_version,
+                                  const void *key, uint32_t key_size, const void *value, uint32_t value_size)
+        {
+                std::string output;
+                Encoder encoder(output);
+
+                encoder << type << table_id << partition_id << epoch_version << key_size << value_size;
+                encoder.write_n_bytes(key, key_size);
+                if (value_size > 0) {
+                        encoder.write_n_bytes(value, value_size);
+                }
+                return output;
+        }
+
+        static std::string encode_commit(uint64_t commit_tid)
+        {
+                std::string output;
+                Encoder encoder(output);
+
+                encoder << static_cast<uint8_t>(COMMIT) << commit_tid;
+                return output;
+        }
+
+        uint8_t type{ 0 };
+        uint32_t table_id{ 0 };
+        uint32_t partition_id{ 0 };
+        uint64_t epoch_version{ 0 };
+        std::string key;
+        std::string value;
+
+        // returns false on a malformed record
+        bool decode(const char *data, uint64_t size)
+        {
+                if (size < sizeof(type)) {
+                        return false;
+                }
+                memcpy(&type, data, sizeof(type));
+                if (type == COMMIT) {
+                        return size == sizeof(type) + sizeof(uint64_t);
+                }
+                if (type > DELETE) {
+                        return false;
+                }
+
+                uint32_t key_size = 0, value_size = 0;
+                const uint64_t fixed_size = sizeof(type) + sizeof(table_id) + sizeof(partition_id) + sizeof(epoch_version) + sizeof(key_size) + sizeof(value_size);
+                if (size < fixed_size) {
+                        return false;
+                }
+
+                Decoder dec(StringPiece(data + sizeof(type), fixed_size - sizeof(type)));
+                dec >> table_id >> partition_id >> epoch_version >> key_size >> value_size;
+                if (size != fixed_size + key_size + value_size) {
+                        return false;
+                }
+                key.assign(data + fixed_size, key_size);
+                value.assign(data + fixed_size + key_size, value_size);
+                return true;
+        }
+};
+
+/*
+ * Replays the streams of a PashaEpochWALLogger into the tables.
+ *
+ * 1. Every stream is scanned in parallel up to its first torn or corrupted
+ *    block; records are grouped into transactions by their commit record.
+ * 2. The recovery epoch is the minimum over all streams of "newest complete
+ *    epoch - 1": every stream holds all of its transactions up to it, so
+ *    replaying exactly the transactions committed in epochs <= it yields a
+ *    consistent state even across streams.
+ * 3. Records are bucketed by (table, partition) and each bucket is replayed
+ *    in parallel in epoch_version order, which is the per-key commit order.
+ */
+class PashaEpochWALRecovery {
+    public:
+        PashaEpochWALRecovery(const std::vector<std::string> &stream_filenames, std::size_t thread_num,
+                              std::function<ITable *(std::size_t table_id, std::size_t partition_id)> get_table)
+                : stream_filenames(stream_filenames)
+                , thread_num(std::max<std::size_t>(1, thread_num))
+                , get_table(get_table)
+                , streams(stream_filenames.size())
+        {
+        }
+
+        // returns the number of replayed transactions
+        uint64_t recover()
+        {
+                std::vector<std::thread> threads;
+
+                for (auto t = 0u; t < thread_num; t++) {
+                        threads.emplace_back([this, t]() {
+                                for (auto i = t; i < streams.size(); i += thread_num) {
+                                        scan_stream(i);
+                                }
+                        });
+                }
+                for (auto &thread : threads) {
+                        thread.join();
+                }
+                threads.clear();
+
+                recovery_epoch = std::numeric_limits<uint64_t>::max();
+                for (auto &stream : streams) {
+                        recovery_epoch = std::min(recovery_epoch, stream.newest_epoch == 0 ? 0 : stream.newest_epoch - 1);
+                }
+                if (streams.empty() == true) {
+                        recovery_epoch = 0;
+                }
+
+                // bucket the committed records by partition
+                std::vector<std::vector<const WALRedoRecord *> > buckets(thread_num);
+                uint64_t replayed_txn_cnt = 0;
+                for (auto &stream : streams) {
+                        for (auto &txn : stream.txns) {
+                                if (txn.epoch > recovery_epoch) {
+                                        continue;
+                                }
+                                for (auto &record : txn.records) {
+                                        buckets[bucket_of(record)].push_back(&record);
+                                }
+                                replayed_txn_cnt++;
+                        }
+                }
+
+                for (auto t = 0u; t < thread_num; t++) {
+                        threads.emplace_back(&PashaEpochWALRecovery::replay_bucket, this, std::ref(buckets[t]));
+                }
+                for (auto &thread : threads) {
+                        thread.join();
+                }
+
+                LOG(INFO) << "WAL recovery: replayed " << replayed_txn_cnt << " transactions from " << streams.size()
+                          << " streams up to epoch " << recovery_epoch;
+
+                return replayed_txn_cnt;
+        }
+
+        uint64_t get_recovery_epoch()
+        {
+                return recovery_epoch;
+        }
+
+    private:
+        struct Txn {
+                uint64_t epoch{ 0 };
+                std::vector<WALRedoRecord> records;
+        };
+
+        struct Stream {
+                uint64_t newest_epoch{ 0 };
+                std::vector<Txn> txns;
+        };
+
+        std::size_t bucket_of(const WALRedoRecord &record)
+        {
+                return (record.table_id * 0x9e3779b97f4a7c15ull + record.partition_id) % thread_num;
+        }
+
+        void scan_stream(std::size_t stream_id)
+        {
+                Stream &stream = streams[stream_id];
+                std::ifstream in(stream_filenames[stream_id], std::ios::binary);
+                std::vector<char> payload;
+                Txn pending;
+
+                if (in.is_open() == false) {
+                        LOG(WARNING) << "WAL recovery: cannot open " << stream_filenames[stream_id];
+                        return;
+                }
+
+                while (true) {
+                        WALStreamBlockHeader header;
+                        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+                                break;
+                        }
+                        if (header.magic != WALStreamBlockHeader::block_magic || header.size > LogBuffer::max_buffer_size) {
+                                break;
+                        }
+                        payload.resize(header.size);
+                        if (!in.read(payload.data(), header.size)) {
+                                break;
+                        }
+                        if (WALStreamBlockHeader::compute_checksum(payload.data(), header.size) != header.checksum) {
+                                break;
+                        }
+                        uint64_t block_bytes = (sizeof(header) + header.size + PashaEpochWALLogger::block_size - 1) /
+                                               PashaEpochWALLogger::block_size * PashaEpochWALLogger::block_size;
+                        in.seekg(block_bytes - sizeof(header) - header.size, std::ios::cur);
+
+                        parse_block(stream, pending, header.epoch, payload.data(), header.size);
+                        stream.newest_epoch = std::max(stream.newest_epoch, header.epoch);
+                }
+                // records without a commit record belong to a transaction that did not make it
+        }
+
+        void parse_block(Stream &stream, Txn &pending, uint64_t epoch, const char *data, uint64_t size)
+        {
+                uint64_t offset = 0;
+
+                while (offset + sizeof(LogBuffer::RecordSizeType) <= size) {
+                        LogBuffer::RecordSizeType record_size;
+                        memcpy(&record_size, data + offset, sizeof(record_size));
+                        offset += sizeof(record_size);
+                        CHECK(offset + record_size <= size) << "WAL recovery: truncated record";
+
+                        WALRedoRecord record;
+                        CHECK(record.decode(data + offset, record_size) == true) << "WAL recovery: records are not in WALRedoRecord format";
+                        offset += record_size;
+
+                        if (record.type == WALRedoRecord::COMMIT) {
+                                // a transaction is as old as its commit record
+                                pending.epoch = epoch;
+                                stream.txns.push_back(std::move(pending));
+                                pending = Txn();
+                        } else {
+                                pending.records.push_back(std::move(record));
+                        }
+                }
+        }
+
+        void replay_bucket(std::vector<const WALRedoRecord *> &bucket)
+        {
+                std::stable_sort(bucket.begin(), bucket.end(), [](const WALRedoRecord *a, const WALRedoRecord *b) {
+                        return a->epoch_version < b->epoch_version;
+                });
+
+                for (auto record : bucket) {
+                        ITable *table = get_table(record->table_id, record->partition_id);
+                        CHECK(table != nullptr);
+                        CHECK(record->key.size() == table->key_size());
+                        const void *key = record->key.data();
+
+                        switch (record->type) {
+                        case WALRedoRecord::UPDATE:
+                        case WALRedoRecord::INSERT:
+                                CHECK(record->value.size() == table->value_size());
+                                if (table->contains(key) == true) {
+                                        table->update(key, record->value.data());
+                                } else {
+                                        table->insert(key, record->value.data());
+                                }
+                                break;
+                        case WALRedoRecord::DELETE:
+                                if (table->contains(key) == true) {
+                                        table->remove(key);
+                                }
+                                break;
+                        default:
+                                CHECK(0);
+                        }
+                }
+        }
+
+        std::vector<std::string> stream_filenames;
+        std::size_t thread_num{ 1 };
+        std::function<ITable *(std::size_t, std::size_t)> get_table;
+
+        std::vector<Stream> streams;
+        uint64_t recovery_epoch{ 0 };
+};
+
+} // namespace star
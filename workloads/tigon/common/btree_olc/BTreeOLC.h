@@ -1659,6 +1659,72 @@ class BPlusTree {
 		EBR<UpdateThreshold, Deallocator>::getLocalThreadData().addRetiredNode(ptr);
 	}
 
+	/**
+	 * Builds the tree bottom-up from `count` pairs sorted by ascending, unique keys.
+	 * Every level is spread evenly over as few nodes as possible, so nothing is
+	 * split on the way. Only for an empty tree that no one else uses yet;
+	 * returns false without touching the tree otherwise.
+	 */
+	bool bulkLoad(const KeyType *keys, const ValueType *values, size_t count)
+	{
+		NodeBase *root = root_.load();
+		if (root->getType() != NodeType::BTreeLeaf || root->getCount() != 0)
+			return false;
+		if (count == 0)
+			return true;
+
+		// nodes of the level being built and the largest key below each of them
+		std::vector<NodeBase *> nodes;
+		std::vector<KeyType> maxKeys;
+
+		const size_t leafCount = (count + BTreeLeaf::maxEntries - 1) / BTreeLeaf::maxEntries;
+		BTreeLeaf *prev = nullptr;
+		for (size_t i = 0, pos = 0; i < leafCount; i++) {
+			size_t n = count / leafCount + (i < count % leafCount ? 1 : 0);
+			// the empty root becomes the leftmost leaf
+			BTreeLeaf *leaf = i == 0 ? static_cast<BTreeLeaf *>(root) : new (new char[LeafPageSize]) BTreeLeaf(); // Placement new
+			for (size_t j = 0; j < n; j++, pos++) {
+				new (&leaf->keys_[j]) KeyType{ keys[pos] }; // Placement new
+				new (&leaf->values_[j]) ValueType{ values[pos] }; // Placement new
+			}
+			leaf->setCount(n);
+			leaf->pre_ = prev;
+			if (prev)
+				prev->next_ = leaf;
+			prev = leaf;
+			nodes.push_back(leaf);
+			maxKeys.push_back(keys[pos - 1]);
+		}
+		stats_.leaf_nodes += leafCount - 1;
+
+		// inner nodes stay one key short of full, insert() splits full ones eagerly
+		const size_t fanout = BTreeInner::maxEntries - 1;
+		while (nodes.size() > 1) {
+			const size_t innerCount = (nodes.size() + fanout - 1) / fanout;
+			std::vector<NodeBase *> parents;
+			std::vector<KeyType> parentMaxKeys;
+			for (size_t i = 0, pos = 0; i < innerCount; i++) {
+				size_t n = nodes.size() / innerCount + (i < nodes.size() % innerCount ? 1 : 0);
+				auto inner = new (new char[InnerPageSize]) BTreeInner(); // Placement new
+				for (size_t j = 0; j < n; j++, pos++) {
+					if (j + 1 < n)
+						inner->newKey(j, maxKeys[pos]);
+					inner->childAt(j) = nodes[pos];
+				}
+				inner->setCount(n - 1);
+				parents.push_back(inner);
+				parentMaxKeys.push_back(maxKeys[pos - 1]);
+			}
+			stats_.inner_nodes += innerCount;
+			nodes.swap(parents);
+			maxKeys.swap(parentMaxKeys);
+		}
+
+		stats_.num_items += count;
+		root_ = nodes[0];
+		return true;
+	}
+
 	/**
 	 * return v if insert successful
 	 * otherwise return an existing value
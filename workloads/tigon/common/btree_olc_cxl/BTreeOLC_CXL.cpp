@@ -11,4 +11,6 @@ uint32_t AllocateRWSpinLatchThreadId()
 
 thread_local uint32_t RWSpinLatchThreadId = AllocateRWSpinLatchThreadId();
 
+bool EnableNodePrefetch = false;
+
 }
\ No newline at end of file
@@ -8,8 +8,10 @@
 #include <immintrin.h>
 #include <sched.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iostream>
@@ -157,12 +159,174 @@ enum class RemoveResult { GOOD = 0, KEY_NOT_FOUND, VALUE_HAS_OTHER_REFERENCE, VA
 
 static inline void prefetch(char *ptr, size_t len)
 {
-	// if (ptr == nullptr) return;
-	// for (char *p = ptr; p < ptr + len; p += 64) {
-	//     __builtin_prefetch(p);
-	// }
+	if (ptr == nullptr)
+		return;
+	for (char *p = ptr; p < ptr + len; p += 64) {
+		__builtin_prefetch(p);
+	}
 }
 
+/** prefetch the search region of child nodes during descent (--btree_prefetch) */
+extern bool EnableNodePrefetch;
+
+/**
+ * A KeyComparator may expose an order-preserving prefix of its keys:
+ *
+ *   uint64_t prefix(const KeyType &k) const;   // a < b implies prefix(a) <= prefix(b)
+ *
+ * Trees over such keys keep a 32-bit head per entry right after the node
+ * header, so a node search is a SIMD compare over the heads and touches a
+ * full key only when its head ties with the search key's.
+ */
+template <class KeyComparator, class KeyType, class = void> struct HasKeyPrefix : std::false_type {
+};
+
+template <class KeyComparator, class KeyType>
+struct HasKeyPrefix<KeyComparator, KeyType, decltype(void(std::declval<const KeyComparator &>().prefix(std::declval<const KeyType &>())))>
+	: std::true_type {
+};
+
+template <class KeyComparator, class KeyType, bool = HasKeyPrefix<KeyComparator, KeyType>::value> struct KeyPrefix {
+	static uint64_t get(const KeyComparator &keyComp, const KeyType &k)
+	{
+		return 0;
+	}
+};
+
+template <class KeyComparator, class KeyType> struct KeyPrefix<KeyComparator, KeyType, true> {
+	static uint64_t get(const KeyComparator &keyComp, const KeyType &k)
+	{
+		return keyComp.prefix(k);
+	}
+};
+
+/**
+ * class KeyHeads - per-node key heads, a node base class
+ *
+ * Prefix compression: a node stores the prefix of its first key once as
+ * `base_`, and each head is the key's prefix minus the base, clamped to
+ * 32 bits. Clamping keeps heads sorted, so keys whose heads tie are the only
+ * ones that need a full comparison; keys far apart from the node's base all
+ * saturate and fall back to that comparison.
+ *
+ * The disabled version is empty and its maintenance calls are no-ops.
+ */
+template <bool Enabled, uint64_t Capacity> struct KeyHeads {
+	static constexpr uint64_t kEntrySize = 0;
+	static constexpr uint64_t kFixedSize = 0;
+
+	template <class PrefixAt> void insertHead(unsigned pos, unsigned count, uint64_t prefix, PrefixAt prefixAt)
+	{
+	}
+
+	void eraseHead(unsigned pos, unsigned count)
+	{
+	}
+
+	template <class PrefixAt> void rebuildHeads(unsigned count, PrefixAt prefixAt)
+	{
+	}
+};
+
+template <uint64_t Capacity> struct KeyHeads<true, Capacity> {
+	static constexpr unsigned kHeadsPerLine = 64 / sizeof(uint32_t);
+
+	// AVX2 loads read up to 7 heads past the last entry
+	static constexpr uint64_t kPadding = 8;
+
+	static constexpr uint64_t kEntrySize = sizeof(uint32_t);
+	static constexpr uint64_t kFixedSize = sizeof(uint64_t) + kPadding * sizeof(uint32_t);
+
+	uint64_t base_ = 0;
+	uint32_t heads_[Capacity + kPadding];
+
+	uint32_t toHead(uint64_t prefix) const
+	{
+		if (prefix <= base_)
+			return 0;
+		return std::min<uint64_t>(prefix - base_, UINT32_MAX);
+	}
+
+	/**
+	 * call after the key at `pos` is in place, before the count grows;
+	 * `count` is the number of keys before the insertion
+	 */
+	template <class PrefixAt> void insertHead(unsigned pos, unsigned count, uint64_t prefix, PrefixAt prefixAt)
+	{
+		if (count > 0 && prefix >= base_) {
+			memmove(heads_ + pos + 1, heads_ + pos, sizeof(uint32_t) * (count - pos));
+			heads_[pos] = toHead(prefix);
+		} else {
+			// a new smallest key: rebase the node on it
+			rebuildHeads(count + 1, prefixAt);
+		}
+	}
+
+	void eraseHead(unsigned pos, unsigned count)
+	{
+		memmove(heads_ + pos, heads_ + pos + 1, sizeof(uint32_t) * (count - pos - 1));
+	}
+
+	template <class PrefixAt> void rebuildHeads(unsigned count, PrefixAt prefixAt)
+	{
+		base_ = count > 0 ? prefixAt(0) : 0;
+		for (unsigned i = 0; i < count; i++) {
+			heads_[i] = toHead(prefixAt(i));
+		}
+	}
+
+	/**
+	 * lower bound of a key among the first `count` entries;
+	 * keyLess(i) compares the full key at `i` against the search key
+	 */
+	template <class KeyLess> unsigned search(uint64_t prefix, unsigned count, KeyLess keyLess) const
+	{
+		uint32_t h = toHead(prefix);
+		unsigned pos = countBelow(h, count);
+		while (pos < count && heads_[pos] == h && keyLess(pos))
+			++pos;
+		return pos;
+	}
+
+	/** number of heads below `h` among the first `count` (heads are sorted) */
+	unsigned countBelow(uint32_t h, unsigned count) const
+	{
+		unsigned lo = 0, hi = count;
+
+		// narrow down to at most one cache line worth of heads
+		while (hi - lo > kHeadsPerLine) {
+			unsigned mid = lo + (hi - lo) / 2;
+			if (heads_[mid] < h)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+
+#if defined(__AVX512F__)
+		__mmask16 valid = static_cast<__mmask16>((1u << (hi - lo)) - 1);
+		__m512i heads = _mm512_maskz_loadu_epi32(valid, heads_ + lo);
+		return lo + __builtin_popcount(_mm512_mask_cmplt_epu32_mask(valid, heads, _mm512_set1_epi32(h)));
+#elif defined(__AVX2__)
+		// no unsigned compare in AVX2: flip the sign bits and compare signed
+		const __m256i flip = _mm256_set1_epi32(INT32_MIN);
+		__m256i key = _mm256_xor_si256(_mm256_set1_epi32(h), flip);
+		unsigned below = 0;
+		for (unsigned i = lo; i < hi; i += 8) {
+			__m256i heads = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(heads_ + i)), flip);
+			unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(key, heads)));
+			if (hi - i < 8)
+				mask &= (1u << (hi - i)) - 1;
+			below += __builtin_popcount(mask);
+		}
+		return lo + below;
+#else
+		while (lo < hi && heads_[lo] < h)
+			++lo;
+		return lo;
+#endif
+	}
+};
+
 /**
  * class BPlusTree
  * This implementation assumes that KeyType has properly implemented default constructor, copy-constructor, assignment-constructor, destructor.
@@ -179,6 +343,10 @@ class BPlusTree {
 	/** this is the element type of the leaf node */
 	using KeyValuePair = std::pair<KeyType, ValueType>;
 
+	/** nodes keep key heads if the comparator exposes key prefixes */
+	static constexpr bool kUseKeyHeads = HasKeyPrefix<KeyComparator, KeyType>::value;
+	using KeyPrefixOf = KeyPrefix<KeyComparator, KeyType>;
+
 	/**
 	 * enum class NodeType - B+ Tree node type
 	 */
@@ -554,6 +722,17 @@ class BPlusTree {
 		}
 	};
 
+	static constexpr uint64_t kHeadEntrySize = KeyHeads<kUseKeyHeads, 0>::kEntrySize;
+	static constexpr uint64_t kHeadFixedSize = KeyHeads<kUseKeyHeads, 0>::kFixedSize;
+
+	static constexpr uint64_t kLeafMaxEntries = (LeafPageSize - sizeof(NodeBase) - sizeof(boost::interprocess::offset_ptr<NodeBase>) * 2 - kHeadFixedSize) /
+						    (sizeof(KeyValuePair) + kHeadEntrySize);
+	static constexpr uint64_t kInnerMaxEntries =
+		(InnerPageSize - sizeof(NodeBase) - kHeadFixedSize) / (sizeof(KeyType) + sizeof(boost::interprocess::offset_ptr<NodeBase>) + kHeadEntrySize);
+
+	using LeafKeyHeads = KeyHeads<kUseKeyHeads, kLeafMaxEntries>;
+	using InnerKeyHeads = KeyHeads<kUseKeyHeads, kInnerMaxEntries>;
+
 	/**
 	 * class StackNodeElement - used when delete nodes recursively
 	 */
@@ -566,9 +745,9 @@ class BPlusTree {
 	/**
 	 * class BTreeLeaf - leaf node
 	 */
-	class BTreeLeaf : public NodeBase {
+	class BTreeLeaf : public NodeBase, public LeafKeyHeads {
 	    public:
-		static constexpr uint64_t maxEntries = (LeafPageSize - sizeof(NodeBase) - sizeof(boost::interprocess::offset_ptr<BTreeLeaf>) * 2) / (sizeof(KeyValuePair));
+		static constexpr uint64_t maxEntries = kLeafMaxEntries;
 		static_assert(maxEntries >= 3, "maxEntries of BTreeLeaf must >= 3");
 
 		boost::interprocess::offset_ptr<BTreeLeaf> pre_;
@@ -617,6 +796,7 @@ class BPlusTree {
 			bool res = false;
 
 			__adjust_elements_in_erase(pos);
+			this->eraseHead(pos, this->getCount());
 
 			res = true;
 			this->setCount(this->getCount() - 1);
@@ -673,7 +853,7 @@ class BPlusTree {
 		 * merge right `sibling`
 		 * `sibling` need to be reclaimed
 		 */
-		void merge(BTreeLeaf *sibling)
+		void merge(BTreeLeaf *sibling, const KeyComparator &keyComp_)
 		{
 			assert(hasEnoughSpace(sibling->getCount()));
 			for (uint16_t i = this->getCount(); i < sibling->getCount() + this->getCount(); i++) {
@@ -683,6 +863,7 @@ class BPlusTree {
 				sibling->values_[i - this->getCount()].~ValueType();
 			}
 			this->setCount(this->getCount() + sibling->getCount());
+			rebuildKeyHeads(keyComp_);
 			this->next_ = sibling->next_.get();
                         if (this->next_.get())
                                 sibling->next_->pre_ = this;
@@ -732,6 +913,7 @@ class BPlusTree {
 					keys_[pos] = k;
 					values_[pos] = createValue();
 				}
+				insertKeyHead(pos, keyComp_);
 				this->setCount(this->getCount() + 1);
 				success = true;
 				return values_[pos];
@@ -739,6 +921,17 @@ class BPlusTree {
 		}
 
 		unsigned lowerBound(const KeyType &k, const KeyComparator &keyComp_)
+		{
+			return lowerBound(k, keyComp_, std::integral_constant<bool, kUseKeyHeads>());
+		}
+
+		unsigned lowerBound(const KeyType &k, const KeyComparator &keyComp_, std::true_type)
+		{
+			unsigned count = std::min<unsigned>(this->getCount(), maxEntries);
+			return this->search(KeyPrefixOf::get(keyComp_, k), count, [&](unsigned i) { return keyComp_(keys_[i], k) < 0; });
+		}
+
+		unsigned lowerBound(const KeyType &k, const KeyComparator &keyComp_, std::false_type)
 		{
 			if (this->getCount() < 128) {
 				int left = 0;
@@ -773,6 +966,20 @@ class BPlusTree {
 			return keys_[this->getCount() - 1];
 		}
 
+		/**
+		 * call after the key at `pos` is in place, before the count grows
+		 */
+		void insertKeyHead(unsigned pos, const KeyComparator &keyComp_)
+		{
+			this->insertHead(pos, this->getCount(), KeyPrefixOf::get(keyComp_, keys_[pos]),
+					 [&](unsigned i) { return KeyPrefixOf::get(keyComp_, keys_[i]); });
+		}
+
+		void rebuildKeyHeads(const KeyComparator &keyComp_)
+		{
+			this->rebuildHeads(this->getCount(), [&](unsigned i) { return KeyPrefixOf::get(keyComp_, keys_[i]); });
+		}
+
 		// void insert_at(KeyType k, ValueType p, unsigned pos) {
 		//     assert(keyComp_(data_[pos].first, k) == 0);
 		//     if (this->getCount()) {
@@ -818,6 +1025,7 @@ class BPlusTree {
 					keys_[pos] = k;
 					values_[pos] = v;
 				}
+				insertKeyHead(pos, keyComp_);
 				this->setCount(this->getCount() + 1);
 				success = true;
 				return v;
@@ -852,6 +1060,7 @@ class BPlusTree {
 					keys_[pos] = k;
 					values_[pos] = v;
 				}
+				insertKeyHead(pos, keyComp_);
 				this->setCount(this->getCount() + 1);
 				return true;
 			}
@@ -860,7 +1069,7 @@ class BPlusTree {
 		/**
 		 * split leaf node
 		 */
-		BTreeLeaf *split(KeyType &sep)
+		BTreeLeaf *split(KeyType &sep, const KeyComparator &keyComp_)
 		{
                         char *base = reinterpret_cast<char *>(star::cxl_memory.cxlalloc_malloc_wrapper(sizeof(BTreeLeaf), star::CXLMemory::INDEX_ALLOCATION));
 			BTreeLeaf *newLeaf = new (base) BTreeLeaf(); // Placement new
@@ -878,6 +1087,8 @@ class BPlusTree {
 				keys_[i + this->getCount()].~KeyType();
 				values_[i + this->getCount()].~ValueType(); // call dtor manually
 			}
+			// the heads of the keys that stay are still valid
+			newLeaf->rebuildKeyHeads(keyComp_);
 
 			__get_separate_key_in_split(sep);
 
@@ -905,14 +1116,14 @@ class BPlusTree {
 			sep = keys_[this->getCount() - 1].deepCopy();
 		}
 	};
-	// static_assert(LeafPageSize > sizeof(BTreeLeaf), "LeafPageSize too small");
+	static_assert(LeafPageSize >= sizeof(BTreeLeaf), "LeafPageSize too small");
 
 	/**
 	 * BTreeInner - inner node
 	 */
-	class BTreeInner : public NodeBase {
+	class BTreeInner : public NodeBase, public InnerKeyHeads {
 	    public:
-		static constexpr uint64_t maxEntries = (InnerPageSize - sizeof(NodeBase)) / (sizeof(KeyType) + sizeof(boost::interprocess::offset_ptr<NodeBase>));
+		static constexpr uint64_t maxEntries = kInnerMaxEntries;
 		static_assert(maxEntries >= 3, "maxEntries of BTreeInner must >= 3");
 
 		static constexpr uint64_t childOffset = maxEntries * sizeof(KeyType);
@@ -961,6 +1172,7 @@ class BPlusTree {
 		bool erase(int pos)
 		{
 			__adjust_elements_in_erase(pos);
+			this->eraseHead(pos, this->getCount());
 
 			this->setCount(this->getCount() - 1);
 			return this->getCount() == 0;
@@ -1012,12 +1224,13 @@ class BPlusTree {
                         }
 		}
 
-		void merge(BTreeInner *sibling, const KeyType &subTreeMaxKey)
+		void merge(BTreeInner *sibling, const KeyType &subTreeMaxKey, const KeyComparator &keyComp_)
 		{
 			__adjust_elements_in_merge(sibling, subTreeMaxKey);
 
 			this->setCount(this->getCount() + 1);
 			this->setCount(this->getCount() + sibling->getCount());
+			rebuildKeyHeads(keyComp_);
 
 			assert(((uint64_t)sibling) != 0xffffffffffffffffull);
 			star::cxl_memory.cxlalloc_free_wrapper(sibling, kLeafPageSize, star::CXLMemory::INDEX_FREE);
@@ -1073,6 +1286,17 @@ class BPlusTree {
 		}
 
 		unsigned lowerBound(const KeyType &k, const KeyComparator &keyComp_)
+		{
+			return lowerBound(k, keyComp_, std::integral_constant<bool, kUseKeyHeads>());
+		}
+
+		unsigned lowerBound(const KeyType &k, const KeyComparator &keyComp_, std::true_type)
+		{
+			unsigned count = std::min<unsigned>(this->getCount(), maxEntries);
+			return this->search(KeyPrefixOf::get(keyComp_, k), count, [&](unsigned i) { return keyComp_(keyAt(i), k) < 0; });
+		}
+
+		unsigned lowerBound(const KeyType &k, const KeyComparator &keyComp_, std::false_type)
 		{
 			if (this->getCount() < 128) {
 				int left = 0;
@@ -1106,7 +1330,7 @@ class BPlusTree {
 			return this->getCount() - threshold;
 		}
 
-		BTreeInner *split(KeyType &sep)
+		BTreeInner *split(KeyType &sep, const KeyComparator &keyComp_)
 		{
                         char *base = reinterpret_cast<char *>(star::cxl_memory.cxlalloc_malloc_wrapper(InnerPageSize, star::CXLMemory::INDEX_ALLOCATION));
 			BTreeInner *newInner = new (base) BTreeInner(); // Placement new
@@ -1131,6 +1355,8 @@ class BPlusTree {
                         for (int i = 0; i < newInner->getCount() + 1; i++) {
                                 newInner->childAt(i) = childAt(this->getCount() + 1 + i).get();
                         }
+			// the heads of the keys that stay are still valid
+			newInner->rebuildKeyHeads(keyComp_);
 
 			return newInner;
 		}
@@ -1141,6 +1367,20 @@ class BPlusTree {
 			return keyAt(this->getCount() - 1);
 		}
 
+		/**
+		 * call after the key at `pos` is in place, before the count grows
+		 */
+		void insertKeyHead(unsigned pos, const KeyComparator &keyComp_)
+		{
+			this->insertHead(pos, this->getCount(), KeyPrefixOf::get(keyComp_, keyAt(pos)),
+					 [&](unsigned i) { return KeyPrefixOf::get(keyComp_, keyAt(i)); });
+		}
+
+		void rebuildKeyHeads(const KeyComparator &keyComp_)
+		{
+			this->rebuildHeads(this->getCount(), [&](unsigned i) { return KeyPrefixOf::get(keyComp_, keyAt(i)); });
+		}
+
 		void insert(const KeyType &k, NodeBase *child, const KeyComparator &keyComp_)
 		{
 			assert(this->getCount() < maxEntries - 1);
@@ -1162,6 +1402,7 @@ class BPlusTree {
 			childAt(pos) = child;
 
 			std::swap(childAt(pos), childAt(pos + 1));
+			insertKeyHead(pos, keyComp_);
 			this->setCount(this->getCount() + 1);
 		}
 
@@ -1189,7 +1430,17 @@ class BPlusTree {
 			}
 		}
 	};
-	static_assert(InnerPageSize > sizeof(BTreeInner), "InnerPageSize too small");
+	static_assert(InnerPageSize >= sizeof(BTreeInner) + BTreeInner::maxEntries * (sizeof(KeyType) + sizeof(boost::interprocess::offset_ptr<NodeBase>)),
+		      "InnerPageSize too small");
+
+	/** bytes a node search reads before it reaches the keys */
+	static constexpr uint64_t kSearchRegionSize = kUseKeyHeads ? std::max(sizeof(NodeBase) + sizeof(LeafKeyHeads), sizeof(NodeBase) + sizeof(InnerKeyHeads)) : 64;
+
+	static void prefetchNode(NodeBase *node)
+	{
+		if (EnableNodePrefetch)
+			prefetch(reinterpret_cast<char *>(node), kSearchRegionSize);
+	}
 
 	/**
 	 * NOTE: developing
@@ -1447,6 +1698,7 @@ class BPlusTree {
 		inner->newKey(0, k);
 		inner->childAt(0) = leftChild;
 		inner->childAt(1) = rightChild;
+		inner->rebuildKeyHeads(keyComp_);
 		root_.store(inner);
 	}
 
@@ -1574,6 +1826,10 @@ class BPlusTree {
 			}
 			// adjust parent: replace the parent key which in the `pos`
 			__adjust_parent_in_reallocNode(p, pos, a->max_key());
+
+			a->rebuildKeyHeads(keyComp_);
+			b->rebuildKeyHeads(keyComp_);
+			p->rebuildKeyHeads(keyComp_);
 		} else {
 			auto a = static_cast<BTreeInner *>(left);
 			auto b = static_cast<BTreeInner *>(right);
@@ -1635,6 +1891,10 @@ class BPlusTree {
 				a->keyAt(a->getCount() - 1).~KeyType();
 				a->setCount(a->getCount() - 1);
 			}
+
+			a->rebuildKeyHeads(keyComp_);
+			b->rebuildKeyHeads(keyComp_);
+			p->rebuildKeyHeads(keyComp_);
 		}
 	}
 	/**
@@ -1712,7 +1972,7 @@ restart:
 				}
 				// Split
 				KeyType sep;
-				BTreeInner *newInner = inner->split(sep);
+				BTreeInner *newInner = inner->split(sep, keyComp_);
 				stats_.inner_nodes++;
 				if (parent)
 					parent->insert(sep, newInner, keyComp_);
@@ -1737,7 +1997,7 @@ restart:
 			versionParent = versionNode;
 
 			node = inner->childAt(inner->lowerBound(k, keyComp_)).get();
-			// prefetch((char *)node, sizeof(NodeMetaData));
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
@@ -1780,7 +2040,7 @@ restart:
 			}
 			// Split
 			KeyType sep;
-			BTreeLeaf *newLeaf = leaf->split(sep);
+			BTreeLeaf *newLeaf = leaf->split(sep, keyComp_);
 			stats_.leaf_nodes++;
 			if (keyComp_(k, sep) > 0) {
 				success = newLeaf->insert(k, v, keyComp_);
@@ -1876,7 +2136,7 @@ restart:
 				}
 				// Split
 				KeyType sep;
-				BTreeInner *newInner = inner->split(sep);
+				BTreeInner *newInner = inner->split(sep, keyComp_);
 				stats_.inner_nodes++;
 				if (parent)
 					parent->insert(sep, newInner, keyComp_);
@@ -1908,7 +2168,7 @@ restart:
 			versionParent = versionNode;
 
 			node = inner->childAt(inner->lowerBound(k, keyComp_)).get();
-			// prefetch((char *)node, sizeof(NodeMetaData));
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
@@ -1946,7 +2206,7 @@ restart:
 			}
 			// Split
 			KeyType sep;
-			BTreeLeaf *newLeaf = leaf->split(sep);
+			BTreeLeaf *newLeaf = leaf->split(sep, keyComp_);
 			stats_.leaf_nodes++;
 			if (keyComp_(k, sep) > 0) {
 				insertRes = newLeaf->insert(k, v, keyComp_, success);
@@ -2047,7 +2307,7 @@ restart:
 				}
 				// Split
 				KeyType sep;
-				BTreeInner *newInner = inner->split(sep);
+				BTreeInner *newInner = inner->split(sep, keyComp_);
 				stats_.inner_nodes++;
 				if (parent)
 					parent->insert(sep, newInner, keyComp_);
@@ -2079,7 +2339,7 @@ restart:
 			versionParent = versionNode;
 
 			node = inner->childAt(inner->lowerBound(k, keyComp_)).get();
-			// prefetch((char *)node, sizeof(NodeMetaData));
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
@@ -2118,7 +2378,7 @@ restart:
 			}
 			// Split
 			KeyType sep;
-			BTreeLeaf *newLeaf = leaf->split(sep);
+			BTreeLeaf *newLeaf = leaf->split(sep, keyComp_);
 			stats_.leaf_nodes++;
 			if (keyComp_(k, sep) > 0) {
 				insertRes = newLeaf->getValue(k, keyComp_, createValue, success);
@@ -2239,7 +2499,7 @@ restart:
 			versionParent = versionNode;
 			node = inner->childAt(inner->lowerBound(lowKey, keyComp_)).get();
 
-			// prefetch((char *)node, kPageSize);
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
@@ -2327,7 +2587,7 @@ restart:
 			versionParent = versionNode;
 			node = inner->childAt(inner->lowerBound(lowKey, keyComp_)).get();
 
-			// prefetch((char *)node, kPageSize);
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
@@ -2356,6 +2616,11 @@ restart:
 
 		bool quit = false;
 		BTreeLeaf *nextLeaf = leaf->next_.get();
+		if (EnableNodePrefetch && nextLeaf != nullptr) {
+			// the next round starts with the first key of the next leaf
+			prefetchNode(nextLeaf);
+			prefetch(reinterpret_cast<char *>(&nextLeaf->keys_[0]), sizeof(KeyType));
+		}
 		for (unsigned p = pos; p < leaf->getCount(); ++p) {
 			bool lastItem = nextLeaf == nullptr && p + 1 == leaf->getCount();
                         CHECK(keyComp_(leaf->keys_[p], lowKey) >= 0);
@@ -2553,7 +2818,7 @@ restart:
 			auto child = static_cast<BTreeLeaf *>(childNode);
 			auto sibling = static_cast<BTreeLeaf *>(siblingNode);
 			if (opt == MergeOperation::LeftToRight) {
-				child->merge(sibling);
+				child->merge(sibling, keyComp_);
 				stats_.leaf_nodes--;
 				// KeyType siblingMaxKey = sibling->max_key();
 				// parentNode->keys_[childPos] = siblingMaxKey;
@@ -2567,7 +2832,7 @@ restart:
 					// if (parentNode == root_.load()) root_.store(child);
 				}
 			} else if (opt == MergeOperation::RightToLeft) {
-				sibling->merge(child);
+				sibling->merge(child, keyComp_);
 				stats_.leaf_nodes--;
 				// KeyType childMaxKey = child->max_key();
 				// parentNode->keys_[siblingPos] = childMaxKey;
@@ -2589,7 +2854,7 @@ restart:
 			auto sibling = static_cast<BTreeInner *>(siblingNode);
 			if (opt == MergeOperation::LeftToRight) {
 				const KeyType &subTreeMaxKey = _getSubTreeMaxKey(child->childAt(child->getCount()).get());
-				child->merge(sibling, subTreeMaxKey);
+				child->merge(sibling, subTreeMaxKey, keyComp_);
 				stats_.inner_nodes--;
 				// KeyType siblingSubTreeMaxKey = _getSubTreeMaxKey(sibling);
 				changeRoot = parentNode->erase(childPos);
@@ -2602,7 +2867,7 @@ restart:
 				}
 			} else if (opt == MergeOperation::RightToLeft) {
 				const KeyType &subTreeMaxKey = _getSubTreeMaxKey(sibling->childAt(sibling->getCount()).get());
-				sibling->merge(child, subTreeMaxKey);
+				sibling->merge(child, subTreeMaxKey, keyComp_);
 				stats_.inner_nodes--;
 				changeRoot = parentNode->erase(siblingPos);
 				if (changeRoot && parentNode == root_.load()) {
@@ -2844,6 +3109,7 @@ restart:
 
 			unsigned pos = inner->lowerBound(element.first, keyComp_);
 			node = inner->childAt(pos).get();
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart) {
 				goto restart;
@@ -3000,6 +3266,7 @@ restart:
 
 			unsigned pos = inner->lowerBound(deleteKey, keyComp_);
 			node = inner->childAt(pos).get();
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart) {
 				goto restart;
@@ -3132,7 +3399,7 @@ restart:
 			versionParent = versionNode;
 
 			node = inner->childAt(inner->lowerBound(key, keyComp_)).get();
-			prefetch((char *)node, sizeof(NodeMetaData));
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
@@ -3207,7 +3474,7 @@ restart:
 			versionParent = versionNode;
 
 			node = inner->childAt(inner->lowerBound(element.first, keyComp_)).get();
-			prefetch((char *)node, sizeof(NodeMetaData));
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
@@ -3277,7 +3544,7 @@ restart:
 			versionParent = versionNode;
 
 			node = inner->childAt(inner->lowerBound(key, keyComp_)).get();
-			prefetch((char *)node, sizeof(NodeMetaData));
+			prefetchNode(node);
 			inner->checkOrRestart(versionNode, needRestart);
 			if (needRestart)
 				goto restart;
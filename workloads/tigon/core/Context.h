@@ -46,12 +46,15 @@ class Context {
 	std::string log_path;
 	std::string cdf_path;
 	std::size_t cpu_core_id = 0;
+	std::size_t cpu_core_num = 0;   // 0 means all cores from cpu_core_id on
 	std::size_t cross_txn_workers = 0;
 	bool hstore_command_logging = true;
 	star::WALLogger *master_logger = nullptr;
         std::vector<star::WALLogger *> slave_loggers;
 
 	std::size_t group_commit_batch_size = 7;
+	std::size_t wal_stream_flushers = 0;    // 0 means a single group commit log file
+	bool wal_recovery = false;
 	// https://www.storagereview.com/review/intel-ssd-dc-p4510-review
 	// We emulate 110us write latency of Intel DC P4510 SSD.
 	std::size_t emulated_persist_latency = 110;
@@ -91,9 +94,12 @@ class Context {
 	double straggler_zipf_factor = 0;
 	std::size_t straggler_num_txn_len = 10;
 	std::size_t granules_per_partition = 128;
+	std::string hash_index = "Striped";
 	bool lotus_async_repl = false;
 	int lotus_checkpoint = 0;
 	std::string lotus_checkpoint_location;
+	std::string table_checkpoint_path;
+	std::size_t table_checkpoint_threads = 0;
 	bool hstore_active_active = false;
 	bool lotus_sp_parallel_exec_commit = false;
 
@@ -102,6 +108,7 @@ class Context {
         bool use_output_thread = false;
         uint64_t cxl_trans_entry_struct_size = 8192;
         uint64_t cxl_trans_entry_num = 4096;
+        bool cxl_trans_var_length = false;
         // Default to ivshmem (shared memory) unless explicitly configured
         std::string cxl_backend = "ivshmem";
         std::string cxl_memory_resource = "SS";
@@ -115,8 +122,10 @@ class Context {
         // Pasha software cache-coherence
         bool enable_scc = true;
         std::string scc_mechanism;
+        uint64_t scc_flush_cost = 0;    // ns per flushed cache line, for pods emulated on one machine
 
         // Pasha ablation study
+        bool btree_prefetch = false;
         bool enable_phantom_detection = true;
         bool model_cxl_search_overhead = false;
 
@@ -126,5 +135,22 @@ class Context {
 
         // pre-migrate
         std::string pre_migrate;
+
+        // skew-aware partition ownership remapping
+        int repartition_interval = 0;
+        double repartition_threshold = 1.25;
+
+        // transactions interleaved by each worker, switching at remote waits
+        int coroutine_num = 1;
+
+        // read-only transactions read migrated rows from a snapshot instead of locking them
+        bool mvcc_snapshot_reads = false;
+
+        // TwoPLPasha lock conflicts: NoWait aborts, WaitDie queues older transactions behind younger holders
+        std::string lock_wait_policy = "NoWait";
+        int lock_wait_timeout_us = 10000;
+
+        // TwoPLPasha releases read locks at the lock point and each write lock right after its write-back
+        bool early_lock_release = false;
 };
 } // namespace star
@@ -8,10 +8,12 @@
 #include "common/Message.h"
 #include "common/MessagePiece.h"
 
+#include <vector>
+
 namespace star
 {
 
-enum class ControlMessage { STATISTICS, SIGNAL, ACK, STOP, NFIELDS };
+enum class ControlMessage { STATISTICS, SIGNAL, ACK, STOP, PARTITION_LOAD, PARTITION_HANDOFF, PARTITION_OWNER, NFIELDS };
 
 class ControlMessageFactory {
     public:
@@ -83,6 +85,63 @@ class ControlMessageFactory {
 		message.set_gen_time(Time::now());
 		return message_size;
 	}
+
+	static std::size_t new_partition_load_message(Message &message, uint64_t epoch, const std::vector<uint64_t> &load)
+	{
+		/*
+		 * The structure of a partition load message: (epoch : uint64_t, partition count : uint64_t, load of each partition : uint64_t)
+		 */
+
+		uint64_t partition_num = load.size();
+		auto message_size = MessagePiece::get_header_size() + sizeof(epoch) + sizeof(partition_num) + partition_num * sizeof(uint64_t);
+		auto message_piece_header =
+			MessagePiece::construct_message_piece_header(static_cast<uint32_t>(ControlMessage::PARTITION_LOAD), message_size, 0, 0);
+
+		Encoder encoder(message.data);
+		encoder << message_piece_header;
+		encoder << epoch << partition_num;
+		for (auto partition_load : load)
+			encoder << partition_load;
+		message.flush();
+		message.set_gen_time(Time::now());
+		return message_size;
+	}
+
+	static std::size_t new_partition_handoff_message(Message &message, uint64_t epoch, uint64_t partition_id, uint64_t new_owner)
+	{
+		/*
+		 * The structure of a partition handoff message: (epoch : uint64_t, partition : uint64_t, new owner : uint64_t)
+		 */
+
+		auto message_size = MessagePiece::get_header_size() + sizeof(epoch) + sizeof(partition_id) + sizeof(new_owner);
+		auto message_piece_header =
+			MessagePiece::construct_message_piece_header(static_cast<uint32_t>(ControlMessage::PARTITION_HANDOFF), message_size, 0, 0);
+
+		Encoder encoder(message.data);
+		encoder << message_piece_header;
+		encoder << epoch << partition_id << new_owner;
+		message.flush();
+		message.set_gen_time(Time::now());
+		return message_size;
+	}
+
+	static std::size_t new_partition_owner_message(Message &message, uint64_t epoch, uint64_t partition_id, uint64_t new_owner)
+	{
+		/*
+		 * The structure of a partition owner message: (epoch : uint64_t, partition : uint64_t, new owner : uint64_t)
+		 */
+
+		auto message_size = MessagePiece::get_header_size() + sizeof(epoch) + sizeof(partition_id) + sizeof(new_owner);
+		auto message_piece_header =
+			MessagePiece::construct_message_piece_header(static_cast<uint32_t>(ControlMessage::PARTITION_OWNER), message_size, 0, 0);
+
+		Encoder encoder(message.data);
+		encoder << message_piece_header;
+		encoder << epoch << partition_id << new_owner;
+		message.flush();
+		message.set_gen_time(Time::now());
+		return message_size;
+	}
 };
 
 } // namespace star
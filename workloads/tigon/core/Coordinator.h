@@ -11,9 +11,12 @@
 #include "common/MPSCRingBuffer.h"
 #include "common/CXLTransport.h"
 #include "common/CXL_EBR.h"
+#include "common/btree_olc_cxl/BTreeOLC_CXL.h"
+#include "common/WALRecovery.h"
 #include "core/ControlMessage.h"
 #include "core/Dispatcher.h"
 #include "core/Executor.h"
+#include "core/PartitionRemapper.h"
 #include "core/Worker.h"
 #include "core/factory/WorkerFactory.h"
 #include <boost/algorithm/string.hpp>
@@ -21,6 +24,7 @@
 #include <thread>
 #include <vector>
 #include <chrono>
+#include <map>
 #include <memory>
 
 #include "protocol/Pasha/MigrationManager.h"
@@ -45,12 +49,30 @@ class Coordinator {
                 cxl_memory.init(context);
                 cxl_memory.init_cxlalloc_for_given_thread(context.worker_num + 1, 0, context.coordinator_num, context.coordinator_id);
 
+                btreeolc_cxl::EnableNodePrefetch = context.btree_prefetch;
+
                 // init CXL transport
                 initCXLTransport();
 
                 // init CXL EBR
                 initCXLEBR();
 
+                // only TwoPLPasha writes WALRedoRecords, other protocols' text records cannot be replayed
+                if (context.wal_stream_flushers > 0 || context.wal_recovery == true) {
+                        CHECK(context.protocol == "TwoPLPasha") << "per-worker wal streams and recovery need TwoPLPasha's WALRedoRecords";
+                }
+
+                // replay the previous run's log streams before the logger truncates them
+                if (context.wal_recovery == true && context.log_path != "") {
+                        std::vector<std::string> stream_filenames;
+                        for (auto i = 0u; i < context.worker_num; i++) {
+                                stream_filenames.push_back(PashaEpochWALLogger::get_stream_filename(context.log_path + "_group_commit.txt", i));
+                        }
+                        PashaEpochWALRecovery recovery(stream_filenames, context.worker_num,
+                                [&db](std::size_t table_id, std::size_t partition_id) { return db.find_table(table_id, partition_id); });
+                        recovery.recover();
+                }
+
                 // init logger
                 if (context.log_path != "" && context.wal_group_commit_time != 0) {
                         std::string redo_filename = context.log_path + "_group_commit.txt";
@@ -80,8 +102,14 @@ class Coordinator {
                                         log_buffer_queues->push_back(log_buffer_queue);
                                         context.slave_loggers.push_back(new star::PashaGroupCommitLoggerSlave(log_buffer_queue, cxl_global_epoch));
                                 }
-                                context.master_logger = new star::PashaGroupCommitLogger(redo_filename, log_buffer_queues, cxl_global_epoch, ioStopFlag,
-                                                context.group_commit_batch_size, context.wal_group_commit_time, context.emulated_persist_latency);
+                                if (context.wal_stream_flushers > 0) {
+                                        logger_type = "Epoch WAL Logger";
+                                        context.master_logger = new star::PashaEpochWALLogger(redo_filename, log_buffer_queues, cxl_global_epoch, ioStopFlag,
+                                                        context.wal_stream_flushers, context.wal_group_commit_time);
+                                } else {
+                                        context.master_logger = new star::PashaGroupCommitLogger(redo_filename, log_buffer_queues, cxl_global_epoch, ioStopFlag,
+                                                        context.group_commit_batch_size, context.wal_group_commit_time, context.emulated_persist_latency);
+                                }
                         }
                         LOG(INFO) << "WAL Group Commiting to file [" << redo_filename << "]" << " using " << logger_type;
                 } else {
@@ -97,6 +125,24 @@ class Coordinator {
                         LOG(INFO) << "WAL Group Commiting off. Log to file " << redo_filename << " using " << logger_type;
                 }
 
+                // init skew-aware partition ownership remapping
+                if (context.repartition_interval > 0) {
+                        CHECK(context.protocol == "TwoPLPasha" || context.protocol == "SundialPasha") << "repartitioning hands partitions off through Pasha data migration";
+                        CHECK(context.partitioner == "hash") << "repartitioning needs exactly one data home per partition";
+                        auto partitioner = PartitionerFactory::create_partitioner(context.partitioner, id, coordinator_num);
+                        partition_remapper = new PartitionRemapper(id, coordinator_num, context.partition_num, context.worker_num, *partitioner,
+                                context.repartition_threshold);
+                        partition_remapper->move_partition_into_cxl = [&db](std::size_t partition_id) {
+                                CHECK(migration_manager != nullptr);
+                                auto move_in_func = std::bind(&MigrationManager::move_row_in, migration_manager, std::placeholders::_1, std::placeholders::_2,
+                                        std::placeholders::_3, std::placeholders::_4);
+                                for (auto i = 0u; i < db.get_table_num_per_partition(); i++) {
+                                        db.find_table(i, partition_id)->move_all_into_cxl(move_in_func);
+                                }
+                        };
+                        LOG(INFO) << "Coordinator " << id << " rebalances partition ownership every " << context.repartition_interval << " seconds";
+                }
+
                 // init workers
 		LOG(INFO) << "Coordinator initializes " << context.worker_num << " workers.";
 		workers = WorkerFactory::create_workers(id, db, context, workerStopFlag);
@@ -207,7 +253,11 @@ class Coordinator {
 
                 std::vector<std::thread> logger_threads;
                 if (context.log_path != "" && context.wal_group_commit_time != 0 && context.lotus_checkpoint != LotusCheckpointScheme::COW_ON_CHECKPOINT_ON_LOGGING_OFF) {
-                        logger_threads.emplace_back(&PashaGroupCommitLogger::start, reinterpret_cast<PashaGroupCommitLogger *>(context.master_logger));
+                        if (context.wal_stream_flushers > 0) {
+                                logger_threads.emplace_back(&PashaEpochWALLogger::start, reinterpret_cast<PashaEpochWALLogger *>(context.master_logger));
+                        } else {
+                                logger_threads.emplace_back(&PashaGroupCommitLogger::start, reinterpret_cast<PashaGroupCommitLogger *>(context.master_logger));
+                        }
                         pin_thread_to_core(logger_threads[0]);
                 }
 
@@ -233,6 +283,9 @@ class Coordinator {
                          total_data_move_in = 0, total_data_move_out = 0;
 		int count = 0;
 
+		// cumulative latency of all workers at the previous report
+		Percentile<int64_t> last_latency;
+
 		do {
 			std::this_thread::sleep_for(std::chrono::seconds(1));
 
@@ -299,6 +352,16 @@ class Coordinator {
 				workers[i]->n_remote_access_with_req.store(0);
 			}
 
+			Percentile<int64_t> latency, window_latency;
+			for (auto i = 0u; i < workers.size(); i++) {
+				auto worker_latency = workers[i]->get_latency_percentile();
+				if (worker_latency != nullptr)
+					latency.merge(*worker_latency);
+			}
+			window_latency = latency;
+			window_latency.subtract(last_latency);
+			last_latency = latency;
+
                         n_data_move_out += num_data_move_out;
                         n_data_move_in += num_data_move_in;
                         num_data_move_out.store(0);
@@ -308,7 +371,8 @@ class Coordinator {
 				  << n_abort_no_retry << "/" << n_abort_lock << "/" << n_abort_read_validation << "), persistence latency "
 				  << total_persistence_latency / (workers.size() - 1) << ", txn latency " << total_txn_latency / (workers.size() - 1)
 				  << ", queued lock latency " << total_queued_lock_latency / (workers.size() - 1) << ", lock latency "
-				  << total_lock_latency / (workers.size() - 1) << ", active_txns " << total_active_txns / (workers.size() - 1)
+				  << total_lock_latency / (workers.size() - 1) << ", txn latency p50 " << window_latency.nth(50) << " us p99 "
+				  << window_latency.nth(99) << " us, active_txns " << total_active_txns / (workers.size() - 1)
 				  << ", n_failed_read_lock " << n_failed_read_lock << ", n_failed_write_lock " << n_failed_write_lock
 				  << ", n_failed_cmd_not_ready " << n_failed_cmd_not_ready << ", n_failed_no_cmd " << n_failed_no_cmd
 				  << ", network size: " << n_network_size << ", avg network size: " << 1.0 * n_network_size / n_commit
@@ -321,6 +385,14 @@ class Coordinator {
                                   << ", data_move_in: " << n_data_move_in
                                   << ", data_move_out: " << n_data_move_out;
 			count++;
+
+			if (partition_remapper != nullptr) {
+				if (count % context.repartition_interval == 0) {
+					report_partition_load(count / context.repartition_interval);
+				}
+				process_repartition_messages();
+			}
+
 			if (count > warmup && count <= timeToRun - cooldown) {
 				warmed_up = true;
 				total_commit += n_commit;
@@ -412,6 +484,11 @@ class Coordinator {
                 int i = 0;
                 void *tmp = NULL;
 
+                if (context.cxl_trans_var_length == true) {
+                        initCXLBatchTransport();
+                        return;
+                }
+
                 if (id == 0) {
                         cxl_ringbuffers = reinterpret_cast<MPSCRingBuffer *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(MPSCRingBuffer) * coordinator_num, 
                                 CXLMemory::TRANSPORT_ALLOCATION));
@@ -432,6 +509,30 @@ class Coordinator {
                 }
         }
 
+        void initCXLBatchTransport()
+        {
+                int i = 0;
+                void *tmp = NULL;
+                CXLBatchRingBuffer *cxl_batch_ringbuffers = nullptr;
+
+                if (id == 0) {
+                        cxl_batch_ringbuffers = reinterpret_cast<CXLBatchRingBuffer *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(CXLBatchRingBuffer) * coordinator_num,
+                                CXLMemory::TRANSPORT_ALLOCATION));
+                        for (i = 0; i < coordinator_num; i++)
+                                new(&cxl_batch_ringbuffers[i]) CXLBatchRingBuffer(context.cxl_trans_entry_struct_size * context.cxl_trans_entry_num);
+                        cxl_transport = new CXLTransport(cxl_batch_ringbuffers);
+                        CXLMemory::commit_shared_data_initialization(CXLMemory::cxl_transport_root_index, cxl_batch_ringbuffers);
+                        LOG(INFO) << "Coordinator " << id << " initializes variable-length CXL transport metadata ("
+                                << coordinator_num << " ringbuffers each with " << cxl_batch_ringbuffers[0].get_capacity() << " Bytes)";
+                } else {
+                        CXLMemory::wait_and_retrieve_cxl_shared_data(CXLMemory::cxl_transport_root_index, &tmp);
+                        cxl_batch_ringbuffers = reinterpret_cast<CXLBatchRingBuffer *>(tmp);
+                        cxl_transport = new CXLTransport(cxl_batch_ringbuffers);
+                        LOG(INFO) << "Coordinator " << id << " retrives variable-length CXL transport metadata ("
+                                << coordinator_num << " ringbuffers each with " << cxl_batch_ringbuffers[0].get_capacity() << " Bytes)";
+                }
+        }
+
         void initCXLEBR()
         {
                 int i = 0;
@@ -560,6 +661,14 @@ class Coordinator {
 				std::unique_ptr<Message> message(in_queue.front());
 				bool ok = in_queue.pop();
 				CHECK(ok);
+
+				// drop repartitioning messages that arrived after the last round
+				while ((*(message->begin())).get_message_type() != static_cast<uint32_t>(ControlMessage::STATISTICS)) {
+					in_queue.wait_till_non_empty();
+					message.reset(in_queue.front());
+					ok = in_queue.pop();
+					CHECK(ok);
+				}
 				CHECK(message->get_message_count() == 1);
 
 				MessagePiece messagePiece = *(message->begin());
@@ -620,6 +729,141 @@ class Coordinator {
 	}
 
     private:
+	void send_control_message(std::unique_ptr<Message> message, std::size_t dest_node_id)
+	{
+		message->set_source_node_id(id);
+		message->set_dest_node_id(dest_node_id);
+		message->set_worker_id(0);
+		if (context.use_output_thread == true) {
+			// message is reclaimed by the output thread
+			out_queue.push(message.release());
+		} else {
+			cxl_transport->send(message.get());
+		}
+	}
+
+	// sends the partition load of the last interval to coordinator 0
+	void report_partition_load(uint64_t epoch)
+	{
+		std::vector<uint64_t> load = partition_remapper->collect_load();
+
+		if (id == 0) {
+			add_partition_load(epoch, load);
+		} else {
+			auto message = std::make_unique<Message>();
+			ControlMessageFactory::new_partition_load_message(*message, epoch, load);
+			send_control_message(std::move(message), 0);
+		}
+	}
+
+	// coordinator 0 only: plans a hand-off once every host has reported an epoch
+	void add_partition_load(uint64_t epoch, const std::vector<uint64_t> &load)
+	{
+		DCHECK(id == 0);
+		if (epoch <= last_planned_epoch)
+			return;
+
+		auto &round = partition_load_rounds[epoch];
+		round.first.resize(load.size(), 0);
+		for (auto i = 0u; i < load.size(); i++)
+			round.first[i] += load[i];
+		if (++round.second < coordinator_num)
+			return;
+
+		PartitionRemapper::Move move;
+		if (handoff_in_flight == false)
+			move = partition_remapper->plan(round.first);
+		partition_load_rounds.erase(partition_load_rounds.begin(), partition_load_rounds.upper_bound(epoch));
+		last_planned_epoch = epoch;
+
+		if (move.partition_id < 0)
+			return;
+
+		LOG(INFO) << "Coordinator " << id << " epoch " << epoch << ": hands partition " << move.partition_id << " off from coordinator " << move.from
+			  << " to coordinator " << move.to;
+		handoff_in_flight = true;
+		if (move.from == id) {
+			start_hand_off(epoch, move.partition_id, move.to);
+		} else {
+			auto message = std::make_unique<Message>();
+			ControlMessageFactory::new_partition_handoff_message(*message, epoch, move.partition_id, move.to);
+			send_control_message(std::move(message), move.from);
+		}
+	}
+
+	void start_hand_off(uint64_t epoch, std::size_t partition_id, std::size_t new_owner)
+	{
+		handoff_epoch = epoch;
+		handoff_new_owner = new_owner;
+		partition_remapper->hand_off(partition_id);
+	}
+
+	void apply_partition_owner(uint64_t epoch, std::size_t partition_id, std::size_t new_owner)
+	{
+		partition_remapper->set_owner(epoch, partition_id, new_owner);
+		if (id == 0)
+			handoff_in_flight = false;
+	}
+
+	/*
+	 * Handles the repartitioning messages queued for this coordinator and
+	 * announces the new owner once a local hand-off has moved all rows into
+	 * CXL. Statistics messages are left for gather_and_print.
+	 */
+	void process_repartition_messages()
+	{
+		while (in_queue.empty() == false) {
+			Message *front = in_queue.front();
+			auto type = static_cast<ControlMessage>((*(front->begin())).get_message_type());
+			if (type == ControlMessage::STATISTICS)
+				break;
+
+			std::unique_ptr<Message> message(front);
+			bool ok = in_queue.pop();
+			CHECK(ok);
+			CHECK(message->get_message_count() == 1);
+
+			MessagePiece messagePiece = *(message->begin());
+			Decoder dec(messagePiece.toStringPiece());
+			uint64_t epoch, partition_id, new_owner, partition_num;
+
+			switch (type) {
+			case ControlMessage::PARTITION_LOAD: {
+				dec >> epoch >> partition_num;
+				std::vector<uint64_t> load(partition_num);
+				for (auto i = 0u; i < partition_num; i++)
+					dec >> load[i];
+				add_partition_load(epoch, load);
+				break;
+			}
+			case ControlMessage::PARTITION_HANDOFF:
+				dec >> epoch >> partition_id >> new_owner;
+				start_hand_off(epoch, partition_id, new_owner);
+				break;
+			case ControlMessage::PARTITION_OWNER:
+				dec >> epoch >> partition_id >> new_owner;
+				apply_partition_owner(epoch, partition_id, new_owner);
+				break;
+			default:
+				CHECK(false) << "Message type: " << static_cast<uint32_t>(type);
+				break;
+			}
+		}
+
+		int64_t partition_id = partition_remapper->take_handed_off();
+		if (partition_id < 0)
+			return;
+
+		for (auto i = 0u; i < coordinator_num; i++) {
+			if (i == id)
+				continue;
+			auto message = std::make_unique<Message>();
+			ControlMessageFactory::new_partition_owner_message(*message, handoff_epoch, partition_id, handoff_new_owner);
+			send_control_message(std::move(message), i);
+		}
+		apply_partition_owner(handoff_epoch, partition_id, handoff_new_owner);
+	}
+
 	void close_sockets()
 	{
 		for (auto i = 0u; i < inSockets.size(); i++) {
@@ -636,11 +880,19 @@ class Coordinator {
 
 	void pin_thread_to_core(std::thread &t)
 	{
-		static std::atomic<uint64_t> core_id{ 0 };
+		static std::atomic<uint64_t> next_core{ 0 };
+
+		// hosts sharing one machine each get their own core range [cpu_core_id, cpu_core_id + cpu_core_num)
+		uint64_t core_id = next_core++;
+		if (context.cpu_core_num > 0) {
+			core_id %= context.cpu_core_num;
+		}
+		core_id = (context.cpu_core_id + core_id) % std::thread::hardware_concurrency();
+
 		LOG(INFO) << "pinned thread to core " << core_id;
 		cpu_set_t cpuset;
 		CPU_ZERO(&cpuset);
-		CPU_SET(core_id++, &cpuset);
+		CPU_SET(core_id, &cpuset);
 		int rc = pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &cpuset);
 		CHECK(rc == 0);
 	}
@@ -666,6 +918,13 @@ class Coordinator {
 	// Useful for transfering messages between partitions for HStore.
 	LockfreeQueue<Message *> out_to_in_queue;
 
-        MPSCRingBuffer *cxl_ringbuffers;
+        MPSCRingBuffer *cxl_ringbuffers = nullptr;
+
+	// skew-aware repartitioning, touched by the coordinator thread only
+	std::map<uint64_t, std::pair<std::vector<uint64_t>, std::size_t> > partition_load_rounds;
+	uint64_t last_planned_epoch = 0;
+	bool handoff_in_flight = false;
+	uint64_t handoff_epoch = 0;
+	std::size_t handoff_new_owner = 0;
 };
 } // namespace star
@@ -11,15 +11,50 @@
 #include "common/Socket.h"
 #include "common/MPSCRingBuffer.h"
 #include "common/CXLTransport.h"
+#include "common/CXLBatchRingBuffer.h"
 #include "core/ControlMessage.h"
 #include "core/Worker.h"
 #include <atomic>
 #include <glog/logging.h>
 #include <thread>
 #include <vector>
+#include <xmmintrin.h>
 
 namespace star
 {
+
+/*
+ * Polling policy of the incoming dispatcher: spin with exponentially growing
+ * pause bursts while the transport is idle, and only start yielding the core
+ * once the bursts reach max_spin, so a message that arrives shortly after an
+ * idle period is picked up without a scheduler round-trip.
+ */
+class AdaptiveBackoff {
+    public:
+        void reset()
+        {
+                spin = min_spin;
+        }
+
+        void idle()
+        {
+                if (spin >= max_spin) {
+                        std::this_thread::yield();
+                        return;
+                }
+                for (uint32_t i = 0; i < spin; i++) {
+                        _mm_pause();
+                }
+                spin *= 2;
+        }
+
+    private:
+        static constexpr uint32_t min_spin = 4;
+        static constexpr uint32_t max_spin = 4096;
+
+        uint32_t spin{ min_spin };
+};
+
 class IncomingDispatcher {
     public:
 	IncomingDispatcher(std::size_t cid, std::size_t group_id, std::size_t io_thread_num, std::vector<Socket> &sockets,
@@ -40,8 +75,10 @@ class IncomingDispatcher {
                 if (context.use_cxl_transport == false)
                         for (auto i = 0u; i < sockets.size(); i++)
                                 buffered_readers.emplace_back(sockets[i]);
-                else
+                else if (cxl_transport->get_batch_ringbuffers() == nullptr)
                         buffered_readers.emplace_back(cxl_ringbuffers[coord_id]);
+                else
+                        batch_readers.emplace_back(cxl_transport->get_batch_ringbuffers()[coord_id]);
 	}
 
 	void start()
@@ -90,9 +127,11 @@ class IncomingDispatcher {
 				internal_message_recv_latency.add(ltc);
 			};
 		};
+		AdaptiveBackoff backoff;
 		while (!stopFlag.load()) {
 			// LOG(INFO) << "Dispatcher coordinator = " << coord_id;
 
+			bool idle = true;
 			process_internal_message_tranfer();
 			for (auto i = 0u; i < numCoordinators; i++) {
 				if (i == coord_id) {
@@ -103,9 +142,9 @@ class IncomingDispatcher {
 
 				if (message == nullptr) {
 					// process_internal_message_tranfer();
-					std::this_thread::yield();
 					continue;
 				}
+				idle = false;
 				message->set_message_recv_time(
 					std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()).time_since_epoch().count());
 				// LOG(INFO) << " message";
@@ -145,12 +184,21 @@ class IncomingDispatcher {
 				socket_message_recv_latency.add(ltc);
 				DCHECK(message == nullptr);
 			}
+
+			if (idle == true && out_to_in_queue.empty() == true) {
+				backoff.idle();
+			} else {
+				backoff.reset();
+			}
 		}
 
 		std::size_t socket_read_syscalls = 0;
 		for (size_t i = 0; i < buffered_readers.size(); ++i) {
 			socket_read_syscalls += buffered_readers[i].get_read_call_cnt();
 		}
+		for (size_t i = 0; i < batch_readers.size(); ++i) {
+			socket_read_syscalls += batch_readers[i].get_read_call_cnt();
+		}
 		LOG(INFO) << "Incoming Dispatcher exits, network size: " << network_size << ". socket_message_recv_latency(50th) "
 			  << socket_message_recv_latency.nth(50) << " socket_message_recv_latency(75th) " << socket_message_recv_latency.nth(75)
 			  << " socket_message_recv_latency(95th) " << socket_message_recv_latency.nth(95) << " socket_message_recv_latency(99th) "
@@ -161,7 +209,14 @@ class IncomingDispatcher {
 
 	bool is_coordinator_message(Message *message)
 	{
-		return (*(message->begin())).get_message_type() == static_cast<uint32_t>(ControlMessage::STATISTICS);
+		auto type = (*(message->begin())).get_message_type();
+		if (type == static_cast<uint32_t>(ControlMessage::STATISTICS))
+			return true;
+
+		// H-Store numbers its messages from 0, so only look for repartitioning messages when it is on
+		return context.repartition_interval > 0 &&
+		       (type == static_cast<uint32_t>(ControlMessage::PARTITION_LOAD) || type == static_cast<uint32_t>(ControlMessage::PARTITION_HANDOFF) ||
+			type == static_cast<uint32_t>(ControlMessage::PARTITION_OWNER));
 	}
 
 	std::unique_ptr<Message> fetchMessageFromCoordinator(uint64_t remote_coordinator_id)
@@ -170,8 +225,10 @@ class IncomingDispatcher {
 
                 if (context.use_cxl_transport == false)
                         message = buffered_readers[remote_coordinator_id].next_message();
-                else
+                else if (batch_readers.empty() == true)
                         message = buffered_readers[0].next_message();
+                else
+                        message = batch_readers[0].next_message();
 
                 return message;
 	}
@@ -182,6 +239,7 @@ class IncomingDispatcher {
 	std::size_t io_thread_num;
 	std::size_t network_size;
 	std::vector<BufferedReader> buffered_readers;
+	std::vector<CXLBatchReader> batch_readers;     // variable-length CXL transport
 	std::vector<std::shared_ptr<Worker> > workers;
 	LockfreeQueue<Message *> &coordinator_queue;
 	LockfreeQueue<Message *> &out_to_in_queue;
@@ -348,6 +406,24 @@ class OutgoingDispatcher {
 				continue;
 			}
 
+			// the variable-length CXL ring batches the messages itself
+			if (context.use_cxl_transport == true && cxl_transport->get_batch_ringbuffers() != nullptr) {
+				auto ts = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()).time_since_epoch().count();
+				for (size_t j = 0; j < messages_by_coordinator[i].size(); ++j) {
+					messages_by_coordinator[i][j]->set_message_send_time(ts);
+					network_size += messages_by_coordinator[i][j]->get_message_length();
+				}
+				auto t = Time::now();
+				cxl_transport->send_batch(i, messages_by_coordinator[i]);
+				sendto_cnt++;
+				auto ltc = (Time::now() - gen_time) / 1000;
+				gen_to_sent_latency.add(ltc);
+				sent_latency.add((Time::now() - t) / 1000);
+				network_msg_cnt += messages_by_coordinator[i].size();
+				network_msg_group_size.add(messages_by_coordinator[i].size());
+				continue;
+			}
+
 			std::unique_ptr<GrouppedMessage> gmsg(new GrouppedMessage);
 			gmsg->set_dest_node_id(i);
 			auto ts = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()).time_since_epoch().count();
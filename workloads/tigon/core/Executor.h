@@ -8,13 +8,16 @@
 #include "common/WALLogger.h"
 #include "common/BufferedFileWriter.h"
 #include "common/CXL_EBR.h"
+#include "common/Coroutine.h"
 #include "core/ControlMessage.h"
 #include "core/Defs.h"
 #include "core/Delay.h"
 #include "core/Partitioner.h"
+#include "core/PartitionRemapper.h"
 #include "core/Worker.h"
 #include "glog/logging.h"
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
@@ -34,6 +37,16 @@ template <class Workload, class Protocol> class Executor : public Worker {
 	using MessageHandlerType = typename ProtocolType::MessageHandlerType;
 
 	using StorageType = typename WorkloadType::StorageType;
+	// transactions in flight when context.coroutine_num > 1
+	struct TransactionSlot {
+		std::unique_ptr<Coroutine> coroutine;
+		std::unique_ptr<TransactionType> transaction;
+		bool retry_transaction = false;
+		bool in_transaction = false;
+		uint64_t last_seed = 0;
+		uint64_t seed = 0;	// state of 'random' while this slot runs, see resume_slot()
+	};
+
 	Executor(std::size_t coordinator_id, std::size_t id, DatabaseType &db, const ContextType &context, std::atomic<uint32_t> &worker_status,
 		 std::atomic<uint32_t> &n_complete_workers, std::atomic<uint32_t> &n_started_workers)
 		: Worker(coordinator_id, id)
@@ -85,8 +98,6 @@ template <class Workload, class Protocol> class Executor : public Worker {
                         global_ebr_meta->thread_init_ebr_meta(context.coordinator_id, id);
                 }
 
-		uint64_t last_seed = 0;
-
 		ExecutorStatus status;
 
 		while ((status = static_cast<ExecutorStatus>(worker_status.load())) != ExecutorStatus::START) {
@@ -95,119 +106,43 @@ template <class Workload, class Protocol> class Executor : public Worker {
 
 		n_started_workers.fetch_add(1);
 
-                bool retry_transaction = false;
-
 		// auto startTime = std::chrono::steady_clock::now();
 		auto t = workload.next_transaction(context, 0, this->id);
-		auto dummy_transaction = t.release();
+		dummy_transaction = t.release();
 		setupHandlers(*dummy_transaction);
-		do {
-			auto tmp_transaction = transaction.get();
-			bool replace_with_dummy = tmp_transaction == nullptr;
-			if (replace_with_dummy) {
-				// Hack: Make sure transaction is not nullptr
-				transaction.reset(dummy_transaction);
-			}
-			process_request();
-			if (replace_with_dummy) {
-				// swap it back.
-				transaction.reset(tmp_transaction);
-			}
 
-			if (!partitioner->is_backup()) {
-				// backup node stands by for replication
-				last_seed = random.get_seed();
-
-				if (retry_transaction) {
-					transaction->reset();
-				} else {
-					auto partition_id = get_partition_id();
+		if (context.coroutine_num > 1) {
+			run_coroutines();
+		} else {
+			uint64_t last_seed = 0;
+			bool retry_transaction = false;
+
+			do {
+				auto tmp_transaction = transaction.get();
+				bool replace_with_dummy = tmp_transaction == nullptr;
+				if (replace_with_dummy) {
+					// Hack: Make sure transaction is not nullptr
+					transaction.reset(dummy_transaction);
+				}
+				process_request();
+				if (replace_with_dummy) {
+					// swap it back.
+					transaction.release();
+					transaction.reset(tmp_transaction);
+				}
 
-					transaction = workload.next_transaction(context, partition_id, this->id);
-					// startTime = std::chrono::steady_clock::now();
-					setupHandlers(*transaction);
+				if (partition_remapper != nullptr && id == 0) {
+					partition_remapper->run_pending_hand_off();
 				}
 
-                                global_ebr_meta->enter_critical_section();
-				auto result = transaction->execute(id);
-				if (result == TransactionResult::READY_TO_COMMIT) {
-					bool commit;
-					{
-						ScopedTimer t([&, this](uint64_t us) {
-							if (commit) {
-								this->transaction->record_commit_work_time(us);
-							} else {
-								auto ltc = std::chrono::duration_cast<std::chrono::nanoseconds>(
-										   std::chrono::steady_clock::now() - transaction->startTime)
-										   .count();
-								this->transaction->set_stall_time(ltc);
-							}
-						});
-						commit = protocol.commit(*transaction, messages);
-					}
-					auto ltc =
-						std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - transaction->startTime)
-							.count();
-					commit_latency.add(ltc);
-					n_network_size.fetch_add(transaction->network_size);
-					if (commit) {
-                                                // for correctness test
-                                                db.global_total_commit.fetch_add(1);
-
-						n_commit.fetch_add(1);
-						if (transaction->si_in_serializable) {
-							n_si_in_serializable.fetch_add(1);
-						}
-						if (transaction->local_validated) {
-							n_local.fetch_add(1);
-						}
-						retry_transaction = false;
-						auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
-														     transaction->startTime)
-								       .count();
-						percentile.add(latency);
-						if (transaction->is_single_partition() == false) {
-							dist_latency.add(latency);
-						} else {
-							local_latency.add(latency);
-						}
-						record_txn_breakdown_stats(*transaction.get());
-					} else {
-						if (transaction->abort_lock) {
-							n_abort_lock.fetch_add(1);
-						} else {
-							DCHECK(transaction->abort_read_validation);
-							n_abort_read_validation.fetch_add(1);
-						}
-						if (context.sleep_on_retry) {
-							std::this_thread::sleep_for(std::chrono::microseconds(random.uniform_dist(0, context.sleep_time)));
-						}
-						random.set_seed(last_seed);
-						retry_transaction = true;
-					}
-				} else if (result == TransactionResult::ABORT_NORETRY) {
-					protocol.abort(*transaction, messages);
-					n_abort_no_retry.fetch_add(1);
-                                        retry_transaction = false;
-				} else {
-                                        CHECK(result == TransactionResult::ABORT);
-                                        protocol.abort(*transaction, messages);
-                                        if (transaction->abort_lock) {
-                                                n_abort_lock.fetch_add(1);
-                                        } else {
-                                                DCHECK(transaction->abort_read_validation);
-                                                n_abort_read_validation.fetch_add(1);
-                                        }
-                                        if (context.sleep_on_retry) {
-                                                std::this_thread::sleep_for(std::chrono::microseconds(random.uniform_dist(0, context.sleep_time)));
-                                        }
-                                        random.set_seed(last_seed);
-                                        retry_transaction = true;
-                                }
-			}
+				if (!partitioner->is_backup()) {
+					// backup node stands by for replication
+					run_transaction(transaction, retry_transaction, last_seed);
+				}
 
-			status = static_cast<ExecutorStatus>(worker_status.load());
-		} while (status != ExecutorStatus::STOP);
+				status = static_cast<ExecutorStatus>(worker_status.load());
+			} while (status != ExecutorStatus::STOP);
+		}
 
 		n_complete_workers.fetch_add(1);
 
@@ -226,6 +161,277 @@ template <class Workload, class Protocol> class Executor : public Worker {
 		LOG(INFO) << "Executor " << id << " exits.";
 	}
 
+	void run_transaction(std::unique_ptr<TransactionType> &txn, bool &retry_transaction, uint64_t &last_seed)
+	{
+		last_seed = random.get_seed();
+
+		if (retry_transaction) {
+			txn->reset();
+		} else {
+			auto partition_id = get_partition_id();
+
+			txn = workload.next_transaction(context, partition_id, this->id);
+			// startTime = std::chrono::steady_clock::now();
+			setupHandlers(*txn);
+		}
+
+		if (running_slot == 0) {
+			// interleaved transactions enter the critical section together, see run_coroutines()
+			global_ebr_meta->enter_critical_section();
+		}
+		auto result = txn->execute(id);
+		if (result == TransactionResult::READY_TO_COMMIT) {
+			bool commit;
+			{
+				ScopedTimer t([&, this](uint64_t us) {
+					if (commit) {
+						txn->record_commit_work_time(us);
+					} else {
+						auto ltc = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - txn->startTime)
+								   .count();
+						txn->set_stall_time(ltc);
+					}
+				});
+				commit = protocol.commit(*txn, messages);
+			}
+			auto ltc = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - txn->startTime).count();
+			commit_latency.add(ltc);
+			n_network_size.fetch_add(txn->network_size);
+			if (commit) {
+				// for correctness test
+				db.global_total_commit.fetch_add(1);
+
+				n_commit.fetch_add(1);
+				if (txn->si_in_serializable) {
+					n_si_in_serializable.fetch_add(1);
+				}
+				if (txn->local_validated) {
+					n_local.fetch_add(1);
+				}
+				retry_transaction = false;
+				auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - txn->startTime).count();
+				percentile.add(latency);
+				if (txn->is_single_partition() == false) {
+					dist_latency.add(latency);
+				} else {
+					local_latency.add(latency);
+				}
+				record_txn_breakdown_stats(*txn.get());
+				if (partition_remapper != nullptr) {
+					for (auto &key : txn->readSet)
+						partition_remapper->record_load(id, key.get_partition_id(), 1);
+				}
+			} else {
+				if (txn->abort_lock) {
+					n_abort_lock.fetch_add(1);
+				} else {
+					DCHECK(txn->abort_read_validation);
+					n_abort_read_validation.fetch_add(1);
+				}
+				if (context.sleep_on_retry) {
+					back_off();
+				}
+				random.set_seed(last_seed);
+				retry_transaction = true;
+			}
+		} else if (result == TransactionResult::ABORT_NORETRY) {
+			protocol.abort(*txn, messages);
+			n_abort_no_retry.fetch_add(1);
+			retry_transaction = false;
+		} else {
+			CHECK(result == TransactionResult::ABORT);
+			protocol.abort(*txn, messages);
+			if (txn->abort_lock) {
+				n_abort_lock.fetch_add(1);
+			} else {
+				DCHECK(txn->abort_read_validation);
+				n_abort_read_validation.fetch_add(1);
+			}
+			if (context.sleep_on_retry) {
+				back_off();
+			}
+			random.set_seed(last_seed);
+			retry_transaction = true;
+		}
+	}
+
+	void back_off()
+	{
+		auto sleep_time = std::chrono::microseconds(random.uniform_dist(0, context.sleep_time));
+		if (running_slot == 0) {
+			std::this_thread::sleep_for(sleep_time);
+			return;
+		}
+
+		// let the other in-flight transactions use the time instead of sleeping
+		auto wake_up_time = std::chrono::steady_clock::now() + sleep_time;
+		while (std::chrono::steady_clock::now() < wake_up_time) {
+			yield_slot();
+		}
+	}
+
+	/*
+	 * Each slot runs transactions one after another in its own coroutine and
+	 * yields whenever its transaction waits for remote responses, at prefetch
+	 * points on CXL rows, and while it backs off after an abort. Requests
+	 * leave tagged with the slot of the issuing transaction (in the message
+	 * header's transaction id) and the remote host echoes the tag, with
+	 * response_tag set, on the response, so that process_request() hands the
+	 * response to that transaction rather than the running one.
+	 */
+	void run_coroutines()
+	{
+		slots.resize(context.coroutine_num);
+		for (auto i = 0u; i < slots.size(); i++) {
+			slots[i].coroutine = std::make_unique<Coroutine>([this, i]() { run_slot(slots[i]); });
+			slots[i].seed = RandomType(reinterpret_cast<uint64_t>(&slots[i])).get_seed();
+		}
+
+		bool quiescing = false;
+		for (;;) {
+			process_request();
+
+			if (partition_remapper != nullptr && id == 0) {
+				partition_remapper->run_pending_hand_off();
+			}
+
+			if (static_cast<ExecutorStatus>(worker_status.load()) == ExecutorStatus::STOP) {
+				// finish the in-flight transactions, but start no new ones
+				stopping = true;
+			}
+
+			/*
+			 * A thread announces one EBR epoch for all its transactions, so it can
+			 * only move to a new epoch while none of them holds references. Slots
+			 * stop starting transactions until the in-flight ones are done.
+			 */
+			if (quiescing == false && global_ebr_meta->should_enter_critical_section()) {
+				quiescing = true;
+			}
+			if (quiescing && std::none_of(slots.begin(), slots.end(), [](const TransactionSlot &slot) { return slot.in_transaction; })) {
+				global_ebr_meta->enter_critical_section();
+				quiescing = false;
+			}
+
+			bool all_finished = true;
+			for (auto i = 0u; i < slots.size(); i++) {
+				if (slots[i].coroutine->is_finished()) {
+					continue;
+				}
+				all_finished = false;
+				if (quiescing && slots[i].in_transaction == false) {
+					continue;
+				}
+				resume_slot(i);
+			}
+			if (all_finished) {
+				break;
+			}
+		}
+
+		slots.clear();
+	}
+
+	void run_slot(TransactionSlot &slot)
+	{
+		while (stopping == false) {
+			if (partitioner->is_backup()) {
+				// backup node stands by for replication
+				yield_slot();
+				continue;
+			}
+
+			slot.in_transaction = true;
+			run_transaction(slot.transaction, slot.retry_transaction, slot.last_seed);
+			slot.in_transaction = false;
+			yield_slot();
+		}
+	}
+
+	void resume_slot(std::size_t i)
+	{
+		// messages under construction belong to whoever is running
+		flush_messages();
+		running_slot = i + 1;
+		tag_messages();
+
+		/*
+		 * Each slot draws from its own stream, so that rewinding the seed to
+		 * retry an aborted transaction replays only that transaction's draws.
+		 * The workload and the transactions hold references to 'random'.
+		 */
+		uint64_t executor_seed = random.get_seed();
+		random.set_seed(slots[i].seed);
+		slots[i].coroutine->resume();
+		slots[i].seed = random.get_seed();
+		random.set_seed(executor_seed);
+
+		flush_messages();
+		running_slot = 0;
+		tag_messages();
+	}
+
+	void yield_slot()
+	{
+		DCHECK(running_slot != 0);
+		// requests must leave before another transaction appends to the messages
+		flush_messages();
+		slots[running_slot - 1].coroutine->yield();
+	}
+
+	// called by transactions that wait for remote responses
+	std::size_t process_request_and_yield()
+	{
+		auto size = process_request();
+		if (running_slot != 0) {
+			yield_slot();
+		}
+		return size;
+	}
+
+	// called before touching a row in CXL memory
+	void prefetch_and_yield(const void *addr)
+	{
+		if (running_slot == 0) {
+			return;
+		}
+		__builtin_prefetch(addr);
+		yield_slot();
+	}
+
+	void tag_messages()
+	{
+		for (auto i = 0u; i < messages.size(); i++) {
+			DCHECK(messages[i]->get_message_count() == 0);
+			messages[i]->set_transaction_id(running_slot);
+		}
+	}
+
+	// returns the transaction the pieces of an incoming message are handled for
+	TransactionType *route_message(Message &message)
+	{
+		auto tag = message.get_transaction_id();
+		if (tag & response_tag) {
+			auto slot = tag & ~response_tag;
+			DCHECK(slot >= 1 && slot <= slots.size());
+			return slots[slot - 1].transaction.get();
+		}
+
+		if (tag != 0) {
+			// echo the tag of the requesting transaction on the responses
+			auto &response = messages[message.get_source_node_id()];
+			if (response->get_message_count() != 0) {
+				flush_messages();
+			}
+			response->set_transaction_id(tag | response_tag);
+		}
+
+		if (running_slot != 0 && slots[running_slot - 1].transaction != nullptr) {
+			return slots[running_slot - 1].transaction.get();
+		}
+		return dummy_transaction;
+	}
+
 	void onExit() override
 	{
 		LOG(INFO) << "Worker " << id << " latency: " << percentile.nth(50) << " us (50%) " << percentile.nth(75) << " us (75%) " << percentile.nth(95)
@@ -272,6 +478,11 @@ template <class Workload, class Protocol> class Executor : public Worker {
 	{
 		std::size_t partition_id;
 
+		if (partition_remapper != nullptr) {
+			// partitions handed over to this host are kept in its local DRAM elsewhere
+			return partition_remapper->pick_partition(random);
+		}
+
 		if (context.partitioner == "pb") {
 			partition_id = random.uniform_dist(0, context.partition_num - 1);
 		} else {
@@ -292,6 +503,11 @@ template <class Workload, class Protocol> class Executor : public Worker {
 		CHECK(false);
 	}
 
+	const Percentile<int64_t> *get_latency_percentile() const override
+	{
+		return &percentile;
+	}
+
 	Message *pop_message() override
 	{
 		if (out_queue.empty())
@@ -299,14 +515,13 @@ template <class Workload, class Protocol> class Executor : public Worker {
 
 		Message *message = out_queue.front();
 
-		// if (delay->delay_enabled()) {
-		//   auto now = std::chrono::steady_clock::now();
-		//   if (std::chrono::duration_cast<std::chrono::microseconds>(now -
-		//                                                             message->time)
-		//           .count() < delay->message_delay()) {
-		//     return nullptr;
-		//   }
-		// }
+		// emulated cross-host latency (--delay), e.g., for pods emulated on one machine
+		if (delay->delay_enabled() && message->get_dest_node_id() != coordinator_id) {
+			auto now = std::chrono::steady_clock::now();
+			if (std::chrono::duration_cast<std::chrono::microseconds>(now - message->time).count() < delay->message_delay()) {
+				return nullptr;
+			}
+		}
 
 		bool ok = out_queue.pop();
 		CHECK(ok);
@@ -324,13 +539,18 @@ template <class Workload, class Protocol> class Executor : public Worker {
 			bool ok = in_queue.pop();
 			CHECK(ok);
 
+			TransactionType *txn = transaction.get();
+			if (context.coroutine_num > 1) {
+				txn = route_message(*message);
+			}
+
 			for (auto it = message->begin(); it != message->end(); it++) {
 				MessagePiece messagePiece = *it;
 				auto type = messagePiece.get_message_type();
 				DCHECK(type < messageHandlers.size());
 				ITable *table = db.find_table(messagePiece.get_table_id(), messagePiece.get_partition_id());
 
-				messageHandlers[type](messagePiece, *messages[message->get_source_node_id()], *table, transaction.get());
+				messageHandlers[type](messagePiece, *messages[message->get_source_node_id()], *table, txn);
 
 				message_stats[type]++;
 				message_sizes[type] += messagePiece.get_message_length();
@@ -338,6 +558,9 @@ template <class Workload, class Protocol> class Executor : public Worker {
 
 			size += message->get_message_count();
 			flush_messages();
+			if (context.coroutine_num > 1) {
+				tag_messages();
+			}
 		}
 		return size;
 	}
@@ -395,6 +618,12 @@ template <class Workload, class Protocol> class Executor : public Worker {
 		dist_txn_remote_work_time_pct;
 	std::unique_ptr<TransactionType> transaction;
 	std::unique_ptr<TransactionType> transaction_replica;
+	TransactionType *dummy_transaction = nullptr;
+
+	static constexpr uint64_t response_tag = 1ull << 63;
+	std::vector<TransactionSlot> slots;
+	std::size_t running_slot = 0; // 1 + index of the running slot, 0 outside of the slots
+	bool stopping = false;
 	std::vector<std::unique_ptr<Message> > messages;
 	std::vector<std::function<void(MessagePiece, Message &, ITable &, TransactionType *)> > messageHandlers;
 	std::vector<std::size_t> message_stats, message_sizes;
@@ -41,10 +41,13 @@ DEFINE_bool(enable_hstore_master, true, "enable hstore master for lock schedulin
 DEFINE_bool(cpu_affinity, false, "pinning each thread to a separate core");
 DEFINE_bool(hstore_command_logging, true, "configure command logging mode for hstore");
 DEFINE_int32(cross_txn_workers, 0, "number of workers generating cross-partition transactions");
-DEFINE_int32(cpu_core_id, 0, "cpu core id");
+DEFINE_int32(cpu_core_id, 0, "first cpu core of this host");
+DEFINE_int32(cpu_core_num, 0, "# cpu cores of this host starting at cpu_core_id (0 = no limit)");
 DEFINE_int32(persist_latency, 110, "emulated persist latency");
 DEFINE_int32(wal_group_commit_time, 10, "wal group commit time in us");
 DEFINE_int32(wal_group_commit_size, 7, "wal group commit batch size");
+DEFINE_int32(wal_stream_flushers, 0, "number of threads flushing per-worker wal streams, TwoPLPasha only (0 logs to a single group commit file)");
+DEFINE_bool(wal_recovery, false, "replay per-worker wal streams into the tables before running, TwoPLPasha only");
 DEFINE_bool(aria_read_only, true, "aria read only optimization");
 DEFINE_bool(aria_reordering, true, "aria reordering optimization");
 DEFINE_bool(aria_si, false, "aria snapshot isolation");
@@ -66,15 +69,19 @@ enum LotusCheckpointScheme {
 };
 DEFINE_int32(lotus_checkpoint, 0, "Lotus COW checkpoint scheme");
 DEFINE_string(lotus_checkpoint_location, "", "Path to store checkpoint files");
+DEFINE_string(table_checkpoint_path, "", "directory of table snapshots, restored on start if complete and written after loading otherwise");
+DEFINE_int32(table_checkpoint_threads, 0, "threads saving or restoring table snapshots (0 = # worker threads)");
 DEFINE_double(stragglers_zipf_factor, 0, "straggler zipfian factor");
 DEFINE_int32(sender_group_nop_count, 40000, "# nop insts to executes during TCP sender message grouping");
 DEFINE_int32(granule_count, 1, "# granules in a partition");
+DEFINE_string(hash_index, "Striped", "DRAM hash index of TableHashMap tables (Striped, OpenAddressing)");
 DEFINE_bool(hstore_active_active, false, "H-Store style active-active replication");
 
 DEFINE_bool(use_cxl_transport, false, "use CXL transport instead of network transport");
 DEFINE_bool(use_output_thread, false, "do you want an output thread?");
 DEFINE_uint64(cxl_trans_entry_struct_size, 8192, "size of enrty in a MPSC ringbuffer");
 DEFINE_uint64(cxl_trans_entry_num, 4096, "number of entries per MPSC ringbuffer");
+DEFINE_bool(cxl_trans_var_length, false, "use variable-length batching CXL ringbuffers (entry_struct_size * entry_num bytes each)");
 // Default to ivshmem so shared-memory mode works out-of-the-box
 DEFINE_string(cxl_backend, "ivshmem", "cxlalloc backend (mmap, shm, ivshmem, dax)");
 DEFINE_string(cxl_memory_resource, "SS", "file or device path backing the CXL heap");
@@ -84,17 +91,31 @@ DEFINE_string(migration_policy, "Eagerly", "Pasha data migration policy");
 DEFINE_string(when_to_move_out, "Reactive", "When to move data out");
 DEFINE_uint64(hw_cc_budget, 1024 * 1024 * 200, "budget for the hardware cache-coherent region");
 
+DEFINE_bool(btree_prefetch, false, "prefetch CXL B+-tree nodes during descent");
+
 DEFINE_bool(enable_phantom_detection, true, "TwoPLPasha enables phantom detection (next-key locking)");
 DEFINE_bool(model_cxl_search_overhead, false, "Model the overhead of local operations always searching through the CXL indexes");
 
 DEFINE_bool(enable_scc, true, "enable software cache-coherence");
 DEFINE_string(scc_mechanism, "NoOP", "Pasha software cache-coherence mechanism");
+DEFINE_int32(scc_flush_cost, 0, "emulated cost in ns of flushing or writing back one cache line");
 
 DEFINE_int32(time_to_run, 30, "time to run");
 DEFINE_int32(time_to_warmup, 10, "time to warm up");
 
 DEFINE_string(pre_migrate, "None", "what tuples to pre-migrate?");
 
+DEFINE_int32(repartition_interval, 0, "seconds between partition ownership rebalancing rounds (0 disables)");
+DEFINE_double(repartition_threshold, 1.25, "busiest/idlest host load ratio that triggers a partition hand-off");
+
+DEFINE_int32(coroutine_num, 1, "in-flight transactions per worker (TwoPLPasha and SundialPasha)");
+
+DEFINE_bool(mvcc_snapshot_reads, false, "TwoPLPasha keeps versions of migrated rows for lock-free snapshot reads");
+
+DEFINE_string(lock_wait_policy, "NoWait", "TwoPLPasha lock conflicts: NoWait or WaitDie (queue behind younger holders)");
+DEFINE_int32(lock_wait_timeout_us, 10000, "TwoPLPasha aborts a transaction waiting for a lock longer than this");
+DEFINE_bool(early_lock_release, false, "TwoPLPasha releases read locks at the lock point and write locks right after their write-back");
+
 #define SETUP_CONTEXT(context)                                                                  \
 	boost::algorithm::split(context.peers, FLAGS_servers, boost::is_any_of(";"));           \
 	context.coordinator_num = context.peers.size();                                         \
@@ -129,11 +150,14 @@ DEFINE_string(pre_migrate, "None", "what tuples to pre-migrate?");
 	context.cpu_affinity = FLAGS_cpu_affinity;                                              \
 	context.enable_hstore_master = FLAGS_enable_hstore_master;                              \
 	context.cpu_core_id = FLAGS_cpu_core_id;                                                \
+	context.cpu_core_num = FLAGS_cpu_core_num;                                              \
 	context.cross_txn_workers = FLAGS_cross_txn_workers;                                    \
 	context.emulated_persist_latency = FLAGS_persist_latency;                               \
 	context.wal_group_commit_time = FLAGS_wal_group_commit_time;                            \
 	context.hstore_command_logging = FLAGS_hstore_command_logging;                          \
 	context.group_commit_batch_size = FLAGS_wal_group_commit_size;                          \
+	context.wal_stream_flushers = FLAGS_wal_stream_flushers;                                \
+	context.wal_recovery = FLAGS_wal_recovery;                                              \
 	context.aria_read_only_optmization = FLAGS_aria_read_only;                              \
 	context.aria_reordering_optmization = FLAGS_aria_reordering;                            \
 	context.aria_snapshot_isolation = FLAGS_aria_si;                                        \
@@ -143,14 +167,19 @@ DEFINE_string(pre_migrate, "None", "what tuples to pre-migrate?");
 	context.straggler_zipf_factor = FLAGS_stragglers_zipf_factor;                           \
 	context.straggler_num_txn_len = FLAGS_stragglers_num_txn_len;                           \
 	context.granules_per_partition = FLAGS_granule_count;                                   \
+	context.hash_index = FLAGS_hash_index;                                                  \
 	context.lotus_async_repl = FLAGS_lotus_async_repl;                                      \
 	context.lotus_checkpoint = FLAGS_lotus_checkpoint;                                      \
 	context.lotus_checkpoint_location = FLAGS_lotus_checkpoint_location;                    \
+	context.table_checkpoint_path = FLAGS_table_checkpoint_path;                            \
+	CHECK_GE(FLAGS_table_checkpoint_threads, 0);                                            \
+	context.table_checkpoint_threads = FLAGS_table_checkpoint_threads;                      \
 	context.hstore_active_active = FLAGS_hstore_active_active;                              \
         context.use_cxl_transport = FLAGS_use_cxl_transport;                                    \
         context.use_output_thread = FLAGS_use_output_thread;                                    \
         context.cxl_trans_entry_struct_size = FLAGS_cxl_trans_entry_struct_size;                \
         context.cxl_trans_entry_num = FLAGS_cxl_trans_entry_num;                                \
+        context.cxl_trans_var_length = FLAGS_cxl_trans_var_length;                              \
         context.cxl_backend = FLAGS_cxl_backend;                                                \
         context.cxl_memory_resource = FLAGS_cxl_memory_resource;                                \
         context.enable_migration_optimization = FLAGS_enable_migration_optimization;            \
@@ -158,10 +187,19 @@ DEFINE_string(pre_migrate, "None", "what tuples to pre-migrate?");
         context.when_to_move_out = FLAGS_when_to_move_out;                                      \
         context.hw_cc_budget = FLAGS_hw_cc_budget;                                              \
         context.model_cxl_search_overhead = FLAGS_model_cxl_search_overhead;                    \
+        context.btree_prefetch = FLAGS_btree_prefetch;                                          \
         context.enable_phantom_detection = FLAGS_enable_phantom_detection;                      \
         context.enable_scc = FLAGS_enable_scc;                                                  \
         context.scc_mechanism = FLAGS_scc_mechanism;                                            \
+        context.scc_flush_cost = FLAGS_scc_flush_cost;                                          \
         context.time_to_run = FLAGS_time_to_run;                                                \
         context.time_to_warmup = FLAGS_time_to_warmup;                                          \
         context.pre_migrate = FLAGS_pre_migrate;                                                \
+        context.repartition_interval = FLAGS_repartition_interval;                              \
+        context.repartition_threshold = FLAGS_repartition_threshold;                            \
+        context.coroutine_num = FLAGS_coroutine_num;                                            \
+        context.mvcc_snapshot_reads = FLAGS_mvcc_snapshot_reads;                                \
+        context.lock_wait_policy = FLAGS_lock_wait_policy;                                      \
+        context.lock_wait_timeout_us = FLAGS_lock_wait_timeout_us;                              \
+        context.early_lock_release = FLAGS_early_lock_release;                                  \
 	context.set_star_partitioner();
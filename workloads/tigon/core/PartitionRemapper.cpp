@@ -0,0 +1,8 @@
+#include "core/PartitionRemapper.h"
+
+namespace star
+{
+
+PartitionRemapper *partition_remapper = nullptr;
+
+}
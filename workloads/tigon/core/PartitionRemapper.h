@@ -0,0 +1,227 @@
+//
+// Skew-aware partition ownership remapping
+//
+
+#pragma once
+
+#include "common/Random.h"
+#include "core/Partitioner.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <glog/logging.h>
+
+namespace star
+{
+
+/*
+ * The Partitioner fixes which host keeps a partition in its local DRAM (its
+ * data home); the remapper decides which host generates the transactions of a
+ * partition (its owner). Both start out identical.
+ *
+ * Executors record how many rows of each partition their committed
+ * transactions accessed. Every repartition interval each coordinator reports
+ * the per-partition load of that interval to coordinator 0, which adds up the
+ * load of the partitions each host owns. If the busiest host has more than
+ * 'threshold' times the load of the idlest one, the busiest host is asked to
+ * hand over the partition whose load is closest to half the gap:
+ *
+ * 1. coordinator 0 sends PARTITION_HANDOFF to the current owner,
+ * 2. the owner stops generating transactions for it and one of its workers
+ *    moves all of the partition's rows into CXL with the Pasha move-in path,
+ * 3. the owner broadcasts PARTITION_OWNER and every host updates its map.
+ *
+ * After the hand-off the new owner and every other host reach the partition's
+ * rows directly in CXL, without migration requests to the data home; nothing
+ * is copied between hosts. Only one hand-off is in flight at a time, and each
+ * round is tagged with an epoch so that late load reports are dropped.
+ */
+class PartitionRemapper {
+    public:
+	PartitionRemapper(std::size_t coordinator_id, std::size_t coordinator_num, std::size_t partition_num, std::size_t worker_num,
+			  const Partitioner &partitioner, double threshold)
+		: coordinator_id(coordinator_id)
+		, coordinator_num(coordinator_num)
+		, partition_num(partition_num)
+		, threshold(threshold)
+		, owners(new std::atomic<uint32_t>[partition_num])
+		, owned(new std::atomic<uint32_t>[partition_num])
+		, last_load(partition_num, 0)
+	{
+		for (auto i = 0u; i < partition_num; i++) {
+			owners[i].store(partitioner.master_coordinator(i), std::memory_order_relaxed);
+			if (owners[i].load(std::memory_order_relaxed) == coordinator_id)
+				owned[owned_num++].store(i, std::memory_order_relaxed);
+		}
+		CHECK(owned_num.load() > 0);
+
+		for (auto i = 0u; i < worker_num; i++) {
+			worker_load.emplace_back(new std::atomic<uint64_t>[partition_num]());
+		}
+	}
+
+	std::size_t owner(std::size_t partition_id) const
+	{
+		return owners[partition_id].load(std::memory_order_relaxed);
+	}
+
+	/*
+	 * Picks the home partition of the next transaction among the partitions
+	 * this host owns. The set may change concurrently; a reader racing with a
+	 * hand-off may still pick the old partition once, which is harmless since
+	 * the data path does not depend on ownership.
+	 */
+	std::size_t pick_partition(Random &random) const
+	{
+		uint32_t n = owned_num.load(std::memory_order_acquire);
+		DCHECK(n > 0);
+		return owned[random.uniform_dist(0, n - 1)].load(std::memory_order_relaxed);
+	}
+
+	// called by worker 'worker_id' only
+	void record_load(std::size_t worker_id, std::size_t partition_id, uint64_t rows)
+	{
+		auto &counter = worker_load[worker_id][partition_id];
+		counter.store(counter.load(std::memory_order_relaxed) + rows, std::memory_order_relaxed);
+	}
+
+	// per-partition load recorded on this host since the previous call
+	std::vector<uint64_t> collect_load()
+	{
+		std::vector<uint64_t> load(partition_num, 0);
+
+		for (auto &counters : worker_load) {
+			for (auto i = 0u; i < partition_num; i++)
+				load[i] += counters[i].load(std::memory_order_relaxed);
+		}
+		for (auto i = 0u; i < partition_num; i++) {
+			uint64_t total = load[i];
+			load[i] -= last_load[i];
+			last_load[i] = total;
+		}
+		return load;
+	}
+
+	struct Move {
+		int64_t partition_id{ -1 };
+		uint32_t from{ 0 }, to{ 0 };
+	};
+
+	// picks at most one hand-off that evens out the owners' load
+	Move plan(const std::vector<uint64_t> &load) const
+	{
+		std::vector<uint64_t> host_load(coordinator_num, 0);
+		std::vector<uint32_t> host_partitions(coordinator_num, 0);
+		Move move;
+
+		for (auto i = 0u; i < partition_num; i++) {
+			host_load[owner(i)] += load[i];
+			host_partitions[owner(i)]++;
+		}
+
+		uint32_t busiest = 0, idlest = 0;
+		for (auto i = 1u; i < coordinator_num; i++) {
+			if (host_load[i] > host_load[busiest])
+				busiest = i;
+			if (host_load[i] < host_load[idlest])
+				idlest = i;
+		}
+
+		// a host keeps at least one partition to generate transactions for
+		if (busiest == idlest || host_partitions[busiest] <= 1 || host_load[busiest] <= threshold * host_load[idlest])
+			return move;
+
+		uint64_t gap = host_load[busiest] - host_load[idlest];
+		uint64_t best_distance = 0;
+		for (auto i = 0u; i < partition_num; i++) {
+			// moving a partition heavier than the gap would only swap the roles
+			if (owner(i) != busiest || load[i] == 0 || load[i] >= gap)
+				continue;
+			uint64_t distance = load[i] > gap / 2 ? load[i] - gap / 2 : gap / 2 - load[i];
+			if (move.partition_id < 0 || distance < best_distance) {
+				move.partition_id = i;
+				best_distance = distance;
+			}
+		}
+		move.from = busiest;
+		move.to = idlest;
+		return move;
+	}
+
+	/*
+	 * Run by the coordinator of the current owner: stops generating
+	 * transactions for the partition and asks worker 0 to move its rows into
+	 * CXL (a worker, because moving rows in may evict others through EBR).
+	 */
+	void hand_off(std::size_t partition_id)
+	{
+		DCHECK(owner(partition_id) == coordinator_id);
+		uint32_t n = owned_num.load(std::memory_order_relaxed);
+		for (auto i = 0u; i < n; i++) {
+			if (owned[i].load(std::memory_order_relaxed) == partition_id) {
+				owned[i].store(owned[n - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+				owned_num.store(n - 1, std::memory_order_release);
+				break;
+			}
+		}
+		pending_hand_off.store(partition_id, std::memory_order_release);
+	}
+
+	// run by worker 0 between transactions
+	void run_pending_hand_off()
+	{
+		int64_t partition_id = pending_hand_off.load(std::memory_order_acquire);
+		if (partition_id < 0)
+			return;
+
+		if (move_partition_into_cxl)
+			move_partition_into_cxl(partition_id);
+		pending_hand_off.store(-1, std::memory_order_relaxed);
+		handed_off.store(partition_id, std::memory_order_release);
+	}
+
+	// returns the partition whose rows are all in CXL now, or -1
+	int64_t take_handed_off()
+	{
+		return handed_off.exchange(-1, std::memory_order_acq_rel);
+	}
+
+	void set_owner(uint64_t epoch, std::size_t partition_id, std::size_t new_owner)
+	{
+		owners[partition_id].store(new_owner, std::memory_order_relaxed);
+		if (new_owner == coordinator_id) {
+			uint32_t n = owned_num.load(std::memory_order_relaxed);
+			owned[n].store(partition_id, std::memory_order_relaxed);
+			owned_num.store(n + 1, std::memory_order_release);
+		}
+		LOG(INFO) << "Coordinator " << coordinator_id << " epoch " << epoch << ": partition " << partition_id << " is owned by coordinator "
+			  << new_owner;
+	}
+
+	// moves every row of a partition into CXL; set by the coordinator
+	std::function<void(std::size_t)> move_partition_into_cxl;
+
+    private:
+	std::size_t coordinator_id;
+	std::size_t coordinator_num;
+	std::size_t partition_num;
+	double threshold;
+
+	std::unique_ptr<std::atomic<uint32_t>[]> owners;
+
+	// partitions owned by this host; only the coordinator thread changes them
+	std::unique_ptr<std::atomic<uint32_t>[]> owned;
+	std::atomic<uint32_t> owned_num{ 0 };
+
+	std::atomic<int64_t> pending_hand_off{ -1 }, handed_off{ -1 };
+
+	// per-worker, per-partition row access counters (single writer each)
+	std::vector<std::unique_ptr<std::atomic<uint64_t>[]> > worker_load;
+	std::vector<uint64_t> last_load;
+};
+
+extern PartitionRemapper *partition_remapper;
+
+} // namespace star
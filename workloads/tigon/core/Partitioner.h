@@ -8,6 +8,7 @@
 #include <memory>
 #include <numeric>
 #include <string>
+#include <vector>
 #define ALL_GRANULES ((1 << 12) - 1)
 namespace star
 {
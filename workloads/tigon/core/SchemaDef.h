@@ -86,6 +86,11 @@
                                 else                                                                       \
                                         return -1;                                                         \
                         }                                                                                  \
+                        /* key prefix for the CXL B+-tree node search (exact: keys order by it) */        \
+                        uint64_t prefix(const key &k) const                                                \
+                        {                                                                                  \
+                                return k.get_plain_key();                                                  \
+                        }                                                                                  \
                 };                                                                                         \
                 struct ValueComparator {                                                                   \
                         int operator()(const value &a, const value &b) const                               \
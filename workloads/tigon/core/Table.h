@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <algorithm>
+#include <numeric>
 #include <thread>
+#include <vector>
 #include "benchmark/tpcc/Schema.h"
 #include "common/ClassOf.h"
 #include "common/Encoder.h"
 #include "common/HashMap.h"
+#include "common/OpenHashMap.h"
 #include "common/StringPiece.h"
 #include "common/btree_olc/BTreeOLC.h"
 
@@ -68,6 +72,10 @@ class ITable {
 
 	virtual bool insert(const void *key, const void *value, bool is_placeholder = false) = 0;
 
+        // inserts row_count rows at once, e.g., when loading a partition. row_generator(i, key, value) fills in row i and is
+        // called for i = 0, 1, ... in order; ordered tables build their index bottom-up, cheapest when the keys come out sorted
+        virtual bool bulk_insert(std::size_t row_count, std::function<void(std::size_t, void *, void *)> row_generator) = 0;
+
         virtual bool insert_lock_next_key(const void *key, const void *value, std::function<bool(const void *, MetaDataType *, void *)> next_key_processor, bool is_placeholder = false) = 0;
 
         virtual bool insert_and_process_adjacent_tuples(const void *key, const void *value,
@@ -131,6 +139,11 @@ class MetaInitFuncNothing {
 	{
 		return 0;
 	}
+
+	void batch(uint64_t *metas, std::size_t count, bool is_tuple_valid = true)
+	{
+		std::fill(metas, metas + count, 0);
+	}
 };
 
 extern uint64_t SundialMetadataInit(bool is_tuple_valid);
@@ -140,15 +153,27 @@ class MetaInitFuncSundial {
 	{
 		return SundialMetadataInit(is_tuple_valid);
 	}
+
+	void batch(uint64_t *metas, std::size_t count, bool is_tuple_valid = true)
+	{
+		for (std::size_t i = 0; i < count; i++)
+			metas[i] = SundialMetadataInit(is_tuple_valid);
+	}
 };
 
 extern uint64_t SundialPashaMetadataLocalInit(bool is_tuple_valid);
+extern void SundialPashaMetadataLocalInitBatch(uint64_t *metas, std::size_t count, bool is_tuple_valid);
 class MetaInitFuncSundialPasha {
     public:
 	uint64_t operator()(bool is_tuple_valid = true)
 	{
 		return SundialPashaMetadataLocalInit(is_tuple_valid);
 	}
+
+	void batch(uint64_t *metas, std::size_t count, bool is_tuple_valid = true)
+	{
+		SundialPashaMetadataLocalInitBatch(metas, count, is_tuple_valid);
+	}
 };
 
 extern uint64_t TwoPLMetadataInit(bool is_tuple_valid);
@@ -158,18 +183,36 @@ class MetaInitFuncTwoPL {
 	{
 		return TwoPLMetadataInit(is_tuple_valid);
 	}
+
+	void batch(uint64_t *metas, std::size_t count, bool is_tuple_valid = true)
+	{
+		for (std::size_t i = 0; i < count; i++)
+			metas[i] = TwoPLMetadataInit(is_tuple_valid);
+	}
 };
 
 extern uint64_t TwoPLPashaMetadataLocalInit(bool is_tuple_valid);
+extern void TwoPLPashaMetadataLocalInitBatch(uint64_t *metas, std::size_t count, bool is_tuple_valid);
 class MetaInitFuncTwoPLPasha {
     public:
 	uint64_t operator()(bool is_tuple_valid = true)
 	{
 		return TwoPLPashaMetadataLocalInit(is_tuple_valid);
 	}
+
+	void batch(uint64_t *metas, std::size_t count, bool is_tuple_valid = true)
+	{
+		TwoPLPashaMetadataLocalInitBatch(metas, count, is_tuple_valid);
+	}
 };
 
-template <std::size_t N, class KeyType, class ValueType, class KeyComparator, class ValueComparator, class MetaInitFunc = MetaInitFuncNothing> class TableHashMap : public ITable {
+/*
+ * MapType is the DRAM index: HashMap (striped std::unordered_map) or
+ * OpenHashMap (open addressing with lock-free reads), see make_hash_table().
+ */
+template <std::size_t N, class KeyType, class ValueType, class KeyComparator, class ValueComparator, class MetaInitFunc = MetaInitFuncNothing,
+          template <std::size_t, class, class> class MapType = HashMap>
+class TableHashMap : public ITable {
     public:
 	using MetaDataType = std::atomic<uint64_t>;
 
@@ -248,6 +291,27 @@ template <std::size_t N, class KeyType, class ValueType, class KeyComparator, cl
                 return true;
 	}
 
+        bool bulk_insert(std::size_t row_count, std::function<void(std::size_t, void *, void *)> row_generator) override
+        {
+                tid_check();
+                std::vector<uint64_t> metas(row_count);
+                MetaInitFunc().batch(metas.data(), row_count);
+
+                // size the index once instead of rehashing while it fills up
+                map_.reserve(map_.size() + row_count);
+                for (std::size_t i = 0; i < row_count; i++) {
+                        KeyType k;
+                        ValueType v;
+                        row_generator(i, &k, &v);
+                        DCHECK(map_.contains(k) == false);
+                        auto &row = map_[k];
+                        std::get<0>(row).store(metas[i]);
+                        std::get<1>(row) = v;
+                }
+
+                return true;
+        }
+
         bool insert_lock_next_key(const void *key, const void *value, std::function<bool(const void *, MetaDataType *, void *)> next_key_processor, bool is_placeholder = false) override
         {
                 CHECK(0);
@@ -359,12 +423,32 @@ template <std::size_t N, class KeyType, class ValueType, class KeyComparator, cl
                 map_.iterate_non_const(processor, []() {});
         }
 
+        // there is no shadow copy: rows are updated in place, so the dump is consistent only while no transaction runs
+	void dump_copy(std::function<void(const void *, const void *)> dump_processor, std::function<void()> unlock_processor) override
+	{
+		auto processor = [&](const KeyType &key, const std::tuple<MetaDataType, ValueType> &row) {
+			dump_processor((const void *)&key, (const void *)&std::get<1>(row));
+		};
+		map_.iterate(processor, unlock_processor);
+	}
+
     private:
-	HashMap<N, KeyType, std::tuple<MetaDataType, ValueType> > map_;
+	MapType<N, KeyType, std::tuple<MetaDataType, ValueType> > map_;
 	std::size_t tableID_;
 	std::size_t partitionID_;
 };
 
+// creates a hash table whose index is chosen by 'hash_index' ("Striped" or "OpenAddressing")
+template <std::size_t N, class KeyType, class ValueType, class KeyComparator, class ValueComparator, class MetaInitFunc = MetaInitFuncNothing>
+std::unique_ptr<ITable> make_hash_table(const std::string &hash_index, std::size_t tableID, std::size_t partitionID)
+{
+        if (hash_index == "OpenAddressing")
+                return std::make_unique<TableHashMap<N, KeyType, ValueType, KeyComparator, ValueComparator, MetaInitFunc, OpenHashMap> >(tableID, partitionID);
+
+        CHECK(hash_index == "Striped") << "unknown hash index " << hash_index;
+        return std::make_unique<TableHashMap<N, KeyType, ValueType, KeyComparator, ValueComparator, MetaInitFunc, HashMap> >(tableID, partitionID);
+}
+
 template <class KeyType, class ValueType, class KeyComparator, class ValueComparator, class MetaInitFunc = MetaInitFuncNothing> class TableBTreeOLC : public ITable {
     public:
         using MetaDataType = std::atomic<uint64_t>;
@@ -538,6 +622,60 @@ template <class KeyType, class ValueType, class KeyComparator, class ValueCompar
 		return success;
 	}
 
+        bool bulk_insert(std::size_t row_count, std::function<void(std::size_t, void *, void *)> row_generator) override
+        {
+                tid_check();
+
+                // rows are generated right into one array, as they never move or get freed
+                ValueStruct *rows = new ValueStruct[row_count];
+                CHECK(rows != nullptr);
+                std::vector<uint64_t> metas(row_count);
+                MetaInitFunc().batch(metas.data(), row_count);
+
+                std::vector<KeyType> keys(row_count);
+                bool is_sorted = true;
+                for (std::size_t i = 0; i < row_count; i++) {
+                        row_generator(i, &keys[i], &rows[i].data);
+                        rows[i].meta = metas[i];
+                        if (i > 0 && KeyComparator()(keys[i - 1], keys[i]) >= 0)
+                                is_sorted = false;
+                }
+
+                std::vector<BTreeOLCValue> values(row_count);
+                for (std::size_t i = 0; i < row_count; i++) {
+                        values[i].row = &rows[i];
+                }
+
+                bool is_unique = true;
+                if (is_sorted == false) {
+                        std::vector<std::size_t> order(row_count);
+                        std::iota(order.begin(), order.end(), 0);
+                        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return KeyComparator()(keys[a], keys[b]) < 0; });
+
+                        std::vector<KeyType> sorted_keys(row_count);
+                        std::vector<BTreeOLCValue> sorted_values(row_count);
+                        for (std::size_t i = 0; i < row_count; i++) {
+                                sorted_keys[i] = keys[order[i]];
+                                sorted_values[i].row = &rows[order[i]];
+                                if (i > 0 && KeyComparator()(sorted_keys[i - 1], sorted_keys[i]) == 0)
+                                        is_unique = false;
+                        }
+                        keys.swap(sorted_keys);
+                        values.swap(sorted_values);
+                }
+
+                if (is_unique == true && btree.bulkLoad(keys.data(), values.data(), row_count) == true) {
+                        return true;
+                }
+
+                // the table is not empty or has duplicate keys
+                bool success = true;
+                for (std::size_t i = 0; i < row_count; i++) {
+                        success = btree.insert(keys[i], values[i]) && success;
+                }
+                return success;
+        }
+
         // used by TwoPL
         bool insert_lock_next_key(const void *key, const void *value, std::function<bool(const void *, MetaDataType *, void *)> next_key_processor, bool is_placeholder = false) override
 	{
@@ -778,6 +916,20 @@ template <class KeyType, class ValueType, class KeyComparator, class ValueCompar
                 btree.scanForUpdateNoContention(start_key, processor);
         }
 
+        // same as TableHashMap: consistent only while no transaction runs; rows come out in key order
+	void dump_copy(std::function<void(const void *, const void *)> dump_processor, std::function<void()> unlock_processor) override
+	{
+                auto processor = [&](const KeyType &key, BTreeOLCValue &value, bool) -> bool {
+                        dump_processor((const void *)&key, (const void *)&value.row->data);
+                        return false;
+		};
+
+                KeyType start_key;
+                memset(&start_key, 0, sizeof(KeyType));
+                btree.scanForUpdateNoContention(start_key, processor);
+                unlock_processor();
+	}
+
     private:
 	BTree btree;
 	std::size_t tableID_;
@@ -855,6 +1007,18 @@ template <class KeyType, class ValueType, class KeyComparator, class ValueCompar
                 return true;
 	}
 
+        bool bulk_insert(std::size_t row_count, std::function<void(std::size_t, void *, void *)> row_generator) override
+        {
+                for (std::size_t i = 0; i < row_count; i++) {
+                        KeyType k;
+                        ValueType v;
+                        row_generator(i, &k, &v);
+                        insert(&k, &v);
+                }
+
+                return true;
+        }
+
         bool insert_lock_next_key(const void *key, const void *value, std::function<bool(const void *, MetaDataType *, void *)> next_key_processor, bool is_placeholder = false) override
         {
                 CHECK(0);
@@ -946,6 +1110,13 @@ template <class KeyType, class ValueType, class KeyComparator, class ValueCompar
                 return HASHMAP;
         }
 
+	void dump_copy(std::function<void(const void *, const void *)> dump_processor, std::function<void()> unlock_processor) override
+	{
+		auto processor = [&](const KeyType &key, const ValueType &value) { dump_processor((const void *)&key, (const void *)&value); };
+		map_.iterate(processor);
+		unlock_processor();
+	}
+
     private:
 	UnsafeHashMap<KeyType, ValueType> map_;
 	std::size_t tableID_;
@@ -1023,6 +1194,18 @@ template <std::size_t N, class KeyType, class ValueType, class KeyComparator, cl
                 return true;
 	}
 
+        bool bulk_insert(std::size_t row_count, std::function<void(std::size_t, void *, void *)> row_generator) override
+        {
+                for (std::size_t i = 0; i < row_count; i++) {
+                        KeyType k;
+                        ValueType v;
+                        row_generator(i, &k, &v);
+                        insert(&k, &v);
+                }
+
+                return true;
+        }
+
         bool insert_lock_next_key(const void *key, const void *value, std::function<bool(const void *, MetaDataType *, void *)> next_key_processor, bool is_placeholder = false) override
         {
                 CHECK(0);
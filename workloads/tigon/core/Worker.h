@@ -6,6 +6,7 @@
 
 #include "common/LockfreeQueue.h"
 #include "common/Message.h"
+#include "common/Percentile.h"
 #include <atomic>
 #include <glog/logging.h>
 #include <queue>
@@ -59,6 +60,12 @@ class Worker {
 
 	virtual Message *pop_message() = 0;
 
+	// committed transaction latency (us) for reporting while the run goes on
+	virtual const Percentile<int64_t> *get_latency_percentile() const
+	{
+		return nullptr;
+	}
+
     public:
 	std::size_t coordinator_id;
 	std::size_t id;
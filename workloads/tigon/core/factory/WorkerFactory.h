@@ -41,6 +41,9 @@
 #include "protocol/Aria/AriaManager.h"
 #include "protocol/Aria/AriaTransaction.h"
 
+#include "protocol/AriaPasha/AriaPashaExecutor.h"
+#include "protocol/AriaPasha/AriaPashaManager.h"
+
 #include "protocol/Sundial/Sundial.h"
 #include "protocol/Sundial/SundialExecutor.h"
 
@@ -83,8 +86,13 @@ class WorkerFactory {
 	static std::vector<std::shared_ptr<Worker> > create_workers(std::size_t coordinator_id, Database &db, const Context &context,
 								    std::atomic<bool> &stop_flag)
 	{
-		std::unordered_set<std::string> protocols = { "Silo", "SiloGC", "Star", "Sundial", "TwoPL", "TwoPLGC", "Calvin", "HStore", "Aria", "TwoPLPasha", "SundialPasha" };
+		std::unordered_set<std::string> protocols = { "Silo", "SiloGC", "Star", "Sundial", "TwoPL", "TwoPLGC", "Calvin", "HStore", "Aria", "AriaPasha", "TwoPLPasha", "SundialPasha" };
 		CHECK(protocols.count(context.protocol) == 1);
+		CHECK(context.coroutine_num >= 1);
+		CHECK(context.coroutine_num == 1 || context.protocol == "TwoPLPasha" || context.protocol == "SundialPasha")
+			<< "Only TwoPLPasha and SundialPasha interleave transactions.";
+		CHECK(context.mvcc_snapshot_reads == false || (context.protocol == "TwoPLPasha" && context.scc_mechanism == "NoOP"))
+			<< "Snapshot reads bypass the CXL latch, so they need TwoPLPasha on hardware-coherent CXL memory.";
 
 		std::vector<std::shared_ptr<Worker> > workers;
 
@@ -243,6 +251,20 @@ class WorkerFactory {
 					manager->total_abort, manager->n_completed_workers, manager->n_started_workers));
 			}
 
+			workers.push_back(manager);
+		} else if (context.protocol == "AriaPasha") {
+			using TransactionType = star::AriaTransaction;
+			using WorkloadType = typename InferType<Context>::template WorkloadType<TransactionType>;
+
+			// the manager moves this host's rows into CXL before the workers start
+			auto manager = std::make_shared<AriaPashaManager<WorkloadType> >(coordinator_id, context.worker_num, db, context, stop_flag);
+
+			for (auto i = 0u; i < context.worker_num; i++) {
+				workers.push_back(std::make_shared<AriaPashaExecutor<WorkloadType> >(coordinator_id, i, db, context, manager->transactions,
+													manager->epoch, manager->worker_status, manager->total_abort,
+													manager->n_completed_workers, manager->n_started_workers));
+			}
+
 			workers.push_back(manager);
 		}
 
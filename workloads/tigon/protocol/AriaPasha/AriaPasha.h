@@ -0,0 +1,61 @@
+//
+// CXL-native Aria
+//
+
+#pragma once
+
+#include "core/Partitioner.h"
+#include "core/Table.h"
+#include "protocol/Aria/AriaTransaction.h"
+#include "protocol/AriaPasha/AriaPashaHelper.h"
+
+#include <cstring>
+
+namespace star
+{
+
+template <class Database> class AriaPasha {
+    public:
+	using DatabaseType = Database;
+	using MetaDataType = std::atomic<uint64_t>;
+	using ContextType = typename DatabaseType::ContextType;
+	using TransactionType = AriaTransaction;
+
+	AriaPasha(DatabaseType &db, const ContextType &context, Partitioner &partitioner)
+		: db(db)
+		, context(context)
+		, partitioner(partitioner)
+	{
+	}
+
+	void abort(TransactionType &txn)
+	{
+		// retried in the next batch
+		txn.abort_lock = true;
+	}
+
+	void commit(TransactionType &txn)
+	{
+		// rows of all partitions are in CXL, so remote writes need no messages
+		auto &writeSet = txn.writeSet;
+		for (auto i = 0u; i < writeSet.size(); i++) {
+			auto &writeKey = writeSet[i];
+			auto tableId = writeKey.get_table_id();
+			auto partitionId = writeKey.get_partition_id();
+			auto table = db.find_table(tableId, partitionId);
+
+			// the reservation word is followed by the value
+			MetaDataType *tid = writeKey.get_tid();
+			if (tid == nullptr) {
+				tid = std::get<0>(aria_pasha_global_helper->search(tableId, partitionId, writeKey.get_key()));
+			}
+			std::memcpy(AriaPashaHelper::get_value(tid), writeKey.get_value(), table->value_size());
+		}
+	}
+
+    private:
+	DatabaseType &db;
+	const ContextType &context;
+	Partitioner &partitioner;
+};
+} // namespace star
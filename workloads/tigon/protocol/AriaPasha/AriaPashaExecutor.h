@@ -0,0 +1,353 @@
+//
+// CXL-native Aria
+//
+
+#pragma once
+
+#include "core/Partitioner.h"
+
+#include "common/Percentile.h"
+#include "core/Worker.h"
+#include "glog/logging.h"
+
+#include "protocol/Aria/AriaHelper.h"
+#include "protocol/AriaPasha/AriaPasha.h"
+#include "protocol/AriaPasha/AriaPashaHelper.h"
+
+#include <chrono>
+#include <thread>
+
+namespace star
+{
+
+template <class Workload> class AriaPashaExecutor : public Worker {
+    public:
+	using WorkloadType = Workload;
+	using DatabaseType = typename WorkloadType::DatabaseType;
+	using StorageType = typename WorkloadType::StorageType;
+
+	using TransactionType = AriaTransaction;
+	static_assert(std::is_same<typename WorkloadType::TransactionType, TransactionType>::value, "Transaction types do not match.");
+
+	using ContextType = typename DatabaseType::ContextType;
+	using RandomType = typename DatabaseType::RandomType;
+	using MetaDataType = std::atomic<uint64_t>;
+
+	using ProtocolType = AriaPasha<DatabaseType>;
+
+	AriaPashaExecutor(std::size_t coordinator_id, std::size_t id, DatabaseType &db, const ContextType &context,
+			  std::vector<std::unique_ptr<TransactionType> > &transactions, std::atomic<uint32_t> &epoch, std::atomic<uint32_t> &worker_status,
+			  std::atomic<uint32_t> &total_abort, std::atomic<uint32_t> &n_complete_workers, std::atomic<uint32_t> &n_started_workers)
+		: Worker(coordinator_id, id)
+		, db(db)
+		, context(context)
+		, transactions(transactions)
+		, epoch(epoch)
+		, worker_status(worker_status)
+		, total_abort(total_abort)
+		, n_complete_workers(n_complete_workers)
+		, n_started_workers(n_started_workers)
+		, partitioner(PartitionerFactory::create_partitioner(context.partitioner, coordinator_id, context.coordinator_num))
+		, workload(coordinator_id, db, random, *partitioner)
+		, random(reinterpret_cast<uint64_t>(this))
+		, protocol(db, context, *partitioner)
+	{
+	}
+
+	~AriaPashaExecutor() = default;
+
+	void start() override
+	{
+		LOG(INFO) << "AriaPashaExecutor " << id << " started. ";
+
+		// each phase ends when every worker of every host is done with it; the
+		// manager crosses the CXL barrier on behalf of this host
+		for (;;) {
+			if (wait_for_phase(ExecutorStatus::Aria_COLLECT_XACT) == false) {
+				LOG(INFO) << "AriaPashaExecutor " << id << " exits. ";
+				return;
+			}
+			n_started_workers.fetch_add(1);
+			generate_transactions();
+			n_complete_workers.fetch_add(1);
+
+			if (wait_for_phase(ExecutorStatus::Aria_READ) == false) {
+				return;
+			}
+			n_started_workers.fetch_add(1);
+			{
+				ScopedTimer t([&, this](uint64_t us) { this->execution_time.add(us); });
+				read_snapshot();
+			}
+			n_complete_workers.fetch_add(1);
+
+			if (wait_for_phase(ExecutorStatus::Aria_COMMIT) == false) {
+				return;
+			}
+			n_started_workers.fetch_add(1);
+			{
+				ScopedTimer t([&, this](uint64_t us) { this->commit_time.add(us); });
+				commit_transactions();
+			}
+			n_complete_workers.fetch_add(1);
+		}
+	}
+
+	std::size_t get_partition_id()
+	{
+		CHECK(context.partition_num % context.coordinator_num == 0);
+
+		auto partition_num_per_node = context.partition_num / context.coordinator_num;
+		std::size_t partition_id = random.uniform_dist(0, partition_num_per_node - 1) * context.coordinator_num + coordinator_id;
+		CHECK(partitioner->has_master_partition(partition_id));
+		return partition_id;
+	}
+
+	void generate_transactions()
+	{
+		auto n_abort = total_abort.load();
+		for (std::size_t i = id; i < transactions.size(); i += context.worker_num) {
+			// aborted transactions were moved to the front of the batch and are
+			// retried with the same query
+			if (transactions[i] == nullptr || i >= n_abort) {
+				auto partition_id = get_partition_id();
+				transactions[i] = workload.next_transaction(context, partition_id, this->id);
+			} else {
+				transactions[i]->reset();
+				transactions[i]->aria_aborted = true;
+			}
+		}
+	}
+
+	void read_snapshot()
+	{
+		auto cur_epoch = epoch.load();
+
+		for (auto i = id; i < transactions.size(); i += context.worker_num) {
+			transactions[i]->set_epoch(cur_epoch);
+			transactions[i]->set_id(i * context.coordinator_num + coordinator_id + 1); // tid starts from 1
+			transactions[i]->set_tid_offset(i);
+			transactions[i]->execution_phase = false;
+			setupHandlers(*transactions[i]);
+
+			auto ltc = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - transactions[i]->startTime).count();
+			transactions[i]->set_stall_time(ltc);
+
+			auto result = transactions[i]->execute(id);
+			if (result == TransactionResult::ABORT_NORETRY) {
+				transactions[i]->abort_no_retry = true;
+				continue;
+			}
+
+			// all reads are served from CXL right away, so the writes can be
+			// filled in and reserved without waiting for responses
+			transactions[i]->execution_phase = true;
+			transactions[i]->execute(id);
+			reserve_transaction(*transactions[i]);
+		}
+	}
+
+	MetaDataType &get_metadata(AriaRWKey &key)
+	{
+		auto tid = key.get_tid();
+		if (!tid) {
+			tid = std::get<0>(aria_pasha_global_helper->search(key.get_table_id(), key.get_partition_id(), key.get_key()));
+			key.set_tid(tid);
+		}
+		return *tid;
+	}
+
+	void reserve_transaction(TransactionType &txn)
+	{
+		if (context.aria_read_only_optmization && txn.is_read_only()) {
+			return;
+		}
+
+		for (auto &readKey : txn.readSet) {
+			if (readKey.get_local_index_read_bit()) {
+				continue;
+			}
+			AriaHelper::reserve_read(get_metadata(readKey), txn.epoch, txn.id);
+		}
+
+		for (auto &writeKey : txn.writeSet) {
+			AriaHelper::reserve_write(get_metadata(writeKey), txn.epoch, txn.id);
+		}
+	}
+
+	void analyze_dependency(TransactionType &txn)
+	{
+		if (context.aria_read_only_optmization && txn.is_read_only()) {
+			return;
+		}
+
+		// analyze raw
+		for (auto &readKey : txn.readSet) {
+			if (readKey.get_local_index_read_bit()) {
+				continue;
+			}
+
+			uint64_t tid = get_metadata(readKey).load();
+			uint64_t epoch = AriaHelper::get_epoch(tid);
+			uint64_t wts = AriaHelper::get_wts(tid);
+			DCHECK(epoch == txn.epoch);
+			if (epoch == txn.epoch && wts < txn.id && wts != 0) {
+				txn.raw = true;
+				break;
+			}
+		}
+
+		// analyze war and waw
+		for (auto &writeKey : txn.writeSet) {
+			uint64_t tid = get_metadata(writeKey).load();
+			uint64_t epoch = AriaHelper::get_epoch(tid);
+			uint64_t rts = AriaHelper::get_rts(tid);
+			uint64_t wts = AriaHelper::get_wts(tid);
+			DCHECK(epoch == txn.epoch);
+			if (epoch == txn.epoch && rts < txn.id && rts != 0) {
+				txn.war = true;
+			}
+			if (epoch == txn.epoch && wts < txn.id && wts != 0) {
+				txn.waw = true;
+			}
+		}
+	}
+
+	void commit_transactions()
+	{
+		std::size_t concur = 0, effective_concur = 0;
+
+		for (auto i = id; i < transactions.size(); i += context.worker_num) {
+			auto &txn = *transactions[i];
+			++concur;
+
+			if (txn.abort_no_retry) {
+				n_abort_no_retry.fetch_add(1);
+				continue;
+			}
+
+			analyze_dependency(txn);
+
+			bool abort;
+			if (context.aria_read_only_optmization && txn.is_read_only()) {
+				abort = false;
+			} else if (txn.waw) {
+				abort = true;
+			} else if (context.aria_snapshot_isolation) {
+				abort = false;
+			} else if (context.aria_reordering_optmization) {
+				abort = txn.war && txn.raw;
+			} else {
+				abort = txn.raw;
+			}
+
+			if (abort) {
+				protocol.abort(txn);
+				n_abort_lock.fetch_add(1);
+				continue;
+			}
+
+			protocol.commit(txn);
+			effective_concur++;
+			n_commit.fetch_add(1);
+			auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - txn.startTime).count();
+			percentile.add(latency);
+			if (txn.distributed_transaction) {
+				this->dist_latency.add(latency);
+			} else {
+				this->local_latency.add(latency);
+			}
+		}
+
+		this->round_concurrency.add(concur);
+		this->effective_round_concurrency.add(effective_concur);
+	}
+
+	void setupHandlers(TransactionType &txn)
+	{
+		txn.readRequestHandler = [this, &txn](AriaRWKey &readKey, std::size_t tid, uint32_t key_offset) {
+			auto table_id = readKey.get_table_id();
+			auto partition_id = readKey.get_partition_id();
+			ITable *table = db.find_table(table_id, partition_id);
+
+			auto row = aria_pasha_global_helper->search(table_id, partition_id, readKey.get_key());
+			AriaHelper::set_key_tid(readKey, row);
+			AriaHelper::read(row, readKey.get_value(), table->value_size());
+
+			if (this->partitioner->has_master_partition(partition_id)) {
+				this->n_local_access.fetch_add(1);
+			} else {
+				this->n_remote_access.fetch_add(1);
+				txn.distributed_transaction = true;
+			}
+		};
+
+		txn.remote_request_handler = [](std::size_t) { return 0; };
+		txn.message_flusher = []() {};
+	}
+
+	const Percentile<int64_t> *get_latency_percentile() const override
+	{
+		return &percentile;
+	}
+
+	void onExit() override
+	{
+		LOG(INFO) << "Worker " << id << " latency: " << percentile.nth(50) << " us (50%) " << percentile.nth(75) << " us (75%) " << percentile.nth(95)
+			  << " us (95%) " << percentile.nth(99) << " us (99%). dist txn latency: " << this->dist_latency.nth(50) << " us (50%) "
+			  << this->dist_latency.nth(99) << " us (99%). local txn latency: " << this->local_latency.nth(50) << " us (50%) "
+			  << this->local_latency.nth(99) << " us (99%). batch concurrency: " << this->round_concurrency.nth(50)
+			  << ". effective batch concurrency: " << this->effective_round_concurrency.nth(50)
+			  << ". execution time: " << this->execution_time.avg() << ". commit time: " << this->commit_time.avg();
+	}
+
+	void push_message(Message *message) override
+	{
+		CHECK(false) << "AriaPasha workers exchange no messages";
+	}
+
+	void push_replica_message(Message *message) override
+	{
+		CHECK(false) << "AriaPasha workers exchange no messages";
+	}
+
+	Message *pop_message() override
+	{
+		return nullptr;
+	}
+
+    private:
+	// returns false on EXIT
+	bool wait_for_phase(ExecutorStatus phase)
+	{
+		for (;;) {
+			auto status = static_cast<ExecutorStatus>(worker_status.load());
+			if (status == ExecutorStatus::EXIT) {
+				return false;
+			}
+			if (status == phase) {
+				return true;
+			}
+			std::this_thread::yield();
+		}
+	}
+
+    private:
+	DatabaseType &db;
+	ContextType context;
+	std::vector<std::unique_ptr<TransactionType> > &transactions;
+	std::atomic<uint32_t> &epoch, &worker_status, &total_abort;
+	std::atomic<uint32_t> &n_complete_workers, &n_started_workers;
+	std::unique_ptr<Partitioner> partitioner;
+	WorkloadType workload;
+	RandomType random;
+	ProtocolType protocol;
+	Percentile<int64_t> percentile;
+	Percentile<int64_t> local_latency;
+	Percentile<int64_t> dist_latency;
+	Percentile<uint64_t> round_concurrency;
+	Percentile<uint64_t> effective_round_concurrency;
+	Percentile<uint64_t> execution_time;
+	Percentile<uint64_t> commit_time;
+};
+} // namespace star
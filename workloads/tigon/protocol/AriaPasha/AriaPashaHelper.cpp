@@ -0,0 +1,7 @@
+#include "protocol/AriaPasha/AriaPashaHelper.h"
+
+namespace star {
+
+AriaPashaHelper *aria_pasha_global_helper = nullptr;
+
+}
@@ -0,0 +1,130 @@
+//
+// Shared-memory state of the CXL-native Aria variant
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "common/CXLMemory.h"
+#include "core/CXLTable.h"
+#include "core/Table.h"
+
+#include "glog/logging.h"
+
+namespace star
+{
+
+/*
+ * AriaPasha keeps every row in CXL memory, laid out as
+ *
+ *     [reservation word (8 bytes) | value]
+ *
+ * where the reservation word has the format of AriaHelper ([epoch | rts | wts]).
+ * The rows are indexed by the shared CXL tables of the database, so each host
+ * reads, reserves and writes any row directly. The batch state in CXL replaces
+ * the signal/stop/ack messages that Aria exchanges at every phase boundary.
+ */
+struct AriaPashaBatchState {
+	// hosts that reached the current barrier
+	std::atomic<uint64_t> arrived;
+
+	// bumped by the last host to arrive
+	std::atomic<uint64_t> generation;
+
+	// set by coordinator 0 before the batch-begin barrier
+	std::atomic<uint64_t> stop;
+};
+
+class AriaPashaHelper {
+    public:
+	using MetaDataType = std::atomic<uint64_t>;
+
+	AriaPashaHelper(std::size_t coordinator_id, std::size_t coordinator_num, std::vector<std::vector<CXLTableBase *> > &cxl_tbl_vecs)
+		: coordinator_id(coordinator_id)
+		, coordinator_num(coordinator_num)
+		, cxl_tbl_vecs(cxl_tbl_vecs)
+	{
+		if (coordinator_id == 0) {
+			batch_state = reinterpret_cast<AriaPashaBatchState *>(
+				cxl_memory.cxlalloc_malloc_wrapper(sizeof(AriaPashaBatchState), CXLMemory::MISC_ALLOCATION));
+			batch_state->arrived.store(0);
+			batch_state->generation.store(0);
+			batch_state->stop.store(0);
+			CXLMemory::commit_shared_data_initialization(CXLMemory::cxl_aria_batch_root_index, batch_state);
+		} else {
+			void *tmp = nullptr;
+			CXLMemory::wait_and_retrieve_cxl_shared_data(CXLMemory::cxl_aria_batch_root_index, &tmp);
+			batch_state = reinterpret_cast<AriaPashaBatchState *>(tmp);
+		}
+	}
+
+	// copies a DRAM row into CXL and indexes it in the shared table
+	bool move_row_in(ITable *table, const void *key, std::tuple<MetaDataType *, void *> &row)
+	{
+		std::size_t row_size = sizeof(MetaDataType) + table->value_size();
+		char *cxl_row = reinterpret_cast<char *>(cxl_memory.cxlalloc_malloc_wrapper(row_size, CXLMemory::DATA_ALLOCATION));
+
+		new (cxl_row) MetaDataType(0);
+		std::memcpy(cxl_row + sizeof(MetaDataType), std::get<1>(row), table->value_size());
+
+		CXLTableBase *cxl_table = cxl_tbl_vecs[table->tableID()][table->partitionID()];
+		bool success = cxl_table->insert(key, cxl_row);
+		CHECK(success == true);
+		return success;
+	}
+
+	std::tuple<MetaDataType *, void *> search(std::size_t table_id, std::size_t partition_id, const void *key)
+	{
+		char *cxl_row = reinterpret_cast<char *>(cxl_tbl_vecs[table_id][partition_id]->search(key));
+		CHECK(cxl_row != nullptr);
+		MetaDataType *tid = reinterpret_cast<MetaDataType *>(cxl_row);
+		return std::make_tuple(tid, get_value(tid));
+	}
+
+	static void *get_value(MetaDataType *tid)
+	{
+		return reinterpret_cast<char *>(tid) + sizeof(MetaDataType);
+	}
+
+	// returns once every host has called barrier() as many times as this one
+	void barrier()
+	{
+		uint64_t generation = batch_state->generation.load();
+
+		if (batch_state->arrived.fetch_add(1) + 1 == coordinator_num) {
+			batch_state->arrived.store(0);
+			batch_state->generation.store(generation + 1);
+			return;
+		}
+
+		while (batch_state->generation.load() == generation) {
+			std::this_thread::yield();
+		}
+	}
+
+	void set_stop()
+	{
+		DCHECK(coordinator_id == 0);
+		batch_state->stop.store(1);
+	}
+
+	bool should_stop()
+	{
+		return batch_state->stop.load() != 0;
+	}
+
+    private:
+	std::size_t coordinator_id;
+	std::size_t coordinator_num;
+	std::vector<std::vector<CXLTableBase *> > &cxl_tbl_vecs;
+	AriaPashaBatchState *batch_state{ nullptr };
+};
+
+extern AriaPashaHelper *aria_pasha_global_helper;
+
+} // namespace star
@@ -0,0 +1,159 @@
+//
+// CXL-native Aria
+//
+
+#pragma once
+
+#include "core/Manager.h"
+#include "core/Partitioner.h"
+#include "protocol/Aria/AriaTransaction.h"
+#include "protocol/AriaPasha/AriaPasha.h"
+#include "protocol/AriaPasha/AriaPashaExecutor.h"
+#include "protocol/AriaPasha/AriaPashaHelper.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace star
+{
+
+template <class Workload> class AriaPashaManager : public star::Manager {
+    public:
+	using base_type = star::Manager;
+
+	using WorkloadType = Workload;
+	using DatabaseType = typename WorkloadType::DatabaseType;
+	using TransactionType = AriaTransaction;
+	static_assert(std::is_same<typename WorkloadType::TransactionType, TransactionType>::value, "Transaction types do not match.");
+	using ContextType = typename DatabaseType::ContextType;
+	using MetaDataType = std::atomic<uint64_t>;
+
+	AriaPashaManager(std::size_t coordinator_id, std::size_t id, DatabaseType &db, const ContextType &context, std::atomic<bool> &stopFlag)
+		: base_type(coordinator_id, id, context, stopFlag)
+		, partitioner(PartitionerFactory::create_partitioner(context.partitioner, coordinator_id, context.coordinator_num))
+		, db(db)
+		, epoch(0)
+	{
+		transactions.resize(context.batch_size);
+
+		// create or retrieve the CXL tables and publish this host's rows in them
+		std::vector<std::vector<CXLTableBase *> > &cxl_tbl_vecs = db.create_or_retrieve_cxl_tables(context);
+		aria_pasha_global_helper = new AriaPashaHelper(coordinator_id, context.coordinator_num, cxl_tbl_vecs);
+
+		auto move_in_func = [](ITable *table, const void *key, std::tuple<MetaDataType *, void *> &row, bool) {
+			return aria_pasha_global_helper->move_row_in(table, key, row);
+		};
+		for (auto i = 0u; i < context.partition_num; i++) {
+			if (partitioner->has_master_partition(i) == false) {
+				continue;
+			}
+			for (auto j = 0u; j < db.get_table_num_per_partition(); j++) {
+				db.find_table(j, i)->move_all_into_cxl(move_in_func);
+			}
+		}
+		LOG(INFO) << "AriaPasha moved the partitions of coordinator " << coordinator_id << " into CXL";
+
+		if (context.log_path != "" && context.wal_group_commit_time != 0 &&
+		    context.lotus_checkpoint != LotusCheckpointScheme::COW_ON_CHECKPOINT_ON_LOGGING_OFF) {
+			// executors do not log, so the manager is the only writer of stream 0
+			logger = context.slave_loggers[0];
+		} else {
+			logger = context.master_logger;
+		}
+	}
+
+	void log_transactions()
+	{
+		uint64_t commit_persistence_time = 0;
+		{
+			ScopedTimer t([&, this](uint64_t us) { commit_persistence_time = us; });
+			std::string txn_command_data = "";
+			for (std::size_t i = 0; i < transactions.size(); i++) {
+				if (transactions[i]->aria_aborted == false) {
+					txn_command_data += transactions[i]->serialize(0);
+				}
+			}
+
+			this->logger->write(txn_command_data.data(), txn_command_data.size(), true, std::chrono::steady_clock::now());
+		}
+		for (auto i = id; i < transactions.size(); i += context.worker_num) {
+			transactions[i]->record_commit_persistence_time(commit_persistence_time);
+		}
+	}
+
+	/*
+	 * All hosts run the same loop; phases are separated by barriers in CXL
+	 * instead of signal/stop/ack messages. Collecting transactions is local,
+	 * so a batch needs two barriers: after the read/reserve phase, so that
+	 * every reservation is in place before dependencies are analyzed, and
+	 * after the commit phase, so that the next batch reads the new values.
+	 */
+	void coordinator_start() override
+	{
+		run_batches();
+	}
+
+	void non_coordinator_start() override
+	{
+		run_batches();
+	}
+
+	void run_batches()
+	{
+		// every host has moved its rows into CXL
+		aria_pasha_global_helper->barrier();
+
+		while (!aria_pasha_global_helper->should_stop()) {
+			epoch.fetch_add(1);
+			cleanup_batch();
+
+			run_phase(ExecutorStatus::Aria_COLLECT_XACT);
+			log_transactions();
+
+			run_phase(ExecutorStatus::Aria_READ);
+			aria_pasha_global_helper->barrier();
+
+			run_phase(ExecutorStatus::Aria_COMMIT);
+			// coordinator 0 decides before the barrier, so every host sees the same decision after it
+			if (coordinator_id == 0 && stopFlag.load()) {
+				aria_pasha_global_helper->set_stop();
+			}
+			aria_pasha_global_helper->barrier();
+		}
+
+		set_worker_status(ExecutorStatus::EXIT);
+	}
+
+	void run_phase(ExecutorStatus status)
+	{
+		n_started_workers.store(0);
+		n_completed_workers.store(0);
+		set_worker_status(status);
+		wait_all_workers_start();
+		wait_all_workers_finish();
+	}
+
+	void cleanup_batch()
+	{
+		std::size_t it = 0;
+		for (auto i = 0u; i < transactions.size(); i++) {
+			if (transactions[i] == nullptr) {
+				break;
+			}
+			if (transactions[i]->abort_lock) {
+				transactions[it++].swap(transactions[i]);
+			}
+		}
+		total_abort.store(it);
+	}
+
+    public:
+	std::unique_ptr<Partitioner> partitioner;
+	DatabaseType &db;
+	WALLogger *logger = nullptr;
+	std::atomic<uint32_t> epoch;
+	std::vector<std::unique_ptr<TransactionType> > transactions;
+	std::atomic<uint32_t> total_abort;
+};
+} // namespace star
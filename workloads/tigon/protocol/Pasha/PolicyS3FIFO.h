@@ -0,0 +1,361 @@
+//
+// Scalable migration policy: per-partition S3-FIFO with a frequency sketch
+//
+
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <vector>
+#include "stdint.h"
+
+#include "core/Table.h"
+#include "common/CXLMemory.h"
+#include "protocol/Pasha/MigrationManager.h"
+
+namespace star
+{
+
+/*
+ * PolicyLRU keeps one doubly linked list per partition in CXL memory and
+ * takes its process-shared spinlock on every access_row, which makes the
+ * tracker a hot, cross-host cache line. This policy keeps all tracking
+ * state in the owner host's DRAM instead:
+ *
+ *   - access_row only bumps a saturating 2-bit counter in the row's own
+ *     policy metadata (no lock, and no store once the counter saturates);
+ *   - the owner runs S3-FIFO over its partitions: new rows enter a small
+ *     probationary FIFO, rows touched again while in it are promoted to the
+ *     main FIFO, and main evicts CLOCK-style;
+ *   - a count-min sketch over recent move-in requests replaces S3-FIFO's
+ *     ghost queue: rows that keep coming back are admitted straight into
+ *     the main FIFO;
+ *   - move-outs are batched: once over budget, we evict down to a low
+ *     watermark so that the following move-ins do not each pay for one;
+ *   - the effective budget adapts between hw_cc_budget / 4 and hw_cc_budget:
+ *     it shrinks while the hit rate of the shared region stays close to the
+ *     best recently observed one and grows back when it drops.
+ */
+class PolicyS3FIFO : public MigrationManager {
+    public:
+        struct S3FIFONode;
+
+        // lives in CXL memory, inside the row
+        struct S3FIFOMeta {
+                S3FIFONode *node{ nullptr };    // this will be in local DRAM and is only accessed by the owner host
+                std::atomic<uint8_t> freq{ 0 };
+        };
+
+        // lives in the owner host's DRAM
+        struct S3FIFONode {
+                S3FIFONode(ITable *table, const void *key, const std::tuple<MetaDataType *, void *> &row, uint64_t metadata_size)
+                        : row_entity(table, key, row, metadata_size)
+                {}
+
+                migrated_row_entity row_entity;
+                S3FIFOMeta *meta{ nullptr };
+                bool is_deleted{ false };
+        };
+
+        /*
+         * Count-min sketch with small saturating counters (capped at 15).
+         * All counters are halved every 'sample_size' increments so
+         * that the sketch follows the recent workload (TinyLFU-style aging).
+         */
+        class FrequencySketch {
+            public:
+                static constexpr uint64_t depth = 4;
+                static constexpr uint8_t max_count = 15;
+
+                explicit FrequencySketch(uint64_t width = 4096)
+                        : width(width)
+                        , sample_size(width * 8)
+                        , counters(depth * width, 0)
+                {
+                        CHECK((width & (width - 1)) == 0);
+                }
+
+                void increment(uint64_t hash)
+                {
+                        for (uint64_t i = 0; i < depth; i++) {
+                                uint8_t &c = counters[i * width + index_of(hash, i)];
+                                if (c < max_count)
+                                        c++;
+                        }
+                        if (++additions == sample_size)
+                                age();
+                }
+
+                uint8_t estimate(uint64_t hash) const
+                {
+                        uint8_t ret = max_count;
+                        for (uint64_t i = 0; i < depth; i++)
+                                ret = std::min(ret, counters[i * width + index_of(hash, i)]);
+                        return ret;
+                }
+
+            private:
+                uint64_t index_of(uint64_t hash, uint64_t i) const
+                {
+                        // derive the per-row hashes from one 64-bit hash (Kirsch-Mitzenmacher)
+                        uint64_t h = (hash & 0xffffffffull) + i * (hash >> 32);
+                        return h & (width - 1);
+                }
+
+                void age()
+                {
+                        for (auto &c : counters)
+                                c >>= 1;
+                        additions = 0;
+                }
+
+                uint64_t width;
+                uint64_t sample_size;
+                uint64_t additions{ 0 };
+                std::vector<uint8_t> counters;
+        };
+
+        class S3FIFOTracker {
+            public:
+                std::mutex tracker_mutex;
+                std::deque<S3FIFONode *> small_queue;
+                std::deque<S3FIFONode *> main_queue;
+                FrequencySketch sketch;
+        };
+
+        static constexpr uint8_t max_freq = 3;
+        static constexpr uint8_t main_admission_threshold = 2;  // sketch estimate needed to skip the small FIFO
+        static constexpr uint64_t small_queue_ratio = 10;       // small FIFO holds ~10% of the tracked rows
+        static constexpr uint64_t move_out_batch_ratio = 64;    // evict budget / 64 below the budget at once
+
+        static constexpr uint64_t adaptation_window = 4096;     // move-ins between two budget adjustments
+        static constexpr uint64_t adaptation_step_ratio = 16;   // each adjustment moves budget / 16
+        static constexpr double hit_rate_tolerance = 0.01;
+        static constexpr double best_hit_rate_decay = 0.002;
+
+        PolicyS3FIFO(std::function<migration_result(ITable *, const void *, const std::tuple<std::atomic<uint64_t> *, void *> &, bool, void *&)> move_from_partition_to_shared_region,
+                        std::function<bool(ITable *, const void *, const std::tuple<std::atomic<uint64_t> *, void *> &)> move_from_shared_region_to_partition,
+                        std::function<bool(ITable *, const void *, bool, bool &, void *&)> delete_and_update_next_key_info,
+                        uint64_t coordinator_id,
+                        uint64_t partition_num,
+                        const std::string when_to_move_out_str,
+                        uint64_t hw_cc_budget)
+        : MigrationManager(move_from_partition_to_shared_region, move_from_shared_region_to_partition, delete_and_update_next_key_info, when_to_move_out_str)
+        , max_hw_cc_budget(hw_cc_budget)
+        , min_hw_cc_budget(hw_cc_budget / 4)
+        , cur_hw_cc_budget(hw_cc_budget)
+        {
+                CHECK(MigrationManager::migration_policy_meta_size >= sizeof(S3FIFOMeta));
+
+                trackers = new S3FIFOTracker[partition_num];
+        }
+
+        void init_migration_policy_metadata(void *migration_policy_meta, ITable *table, const void *key, const std::tuple<MetaDataType *, void *> &row, uint64_t metadata_size) override
+        {
+                S3FIFOMeta *s3fifo_meta = reinterpret_cast<S3FIFOMeta *>(migration_policy_meta);
+                new(s3fifo_meta) S3FIFOMeta();
+                s3fifo_meta->node = new S3FIFONode(table, key, row, metadata_size);
+                s3fifo_meta->node->meta = s3fifo_meta;
+        }
+
+        void access_row(void *migration_policy_meta, uint64_t partition_id) override
+        {
+                S3FIFOMeta *s3fifo_meta = reinterpret_cast<S3FIFOMeta *>(migration_policy_meta);
+
+                // avoid dirtying the cache line once the counter saturates
+                uint8_t freq = s3fifo_meta->freq.load(std::memory_order_relaxed);
+                if (freq < max_freq)
+                        s3fifo_meta->freq.store(freq + 1, std::memory_order_relaxed);
+
+                count_hit();
+        }
+
+        migration_result move_row_in(ITable *table, const void *key, const std::tuple<MetaDataType *, void *> &row, bool inc_ref_cnt) override
+        {
+                S3FIFOTracker &tracker = trackers[table->partitionID()];
+                void *migration_policy_meta = nullptr;
+                migration_result ret = migration_result::FAIL_OOM;
+                uint64_t hash = hash_key(table, key);
+
+                tracker.tracker_mutex.lock();
+                tracker.sketch.increment(hash);
+                ret = move_from_partition_to_shared_region(table, key, row, inc_ref_cnt, migration_policy_meta);
+                if (ret == migration_result::SUCCESS) {
+                        CHECK(migration_policy_meta != nullptr);
+                        S3FIFONode *node = reinterpret_cast<S3FIFOMeta *>(migration_policy_meta)->node;
+                        if (tracker.sketch.estimate(hash) >= main_admission_threshold) {
+                                tracker.main_queue.push_back(node);
+                        } else {
+                                tracker.small_queue.push_back(node);
+                        }
+                }
+                tracker.tracker_mutex.unlock();
+
+                if (ret != migration_result::FAIL_ALREADY_IN_CXL) {
+                        uint64_t misses = n_misses.fetch_add(1, std::memory_order_relaxed) + 1;
+                        if (misses % adaptation_window == 0)
+                                adapt_hw_cc_budget();
+                }
+
+                return ret;
+        }
+
+        bool move_row_out(uint64_t partition_id) override
+        {
+                S3FIFOTracker &tracker = trackers[partition_id];
+                uint64_t budget = cur_hw_cc_budget.load(std::memory_order_relaxed);
+                uint64_t low_watermark = budget - budget / move_out_batch_ratio;
+                bool ret = false;
+
+                if (cxl_memory.get_stats(CXLMemory::TOTAL_HW_CC_USAGE) < budget) {
+                        return ret;
+                }
+
+                tracker.tracker_mutex.lock();
+
+                // every queued row gets at most one look per call
+                uint64_t attempts = tracker.small_queue.size() + tracker.main_queue.size();
+                while (attempts-- > 0 && cxl_memory.get_stats(CXLMemory::TOTAL_HW_CC_USAGE) >= low_watermark) {
+                        S3FIFONode *victim = nullptr;
+                        bool from_small = false;
+
+                        if (tracker.small_queue.empty() == false &&
+                            (tracker.main_queue.empty() == true ||
+                             tracker.small_queue.size() * small_queue_ratio >= tracker.small_queue.size() + tracker.main_queue.size())) {
+                                victim = tracker.small_queue.front();
+                                tracker.small_queue.pop_front();
+                                from_small = true;
+                        } else {
+                                victim = tracker.main_queue.front();
+                                tracker.main_queue.pop_front();
+                        }
+
+                        if (victim->is_deleted == true) {
+                                delete victim;
+                                continue;
+                        }
+
+                        uint8_t freq = victim->meta->freq.load(std::memory_order_relaxed);
+                        if (from_small == true && freq > 1) {
+                                // re-accessed while on probation
+                                victim->meta->freq.store(0, std::memory_order_relaxed);
+                                tracker.main_queue.push_back(victim);
+                                continue;
+                        }
+                        if (from_small == false && freq > 0) {
+                                victim->meta->freq.store(freq - 1, std::memory_order_relaxed);
+                                tracker.main_queue.push_back(victim);
+                                continue;
+                        }
+
+                        migrated_row_entity &victim_row_entity = victim->row_entity;
+                        if (move_from_shared_region_to_partition(victim_row_entity.table, victim_row_entity.key, victim_row_entity.local_row) == true) {
+                                delete victim;
+                                ret = true;
+                        } else {
+                                // still referenced; retry later
+                                if (from_small == true) {
+                                        tracker.small_queue.push_back(victim);
+                                } else {
+                                        tracker.main_queue.push_back(victim);
+                                }
+                        }
+                }
+
+                tracker.tracker_mutex.unlock();
+
+                return ret;
+        }
+
+        bool delete_specific_row_and_move_out(ITable *table, const void *key, bool is_delete_local) override
+        {
+                S3FIFOTracker &tracker = trackers[table->partitionID()];
+                void *migration_policy_meta = nullptr;
+                bool need_move_out = false, ret = false;
+
+                tracker.tracker_mutex.lock();
+
+                // delete and update next key information
+                ret = delete_and_update_next_key_info(table, key, is_delete_local, need_move_out, migration_policy_meta);
+                CHECK(ret == true);
+
+                if (need_move_out == true) {
+                        // the node is dropped lazily when it reaches the head of its queue
+                        CHECK(migration_policy_meta != nullptr);
+                        S3FIFOMeta *s3fifo_meta = reinterpret_cast<S3FIFOMeta *>(migration_policy_meta);
+                        s3fifo_meta->node->is_deleted = true;
+                }
+
+                tracker.tracker_mutex.unlock();
+
+                return ret;
+        }
+
+    private:
+        static uint64_t hash_key(ITable *table, const void *key)
+        {
+                // FNV-1a over the table id and the key bytes
+                const uint8_t *p = reinterpret_cast<const uint8_t *>(key);
+                uint64_t h = 0xcbf29ce484222325ull ^ table->tableID();
+                for (std::size_t i = 0; i < table->key_size(); i++) {
+                        h ^= p[i];
+                        h *= 0x100000001b3ull;
+                }
+                return h;
+        }
+
+        void count_hit()
+        {
+                // keep the shared counter off the fast path
+                static thread_local uint64_t local_hits = 0;
+                if (++local_hits == 64) {
+                        n_hits.fetch_add(local_hits, std::memory_order_relaxed);
+                        local_hits = 0;
+                }
+        }
+
+        /*
+         * Hits are counted on the accessing hosts and misses on the owners;
+         * we look at the local ratio of both, which matches the global one
+         * as long as hosts see similar workloads.
+         */
+        void adapt_hw_cc_budget()
+        {
+                std::unique_lock<std::mutex> lock(adaptation_mutex, std::try_to_lock);
+                if (lock.owns_lock() == false)
+                        return;
+
+                uint64_t hits = n_hits.load(std::memory_order_relaxed);
+                uint64_t misses = n_misses.load(std::memory_order_relaxed);
+                uint64_t window_hits = hits - last_hits, window_misses = misses - last_misses;
+                last_hits = hits;
+                last_misses = misses;
+                if (window_hits + window_misses == 0)
+                        return;
+
+                double hit_rate = static_cast<double>(window_hits) / (window_hits + window_misses);
+                uint64_t budget = cur_hw_cc_budget.load(std::memory_order_relaxed);
+                uint64_t step = max_hw_cc_budget / adaptation_step_ratio;
+
+                best_hit_rate = std::max(hit_rate, best_hit_rate - best_hit_rate_decay);
+                if (hit_rate + hit_rate_tolerance >= best_hit_rate) {
+                        budget = budget > min_hw_cc_budget + step ? budget - step : min_hw_cc_budget;
+                } else {
+                        budget = std::min(budget + step, max_hw_cc_budget);
+                }
+                cur_hw_cc_budget.store(budget, std::memory_order_relaxed);
+        }
+
+        uint64_t max_hw_cc_budget{ 0 };
+        uint64_t min_hw_cc_budget{ 0 };
+        std::atomic<uint64_t> cur_hw_cc_budget{ 0 };
+
+        std::atomic<uint64_t> n_hits{ 0 }, n_misses{ 0 };
+        std::mutex adaptation_mutex;
+        uint64_t last_hits{ 0 }, last_misses{ 0 };
+        double best_hit_rate{ 0 };
+
+        S3FIFOTracker *trackers{ nullptr };
+};
+
+} // namespace star
@@ -0,0 +1,256 @@
+//
+// Software Cache-Coherence Manager
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include "common/CXLMemory.h"
+#include "protocol/Pasha/SCCManager.h"
+
+namespace star
+{
+
+/*
+ * Limited-pointer host set packed into 'Slots' 7-bit fields of a word,
+ * starting at bit 'Offset'. Each slot holds host_id + 1 (0 = empty), so the
+ * set covers pods of up to 127 hosts no matter how few slots it has.
+ *
+ * The set may overflow. Callers must treat "not in the set" as "unknown"
+ * (i.e., flush), never as "clean", which keeps the directory conservative.
+ */
+template <int Offset, int Slots> struct SCCHostSet {
+        static constexpr uint64_t slot_bits = 7;
+        static constexpr uint64_t slot_mask = (1ull << slot_bits) - 1;
+        static constexpr uint64_t max_host_num = slot_mask;
+        static constexpr uint64_t total_bits = slot_bits * Slots;
+
+        static_assert(Offset + total_bits <= 64, "host set does not fit into the word");
+
+        static uint64_t get_slot(uint64_t word, int i)
+        {
+                return (word >> (Offset + i * slot_bits)) & slot_mask;
+        }
+
+        static void set_slot(uint64_t &word, int i, uint64_t v)
+        {
+                word &= ~(slot_mask << (Offset + i * slot_bits));
+                word |= (v << (Offset + i * slot_bits));
+        }
+
+        static bool contains(uint64_t word, uint64_t host_id)
+        {
+                for (int i = 0; i < Slots; i++)
+                        if (get_slot(word, i) == host_id + 1)
+                                return true;
+                return false;
+        }
+
+        // returns false if the set is full and the host was not recorded
+        static bool insert(uint64_t &word, uint64_t host_id)
+        {
+                CHECK(host_id < max_host_num);
+                int free_slot = -1;
+                for (int i = 0; i < Slots; i++) {
+                        uint64_t v = get_slot(word, i);
+                        if (v == host_id + 1)
+                                return true;
+                        if (v == 0 && free_slot == -1)
+                                free_slot = i;
+                }
+                if (free_slot == -1)
+                        return false;
+                set_slot(word, free_slot, host_id + 1);
+                return true;
+        }
+
+        static void erase(uint64_t &word, uint64_t host_id)
+        {
+                for (int i = 0; i < Slots; i++)
+                        if (get_slot(word, i) == host_id + 1)
+                                set_slot(word, i, 0);
+        }
+
+        static void clear(uint64_t &word)
+        {
+                word &= ~(((1ull << total_bits) - 1) << Offset);
+        }
+
+        static bool empty(uint64_t word)
+        {
+                return ((word >> Offset) & ((1ull << total_bits) - 1)) == 0;
+        }
+
+        // calls func(host_id) for every recorded host
+        template <class Func> static void for_each(uint64_t word, Func func)
+        {
+                for (int i = 0; i < Slots; i++) {
+                        uint64_t v = get_slot(word, i);
+                        if (v != 0)
+                                func(v - 1);
+                }
+        }
+};
+
+/*
+ * Directory-based SCC with per-row dirty-line masks.
+ *
+ * Compared to SCCWriteThrough:
+ *   - writes only copy and write back the cache lines whose content changed;
+ *   - hosts that held a clean copy before a write only invalidate the lines
+ *     written since, instead of the whole row;
+ *   - the directory is a limited-pointer set instead of a 16-bit bitmap, so
+ *     pods are no longer capped at 16 hosts.
+ *
+ * Directory word layout (the 8-byte scc_meta of the row):
+ * bit 63 - 43: up to 3 hosts whose cached copy is fully up to date
+ * bit 42 - 22: up to 3 hosts whose cached copy is stale only in the lines of dirty_mask
+ * bit 21 - 16: unused
+ * bit 15 - 0:  dirty_mask; bit i covers the i-th group of ceil(#lines / 16) lines
+ */
+class SCCDirtyLine : public SCCManager {
+    public:
+        using CleanSet = SCCHostSet<43, 3>;
+        using StaleSet = SCCHostSet<22, 3>;
+
+        static constexpr uint64_t dirty_mask_bits = 16;
+        static constexpr uint64_t dirty_mask_mask = (1ull << dirty_mask_bits) - 1;
+
+        void init_scc_metadata(void *scc_meta, std::size_t cur_host_id) override
+        {
+                uint64_t *meta = reinterpret_cast<uint64_t *>(scc_meta);
+
+                // the row might reuse memory this host cached in a previous life,
+                // so nobody starts out clean; the first write copies everything
+                *meta = 0;
+        }
+
+        void do_read(void *scc_meta, std::size_t cur_host_id, void *dst, const void *src, uint64_t size) override
+        {
+                uint64_t *meta = reinterpret_cast<uint64_t *>(scc_meta);
+                uint64_t word = *meta;
+
+                if (CleanSet::contains(word, cur_host_id) == true) {
+                        // statistics
+                        num_cache_hit.fetch_add(1);
+                } else {
+                        if (StaleSet::contains(word, cur_host_id) == true) {
+                                // our copy was clean before the writes in dirty_mask
+                                flush_line_groups(src, size, word & dirty_mask_mask);
+                                StaleSet::erase(word, cur_host_id);
+                        } else {
+                                clflush(src, size);
+                        }
+                        CleanSet::insert(word, cur_host_id);
+                        *meta = word;
+
+                        // statistics
+                        num_cache_miss.fetch_add(1);
+                }
+
+                // do read
+                std::memcpy(dst, src, size);
+        }
+
+        void do_write(void *scc_meta, std::size_t cur_host_id, void *dst, const void *src, uint64_t size) override
+        {
+                uint64_t *meta = reinterpret_cast<uint64_t *>(scc_meta);
+                uint64_t word = *meta;
+                uint64_t write_mask = 0;
+
+                if (CleanSet::contains(word, cur_host_id) == false) {
+                        // our copy may be stale, so refresh it before diffing
+                        clflush(dst, size);
+                }
+
+                // copy only the lines that changed and write them back in one batch
+                uint64_t group_size = get_line_group_size(dst, size);
+                uint64_t lines = 0;
+                for_each_line(dst, size, [&](uint64_t line_idx, uint64_t off, uint64_t len) {
+                        char *d = reinterpret_cast<char *>(dst) + off;
+                        const char *s = reinterpret_cast<const char *>(src) + off;
+                        if (std::memcmp(d, s, len) != 0) {
+                                std::memcpy(d, s, len);
+                                _mm_clwb(d);
+                                write_mask |= 1ull << (line_idx / group_size);
+                                lines++;
+                        }
+                });
+                if (lines > 0) {
+                        _mm_sfence();
+                        model_flush_cost(lines);
+
+                        // statistics
+                        num_clwb.fetch_add(1);
+                        num_clwb_lines.fetch_add(lines);
+                }
+
+                // everyone else that was clean now misses exactly the lines we wrote
+                if (write_mask != 0) {
+                        if (StaleSet::empty(word) == true)
+                                word &= ~dirty_mask_mask;
+                        word |= write_mask;
+                        CleanSet::for_each(word, [&](uint64_t host_id) {
+                                if (host_id != cur_host_id)
+                                        StaleSet::insert(word, host_id);        // overflowing hosts fall back to full flushes
+                        });
+                        CleanSet::clear(word);
+                }
+                StaleSet::erase(word, cur_host_id);
+                CleanSet::insert(word, cur_host_id);
+                *meta = word;
+        }
+
+    protected:
+        // calls func(line_idx, offset, length) for every cache-line-aligned chunk of [addr, addr + size)
+        template <class Func> static void for_each_line(const void *addr, uint64_t size, Func func)
+        {
+                uint64_t start = reinterpret_cast<uint64_t>(addr);
+                uint64_t off = 0, line_idx = 0;
+
+                while (off < size) {
+                        uint64_t next_line = ((start + off) & ~(cacheline_size - 1)) + cacheline_size;
+                        uint64_t len = std::min(next_line - (start + off), size - off);
+                        func(line_idx, off, len);
+                        off += len;
+                        line_idx++;
+                }
+        }
+
+        static uint64_t get_line_num(const void *addr, uint64_t size)
+        {
+                uint64_t start = reinterpret_cast<uint64_t>(addr) & ~(cacheline_size - 1);
+                uint64_t end = reinterpret_cast<uint64_t>(addr) + size;
+                return (end - start + cacheline_size - 1) / cacheline_size;
+        }
+
+        static uint64_t get_line_group_size(const void *addr, uint64_t size)
+        {
+                uint64_t line_num = get_line_num(addr, size);
+                return std::max<uint64_t>(1, (line_num + dirty_mask_bits - 1) / dirty_mask_bits);
+        }
+
+        void flush_line_groups(const void *addr, uint64_t size, uint64_t mask)
+        {
+                uint64_t group_size = get_line_group_size(addr, size);
+                uint64_t base = reinterpret_cast<uint64_t>(addr) & ~(cacheline_size - 1);
+                uint64_t line_num = get_line_num(addr, size);
+                uint64_t lines = 0;
+
+                for (uint64_t line_idx = 0; line_idx < line_num; line_idx++) {
+                        if ((mask & (1ull << (line_idx / group_size))) == 0)
+                                continue;
+                        _mm_clflushopt(reinterpret_cast<void *>(base + line_idx * cacheline_size));
+                        lines++;
+                }
+                _mm_sfence();
+                model_flush_cost(lines);
+
+                // statistics
+                num_clflush.fetch_add(1);
+                num_clflush_lines.fetch_add(lines);
+        }
+};
+
+} // namespace star
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <atomic>
+#include <chrono>
 #include <immintrin.h>
 #include <xmmintrin.h>
 #include <glog/logging.h>
@@ -35,11 +36,23 @@ class SCCManager {
         virtual void prepare_read(void *scc_meta, std::size_t cur_host_id, void *scc_data, uint64_t size) {}
         virtual void finish_write(void *scc_meta, std::size_t cur_host_id, void *scc_data, uint64_t size) {}
 
+        // called once a transaction has released all of its locks; every write
+        // it made must have gone through finish_write by then
+        virtual void end_transaction(std::size_t cur_host_id) {}
+
+        // emulated latency of flushing or writing back one cache line (--scc_flush_cost)
+        void set_flush_cost(uint64_t flush_cost_ns)
+        {
+                this->flush_cost_ns = flush_cost_ns;
+        }
+
         void print_stats()
         {
                 LOG(INFO) << "software cache-coherence statistics:"
                           << " num_clflush: " << num_clflush
                           << " num_clwb: " << num_clwb
+                          << " num_clflush_lines: " << num_clflush_lines
+                          << " num_clwb_lines: " << num_clwb_lines
                           << " num_cache_hit: " << num_cache_hit
                           << " num_cache_miss: " << num_cache_miss
                           << " cache hit rate: " << 100.0 * num_cache_hit / (num_cache_hit + num_cache_miss) << "%";
@@ -50,8 +63,7 @@ class SCCManager {
 
         inline void clflush(const void *addr, uint64_t len)
         {
-                // statistics
-                num_clflush.fetch_add(1);
+                uint64_t lines = 0;
 
                 /*
                  * Loop through cache-line-size (typically 64B) aligned chunks
@@ -59,16 +71,21 @@ class SCCManager {
                  */
                 for (uint64_t ptr = (uint64_t)addr & ~(cacheline_size - 1); ptr < (uint64_t)addr + len; ptr += cacheline_size) {
                         _mm_clflushopt((void *)ptr);
+                        lines++;
                 }
 
+                // statistics
+                num_clflush.fetch_add(1);
+                num_clflush_lines.fetch_add(lines);
+
                 // make sure clflush completes before memcpy
                 _mm_sfence();
+                model_flush_cost(lines);
         }
 
         inline void clwb(const void *addr, uint64_t len)
         {
-                // statistics
-                num_clwb.fetch_add(1);
+                uint64_t lines = 0;
 
                 /*
                  * Loop through cache-line-size (typically 64B) aligned chunks
@@ -76,14 +93,38 @@ class SCCManager {
                  */
                 for (uint64_t ptr = (uint64_t)addr & ~(cacheline_size - 1); ptr < (uint64_t)addr + len; ptr += cacheline_size) {
                         _mm_clwb((void *)ptr);
+                        lines++;
                 }
 
+                // statistics
+                num_clwb.fetch_add(1);
+                num_clwb_lines.fetch_add(lines);
+
                 // make sure clwb completes before memcpy
                 _mm_sfence();
+                model_flush_cost(lines);
         }
 
+        /*
+         * On a pod emulated on one machine, flushes hit local DRAM and are much
+         * cheaper than on real CXL memory, so we charge the difference here.
+         */
+        inline void model_flush_cost(uint64_t lines)
+        {
+                if (flush_cost_ns == 0 || lines == 0)
+                        return;
+
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::nanoseconds(flush_cost_ns * lines);
+                while (std::chrono::steady_clock::now() < deadline)
+                        _mm_pause();
+        }
+
+        uint64_t flush_cost_ns = 0;
+
         std::atomic<uint64_t> num_clflush{ 0 };
         std::atomic<uint64_t> num_clwb{ 0 };
+        std::atomic<uint64_t> num_clflush_lines{ 0 };
+        std::atomic<uint64_t> num_clwb_lines{ 0 };
         std::atomic<uint64_t> num_cache_hit{ 0 };
         std::atomic<uint64_t> num_cache_miss{ 0 };
 };
@@ -7,9 +7,11 @@
 #include <string>
 
 #include "protocol/Pasha/SCCManager.h"
+#include "protocol/Pasha/SCCDirtyLine.h"
 #include "protocol/Pasha/SCCNonTemporal.h"
 #include "protocol/Pasha/SCCNoOP.h"
 #include "protocol/Pasha/SCCWriteThrough.h"
+#include "protocol/TwoPLPasha/TwoPLPashaSCCDirtyLine.h"
 #include "protocol/TwoPLPasha/TwoPLPashaSCCNonTemporal.h"
 #include "protocol/TwoPLPasha/TwoPLPashaSCCWriteThrough.h"
 #include "protocol/TwoPLPasha/TwoPLPashaSCCWriteThroughNoSharedRead.h"
@@ -19,7 +21,7 @@ namespace star
 
 class SCCManagerFactory {
     public:
-	static SCCManager *create_scc_manager(const std::string &protocol, const std::string &scc_mechanism)
+	static SCCManager *create_scc_manager(const std::string &protocol, const std::string &scc_mechanism, uint64_t flush_cost_ns)
 	{
                 SCCManager *scc_manager = nullptr;
 
@@ -30,6 +32,8 @@ class SCCManagerFactory {
                                 scc_manager = new SCCNoOP();
                         } else if (scc_mechanism == "WriteThrough") {
                                 scc_manager = new SCCWriteThrough();
+                        } else if (scc_mechanism == "DirtyLine") {
+                                scc_manager = new SCCDirtyLine();
                         } else {
                                 CHECK(0);
                         }
@@ -42,11 +46,17 @@ class SCCManagerFactory {
                                 scc_manager = new TwoPLPashaSCCWriteThrough();
                         } else if (scc_mechanism == "WriteThroughNoSharedRead") {
                                 scc_manager = new TwoPLPashaSCCWriteThroughNoSharedRead();
+                        } else if (scc_mechanism == "DirtyLine") {
+                                scc_manager = new TwoPLPashaSCCDirtyLine();
                         } else {
                                 CHECK(0);
                         }
                 }
 
+                if (scc_manager != nullptr) {
+                        scc_manager->set_flush_cost(flush_cost_ns);
+                }
+
 		return scc_manager;
 	}
 };
@@ -697,7 +697,6 @@ template <class Database> class SundialPasha {
 				} else {
 					txn.pendingResponses++;
 					auto coordinatorID = k;
-					messages[coordinatorID]->set_transaction_id(txn.transaction_id);
 					txn.network_size += MessageFactoryType::new_replication_message(*messages[coordinatorID], *table, writeKey.get_key(),
 													writeKey.get_value(), txn.commit_ts,
 													persist_replication[i][k]);
@@ -54,7 +54,7 @@ class SundialPashaExecutor : public Executor<Workload, SundialPasha<typename Wor
                                 context.partition_num, context.when_to_move_out, hw_cc_budget_per_host);
 
                         // init software cache-coherence manager
-                        scc_manager = SCCManagerFactory::create_scc_manager(context.protocol, context.scc_mechanism);
+                        scc_manager = SCCManagerFactory::create_scc_manager(context.protocol, context.scc_mechanism, context.scc_flush_cost);
 
                         // handle pre-migration
                         if (context.pre_migrate == "None") {
@@ -129,6 +129,9 @@ class SundialPashaExecutor : public Executor<Workload, SundialPasha<typename Wor
                                         // data is in the shared region
                                         bool success = true;
 
+                                        // the row is pinned, so other transactions can run while it is fetched
+                                        this->prefetch_and_yield(migrated_row);
+
                                         std::pair<uint64_t, uint64_t> rwts;
                                         if (write_lock) {
                                                 DCHECK(local_index_read == false);
@@ -280,7 +283,7 @@ class SundialPashaExecutor : public Executor<Workload, SundialPasha<typename Wor
                         return true;
 		};
 
-		txn.remote_request_handler = [this](std::size_t) { return this->process_request(); };
+		txn.remote_request_handler = [this](std::size_t) { return this->process_request_and_yield(); };
 		txn.message_flusher = [this]() { this->flush_messages(); };
 		txn.get_table = [this](std::size_t tableId, std::size_t partitionId) { return this->db.find_table(tableId, partitionId); };
 		txn.set_logger(this->logger);
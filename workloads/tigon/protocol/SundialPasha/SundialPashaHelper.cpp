@@ -9,6 +9,16 @@ uint64_t SundialPashaMetadataLocalInit(bool is_tuple_valid = true)
         return reinterpret_cast<uint64_t>(lmeta);
 }
 
+// local metadata is never freed, so the rows loaded together share one allocation
+void SundialPashaMetadataLocalInitBatch(uint64_t *metas, std::size_t count, bool is_tuple_valid = true)
+{
+        auto lmetas = new SundialPashaMetadataLocal[count];
+        for (std::size_t i = 0; i < count; i++) {
+                lmetas[i].is_valid = is_tuple_valid;
+                metas[i] = reinterpret_cast<uint64_t>(&lmetas[i]);
+        }
+}
+
 SundialPashaHelper *sundial_pasha_global_helper = nullptr;
 
 }
@@ -106,6 +106,7 @@ struct SundialPashaMetadataShared {
 };
 
 uint64_t SundialPashaMetadataLocalInit(bool is_tuple_valid);
+void SundialPashaMetadataLocalInitBatch(uint64_t *metas, std::size_t count, bool is_tuple_valid);
 
 /* 
  * lmeta means local metadata stored in local DRAM
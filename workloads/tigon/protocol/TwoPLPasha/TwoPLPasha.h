@@ -10,6 +10,7 @@
 
 #include "core/Partitioner.h"
 #include "core/Table.h"
+#include "common/WALRecovery.h"
 #include "protocol/TwoPLPasha/TwoPLPashaHelper.h"
 #include "protocol/TwoPLPasha/TwoPLPashaMessage.h"
 #include "protocol/TwoPLPasha/TwoPLPashaTransaction.h"
@@ -340,6 +341,12 @@ template <class Database> class TwoPLPasha {
 
 	bool commit(TransactionType &txn, std::vector<std::unique_ptr<Message> > &messages)
 	{
+                if (txn.snapshot_read_state == TransactionType::SNAPSHOT_READ_ON && txn.writeSet.empty() == false) {
+                        // the snapshot reads are not protected by locks - retry with locking
+                        txn.snapshot_read_candidate = false;
+                        txn.abort_lock = true;
+                }
+
 		if (txn.abort_lock) {
 			abort(txn, messages);
 			return false;
@@ -347,6 +354,17 @@ template <class Database> class TwoPLPasha {
 
                 uint64_t cur_global_epoch = txn.get_logger()->get_global_epoch();
 
+                // all locks are held, see TwoPLPashaHelper::get_commit_version_epoch()
+                uint64_t version_epoch = 0;
+                if (context.mvcc_snapshot_reads == true) {
+                        version_epoch = TwoPLPashaHelper::get_commit_version_epoch();
+                }
+
+                if (this->context.early_lock_release == true) {
+                        // past the lock point nothing can abort the transaction, and the reads are done
+                        release_read_locks(txn);
+                }
+
                 {
 			ScopedTimer t([&, this](uint64_t us) { txn.record_commit_prepare_time(us); });
 			if (txn.get_logger()) {
@@ -371,9 +389,7 @@ template <class Database> class TwoPLPasha {
                                 ScopedTimer t([&, this](uint64_t us) { txn.record_commit_persistence_time(us); });
                                 // Persist commit record
                                 if (txn.get_logger()) {
-                                        std::ostringstream ss;
-                                        ss << commit_tid << true;
-                                        auto output = ss.str();
+                                        auto output = WALRedoRecord::encode_commit(commit_tid);
                                         auto lsn = txn.get_logger()->write(output.c_str(), output.size(), true, txn.startTime);
                                         // txn.get_logger()->sync(lsn, [&](){ txn.remote_request_handler(); });
                                 }
@@ -523,7 +539,7 @@ template <class Database> class TwoPLPasha {
 		{
 			ScopedTimer t([&, this](uint64_t us) { txn.record_commit_write_back_time(us); });
 			// write and replicate
-			write_and_replicate(txn, commit_tid, messages);
+			write_and_replicate(txn, commit_tid, version_epoch, cur_global_epoch, messages);
 		}
 
 		// release locks
@@ -532,6 +548,7 @@ template <class Database> class TwoPLPasha {
 			// write and replicate
 			release_lock(txn, commit_tid, messages, cur_global_epoch);
 		}
+                scc_manager->end_transaction(this->context.coordinator_id);
 
                 // release migrated rows
                 release_migrated_rows(txn);
@@ -547,7 +564,7 @@ template <class Database> class TwoPLPasha {
 		return true;
 	}
 
-	void write_and_replicate(TransactionType &txn, uint64_t commit_tid, std::vector<std::unique_ptr<Message> > &messages)
+	void write_and_replicate(TransactionType &txn, uint64_t commit_tid, uint64_t version_epoch, uint64_t cur_global_epoch, std::vector<std::unique_ptr<Message> > &messages)
 	{
 		auto &readSet = txn.readSet;
 		auto &writeSet = txn.writeSet;
@@ -631,14 +648,27 @@ template <class Database> class TwoPLPasha {
                                                 twopl_pasha_global_helper->model_cxl_search_overhead(cached_row, tableId, partitionId, writeKey.get_key());
                                         }
 
-                                        twopl_pasha_global_helper->update(cached_row, value, value_size);
+                                        twopl_pasha_global_helper->update(cached_row, value, value_size, version_epoch);
+
+                                        if (this->context.early_lock_release == true) {
+                                                // this is the last write to the row, the next transaction can have it now
+                                                uint64_t epoch_version = generate_epoch_version(writeKey.get_tid(), cur_global_epoch);
+                                                twopl_pasha_global_helper->write_lock_release(*std::get<0>(cached_row), value_size, epoch_version);
+                                                writeKey.clear_write_lock_bit();
+                                        }
                                 } else {
                                         auto key = writeKey.get_key();
                                         auto value = writeKey.get_value();
                                         auto value_size = table->value_size();
                                         char *migrated_row = writeKey.get_cached_migrated_row();
                                         DCHECK(migrated_row != nullptr);
-                                        twopl_pasha_global_helper->remote_update(migrated_row, value, value_size);
+                                        twopl_pasha_global_helper->remote_update(migrated_row, value, value_size, version_epoch);
+
+                                        if (this->context.early_lock_release == true) {
+                                                uint64_t epoch_version = generate_epoch_version(writeKey.get_tid(), cur_global_epoch);
+                                                twopl_pasha_global_helper->remote_write_lock_release(migrated_row, value_size, epoch_version);
+                                                writeKey.clear_write_lock_bit();
+                                        }
                                 }
                         }
                 }
@@ -661,14 +691,14 @@ template <class Database> class TwoPLPasha {
                                                         auto value_size = table->value_size();
                                                         std::tuple<MetaDataType *, void *> row = std::make_tuple(scan_results[i].meta, scan_results[i].data);
                                                         DCHECK(std::get<0>(row) != nullptr && std::get<1>(row) != nullptr);
-                                                        twopl_pasha_global_helper->update(row, value, value_size);
+                                                        twopl_pasha_global_helper->update(row, value, value_size, version_epoch);
                                                 }
                                         } else {
                                                 for (auto i = 0u; i < scan_results.size(); i++) {
                                                         char *cxl_row = reinterpret_cast<char *>(scan_results[i].meta);
                                                         TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(cxl_row);
                                                         auto value_size = table->value_size();
-                                                        twopl_pasha_global_helper->remote_update(cxl_row, smeta->get_scc_data()->data, value_size);
+                                                        twopl_pasha_global_helper->remote_update(cxl_row, smeta->get_scc_data()->data, value_size, version_epoch);
                                                 }
                                         }
                                 }
@@ -704,12 +734,9 @@ template <class Database> class TwoPLPasha {
                         auto tid = writeKey.get_tid();
                         DCHECK(key);
                         DCHECK(value);
-                        std::ostringstream ss;
 
-                        int log_type = 0;       // 0 stands for update
                         uint64_t epoch_version = generate_epoch_version(tid, cur_global_epoch);
-                        ss << log_type << tableId << partitionId << epoch_version << std::string((char *)key, key_size) << std::string((char *)value, value_size);
-                        auto output = ss.str();
+                        auto output = WALRedoRecord::encode(WALRedoRecord::UPDATE, tableId, partitionId, epoch_version, key, key_size, value, value_size);
                         txn.get_logger()->write(output.c_str(), output.size(), false, txn.startTime);
                 }
 
@@ -729,12 +756,9 @@ template <class Database> class TwoPLPasha {
                         auto tid = insertKey.get_tid();
                         DCHECK(key);
                         DCHECK(value);
-                        std::ostringstream ss;
 
-                        int log_type = 1;       // 1 stands for insert
                         uint64_t epoch_version = generate_epoch_version(tid, cur_global_epoch);
-                        ss << log_type << tableId << partitionId << epoch_version << std::string((char *)key, key_size) << std::string((char *)value, value_size);
-                        auto output = ss.str();
+                        auto output = WALRedoRecord::encode(WALRedoRecord::INSERT, tableId, partitionId, epoch_version, key, key_size, value, value_size);
                         txn.get_logger()->write(output.c_str(), output.size(), false, txn.startTime);
                 }
 
@@ -752,26 +776,21 @@ template <class Database> class TwoPLPasha {
                         auto tid = deleteKey.get_tid();
                         DCHECK(key);
                         DCHECK(value);
-                        std::ostringstream ss;
 
-                        int log_type = 2;       // 2 stands for delete
                         uint64_t epoch_version = generate_epoch_version(tid, cur_global_epoch);
-                        ss << log_type << tableId << partitionId << epoch_version << std::string((char *)key, key_size);     // do not need to log value for deletes
-                        auto output = ss.str();
+                        auto output = WALRedoRecord::encode(WALRedoRecord::DELETE, tableId, partitionId, epoch_version, key, key_size, nullptr, 0);     // do not need to log value for deletes
                         txn.get_logger()->write(output.c_str(), output.size(), false, txn.startTime);
                 }
 	}
 
-	void release_lock(TransactionType &txn, uint64_t commit_tid, std::vector<std::unique_ptr<Message> > &messages, uint64_t cur_global_epoch)
-	{
-		// release read locks & write locks
+        void release_read_locks(TransactionType &txn)
+        {
 		auto &readSet = txn.readSet;
 
 		for (auto i = 0u; i < readSet.size(); i++) {
 			auto &readKey = readSet[i];
 			auto tableId = readKey.get_table_id();
 			auto partitionId = readKey.get_partition_id();
-			auto table = db.find_table(tableId, partitionId);
 			if (readKey.get_read_lock_bit()) {
 				if (partitioner.has_master_partition(partitionId)) {
 					auto cached_row = readKey.get_cached_local_row();
@@ -788,7 +807,23 @@ template <class Database> class TwoPLPasha {
                                         DCHECK(migrated_row != nullptr);
                                         twopl_pasha_global_helper->remote_read_lock_release(migrated_row);
 				}
+                                readKey.clear_read_lock_bit();
 			}
+		}
+        }
+
+	void release_lock(TransactionType &txn, uint64_t commit_tid, std::vector<std::unique_ptr<Message> > &messages, uint64_t cur_global_epoch)
+	{
+		// release read locks & write locks
+		auto &readSet = txn.readSet;
+
+                release_read_locks(txn);
+
+		for (auto i = 0u; i < readSet.size(); i++) {
+			auto &readKey = readSet[i];
+			auto tableId = readKey.get_table_id();
+			auto partitionId = readKey.get_partition_id();
+			auto table = db.find_table(tableId, partitionId);
 
                         if (readKey.get_write_lock_bit()) {
 				if (partitioner.has_master_partition(partitionId)) {
@@ -905,21 +940,22 @@ template <class Database> class TwoPLPasha {
                                                 }
                                         }
                                 } else if (scanKey.get_request_type() == TwoPLPashaRWKey::SCAN_FOR_UPDATE) {
-                                        // release write locks for updates
+                                        // release write locks for updates; the rows were written,
+                                        // so their dirty lines must be written back on release
                                         if (partitioner.has_master_partition(partitionId)) {
                                                 for (auto i = 0u; i < scan_results.size(); i++) {
                                                         auto key = reinterpret_cast<const void *>(scan_results[i].key);
                                                         std::atomic<uint64_t> *meta = scan_results[i].meta;
                                                         DCHECK(meta != nullptr);
                                                         // TODO: update epoch-version
-                                                        TwoPLPashaHelper::write_lock_release(*meta);
+                                                        twopl_pasha_global_helper->write_lock_release(*meta, table->value_size(), commit_tid);
                                                 }
                                         } else {
                                                 for (auto i = 0u; i < scan_results.size(); i++) {
                                                         char *cxl_row = reinterpret_cast<char *>(scan_results[i].meta);
                                                         DCHECK(cxl_row != nullptr);
                                                         // TODO: update epoch-version
-                                                        TwoPLPashaHelper::remote_write_lock_release(cxl_row);
+                                                        twopl_pasha_global_helper->remote_write_lock_release(cxl_row, table->value_size(), commit_tid);
                                                 }
                                         }
                                 } else if (scanKey.get_request_type() == TwoPLPashaRWKey::SCAN_FOR_INSERT) {
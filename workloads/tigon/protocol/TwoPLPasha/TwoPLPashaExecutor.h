@@ -54,7 +54,7 @@ class TwoPLPashaExecutor : public Executor<Workload, TwoPLPasha<typename Workloa
                                 context.partition_num, context.when_to_move_out, hw_cc_budget_per_host);
 
                         // init software cache-coherence manager
-                        scc_manager = SCCManagerFactory::create_scc_manager(context.protocol, context.scc_mechanism);
+                        scc_manager = SCCManagerFactory::create_scc_manager(context.protocol, context.scc_mechanism, context.scc_flush_cost);
 
                         // handle pre-migration
                         if (context.pre_migrate == "None") {
@@ -76,8 +76,78 @@ class TwoPLPashaExecutor : public Executor<Workload, TwoPLPasha<typename Workloa
 
 	~TwoPLPashaExecutor() = default;
 
+        /*
+         * With --lock_wait_policy=WaitDie, a transaction that fails to take a lock queues up in the row's
+         * waiter queue if wait-die lets it, spins on its waiter node while serving requests and letting
+         * the other in-flight transactions run, and takes the lock again once woken up. Returns false
+         * if the transaction has to abort instead: it is younger than a holder, or waits too long.
+         */
+        template <class TakeLock, class Enqueue, class Cancel>
+        bool wait_for_lock(TransactionType &txn, bool write_lock, TakeLock take_lock, Enqueue enqueue, Cancel cancel)
+        {
+                if (lock_waiters.empty()) {
+                        // one waiter per in-flight transaction, allocated by the worker thread
+                        lock_waiters.resize(this->context.coroutine_num + 1);
+                        for (auto i = 0u; i < lock_waiters.size(); i++) {
+                                void *waiter = cxl_memory.cxlalloc_malloc_wrapper(sizeof(TwoPLPashaLockWaiter), CXLMemory::MISC_ALLOCATION);
+                                CHECK(waiter != nullptr);
+                                lock_waiters[i] = new (waiter) TwoPLPashaLockWaiter();
+                        }
+                }
+
+                TwoPLPashaLockWaiter *waiter = lock_waiters[this->running_slot];
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(this->context.lock_wait_timeout_us);
+
+                for (;;) {
+                        waiter->reset(txn.lock_wait_ts(), write_lock);
+                        auto res = enqueue(waiter);
+                        if (res == TwoPLPashaHelper::lock_wait_result::DIE) {
+                                return false;
+                        }
+
+                        if (res == TwoPLPashaHelper::lock_wait_result::WAIT) {
+                                while (waiter->woken.load(std::memory_order_acquire) == false) {
+                                        if (std::chrono::steady_clock::now() > deadline) {
+                                                cancel(waiter);
+                                                return false;
+                                        }
+                                        this->process_request_and_yield();
+                                }
+                        }
+
+                        if (take_lock() == true) {
+                                return true;
+                        }
+
+                        // someone else got the lock first
+                        if (std::chrono::steady_clock::now() > deadline) {
+                                cancel(waiter);
+                                return false;
+                        }
+                }
+        }
+
+        // snapshot reads only pay off for transactions reading rows that are likely in CXL
+        bool is_snapshot_read_candidate(TransactionType &txn)
+        {
+                if (this->context.mvcc_snapshot_reads == false) {
+                        return false;
+                }
+                if (this->context.pre_migrate == "All") {
+                        return true;
+                }
+                for (int32_t i = 0; i < txn.get_partition_count(); i++) {
+                        if (this->partitioner->has_master_partition(txn.get_partition(i)) == false) {
+                                return true;
+                        }
+                }
+                return false;
+        }
+
 	void setupHandlers(TransactionType &txn) override
 	{
+                txn.snapshot_read_candidate = is_snapshot_read_candidate(txn);
+
 		txn.lock_request_handler = [this, &txn](std::size_t table_id, std::size_t partition_id, uint32_t key_offset, const void *key, void *value,
 							bool local_index_read, bool write_lock, std::tuple<star::ITable::MetaDataType *, void *> &cached_local_row,
                                                         char *&cached_migrated_row, bool &success, bool &remote) -> uint64_t {
@@ -91,6 +161,32 @@ class TwoPLPashaExecutor : public Executor<Workload, TwoPLPasha<typename Workloa
 				return twopl_pasha_global_helper->read(row, value, value_bytes, this->n_local_cxl_access);
 			}
 
+                        if (txn.snapshot_read_state == TransactionType::SNAPSHOT_READ_ON) {
+                                DCHECK(write_lock == false);
+                                remote = false;
+
+                                if (this->partitioner->has_master_partition(partition_id)) {
+                                        // statistics
+                                        this->n_local_access.fetch_add(1);
+
+                                        auto row = table->search(key);
+                                        DCHECK(std::get<0>(row) != nullptr && std::get<1>(row) != nullptr);
+                                        success = twopl_pasha_global_helper->local_snapshot_read(row, value, table->value_size(), txn.snapshot_epoch);
+                                } else {
+                                        // statistics
+                                        this->n_remote_access.fetch_add(1);
+
+                                        txn.distributed_transaction = true;
+                                        success = twopl_pasha_global_helper->remote_snapshot_read(table_id, partition_id, key, value, table->value_size(), txn.snapshot_epoch);
+                                }
+
+                                if (success == false) {
+                                        // the row is in local memory or no version is old enough - retry with locking
+                                        txn.snapshot_read_candidate = false;
+                                }
+                                return 0;
+                        }
+
 			if (this->partitioner->has_master_partition(partition_id)) {
                                 // statistics
                                 this->n_local_access.fetch_add(1);
@@ -108,11 +204,20 @@ class TwoPLPashaExecutor : public Executor<Workload, TwoPLPasha<typename Workloa
 
                                 uint64_t tid = 0;
 
-				if (write_lock) {
-					tid = twopl_pasha_global_helper->take_write_lock_and_read(row, value, table->value_size(), success, this->n_local_cxl_access);
-				} else {
-					tid = twopl_pasha_global_helper->take_read_lock_and_read(row, value, table->value_size(), success, this->n_local_cxl_access);
-				}
+                                auto take_lock = [&]() {
+                                        if (write_lock) {
+                                                tid = twopl_pasha_global_helper->take_write_lock_and_read(row, value, table->value_size(), success, this->n_local_cxl_access, txn.lock_wait_ts());
+                                        } else {
+                                                tid = twopl_pasha_global_helper->take_read_lock_and_read(row, value, table->value_size(), success, this->n_local_cxl_access, txn.lock_wait_ts());
+                                        }
+                                        return success;
+                                };
+
+                                if (take_lock() == false && TwoPLPashaHelper::lock_wait_enabled == true) {
+                                        success = this->wait_for_lock(txn, write_lock, take_lock,
+                                                [&](TwoPLPashaLockWaiter *waiter) { return twopl_pasha_global_helper->enqueue_lock_waiter(row, table->value_size(), waiter); },
+                                                [&](TwoPLPashaLockWaiter *waiter) { twopl_pasha_global_helper->cancel_lock_waiter(row, waiter); });
+                                }
 
 				if (success == true) {
 					return tid;
@@ -137,6 +242,9 @@ class TwoPLPashaExecutor : public Executor<Workload, TwoPLPasha<typename Workloa
                                 if (migrated_row != nullptr) {
                                         remote = false;
 
+                                        // the row is pinned, so other transactions can run while it is fetched
+                                        this->prefetch_and_yield(migrated_row);
+
                                         // cache migrated row pointer
                                         cached_migrated_row = migrated_row;
 
@@ -145,10 +253,19 @@ class TwoPLPashaExecutor : public Executor<Workload, TwoPLPasha<typename Workloa
                                         // mark it as reference counted so that we know if we need to release it upon commit/abort
                                         txn.readSet[key_offset].set_reference_counted();
 
-                                        if (write_lock) {
-                                                tid = twopl_pasha_global_helper->remote_take_write_lock_and_read(migrated_row, value, table->value_size(), false, success);
-                                        } else {
-                                                tid = twopl_pasha_global_helper->remote_take_read_lock_and_read(migrated_row, value, table->value_size(), false, success);
+                                        auto take_lock = [&]() {
+                                                if (write_lock) {
+                                                        tid = twopl_pasha_global_helper->remote_take_write_lock_and_read(migrated_row, value, table->value_size(), false, success, txn.lock_wait_ts());
+                                                } else {
+                                                        tid = twopl_pasha_global_helper->remote_take_read_lock_and_read(migrated_row, value, table->value_size(), false, success, txn.lock_wait_ts());
+                                                }
+                                                return success;
+                                        };
+
+                                        if (take_lock() == false && TwoPLPashaHelper::lock_wait_enabled == true) {
+                                                success = this->wait_for_lock(txn, write_lock, take_lock,
+                                                        [&](TwoPLPashaLockWaiter *waiter) { return twopl_pasha_global_helper->remote_enqueue_lock_waiter(migrated_row, table->value_size(), waiter); },
+                                                        [&](TwoPLPashaLockWaiter *waiter) { twopl_pasha_global_helper->remote_cancel_lock_waiter(migrated_row, waiter); });
                                         }
 
                                         if (success == true) {
@@ -553,10 +670,14 @@ class TwoPLPashaExecutor : public Executor<Workload, TwoPLPasha<typename Workloa
                         };
                 };
 
-		txn.remote_request_handler = [this](std::size_t) { return this->process_request(); };
+		txn.remote_request_handler = [this](std::size_t) { return this->process_request_and_yield(); };
 		txn.message_flusher = [this]() { this->flush_messages(); };
 		txn.get_table = [this](std::size_t tableId, std::size_t partitionId) { return this->db.find_table(tableId, partitionId); };
 		txn.set_logger(this->logger);
 	};
+
+    private:
+        // indexed by the running slot, see wait_for_lock()
+        std::vector<TwoPLPashaLockWaiter *> lock_waiters;
 };
 } // namespace star
@@ -9,6 +9,18 @@ uint64_t TwoPLPashaMetadataLocalInit(bool is_tuple_valid = true)
         return reinterpret_cast<uint64_t>(lmeta);
 }
 
+// local metadata is never freed, so the rows loaded together share one allocation
+void TwoPLPashaMetadataLocalInitBatch(uint64_t *metas, std::size_t count, bool is_tuple_valid = true)
+{
+        auto lmetas = new TwoPLPashaMetadataLocal[count];
+        for (std::size_t i = 0; i < count; i++) {
+                lmetas[i].is_valid = is_tuple_valid;
+                metas[i] = reinterpret_cast<uint64_t>(&lmetas[i]);
+        }
+}
+
 TwoPLPashaHelper *twopl_pasha_global_helper = nullptr;
 
+bool TwoPLPashaHelper::lock_wait_enabled = false;
+
 }
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <list>
 #include <tuple>
@@ -12,6 +13,7 @@
 #include "common/CCSet.h"
 #include "common/CCHashTable.h"
 #include "common/CXLMemory.h"
+#include "common/atomic_offset_ptr.hpp"
 #include "common/CXL_EBR.h"
 #include "core/Context.h"
 #include "core/CXLTable.h"
@@ -26,6 +28,125 @@
 namespace star
 {
 
+// an older version of a migrated row, see TwoPLPashaHelper::write_versioned()
+struct TwoPLPashaVersion {
+        uint64_t version_epoch{ 0 };
+
+        AtomicOffsetPtr<TwoPLPashaVersion> prev_version;
+
+        char data[];
+};
+
+// a transaction waiting for a row lock, allocated in CXL memory so that any host can wake it up
+struct TwoPLPashaLockWaiter {
+        void reset(uint64_t ts, bool write_lock)
+        {
+                this->ts = ts;
+                this->write_lock = write_lock;
+                next.store(nullptr);
+                woken.store(false, std::memory_order_release);
+        }
+
+        // wait-die priority of the waiting transaction, smaller is older
+        uint64_t ts{ 0 };
+
+        bool write_lock{ false };
+
+        // set by the transaction that frees the row, the waiter spins on it
+        std::atomic<bool> woken{ false };
+
+        AtomicOffsetPtr<TwoPLPashaLockWaiter> next;
+};
+
+/*
+ * Waiters for a row lock with --lock_wait_policy=WaitDie, see TwoPLPashaHelper::enqueue_lock_waiter().
+ *
+ * The queue sits in the local metadata of a row, or in hardware-coherent CXL memory once the row is
+ * migrated (every host updates it, see TwoPLPashaSharedDataSCC::lock_queue), and is only modified under
+ * the row latch. Each waiter spins on its own node (MCS style) until the transaction that frees the
+ * row wakes the writer or the run of readers at the head.
+ *
+ * holder_ts is the smallest priority among the holders and waiters since the row was last free; 0 if
+ * one of the holders did not say (scans, messages). A transaction only waits if it is older than
+ * holder_ts, so every wait is for younger transactions and no cycle can form.
+ */
+struct TwoPLPashaLockQueue {
+        void init(uint64_t holder_ts)
+        {
+                this->holder_ts = holder_ts;
+                head.store(nullptr);
+        }
+
+        void push(TwoPLPashaLockWaiter *waiter)
+        {
+                TwoPLPashaLockWaiter *cur = head.load();
+                if (cur == nullptr) {
+                        head.store(waiter);
+                        return;
+                }
+                while (cur->next.load() != nullptr) {
+                        cur = cur->next.load();
+                }
+                cur->next.store(waiter);
+        }
+
+        void remove(TwoPLPashaLockWaiter *waiter)
+        {
+                TwoPLPashaLockWaiter *prev = nullptr, *cur = head.load();
+                while (cur != nullptr && cur != waiter) {
+                        prev = cur;
+                        cur = cur->next.load();
+                }
+                if (cur == nullptr) {
+                        // already woken up
+                        return;
+                }
+                if (prev == nullptr) {
+                        head.store(cur->next.load());
+                } else {
+                        prev->next.store(cur->next.load());
+                }
+        }
+
+        // called when the row becomes free
+        void wake_head()
+        {
+                TwoPLPashaLockWaiter *cur = head.load();
+                if (cur != nullptr) {
+                        bool readers = (cur->write_lock == false);
+                        do {
+                                // the waiter may reuse its node as soon as it is woken up
+                                TwoPLPashaLockWaiter *next = cur->next.load();
+                                cur->woken.store(true, std::memory_order_release);
+                                cur = next;
+                        } while (readers == true && cur != nullptr && cur->write_lock == false);
+                }
+                head.store(cur);
+
+                // the woken transactions count again once they get the lock
+                holder_ts = UINT64_MAX;
+                for (; cur != nullptr; cur = cur->next.load()) {
+                        holder_ts = std::min(holder_ts, cur->ts);
+                }
+        }
+
+        // called when the row moves between local and CXL memory, the waiters retry at the new place
+        void wake_all()
+        {
+                TwoPLPashaLockWaiter *cur = head.load();
+                while (cur != nullptr) {
+                        TwoPLPashaLockWaiter *next = cur->next.load();
+                        cur->woken.store(true, std::memory_order_release);
+                        cur = next;
+                }
+                head.store(nullptr);
+        }
+
+        uint64_t holder_ts{ UINT64_MAX };
+
+        AtomicOffsetPtr<TwoPLPashaLockWaiter> head;
+};
+
 struct TwoPLPashaSharedDataSCC {
         TwoPLPashaSharedDataSCC()
                 : tid(0)
@@ -35,6 +156,9 @@ struct TwoPLPashaSharedDataSCC {
 
         static constexpr int valid_flag_index = 0;
 
+        // the data cannot be placed in any snapshot, e.g., it has been inserted or deleted in place
+        static constexpr uint64_t unversioned = UINT64_MAX;
+
         bool get_flag(int flag_index) {
                 return (flags & (1 << flag_index)) != 0;
         }
@@ -61,6 +185,16 @@ struct TwoPLPashaSharedDataSCC {
         // TODO: should be moved to HWcc ultimately
         char migration_policy_meta[MigrationManager::migration_policy_meta_size];
 
+        // multi-version concurrency control (only with --mvcc_snapshot_reads)
+        // the epoch in which the current data was written, and the older versions newest first
+        std::atomic<uint64_t> version_epoch{ 0 };
+        AtomicOffsetPtr<TwoPLPashaVersion> prev_version;
+
+        // lock waiters (only with --lock_wait_policy=WaitDie, nullptr otherwise). Hosts change the queue
+        // without prepare_read / finish_write, so it is allocated in hardware-coherent memory; the
+        // pointer is set when the row is moved in and stays until it is moved out.
+        AtomicOffsetPtr<TwoPLPashaLockQueue> lock_queue;
+
         char data[];
 };
 
@@ -100,6 +234,9 @@ struct TwoPLPashaMetadataLocal {
         char *migrated_row{ nullptr };
 
         TwoPLPashaSharedDataSCC *scc_data{ nullptr };
+
+        // lock waiters while the row is not migrated (only with --lock_wait_policy=WaitDie)
+        TwoPLPashaLockQueue lock_queue;
 };
 
 struct TwoPLPashaMetadataShared {
@@ -276,6 +413,18 @@ retry:
                 set_bit(host_id + SCC_BITS_OFFSET);
         }
 
+        uint64_t get_scc_bits()
+        {
+                return (atomic_word.load(std::memory_order_acquire) >> SCC_BITS_OFFSET) & SCC_BITS_MASK;
+        }
+
+        void set_scc_bits(uint64_t scc_bits)
+        {
+                uint64_t orig_atomic_word = atomic_word.load(std::memory_order_acquire);
+                orig_atomic_word &= ~(SCC_BITS_MASK << SCC_BITS_OFFSET);
+                atomic_word.store(orig_atomic_word | ((scc_bits & SCC_BITS_MASK) << SCC_BITS_OFFSET), std::memory_order_release);
+        }
+
 	static constexpr int LATCH_BIT_OFFSET = 63;
 	static constexpr uint64_t LATCH_BIT_MASK = 0x1ull;
 
@@ -312,6 +461,7 @@ retry:
 };
 
 uint64_t TwoPLPashaMetadataLocalInit(bool is_tuple_valid);
+void TwoPLPashaMetadataLocalInitBatch(uint64_t *metas, std::size_t count, bool is_tuple_valid);
 
 class TwoPLPashaHelper {
     public:
@@ -322,6 +472,7 @@ class TwoPLPashaHelper {
                 , context(context)
                 , cxl_tbl_vecs(cxl_tbl_vecs)
         {
+                lock_wait_enabled = (context.lock_wait_policy == "WaitDie");
         }
 
 	uint64_t read(const std::tuple<MetaDataType *, void *> &row, void *dest, std::size_t size, std::atomic<uint64_t> &local_cxl_access)
@@ -362,7 +513,7 @@ class TwoPLPashaHelper {
 		CHECK(0);
 	}
 
-        void update(const std::tuple<MetaDataType *, void *> &row, const void *value, std::size_t value_size)
+        void update(const std::tuple<MetaDataType *, void *> &row, const void *value, std::size_t value_size, uint64_t version_epoch)
 	{
 		MetaDataType &meta = *std::get<0>(row);
                 TwoPLPashaMetadataLocal *lmeta = reinterpret_cast<TwoPLPashaMetadataLocal *>(meta.load());
@@ -380,14 +531,18 @@ class TwoPLPashaHelper {
 
                         smeta->lock();
                         DCHECK(scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index) == true);
-                        scc_manager->do_write(nullptr, coordinator_id, data_ptr, value, value_size);
+                        if (context.mvcc_snapshot_reads == true) {
+                                write_versioned(scc_data, value, value_size, version_epoch);
+                        } else {
+                                scc_manager->do_write(nullptr, coordinator_id, data_ptr, value, value_size);
+                        }
                         smeta->set_is_data_modified_since_moved_in();
                         smeta->unlock();
                 }
 		lmeta->unlock();
 	}
 
-        void remote_update(char *row, const void *value, std::size_t value_size)
+        void remote_update(char *row, const void *value, std::size_t value_size, uint64_t version_epoch)
 	{
 		TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(row);
                 TwoPLPashaSharedDataSCC *scc_data = smeta->get_scc_data();
@@ -395,11 +550,185 @@ class TwoPLPashaHelper {
 
 		smeta->lock();
                 DCHECK(scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index) == true);
-                scc_manager->do_write(nullptr, coordinator_id, data_ptr, value, value_size);
+                if (context.mvcc_snapshot_reads == true) {
+                        write_versioned(scc_data, value, value_size, version_epoch);
+                } else {
+                        scc_manager->do_write(nullptr, coordinator_id, data_ptr, value, value_size);
+                }
                 smeta->set_is_data_modified_since_moved_in();
                 smeta->unlock();
 	}
 
+        /*
+         * Multi-version concurrency control for migrated rows.
+         *
+         * Versions are stamped with the CXL-wide EBR epoch. A committing transaction holds all its locks
+         * and stamps its writes with global epoch + 2; a snapshot is the global epoch when it is taken.
+         * The global epoch advances only after every thread has entered the current one, and a thread
+         * stays in one epoch for a whole transaction, so a transaction that may still write has a stamp
+         * above every snapshot taken meanwhile, and the transactions stamped at or below a snapshot have
+         * finished. Stamps also follow lock order, so a snapshot is a consistent cut.
+         *
+         * The writer keeps the data it overwrites on a short chain hanging off the row. Snapshot readers
+         * neither latch nor lock the row: they copy the current data when it is old enough and
+         * unlocked, or the newest version on the chain that is, and fall back to locking otherwise.
+         * Versions no snapshot can still need are reclaimed through EBR.
+         */
+        static uint64_t get_commit_version_epoch()
+        {
+                return global_ebr_meta->get_global_epoch() + 2;
+        }
+
+        static uint64_t get_snapshot_epoch()
+        {
+                return global_ebr_meta->get_global_epoch();
+        }
+
+        // called with the CXL latch held
+        void write_versioned(TwoPLPashaSharedDataSCC *scc_data, const void *value, std::size_t value_size, uint64_t version_epoch)
+        {
+                uint64_t cur_version_epoch = scc_data->version_epoch.load(std::memory_order_relaxed);
+                bool keep_versions = true;
+
+                if (value == scc_data->data) {
+                        // scan_for_update modified the row in place, so the previous version is gone
+                        keep_versions = false;
+                } else if (cur_version_epoch < version_epoch) {
+                        TwoPLPashaVersion *version = reinterpret_cast<TwoPLPashaVersion *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(TwoPLPashaVersion) + value_size, CXLMemory::DATA_ALLOCATION));
+                        if (version != nullptr) {
+                                version->version_epoch = cur_version_epoch;
+                                std::memcpy(version->data, scc_data->data, value_size);
+                                version->prev_version.store(scc_data->prev_version.load());
+                                scc_data->prev_version.store(version);
+                        } else {
+                                keep_versions = false;
+                        }
+                } else if (cur_version_epoch > version_epoch) {
+                        // unversioned, or moved in after this transaction took its stamp
+                        keep_versions = false;
+                }
+
+                if (keep_versions == true) {
+                        prune_versions(scc_data, value_size);
+                } else {
+                        retire_versions(scc_data, value_size);
+                }
+
+                scc_manager->do_write(nullptr, coordinator_id, scc_data->data, value, value_size);
+                scc_data->version_epoch.store(version_epoch, std::memory_order_release);
+        }
+
+        // called with the CXL latch held
+        void init_versions(TwoPLPashaSharedDataSCC *scc_data)
+        {
+                // the data was committed before the row was moved in
+                scc_data->version_epoch.store(get_commit_version_epoch(), std::memory_order_release);
+                scc_data->prev_version.store(nullptr);
+        }
+
+        // called with the CXL latch held
+        void prune_versions(TwoPLPashaSharedDataSCC *scc_data, std::size_t value_size)
+        {
+                // running snapshots are at least global epoch - 1, and each needs the newest version at or below it
+                uint64_t global_epoch = global_ebr_meta->get_global_epoch();
+                uint64_t oldest_snapshot_epoch = global_epoch > 0 ? global_epoch - 1 : 0;
+
+                TwoPLPashaVersion *version = scc_data->prev_version.load();
+                while (version != nullptr && version->version_epoch > oldest_snapshot_epoch) {
+                        version = version->prev_version.load();
+                }
+                if (version == nullptr) {
+                        return;
+                }
+
+                TwoPLPashaVersion *garbage = version->prev_version.load();
+                version->prev_version.store(nullptr);
+                retire_version_chain(garbage, value_size);
+        }
+
+        // called with the CXL latch held
+        void retire_versions(TwoPLPashaSharedDataSCC *scc_data, std::size_t value_size)
+        {
+                TwoPLPashaVersion *garbage = scc_data->prev_version.load();
+                scc_data->prev_version.store(nullptr);
+                retire_version_chain(garbage, value_size);
+        }
+
+        // snapshot readers may still be walking the chain
+        void retire_version_chain(TwoPLPashaVersion *garbage, std::size_t value_size)
+        {
+                while (garbage != nullptr) {
+                        TwoPLPashaVersion *next = garbage->prev_version.load();
+                        cxl_memory.cxlalloc_free_wrapper(garbage, sizeof(TwoPLPashaVersion) + value_size, CXLMemory::DATA_FREE);
+                        global_ebr_meta->add_retired_object(garbage, sizeof(TwoPLPashaVersion) + value_size, CXLMemory::DATA_FREE);
+                        garbage = next;
+                }
+        }
+
+        // returns false if the snapshot has to fall back to locking
+        static bool snapshot_read(char *row, void *dest, std::size_t size, uint64_t snapshot_epoch)
+        {
+                TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(row);
+                TwoPLPashaSharedDataSCC *scc_data = smeta->get_scc_data();
+
+                uint64_t version_epoch = scc_data->version_epoch.load(std::memory_order_acquire);
+                if (version_epoch == TwoPLPashaSharedDataSCC::unversioned) {
+                        return false;
+                }
+
+                if (version_epoch <= snapshot_epoch) {
+                        // the lock holder may be modifying the data in place, e.g., scan_for_update
+                        if (smeta->is_write_locked() == true) {
+                                return false;
+                        }
+                        std::memcpy(dest, scc_data->data, size);
+                        bool is_valid = scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
+                        std::atomic_thread_fence(std::memory_order_acquire);
+
+                        // a writer might have locked and overwritten the row while we were copying
+                        return is_valid == true && smeta->is_write_locked() == false &&
+                               scc_data->version_epoch.load(std::memory_order_relaxed) == version_epoch;
+                }
+
+                // older versions are immutable
+                TwoPLPashaVersion *version = scc_data->prev_version.load();
+                while (version != nullptr) {
+                        if (version->version_epoch <= snapshot_epoch) {
+                                std::memcpy(dest, version->data, size);
+                                return true;
+                        }
+                        version = version->prev_version.load();
+                }
+                return false;
+        }
+
+        // used for local point queries of snapshot transactions
+        bool local_snapshot_read(const std::tuple<MetaDataType *, void *> &row, void *dest, std::size_t size, uint64_t snapshot_epoch)
+        {
+                MetaDataType &meta = *std::get<0>(row);
+                TwoPLPashaMetadataLocal *lmeta = reinterpret_cast<TwoPLPashaMetadataLocal *>(meta.load());
+                char *migrated_row = nullptr;
+
+                // rows in local memory are not versioned
+                lmeta->lock();
+                if (lmeta->is_migrated == true) {
+                        migrated_row = lmeta->migrated_row;
+                }
+                lmeta->unlock();
+
+                // a concurrent move-out retires the CXL row through EBR
+                return migrated_row != nullptr && snapshot_read(migrated_row, dest, size, snapshot_epoch);
+        }
+
+        // used for remote point queries of snapshot transactions
+        bool remote_snapshot_read(std::size_t table_id, std::size_t partition_id, const void *key, void *dest, std::size_t size, uint64_t snapshot_epoch)
+        {
+                CXLTableBase *target_cxl_table = cxl_tbl_vecs[table_id][partition_id];
+                char *migrated_row = reinterpret_cast<char *>(target_cxl_table->search(key));
+
+                return migrated_row != nullptr && snapshot_read(migrated_row, dest, size, snapshot_epoch);
+        }
+
 	/**
 	 * [write lock bit (1) |  read lock bit (9) -- 512 - 1 locks | seq id  (54) ]
 	 *
@@ -441,6 +770,124 @@ class TwoPLPashaHelper {
                 value &= ~(WRITE_LOCK_BIT_MASK << WRITE_LOCK_BIT_OFFSET);
         }
 
+        // called under the row latch whenever a lock is granted, ts is 0 for holders that never wait
+        static void lock_granted(TwoPLPashaLockQueue &queue, uint64_t ts)
+        {
+                if (lock_wait_enabled == true) {
+                        queue.holder_ts = std::min(queue.holder_ts, ts);
+                }
+        }
+
+        // called under the row latch whenever a lock is released
+        static void lock_released(TwoPLPashaLockQueue &queue, bool row_is_free)
+        {
+                if (lock_wait_enabled == true && row_is_free == true) {
+                        queue.wake_head();
+                }
+        }
+
+        // the same for migrated rows, called under the CXL latch
+        static void lock_granted(TwoPLPashaSharedDataSCC *scc_data, uint64_t ts)
+        {
+                if (lock_wait_enabled == true) {
+                        lock_granted(*scc_data->lock_queue.load(), ts);
+                }
+        }
+
+        static void lock_released(TwoPLPashaSharedDataSCC *scc_data, bool row_is_free)
+        {
+                if (lock_wait_enabled == true) {
+                        lock_released(*scc_data->lock_queue.load(), row_is_free);
+                }
+        }
+
+        enum class lock_wait_result { RETRY, WAIT, DIE };
+
+        /*
+         * Called after failing to take a lock with --lock_wait_policy=WaitDie. The waiter is queued if the
+         * row is still locked and the transaction is older than all holders and waiters; it then spins
+         * until woken up and takes the lock again. Otherwise the transaction retries right away if the
+         * row is free, or dies (aborts) if it is younger or the row is gone.
+         */
+        lock_wait_result enqueue_lock_waiter(const std::tuple<MetaDataType *, void *> &row, std::size_t size, TwoPLPashaLockWaiter *waiter)
+        {
+                MetaDataType &meta = *std::get<0>(row);
+                TwoPLPashaMetadataLocal *lmeta = reinterpret_cast<TwoPLPashaMetadataLocal *>(meta.load());
+                lock_wait_result res = lock_wait_result::DIE;
+
+                lmeta->lock();
+                if (lmeta->is_migrated == false) {
+                        if (lmeta->is_valid == true) {
+                                bool conflict = false;
+                                if (waiter->write_lock == true) {
+                                        conflict = is_read_locked(lmeta->tid) || is_write_locked(lmeta->tid);
+                                } else {
+                                        conflict = is_write_locked(lmeta->tid) || read_lock_num(lmeta->tid) == read_lock_max();
+                                }
+                                res = enqueue_lock_waiter(lmeta->lock_queue, conflict, waiter);
+                        } else {
+                                // the row is deleted, nobody gets it anymore
+                                lmeta->lock_queue.wake_all();
+                        }
+                } else {
+                        res = remote_enqueue_lock_waiter(lmeta->migrated_row, size, waiter);
+                }
+                lmeta->unlock();
+
+                return res;
+        }
+
+        lock_wait_result remote_enqueue_lock_waiter(char *row, std::size_t size, TwoPLPashaLockWaiter *waiter)
+        {
+                TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(row);
+                TwoPLPashaSharedDataSCC *scc_data = smeta->get_scc_data();
+                lock_wait_result res = lock_wait_result::DIE;
+
+                smeta->lock();
+                scc_manager->prepare_read(smeta, coordinator_id, scc_data, sizeof(TwoPLPashaSharedDataSCC) + size);
+                if (scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index) == true) {
+                        bool conflict = false;
+                        if (waiter->write_lock == true) {
+                                conflict = smeta->get_reader_count() > 0 || smeta->is_write_locked();
+                        } else {
+                                conflict = smeta->is_write_locked() || smeta->get_reader_count() == smeta->get_reader_count_max();
+                        }
+                        res = enqueue_lock_waiter(*scc_data->lock_queue.load(), conflict, waiter);
+                } else {
+                        scc_data->lock_queue.load()->wake_all();
+                }
+                smeta->unlock();
+
+                return res;
+        }
+
+        // stops waiting, and passes the wake-up on if the waiter got one but does not take the lock
+        void cancel_lock_waiter(const std::tuple<MetaDataType *, void *> &row, TwoPLPashaLockWaiter *waiter)
+        {
+                MetaDataType &meta = *std::get<0>(row);
+                TwoPLPashaMetadataLocal *lmeta = reinterpret_cast<TwoPLPashaMetadataLocal *>(meta.load());
+
+                lmeta->lock();
+                if (lmeta->is_migrated == false) {
+                        lmeta->lock_queue.remove(waiter);
+                        lock_released(lmeta->lock_queue, is_read_locked(lmeta->tid) == false && is_write_locked(lmeta->tid) == false);
+                } else {
+                        remote_cancel_lock_waiter(lmeta->migrated_row, waiter);
+                }
+                lmeta->unlock();
+        }
+
+        void remote_cancel_lock_waiter(char *row, TwoPLPashaLockWaiter *waiter)
+        {
+                TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(row);
+                TwoPLPashaSharedDataSCC *scc_data = smeta->get_scc_data();
+
+                smeta->lock();
+                scc_data->lock_queue.load()->remove(waiter);
+                lock_released(scc_data, smeta->get_reader_count() == 0 && smeta->is_write_locked() == false);
+                smeta->unlock();
+        }
+
 	uint64_t read_lock(std::atomic<uint64_t> &meta, void* data_ptr, uint64_t size, bool &success)
 	{
                 TwoPLPashaMetadataLocal *lmeta = reinterpret_cast<TwoPLPashaMetadataLocal *>(meta.load());
@@ -466,6 +913,7 @@ class TwoPLPashaHelper {
                         // OK, we can get the lock
                         new_value = old_value + (1ull << READ_LOCK_BIT_OFFSET);
                         lmeta->tid = new_value;
+                        lock_granted(lmeta->lock_queue, 0);
                         success = true;
                 } else {
                         TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(lmeta->migrated_row);
@@ -513,6 +961,7 @@ class TwoPLPashaHelper {
 
                         // OK, we can get the lock
                         smeta->increase_reader_count();
+                        lock_granted(scc_data, 0);
                         success = true;
 
                         smeta->unlock();
@@ -523,7 +972,7 @@ out_unlock_lmeta:
 		return tid;
 	}
 
-        uint64_t take_read_lock_and_read(const std::tuple<MetaDataType *, void *> &row, void *dest, std::size_t size, bool &success, std::atomic<uint64_t> &local_cxl_access)
+        uint64_t take_read_lock_and_read(const std::tuple<MetaDataType *, void *> &row, void *dest, std::size_t size, bool &success, std::atomic<uint64_t> &local_cxl_access, uint64_t ts = 0)
 	{
                 MetaDataType &meta = *std::get<0>(row);
                 TwoPLPashaMetadataLocal *lmeta = reinterpret_cast<TwoPLPashaMetadataLocal *>(meta.load());
@@ -551,6 +1000,7 @@ out_unlock_lmeta:
                         // OK, we can get the lock
                         new_value = old_value + (1ull << READ_LOCK_BIT_OFFSET);
                         lmeta->tid = new_value;
+                        lock_granted(lmeta->lock_queue, ts);
                         success = true;
 
                         // read the data
@@ -609,6 +1059,7 @@ out_unlock_lmeta:
 
                         // OK, we can get the lock
                         smeta->increase_reader_count();
+                        lock_granted(scc_data, ts);
                         success = true;
 
                         // read the data from the local copy
@@ -622,7 +1073,7 @@ out_unlock_lmeta:
 		return tid;
 	}
 
-        uint64_t remote_take_read_lock_and_read(char *row, void *dest, std::size_t size, bool inc_ref_cnt, bool &success)
+        uint64_t remote_take_read_lock_and_read(char *row, void *dest, std::size_t size, bool inc_ref_cnt, bool &success, uint64_t ts = 0)
 	{
 		TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(row);
                 TwoPLPashaSharedDataSCC *scc_data = smeta->get_scc_data();
@@ -653,6 +1104,7 @@ out_unlock_lmeta:
 
                 // OK, we can get the lock
                 smeta->increase_reader_count();
+                lock_granted(scc_data, ts);
                 success = true;
 
                 // read the data
@@ -698,6 +1150,7 @@ out_unlock_lmeta:
 
                 // OK, we can get the lock
                 smeta->increase_reader_count();
+                lock_granted(scc_data, 0);
                 success = true;
 
                 // increase reference counting only if we get the lock
@@ -733,6 +1186,7 @@ out_unlock_lmeta:
                         // OK, we can get the lock
                         new_value = old_value + (WRITE_LOCK_BIT_MASK << WRITE_LOCK_BIT_OFFSET);
                         lmeta->tid = new_value;
+                        lock_granted(lmeta->lock_queue, 0);
                         success = true;
                 } else {
                         TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(lmeta->migrated_row);
@@ -780,6 +1234,7 @@ out_unlock_lmeta:
 
                         // OK, we can get the lock
                         smeta->set_write_locked();
+                        lock_granted(scc_data, 0);
                         success = true;
 
                         smeta->unlock();
@@ -790,7 +1245,7 @@ out_unlock_lmeta:
 		return tid;
 	}
 
-        uint64_t take_write_lock_and_read(const std::tuple<MetaDataType *, void *> &row, void *dest, std::size_t size, bool &success, std::atomic<uint64_t> &local_cxl_access)
+        uint64_t take_write_lock_and_read(const std::tuple<MetaDataType *, void *> &row, void *dest, std::size_t size, bool &success, std::atomic<uint64_t> &local_cxl_access, uint64_t ts = 0)
 	{
                 MetaDataType &meta = *std::get<0>(row);
                 TwoPLPashaMetadataLocal *lmeta = reinterpret_cast<TwoPLPashaMetadataLocal *>(meta.load());
@@ -818,6 +1273,7 @@ out_unlock_lmeta:
                         // OK, we can get the lock
                         new_value = old_value + (WRITE_LOCK_BIT_MASK << WRITE_LOCK_BIT_OFFSET);
                         lmeta->tid = new_value;
+                        lock_granted(lmeta->lock_queue, ts);
                         success = true;
 
                         // read the data
@@ -876,6 +1332,7 @@ out_unlock_lmeta:
 
                         // OK, we can get the lock
                         smeta->set_write_locked();
+                        lock_granted(scc_data, ts);
                         success = true;
 
                         // read the data from the local copy
@@ -889,7 +1346,7 @@ out_unlock_lmeta:
 		return tid;
 	}
 
-        uint64_t remote_take_write_lock_and_read(char *row, void *dest, std::size_t size, bool inc_ref_cnt, bool &success)
+        uint64_t remote_take_write_lock_and_read(char *row, void *dest, std::size_t size, bool inc_ref_cnt, bool &success, uint64_t ts = 0)
 	{
 		TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(row);
                 TwoPLPashaSharedDataSCC *scc_data = smeta->get_scc_data();
@@ -920,6 +1377,7 @@ out_unlock_lmeta:
 
                 // OK, we can get the lock
                 smeta->set_write_locked();
+                lock_granted(scc_data, ts);
                 success = true;
 
                 // read the data
@@ -965,6 +1423,7 @@ out_unlock_lmeta:
 
                 // OK, we can get the lock
                 smeta->set_write_locked();
+                lock_granted(scc_data, 0);
                 success = true;
 
                 // increase reference counting only if we get the lock
@@ -988,6 +1447,7 @@ out_unlock_lmeta:
 			DCHECK(!is_write_locked(old_value));
 			new_value = old_value - (1ull << READ_LOCK_BIT_OFFSET);
                         lmeta->tid = new_value;
+                        lock_released(lmeta->lock_queue, is_read_locked(new_value) == false);
                 } else {
                         TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(lmeta->migrated_row);
 
@@ -995,6 +1455,7 @@ out_unlock_lmeta:
 			DCHECK(smeta->get_reader_count() > 0);
 			DCHECK(smeta->is_write_locked() == false);
 			smeta->decrease_reader_count();
+			lock_released(smeta->get_scc_data(), smeta->get_reader_count() == 0);
                         smeta->unlock();
                 }
                 lmeta->unlock();
@@ -1010,6 +1471,7 @@ out_unlock_lmeta:
                 DCHECK(smeta->get_reader_count() > 0);
                 DCHECK(smeta->is_write_locked() == false);
                 smeta->decrease_reader_count();
+                lock_released(scc_data, smeta->get_reader_count() == 0);
 
                 smeta->unlock();
 	}
@@ -1027,6 +1489,7 @@ out_unlock_lmeta:
                         DCHECK(is_write_locked(old_value));
                         new_value = old_value - (1ull << WRITE_LOCK_BIT_OFFSET);
                         lmeta->tid = new_value;
+                        lock_released(lmeta->lock_queue, true);
                 } else {
                         TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(lmeta->migrated_row);
 
@@ -1034,6 +1497,7 @@ out_unlock_lmeta:
                         DCHECK(smeta->get_reader_count() == 0);
                         DCHECK(smeta->is_write_locked() == true);
                         smeta->clear_write_locked();
+                        lock_released(smeta->get_scc_data(), true);
                         smeta->unlock();
                 }
                 lmeta->unlock();
@@ -1049,6 +1513,7 @@ out_unlock_lmeta:
                 DCHECK(smeta->get_reader_count() == 0);
                 DCHECK(smeta->is_write_locked() == true);
                 smeta->clear_write_locked();
+                lock_released(scc_data, true);
                 smeta->unlock();
 	}
 
@@ -1066,6 +1531,7 @@ out_unlock_lmeta:
                         DCHECK(!is_read_locked(new_value));
                         DCHECK(!is_write_locked(new_value));
                         lmeta->tid = new_value;
+                        lock_released(lmeta->lock_queue, true);
                 } else {
                         TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(lmeta->migrated_row);
                         TwoPLPashaSharedDataSCC *scc_data = smeta->get_scc_data();
@@ -1074,10 +1540,11 @@ out_unlock_lmeta:
                         DCHECK(smeta->get_reader_count() == 0);
                         DCHECK(smeta->is_write_locked() == true);
                         smeta->clear_write_locked();
+                        lock_released(scc_data, true);
 
                         scc_data->tid = new_value;
 
-                        scc_manager->finish_write(smeta, coordinator_id, scc_data, sizeof(TwoPLPashaMetadataShared) + size);
+                        scc_manager->finish_write(smeta, coordinator_id, scc_data, sizeof(TwoPLPashaSharedDataSCC) + size);
                         smeta->unlock();
                 }
                 lmeta->unlock();
@@ -1096,10 +1563,11 @@ out_unlock_lmeta:
                 DCHECK(smeta->get_reader_count() == 0);
                 DCHECK(smeta->is_write_locked() == true);
                 smeta->clear_write_locked();
+                lock_released(scc_data, true);
 
                 scc_data->tid = new_value;
 
-                scc_manager->finish_write(smeta, coordinator_id, scc_data, sizeof(TwoPLPashaMetadataShared) + size);
+                scc_manager->finish_write(smeta, coordinator_id, scc_data, sizeof(TwoPLPashaSharedDataSCC) + size);
                 smeta->unlock();
 	}
 
@@ -1114,6 +1582,7 @@ out_unlock_lmeta:
 
                         smeta->lock();
                         DCHECK(scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index) == !is_valid);
+                        scc_data->version_epoch.store(TwoPLPashaSharedDataSCC::unversioned, std::memory_order_release);
                         if (is_valid == true) {
                                 scc_data->set_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
                         } else {
@@ -1135,6 +1604,7 @@ out_unlock_lmeta:
 		smeta->lock();
                 DCHECK(scc_data->ref_cnt > 0);
                 DCHECK(scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index) == !is_valid);
+                scc_data->version_epoch.store(TwoPLPashaSharedDataSCC::unversioned, std::memory_order_release);
                 if (is_valid == true) {
                         scc_data->set_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
                 } else {
@@ -1288,6 +1758,17 @@ out_unlock_lmeta:
                         }
                         new(smeta) TwoPLPashaMetadataShared(scc_data);
 
+                        TwoPLPashaLockQueue *lock_queue = nullptr;
+                        if (lock_wait_enabled == true) {
+                                lock_queue = reinterpret_cast<TwoPLPashaLockQueue *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(TwoPLPashaLockQueue), CXLMemory::MISC_ALLOCATION));
+                                if (lock_queue == nullptr) {
+                                        res = migration_result::FAIL_OOM;
+                                        lmeta->unlock();
+                                        return res;
+                                }
+                                new(lock_queue) TwoPLPashaLockQueue();
+                        }
+
                         // init migration policy metadata
                         migration_manager->init_migration_policy_metadata(&scc_data->migration_policy_meta, table, key, row, sizeof(TwoPLPashaMetadataShared));
                         migration_policy_meta = scc_data->migration_policy_meta;
@@ -1305,6 +1786,9 @@ out_unlock_lmeta:
                                 scc_data->clear_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
                         }
                         scc_data->tid = lmeta->tid;
+                        if (context.mvcc_snapshot_reads == true) {
+                                init_versions(scc_data);
+                        }
                         smeta->set_reader_count(read_lock_num(lmeta->tid));
                         if (is_write_locked(lmeta->tid) == true) {
                                 smeta->set_write_locked();
@@ -1314,6 +1798,13 @@ out_unlock_lmeta:
                         DCHECK(read_lock_num(lmeta->tid) == smeta->get_reader_count());
                         DCHECK(is_write_locked(lmeta->tid) == smeta->is_write_locked());
 
+                        // the local lock waiters retry on the migrated row
+                        if (lock_queue != nullptr) {
+                                lock_queue->init(lmeta->lock_queue.holder_ts);
+                        }
+                        scc_data->lock_queue.store(lock_queue);
+                        lmeta->lock_queue.wake_all();
+
                         // copy data
                         if (lmeta->is_data_modified_since_moved_out == true || context.enable_migration_optimization == false) {
                                 scc_manager->do_write(nullptr, coordinator_id, scc_data->data, local_data, table->value_size());
@@ -1425,6 +1916,17 @@ out_unlock_lmeta:
                                 }
                                 new(cur_smeta) TwoPLPashaMetadataShared(cur_scc_data);
 
+                                TwoPLPashaLockQueue *cur_lock_queue = nullptr;
+                                if (lock_wait_enabled == true) {
+                                        cur_lock_queue = reinterpret_cast<TwoPLPashaLockQueue *>(cxl_memory.cxlalloc_malloc_wrapper(sizeof(TwoPLPashaLockQueue), CXLMemory::MISC_ALLOCATION));
+                                        if (cur_lock_queue == nullptr) {
+                                                res = migration_result::FAIL_OOM;
+                                                cur_lmeta->unlock();
+                                                return;
+                                        }
+                                        new(cur_lock_queue) TwoPLPashaLockQueue();
+                                }
+
                                 // init migration policy metadata
                                 migration_manager->init_migration_policy_metadata(&cur_scc_data->migration_policy_meta, table, key, row, sizeof(TwoPLPashaMetadataShared));
                                 migration_policy_meta = cur_scc_data->migration_policy_meta;
@@ -1442,6 +1944,9 @@ out_unlock_lmeta:
                                         cur_scc_data->clear_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
                                 }
                                 cur_scc_data->tid = cur_lmeta->tid;
+                                if (context.mvcc_snapshot_reads == true) {
+                                        init_versions(cur_scc_data);
+                                }
                                 cur_smeta->set_reader_count(read_lock_num(cur_lmeta->tid));
                                 if (is_write_locked(cur_lmeta->tid) == true) {
                                         cur_smeta->set_write_locked();
@@ -1451,6 +1956,13 @@ out_unlock_lmeta:
                                 DCHECK(read_lock_num(cur_lmeta->tid) == cur_smeta->get_reader_count());
                                 DCHECK(is_write_locked(cur_lmeta->tid) == cur_smeta->is_write_locked());
 
+                                // the local lock waiters retry on the migrated row
+                                if (cur_lock_queue != nullptr) {
+                                        cur_lock_queue->init(cur_lmeta->lock_queue.holder_ts);
+                                }
+                                cur_scc_data->lock_queue.store(cur_lock_queue);
+                                cur_lmeta->lock_queue.wake_all();
+
                                 // copy data
                                 if (cur_lmeta->is_data_modified_since_moved_out == true || context.enable_migration_optimization == false) {
                                         scc_manager->do_write(nullptr, coordinator_id, cur_scc_data->data, cur_data, table->value_size());
@@ -1629,6 +2141,13 @@ out_unlock_lmeta:
                         DCHECK(read_lock_num(lmeta->tid) == smeta->get_reader_count());
                         DCHECK(is_write_locked(lmeta->tid) == smeta->is_write_locked());
 
+                        // the lock waiters in CXL are all local, they retry on the local row
+                        TwoPLPashaLockQueue *lock_queue = scc_data->lock_queue.load();
+                        if (lock_queue != nullptr) {
+                                lmeta->lock_queue.init(lock_queue->holder_ts);
+                                lock_queue->wake_all();
+                        }
+
                         // copy data back
                         if (smeta->is_data_modified_since_moved_in() == true || context.enable_migration_optimization == false) {
                                 scc_manager->do_read(nullptr, coordinator_id, local_data, scc_data->data, table->value_size());
@@ -1638,6 +2157,9 @@ out_unlock_lmeta:
 
                         // set the migrated row as invalid
                         scc_data->clear_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
+                        if (context.mvcc_snapshot_reads == true) {
+                                retire_versions(scc_data, table->value_size());
+                        }
 
                         // remove from CXL index
                         CXLTableBase *target_cxl_table = cxl_tbl_vecs[table->tableID()][table->partitionID()];
@@ -1649,6 +2171,10 @@ out_unlock_lmeta:
                         lmeta->is_migrated = false;
 
                         // free the CXL row
+                        if (lock_queue != nullptr) {
+                                cxl_memory.cxlalloc_free_wrapper(lock_queue, sizeof(TwoPLPashaLockQueue), CXLMemory::MISC_FREE);
+                                global_ebr_meta->add_retired_object(lock_queue, sizeof(TwoPLPashaLockQueue), CXLMemory::MISC_FREE);
+                        }
                         if (context.enable_scc == false) {
                                 cxl_memory.cxlalloc_free_wrapper(smeta->get_scc_data(), sizeof(TwoPLPashaSharedDataSCC) + table->value_size(), CXLMemory::DATA_FREE);
                                 global_ebr_meta->add_retired_object(smeta->get_scc_data(), sizeof(TwoPLPashaSharedDataSCC) + table->value_size(), CXLMemory::DATA_FREE);
@@ -1735,6 +2261,13 @@ out_unlock_lmeta:
                                 DCHECK(read_lock_num(cur_lmeta->tid) == cur_smeta->get_reader_count());
                                 DCHECK(is_write_locked(cur_lmeta->tid) == cur_smeta->is_write_locked());
 
+                                // the lock waiters in CXL are all local, they retry on the local row
+                                TwoPLPashaLockQueue *cur_lock_queue = cur_scc_data->lock_queue.load();
+                                if (cur_lock_queue != nullptr) {
+                                        cur_lmeta->lock_queue.init(cur_lock_queue->holder_ts);
+                                        cur_lock_queue->wake_all();
+                                }
+
                                 // copy data back
                                 if (cur_smeta->is_data_modified_since_moved_in() == true || context.enable_migration_optimization == false) {
                                         scc_manager->do_read(nullptr, coordinator_id, cur_data, cur_smeta->get_scc_data()->data, table->value_size());
@@ -1744,12 +2277,19 @@ out_unlock_lmeta:
 
                                 // set the migrated row as invalid
                                 cur_scc_data->clear_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
+                                if (context.mvcc_snapshot_reads == true) {
+                                        retire_versions(cur_scc_data, table->value_size());
+                                }
 
                                 // mark the local row as not migrated
                                 cur_lmeta->migrated_row = nullptr;
                                 cur_lmeta->is_migrated = false;
 
                                 // free the CXL row
+                                if (cur_lock_queue != nullptr) {
+                                        cxl_memory.cxlalloc_free_wrapper(cur_lock_queue, sizeof(TwoPLPashaLockQueue), CXLMemory::MISC_FREE);
+                                        global_ebr_meta->add_retired_object(cur_lock_queue, sizeof(TwoPLPashaLockQueue), CXLMemory::MISC_FREE);
+                                }
                                 if (context.enable_scc == false) {
                                         cxl_memory.cxlalloc_free_wrapper(cur_smeta->get_scc_data(), sizeof(TwoPLPashaSharedDataSCC) + table->value_size(), CXLMemory::DATA_FREE);
                                         global_ebr_meta->add_retired_object(cur_smeta->get_scc_data(), sizeof(TwoPLPashaSharedDataSCC) + table->value_size(), CXLMemory::DATA_FREE);
@@ -1962,10 +2502,14 @@ out_unlock_lmeta:
                                 cur_smeta->lock();
                                 if (is_local_delete == true) {
                                         DCHECK(cur_scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index) == true);
+                                        cur_scc_data->version_epoch.store(TwoPLPashaSharedDataSCC::unversioned, std::memory_order_release);
                                         cur_scc_data->clear_flag(TwoPLPashaSharedDataSCC::valid_flag_index);
                                 } else {
                                         DCHECK(cur_scc_data->get_flag(TwoPLPashaSharedDataSCC::valid_flag_index) == false);
                                 }
+                                if (context.mvcc_snapshot_reads == true) {
+                                        retire_versions(cur_scc_data, table->value_size());
+                                }
                                 migration_policy_meta = cur_scc_data->migration_policy_meta;
                                 cur_smeta->unlock();
 
@@ -2005,7 +2549,23 @@ out_unlock_lmeta:
 	static constexpr int WRITE_LOCK_BIT_OFFSET = 63;
 	static constexpr uint64_t WRITE_LOCK_BIT_MASK = 0x1ull;
 
+        // --lock_wait_policy=WaitDie
+        static bool lock_wait_enabled;
+
     private:
+        static lock_wait_result enqueue_lock_waiter(TwoPLPashaLockQueue &queue, bool conflict, TwoPLPashaLockWaiter *waiter)
+        {
+                if (conflict == false) {
+                        return lock_wait_result::RETRY;
+                }
+                if (waiter->ts >= queue.holder_ts) {
+                        return lock_wait_result::DIE;
+                }
+                queue.push(waiter);
+                queue.holder_ts = waiter->ts;
+                return lock_wait_result::WAIT;
+        }
+
         std::size_t coordinator_id;
 
         Context context;
@@ -0,0 +1,180 @@
+//
+// Software Cache-Coherence Manager
+//
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include "common/CXLMemory.h"
+#include "protocol/Pasha/SCCManager.h"
+#include "protocol/Pasha/SCCDirtyLine.h"
+#include "protocol/TwoPLPasha/TwoPLPashaHelper.h"
+
+namespace star
+{
+
+/*
+ * Dirty-line variant of TwoPLPashaSCCWriteThrough.
+ *
+ * The 16 SCC bits of the tuple hold two 7-bit host slots instead of a
+ * per-host bitmap, so the directory works for up to 127 hosts; hosts that
+ * do not fit are simply never recorded as clean and always flush.
+ *
+ * Writes are diffed against the (coherent) cached copy at cache-line
+ * granularity. Only the changed lines are copied, and their write-backs are
+ * deferred to finish_write, i.e., to the write lock release, where they are
+ * issued together with the tuple header and fenced once.
+ */
+class TwoPLPashaSCCDirtyLine : public SCCDirtyLine {
+    public:
+        using HostSet = SCCHostSet<0, 2>;
+
+        void init_scc_metadata(void *scc_meta, std::size_t cur_host_id) override
+        {
+                TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(scc_meta);
+                uint64_t scc_bits = 0;
+
+                HostSet::insert(scc_bits, cur_host_id);
+                smeta->set_scc_bits(scc_bits);
+
+                // the row is being moved in; write it back in full once
+                get_fresh_row() = smeta;
+        }
+
+        void do_read(void *scc_meta, std::size_t cur_host_id, void *dst, const void *src, uint64_t size) override
+        {
+                memcpy(dst, src, size);
+        }
+
+        void do_write(void *scc_meta, std::size_t cur_host_id, void *dst, const void *src, uint64_t size) override
+        {
+                std::vector<char *> &pending_lines = get_pending_lines();
+                TwoPLPashaMetadataShared *fresh_row = get_fresh_row();
+
+                if (fresh_row != nullptr && fresh_row->get_scc_data()->data == dst) {
+                        memcpy(dst, src, size);
+                        return;
+                }
+
+                // the caller holds the write lock, which made our cached copy
+                // coherent in prepare_read, so unchanged lines need no copy
+                for_each_line(dst, size, [&](uint64_t line_idx, uint64_t off, uint64_t len) {
+                        char *d = reinterpret_cast<char *>(dst) + off;
+                        const char *s = reinterpret_cast<const char *>(src) + off;
+                        if (std::memcmp(d, s, len) != 0) {
+                                std::memcpy(d, s, len);
+                                pending_lines.push_back(d);
+                        }
+                });
+        }
+
+        void prepare_read(void *scc_meta, std::size_t cur_host_id, void *scc_data, uint64_t size) override
+        {
+                TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(scc_meta);
+
+                if (smeta == nullptr) {
+                        clflush(scc_data, size);
+
+                        // statistics
+                        num_cache_miss.fetch_add(1);
+                        return;
+                }
+
+                uint64_t scc_bits = smeta->get_scc_bits();
+                if (HostSet::contains(scc_bits, cur_host_id) == false) {
+                        clflush(scc_data, size);
+                        if (HostSet::insert(scc_bits, cur_host_id) == true)
+                                smeta->set_scc_bits(scc_bits);
+
+                        // statistics
+                        num_cache_miss.fetch_add(1);
+                } else {
+                        // statistics
+                        num_cache_hit.fetch_add(1);
+                }
+        }
+
+        void finish_write(void *scc_meta, std::size_t cur_host_id, void *scc_data, uint64_t size) override
+        {
+                TwoPLPashaMetadataShared *smeta = reinterpret_cast<TwoPLPashaMetadataShared *>(scc_meta);
+                TwoPLPashaSharedDataSCC *data = reinterpret_cast<TwoPLPashaSharedDataSCC *>(scc_data);
+                std::vector<char *> &pending_lines = get_pending_lines();
+                uint64_t scc_bits = 0;
+
+                // the writer is the only host with an up-to-date copy
+                HostSet::insert(scc_bits, cur_host_id);
+                smeta->set_scc_bits(scc_bits);
+
+                if (get_fresh_row() == smeta) {
+                        get_fresh_row() = nullptr;
+                        clwb(scc_data, size);
+                        return;
+                }
+
+                /*
+                 * write back the header (tid, flags, ...) and the lines of this
+                 * row that do_write changed. lines of other rows stay pending
+                 * until their own write lock is released.
+                 */
+                char *begin = reinterpret_cast<char *>(scc_data);
+                char *end = begin + size;
+                uint64_t lines = 0;
+                for (uint64_t ptr = (uint64_t)begin & ~(cacheline_size - 1); ptr < (uint64_t)data->data; ptr += cacheline_size) {
+                        _mm_clwb((void *)ptr);
+                        lines++;
+                }
+                for (std::size_t i = 0; i < pending_lines.size();) {
+                        if (pending_lines[i] >= begin && pending_lines[i] < end) {
+                                _mm_clwb(pending_lines[i]);
+                                lines++;
+                                pending_lines[i] = pending_lines.back();
+                                pending_lines.pop_back();
+                        } else {
+                                i++;
+                        }
+                }
+                _mm_sfence();
+                model_flush_cost(lines);
+
+                // statistics
+                num_clwb.fetch_add(1);
+                num_clwb_lines.fetch_add(lines);
+        }
+
+        void end_transaction(std::size_t cur_host_id) override
+        {
+                std::vector<char *> &pending_lines = get_pending_lines();
+
+                // a line left here belongs to a row whose write lock was released
+                // without finish_write, i.e., its update never reached CXL memory
+                DCHECK(pending_lines.empty()) << pending_lines.size() << " dirty lines were not written back";
+                DCHECK(get_fresh_row() == nullptr);
+
+                if (pending_lines.empty() == false) {
+                        for (char *line : pending_lines)
+                                _mm_clwb(line);
+                        _mm_sfence();
+                        model_flush_cost(pending_lines.size());
+                        num_clwb_lines.fetch_add(pending_lines.size());
+                        pending_lines.clear();
+                }
+        }
+
+    private:
+        // changed lines not yet written back, per worker thread
+        static std::vector<char *> &get_pending_lines()
+        {
+                static thread_local std::vector<char *> pending_lines;
+                return pending_lines;
+        }
+
+        // the row whose move-in this worker thread is in the middle of
+        static TwoPLPashaMetadataShared *&get_fresh_row()
+        {
+                static thread_local TwoPLPashaMetadataShared *fresh_row = nullptr;
+                return fresh_row;
+        }
+};
+
+} // namespace star
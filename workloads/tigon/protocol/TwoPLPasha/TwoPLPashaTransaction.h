@@ -10,6 +10,7 @@
 #include "core/Defs.h"
 #include "core/Partitioner.h"
 #include "core/Table.h"
+#include "protocol/TwoPLPasha/TwoPLPashaHelper.h"
 #include "protocol/TwoPLPasha/TwoPLPashaRWKey.h"
 #include <chrono>
 #include <glog/logging.h>
@@ -185,12 +186,20 @@ class TwoPLPashaTransaction {
                 scanSet.clear();
                 insertSet.clear();
                 deleteSet.clear();
+                snapshot_read_state = SNAPSHOT_READ_UNDECIDED;
+                snapshot_epoch = 0;
 	}
 
         bool should_abort() {
                 return abort_lock || abort_read_validation || abort_insert || abort_delete;
         }
 
+        // wait-die priority (smaller is older), kept across retries so that a transaction ages and eventually waits
+        uint64_t lock_wait_ts() const {
+                auto start_us = std::chrono::duration_cast<std::chrono::microseconds>(startTime.time_since_epoch()).count();
+                return (static_cast<uint64_t>(start_us) << 8) | (coordinator_id & 0xff);
+        }
+
 	virtual TransactionResult execute(std::size_t worker_id) = 0;
 
 	virtual void reset_query() = 0;
@@ -350,11 +359,41 @@ class TwoPLPashaTransaction {
 		add_to_delete_set(deleteKey);
 	}
 
+        // true if the unprocessed requests only read rows
+        bool has_only_reads_to_process()
+        {
+                if (writeSet.empty() == false) {
+                        return false;
+                }
+                for (int i = int(readSet.size()) - 1; i >= 0 && readSet[i].get_processed() == false; i--) {
+                        if (readSet[i].get_write_lock_request_bit()) {
+                                return false;
+                        }
+                }
+                return (scanSet.empty() || scanSet.back().get_processed()) && (insertSet.empty() || insertSet.back().get_processed()) &&
+                       (deleteSet.empty() || deleteSet.back().get_processed());
+        }
+
 	bool process_requests(std::size_t worker_id, bool last_call_in_transaction = true)
 	{
 		bool ret = false;
 		ScopedTimer t_local_work([&, this](uint64_t us) { this->record_local_work_time(us); });
 
+                // a transaction reads from a snapshot until it turns out not to be read-only
+                if (snapshot_read_state == SNAPSHOT_READ_UNDECIDED) {
+                        if (snapshot_read_candidate == true && has_only_reads_to_process() == true) {
+                                snapshot_read_state = SNAPSHOT_READ_ON;
+                                snapshot_epoch = TwoPLPashaHelper::get_snapshot_epoch();
+                        } else {
+                                snapshot_read_state = SNAPSHOT_READ_OFF;
+                        }
+                } else if (snapshot_read_state == SNAPSHOT_READ_ON && has_only_reads_to_process() == false) {
+                        // the snapshot reads are not protected by locks - retry with locking
+                        snapshot_read_candidate = false;
+                        abort_lock = true;
+                        return true;
+                }
+
 		// processing read requests
 		for (int i = int(readSet.size()) - 1; i >= 0; i--) {
 			// early return
@@ -375,7 +414,8 @@ class TwoPLPashaTransaction {
                                 readSet[i].set_cached_migrated_row(cached_migrated_row);
 				if (success) {
 					readSet[i].set_tid(tid);
-					if (readSet[i].get_read_lock_request_bit() && !readSet[i].get_local_index_read_bit()) {
+					if (readSet[i].get_read_lock_request_bit() && !readSet[i].get_local_index_read_bit() &&
+					    snapshot_read_state != SNAPSHOT_READ_ON) {
 						readSet[i].set_read_lock_bit();
 					}
 
@@ -553,5 +593,12 @@ process_net_req_and_ret:
 	uint64_t straggler_wait_time = 0;
 
         std::unordered_set<std::size_t> remote_hosts_involved;
+
+        // MVCC snapshot reads (--mvcc_snapshot_reads)
+        enum { SNAPSHOT_READ_UNDECIDED, SNAPSHOT_READ_ON, SNAPSHOT_READ_OFF };
+        int snapshot_read_state = SNAPSHOT_READ_UNDECIDED;
+        uint64_t snapshot_epoch = 0;
+        // set by the executor for a new transaction and kept across retries, so that a fallback retries with locks
+        bool snapshot_read_candidate = false;
 };
 } // namespace star
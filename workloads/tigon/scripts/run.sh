@@ -49,10 +49,26 @@ else
     CXL_BACKEND_FLAGS=""
 fi
 
+# TwoPLPasha and SundialPasha workers interleave this many transactions
+#   export COROUTINE_NUM=4
+COROUTINE_NUM=${COROUTINE_NUM:-1}
+
+# TwoPLPasha read-only transactions read migrated rows from a snapshot (needs SCC_MECH=NoOP)
+#   export MVCC_SNAPSHOT_READS=true
+MVCC_SNAPSHOT_READS=${MVCC_SNAPSHOT_READS:-false}
+
+# TwoPLPasha lock conflicts: NoWait aborts, WaitDie lets older transactions wait in the row's queue
+#   export LOCK_WAIT_POLICY=WaitDie
+LOCK_WAIT_POLICY=${LOCK_WAIT_POLICY:-NoWait}
+
+# TwoPLPasha releases read locks at the lock point and write locks right after their write-back
+#   export EARLY_LOCK_RELEASE=true
+EARLY_LOCK_RELEASE=${EARLY_LOCK_RELEASE:-false}
+
 function print_usage {
         echo "[usage] ./run.sh [TPCC/YCSB/KILL/COMPILE/COMPILE_SYNC/CI/COLLECT_OUTPUTS] EXP-SPECIFIC"
         echo "TPCC: [SundialPasha/Sundial/TwoPLPasha/TwoPLPashaPhantom/TwoPL] HOST_NUM WORKER_NUM QUERY_TYPE REMOTE_NEWORDER_PERC REMOTE_PAYMENT_PERC USE_CXL_TRANS USE_OUTPUT_THREAD ENABLE_MIGRATION_OPTIMIZATION MIGRATION_POLICY WHEN_TO_MOVE_OUT HW_CC_BUDGET ENABLE_SCC SCC_MECH PRE_MIGRATE TIME_TO_RUN TIME_TO_WARMUP LOGGING_TYPE EPOCH_LEN MODEL_CXL_SEARCH GATHER_OUTPUTS"
-        echo "YCSB: [SundialPasha/Sundial/TwoPLPasha/TwoPLPashaPhantom/TwoPL] HOST_NUM WORKER_NUM QUERY_TYPE KEYS RW_RATIO ZIPF_THETA CROSS_RATIO USE_CXL_TRANS USE_OUTPUT_THREAD ENABLE_MIGRATION_OPTIMIZATION MIGRATION_POLICY WHEN_TO_MOVE_OUT HW_CC_BUDGET ENABLE_SCC SCC_MECH PRE_MIGRATE TIME_TO_RUN TIME_TO_WARMUP LOGGING_TYPE EPOCH_LEN MODEL_CXL_SEARCH GATHER_OUTPUTS"
+        echo "YCSB: [SundialPasha/Sundial/TwoPLPasha/TwoPLPashaPhantom/TwoPL/AriaPasha] HOST_NUM WORKER_NUM QUERY_TYPE KEYS RW_RATIO ZIPF_THETA CROSS_RATIO USE_CXL_TRANS USE_OUTPUT_THREAD ENABLE_MIGRATION_OPTIMIZATION MIGRATION_POLICY WHEN_TO_MOVE_OUT HW_CC_BUDGET ENABLE_SCC SCC_MECH PRE_MIGRATE TIME_TO_RUN TIME_TO_WARMUP LOGGING_TYPE EPOCH_LEN MODEL_CXL_SEARCH GATHER_OUTPUTS"
         echo "SmallBank: [SundialPasha/Sundial/TwoPLPasha/TwoPLPashaPhantom/TwoPL] HOST_NUM WORKER_NUM KEYS ZIPF_THETA CROSS_RATIO USE_CXL_TRANS USE_OUTPUT_THREAD ENABLE_MIGRATION_OPTIMIZATION MIGRATION_POLICY WHEN_TO_MOVE_OUT HW_CC_BUDGET ENABLE_SCC SCC_MECH PRE_MIGRATE TIME_TO_RUN TIME_TO_WARMUP LOGGING_TYPE EPOCH_LEN MODEL_CXL_SEARCH GATHER_OUTPUTS"
         echo "TATP: [SundialPasha/Sundial/TwoPLPasha/TwoPLPashaPhantom/TwoPL] HOST_NUM WORKER_NUM KEYS CROSS_RATIO USE_CXL_TRANS USE_OUTPUT_THREAD ENABLE_MIGRATION_OPTIMIZATION MIGRATION_POLICY WHEN_TO_MOVE_OUT HW_CC_BUDGET ENABLE_SCC SCC_MECH PRE_MIGRATE TIME_TO_RUN TIME_TO_WARMUP LOGGING_TYPE EPOCH_LEN MODEL_CXL_SEARCH GATHER_OUTPUTS"
         echo "KILL: None"
@@ -188,7 +204,7 @@ function run_exp_tpcc {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -201,7 +217,7 @@ function run_exp_tpcc {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC" 0
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC" 0
 
         elif [ $PROTOCOL = "Sundial" ]; then
                 # launch 1-$HOST_NUM processes
@@ -238,7 +254,7 @@ function run_exp_tpcc {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -251,7 +267,7 @@ function run_exp_tpcc {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC" 0
 
         elif [ $PROTOCOL = "TwoPLPashaPhantom" ]; then
                 # launch 1-$HOST_NUM processes
@@ -266,7 +282,7 @@ function run_exp_tpcc {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -279,7 +295,7 @@ function run_exp_tpcc {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --neworder_dist=$REMOTE_NEWORDER_PERC --payment_dist=$REMOTE_PAYMENT_PERC" 0
 
         elif [ $PROTOCOL = "TwoPL" ]; then
                 # launch 1-$HOST_NUM processes
@@ -368,7 +384,7 @@ function run_exp_ycsb {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2 &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2 &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -381,7 +397,7 @@ function run_exp_ycsb {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2" 0
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2" 0
 
         elif [ $PROTOCOL = "Sundial" ]; then
                 # launch 1-$HOST_NUM processes
@@ -418,7 +434,7 @@ function run_exp_ycsb {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2 &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2 &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -431,7 +447,7 @@ function run_exp_ycsb {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2" 0
 
         elif [ $PROTOCOL = "TwoPLPashaPhantom" ]; then
                 # launch 1-$HOST_NUM processes
@@ -446,7 +462,7 @@ function run_exp_ycsb {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2 &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2 &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -459,7 +475,30 @@ function run_exp_ycsb {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2" 0
+
+        elif [ $PROTOCOL = "AriaPasha" ]; then
+                # Aria batches of 1000 transactions per host, with every row in CXL
+                # launch 1-$HOST_NUM processes
+                for (( i=1; i < $HOST_NUM; ++i ))
+                do
+                        ssh_command "cd pasha; nohup ./bench_ycsb --logtostderr=1 --id=$i --servers=\"$SERVER_STRING\" \
+--threads=$WORKER_NUM --partition_num=$PARTITION_NUM --granule_count=2000 \
+--log_path=$LOG_PATH --lotus_checkpoint=$LOTUS_CHECKPOINT --persist_latency=0 --wal_group_commit_time=$WAL_GROUP_COMMIT_TIME --wal_group_commit_size=$WAL_GROUP_COMMIT_BATCH_SIZE \
+--partitioner=hash --hstore_command_logging=false \
+--replica_group=1 --lock_manager=0 --batch_flush=1 --lotus_async_repl=true --batch_size=1000 --time_to_run=$TIME_TO_RUN --time_to_warmup=$TIME_TO_WARMUP \
+--use_cxl_transport=$USE_CXL_TRANS --use_output_thread=$USE_OUTPUT_THREAD --cxl_trans_entry_struct_size=$CXL_TRANS_ENTRY_STRUCT_SIZE --cxl_trans_entry_num=$CXL_TRANS_ENTRY_NUM $CXL_BACKEND_FLAGS \
+--protocol=AriaPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2 &> output.txt < /dev/null &" $i
+                done
+
+                # launch the first process
+                ssh_command "cd pasha; ./bench_ycsb --logtostderr=1 --id=0 --servers=\"$SERVER_STRING\" \
+--threads=$WORKER_NUM --partition_num=$PARTITION_NUM --granule_count=2000 \
+--log_path=$LOG_PATH --lotus_checkpoint=$LOTUS_CHECKPOINT --persist_latency=0 --wal_group_commit_time=$WAL_GROUP_COMMIT_TIME --wal_group_commit_size=$WAL_GROUP_COMMIT_BATCH_SIZE \
+--partitioner=hash --hstore_command_logging=false \
+--replica_group=1 --lock_manager=0 --batch_flush=1 --lotus_async_repl=true --batch_size=1000 --time_to_run=$TIME_TO_RUN --time_to_warmup=$TIME_TO_WARMUP \
+--use_cxl_transport=$USE_CXL_TRANS --use_output_thread=$USE_OUTPUT_THREAD --cxl_trans_entry_struct_size=$CXL_TRANS_ENTRY_STRUCT_SIZE --cxl_trans_entry_num=$CXL_TRANS_ENTRY_NUM $CXL_BACKEND_FLAGS \
+--protocol=AriaPasha --query=$QUERY_TYPE --keys=$KEYS --read_write_ratio=$RW_RATIO --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO --cross_part_num=2" 0
 
         elif [ $PROTOCOL = "TwoPL" ]; then
                 # launch 1-$HOST_NUM processes
@@ -546,7 +585,7 @@ function run_exp_smallbank {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -559,7 +598,7 @@ function run_exp_smallbank {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
 
         elif [ $PROTOCOL = "Sundial" ]; then
                 # launch 1-$HOST_NUM processes
@@ -596,7 +635,7 @@ function run_exp_smallbank {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -609,7 +648,7 @@ function run_exp_smallbank {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
 
         elif [ $PROTOCOL = "TwoPLPashaPhantom" ]; then
                 # launch 1-$HOST_NUM processes
@@ -624,7 +663,7 @@ function run_exp_smallbank {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -637,7 +676,7 @@ function run_exp_smallbank {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
 
         elif [ $PROTOCOL = "TwoPL" ]; then
                 # launch 1-$HOST_NUM processes
@@ -724,7 +763,7 @@ function run_exp_tatp {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -737,7 +776,7 @@ function run_exp_tatp {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH \
 --pre_migrate=$PRE_MIGRATE \
---protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
+--coroutine_num=$COROUTINE_NUM --protocol=SundialPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
 
         elif [ $PROTOCOL = "Sundial" ]; then
                 # launch 1-$HOST_NUM processes
@@ -774,7 +813,7 @@ function run_exp_tatp {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -787,7 +826,7 @@ function run_exp_tatp {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
 
         elif [ $PROTOCOL = "TwoPLPashaPhantom" ]; then
                 # launch 1-$HOST_NUM processes
@@ -802,7 +841,7 @@ function run_exp_tatp {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO &> output.txt < /dev/null &" $i
                 done
 
                 # launch the first process
@@ -815,7 +854,7 @@ function run_exp_tatp {
 --enable_migration_optimization=$ENABLE_MIGRATION_OPTIMIZATION --migration_policy=$MIGRATION_POLICY --when_to_move_out=$WHEN_TO_MOVE_OUT --hw_cc_budget=$HW_CC_BUDGET \
 --enable_scc=$ENABLE_SCC --scc_mechanism=$SCC_MECH --enable_phantom_detection=false --model_cxl_search_overhead=$MODEL_CXL_SEARCH_OVERHEAD \
 --pre_migrate=$PRE_MIGRATE \
---protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
+--coroutine_num=$COROUTINE_NUM --mvcc_snapshot_reads=$MVCC_SNAPSHOT_READS --lock_wait_policy=$LOCK_WAIT_POLICY --early_lock_release=$EARLY_LOCK_RELEASE --protocol=TwoPLPasha --keys=$KEYS --zipf=$ZIPF_THETA --cross_ratio=$CROSS_RATIO" 0
 
         elif [ $PROTOCOL = "TwoPL" ]; then
                 # launch 1-$HOST_NUM processes
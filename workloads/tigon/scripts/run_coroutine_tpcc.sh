@@ -0,0 +1,55 @@
+#! /bin/bash
+
+set -uo pipefail
+# set -x
+
+typeset SCRIPT_DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
+typeset current_date_time="`date +%Y%m%d%H%M`"
+
+source $SCRIPT_DIR/common.sh
+
+function print_usage {
+        echo "[usage] $0 RESULT_ROOT_DIR"
+}
+
+if [ $# != 1 ]; then
+        print_usage
+        exit -1
+fi
+
+typeset RESULT_ROOT_DIR=$1
+
+########### General Configuration BEGIN ###########
+
+# common parameters
+typeset HOST_NUM=8
+typeset WORKER_NUM=3
+
+typeset DEFAULT_WAL_GROUP_COMMIT_TIME=10000 # 10 ms
+
+typeset DEFAULT_HCC_SIZE_LIMIT=$(( 1024*1024*200 ))     # 200 MB
+
+# common parameters for TPCC
+typeset TPCC_RUN_TIME=30
+typeset TPCC_WARMUP_TIME=10
+
+# in-flight transactions per worker
+typeset COROUTINE_NUMS="1 2 4 8"
+
+# percentage of remote NewOrder and Payment transactions
+typeset MULTI_PARTITION_PERCS="0 20 40 60 80 100"
+
+########### General Configuration END ###########
+
+for COROUTINE_NUM in $COROUTINE_NUMS
+do
+        export COROUTINE_NUM
+        typeset RESULT_DIR=$RESULT_ROOT_DIR/tpcc-coroutine-$COROUTINE_NUM
+        mkdir -p $RESULT_DIR
+
+        for PERC in $MULTI_PARTITION_PERCS
+        do
+                run_tpcc_single $RESULT_DIR TwoPLPasha $HOST_NUM $WORKER_NUM $PERC $PERC 1 0 Clock OnDemand $DEFAULT_HCC_SIZE_LIMIT 1 WriteThrough NonPart GROUP_WAL $DEFAULT_WAL_GROUP_COMMIT_TIME 0 $TPCC_RUN_TIME $TPCC_WARMUP_TIME       # Tigon-TwoPL
+                run_tpcc_single $RESULT_DIR SundialPasha $HOST_NUM $WORKER_NUM $PERC $PERC 1 0 Clock OnDemand $DEFAULT_HCC_SIZE_LIMIT 1 WriteThrough NonPart GROUP_WAL $DEFAULT_WAL_GROUP_COMMIT_TIME 0 $TPCC_RUN_TIME $TPCC_WARMUP_TIME     # Tigon-Sundial
+        done
+done
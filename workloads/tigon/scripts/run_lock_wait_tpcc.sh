@@ -0,0 +1,61 @@
+#! /bin/bash
+
+set -uo pipefail
+# set -x
+
+typeset SCRIPT_DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
+typeset current_date_time="`date +%Y%m%d%H%M`"
+
+source $SCRIPT_DIR/common.sh
+
+function print_usage {
+        echo "[usage] $0 RESULT_ROOT_DIR"
+}
+
+if [ $# != 1 ]; then
+        print_usage
+        exit -1
+fi
+
+typeset RESULT_ROOT_DIR=$1
+
+########### General Configuration BEGIN ###########
+
+# common parameters
+typeset HOST_NUM=8
+
+typeset DEFAULT_WAL_GROUP_COMMIT_TIME=10000 # 10 ms
+
+typeset DEFAULT_HCC_SIZE_LIMIT=$(( 1024*1024*200 ))     # 200 MB
+
+# common parameters for TPCC
+typeset TPCC_RUN_TIME=30
+typeset TPCC_WARMUP_TIME=10
+
+# TPCC uses one warehouse per worker, so this is also the number of warehouses per host
+typeset WORKER_NUMS="1 2 3 4"
+
+# percentage of remote NewOrder and Payment transactions
+typeset MULTI_PARTITION_PERCS="0 20 60 100"
+
+# lock conflict handling: POLICY:EARLY_LOCK_RELEASE
+typeset LOCK_MODES="NoWait:false WaitDie:false WaitDie:true"
+
+########### General Configuration END ###########
+
+for LOCK_MODE in $LOCK_MODES
+do
+        export LOCK_WAIT_POLICY=${LOCK_MODE%%:*}
+        export EARLY_LOCK_RELEASE=${LOCK_MODE##*:}
+
+        for WORKER_NUM in $WORKER_NUMS
+        do
+                typeset RESULT_DIR=$RESULT_ROOT_DIR/tpcc-$LOCK_WAIT_POLICY-elr-$EARLY_LOCK_RELEASE-warehouses-$WORKER_NUM
+                mkdir -p $RESULT_DIR
+
+                for PERC in $MULTI_PARTITION_PERCS
+                do
+                        run_tpcc_single $RESULT_DIR TwoPLPasha $HOST_NUM $WORKER_NUM $PERC $PERC 1 0 Clock OnDemand $DEFAULT_HCC_SIZE_LIMIT 1 WriteThrough NonPart GROUP_WAL $DEFAULT_WAL_GROUP_COMMIT_TIME 0 $TPCC_RUN_TIME $TPCC_WARMUP_TIME       # Tigon-TwoPL
+                done
+        done
+done
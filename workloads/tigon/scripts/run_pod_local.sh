@@ -0,0 +1,163 @@
+#!/usr/bin/env bash
+
+set -euo pipefail
+# Emulate a CXL pod on one machine without VMs
+# - Runs HOST_NUM coordinator processes (ids 0..HOST_NUM-1) on 127.0.0.1
+# - All processes map the same file (--cxl_backend=mmap) as the shared CXL pool
+# - Each process is pinned to its own CORES_PER_HOST cores
+# - Cross-host messages are delayed by CROSS_HOST_DELAY_US microseconds
+# - Every cache line flushed by software cache coherence costs SCC_FLUSH_COST_NS
+# - Passes through any extra CLI args to every process
+#
+# Usage: ./scripts/run_pod_local.sh BENCHMARK PROTOCOL HOST_NUM WORKER_NUM [extra flags]
+#   BENCHMARK: TPCC, YCSB, SmallBank, TATP, or ALL
+#   PROTOCOL: TwoPLPasha, SundialPasha, ...
+
+if [[ $# -lt 4 ]]; then
+  echo "Usage: $0 TPCC|YCSB|SmallBank|TATP|ALL PROTOCOL HOST_NUM WORKER_NUM [extra flags]" >&2
+  exit 1
+fi
+
+BENCHMARK=$1
+PROTOCOL=$2
+HOST_NUM=$3
+WORKER_NUM=$4
+shift 4
+
+SCRIPT_DIR=$( cd -- "$( dirname -- "${BASH_SOURCE[0]}" )" &> /dev/null && pwd )
+BIN_DIR=${BIN_DIR:-"${SCRIPT_DIR}/../build"}
+LOG_DIR=${LOG_DIR:-"${BIN_DIR}/pod_logs"}
+
+# Pod shape (can be overridden from the environment)
+POD_CXL_RESOURCE=${POD_CXL_RESOURCE:-/dev/shm/tigon_pod}
+FIRST_CORE=${FIRST_CORE:-0}
+CORES_PER_HOST=${CORES_PER_HOST:-$(( WORKER_NUM + 2 ))}   # workers plus I/O threads
+CROSS_HOST_DELAY_US=${CROSS_HOST_DELAY_US:-0}
+SCC_FLUSH_COST_NS=${SCC_FLUSH_COST_NS:-0}
+BASE_PORT=${BASE_PORT:-1234}
+
+# Run settings
+TIME_TO_RUN=${TIME_TO_RUN:-15}
+TIME_TO_WARMUP=${TIME_TO_WARMUP:-5}
+HW_CC_BUDGET=${HW_CC_BUDGET:-$(( 200 * 1024 * 1024 ))}
+SCC_MECH=${SCC_MECH:-WriteThrough}
+COROUTINE_NUM=${COROUTINE_NUM:-1}
+
+TOTAL_CORES=$(nproc)
+if (( FIRST_CORE + HOST_NUM * CORES_PER_HOST > TOTAL_CORES )); then
+  echo "Warning: ${HOST_NUM} hosts x ${CORES_PER_HOST} cores do not fit on ${TOTAL_CORES} cores; hosts will share cores" >&2
+fi
+
+SERVER_STRING=""
+for (( i=0; i < HOST_NUM; ++i )); do
+  SERVER_STRING+="${SERVER_STRING:+;}127.0.0.1:$(( BASE_PORT + i ))"
+done
+
+PIDS=()
+cleanup() {
+  for pid in "${PIDS[@]:-}"; do
+    [[ -n "${pid}" ]] && kill "${pid}" 2> /dev/null || true
+  done
+  rm -f "${POD_CXL_RESOURCE}"
+}
+trap cleanup EXIT
+
+# core range "a-b" of host $1, wrapping around when the machine is too small
+host_cpu_list() {
+  local first=$(( (FIRST_CORE + $1 * CORES_PER_HOST) % TOTAL_CORES ))
+  local last=$(( first + CORES_PER_HOST - 1 ))
+  if (( last >= TOTAL_CORES )); then
+    last=$(( TOTAL_CORES - 1 ))
+  fi
+  echo "${first}-${last}"
+}
+
+benchmark_flags() {
+  case $1 in
+    TPCC)
+      echo "--partition_num=$(( HOST_NUM * WORKER_NUM )) --query=${TPCC_QUERY:-mixed} \
+--neworder_dist=${NEWORDER_DIST:-10} --payment_dist=${PAYMENT_DIST:-15}"
+      ;;
+    YCSB)
+      echo "--partition_num=${HOST_NUM} --query=${YCSB_QUERY:-rmw} --keys=${KEYS:-200000} \
+--read_write_ratio=${RW_RATIO:-50} --zipf=${ZIPF_THETA:-0} --cross_ratio=${CROSS_RATIO:-10}"
+      ;;
+    SmallBank|TATP)
+      echo "--partition_num=${HOST_NUM} --keys=${KEYS:-1000000} \
+--zipf=${ZIPF_THETA:-0} --cross_ratio=${CROSS_RATIO:-10}"
+      ;;
+    *)
+      echo "Unknown benchmark $1" >&2
+      exit 1
+      ;;
+  esac
+}
+
+run_benchmark() {
+  local benchmark=$1
+  shift
+  local bench_bin="${BIN_DIR}/bench_$(echo "${benchmark}" | tr '[:upper:]' '[:lower:]')"
+  if [[ ! -x "${bench_bin}" ]]; then
+    echo "$(basename "${bench_bin}") not found at ${bench_bin}" >&2
+    echo "Build first:" >&2
+    echo "  cmake -S ${SCRIPT_DIR}/.. -B ${BIN_DIR}" >&2
+    echo "  cmake --build ${BIN_DIR} -j" >&2
+    exit 1
+  fi
+
+  # every run starts from an empty pool
+  rm -f "${POD_CXL_RESOURCE}"
+  mkdir -p "${LOG_DIR}"
+
+  local flags=(
+    --logtostderr=1
+    --servers="${SERVER_STRING}"
+    --threads="${WORKER_NUM}"
+    --granule_count=2000
+    --partitioner=hash --hstore_command_logging=false
+    --replica_group=1 --lock_manager=0 --batch_flush=1 --lotus_async_repl=true --batch_size=0
+    --time_to_run="${TIME_TO_RUN}" --time_to_warmup="${TIME_TO_WARMUP}"
+    --cxl_backend=mmap --cxl_memory_resource="${POD_CXL_RESOURCE}"
+    --use_cxl_transport=true --use_output_thread=true
+    --enable_migration_optimization=true --migration_policy=LRU --when_to_move_out=Reactive
+    --hw_cc_budget="${HW_CC_BUDGET}"
+    --enable_scc=true --scc_mechanism="${SCC_MECH}" --pre_migrate=NonPart
+    --coroutine_num="${COROUTINE_NUM}" --protocol="${PROTOCOL}"
+    --cpu_core_num="${CORES_PER_HOST}"
+    --delay="${CROSS_HOST_DELAY_US}" --scc_flush_cost="${SCC_FLUSH_COST_NS}"
+    $(benchmark_flags "${benchmark}")
+  )
+
+  echo "Running ${benchmark} on an emulated pod of ${HOST_NUM} hosts x ${WORKER_NUM} workers (${PROTOCOL})"
+  echo "  CXL pool: ${POD_CXL_RESOURCE}"
+  echo "  cross-host delay: ${CROSS_HOST_DELAY_US} us, SCC flush cost: ${SCC_FLUSH_COST_NS} ns/line"
+
+  # launch hosts 1..HOST_NUM-1 in the background, then host 0 in the foreground
+  PIDS=()
+  local i
+  for (( i=1; i < HOST_NUM; ++i )); do
+    local cpus
+    cpus=$(host_cpu_list "${i}")
+    taskset -c "${cpus}" "${bench_bin}" --id="${i}" --cpu_core_id="${cpus%-*}" "${flags[@]}" "$@" \
+      &> "${LOG_DIR}/${benchmark}_host${i}.txt" < /dev/null &
+    PIDS+=($!)
+  done
+
+  local cpus
+  cpus=$(host_cpu_list 0)
+  taskset -c "${cpus}" "${bench_bin}" --id=0 --cpu_core_id="${cpus%-*}" "${flags[@]}" "$@" \
+    2>&1 | tee "${LOG_DIR}/${benchmark}_host0.txt"
+
+  for pid in "${PIDS[@]:-}"; do
+    [[ -n "${pid}" ]] && wait "${pid}" || true
+  done
+  PIDS=()
+}
+
+if [[ "${BENCHMARK}" == "ALL" ]]; then
+  for benchmark in TPCC YCSB SmallBank TATP; do
+    run_benchmark "${benchmark}" "$@"
+  done
+else
+  run_benchmark "${BENCHMARK}" "$@"
+fi
@@ -113,6 +113,8 @@ extern const char* const SERIALIZE_MAGIC_NUM;
 extern const char* const SERIALIZE_VERSION;
 
 extern const char* const SQ4_UNIFORM_TRUNC_RATE;
+extern const char* const PQ_DIM;
+extern const char* const PQ_USE_OPQ;
 
 // hgraph params
 extern const char* const HGRAPH_USE_REORDER;
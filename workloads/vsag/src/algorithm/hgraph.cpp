@@ -18,7 +18,9 @@
 #include <fmt/format-inl.h>
 
 #include <memory>
+#include <numeric>
 #include <stdexcept>
+#include <thread>
 
 #include "common.h"
 #include "data_cell/sparse_graph_datacell.h"
@@ -63,6 +65,7 @@ HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonPa
     if (this->build_thread_count_ > 1) {
         this->build_pool_ = std::make_unique<progschj::ThreadPool>(this->build_thread_count_);
     }
+    this->search_pool_ = common_param.thread_pool_;
     this->init_features();
 }
 
@@ -123,7 +126,10 @@ HGraph::KnnSearch(const DatasetPtr& query,
     k = std::min(k, GetNumElements());
 
     // check query vector
-    CHECK_ARGUMENT(query->GetNumElements() == 1, "query dataset should contain 1 vector only");
+    CHECK_ARGUMENT(query->GetNumElements() >= 1, "query dataset should contain at least 1 vector");
+    if (query->GetNumElements() > 1) {
+        return this->batch_knn_search(query, k, parameters, ft);
+    }
 
     InnerSearchParam search_param;
     search_param.ep = this->entry_point_id_;
@@ -177,6 +183,159 @@ HGraph::KnnSearch(const DatasetPtr& query,
     return std::move(dataset_results);
 }
 
+DatasetPtr
+HGraph::batch_knn_search(const DatasetPtr& query,
+                         int64_t k,
+                         const std::string& parameters,
+                         const FilterPtr& filter) const {
+    auto query_count = query->GetNumElements();
+    const auto* queries = query->GetFloat32Vectors();
+    auto params = HGraphSearchParameters::FromJson(parameters);
+
+    Vector<InnerIdType> entry_points(query_count, this->entry_point_id_, allocator_);
+    this->batch_search_route_graphs(queries, query_count, entry_points);
+
+    auto dataset_results = Dataset::Make();
+    dataset_results->Dim(k)->NumElements(query_count)->Owner(true, allocator_);
+    auto* ids = (int64_t*)allocator_->Allocate(sizeof(int64_t) * query_count * k);
+    dataset_results->Ids(ids);
+    auto* dists = (float*)allocator_->Allocate(sizeof(float) * query_count * k);
+    dataset_results->Distances(dists);
+    // rows with fewer than k results are padded with id -1
+    std::fill(ids, ids + query_count * k, -1);
+    std::fill(dists, dists + query_count * k, std::numeric_limits<float>::max());
+
+    auto search_func = [&](int64_t begin, int64_t end) -> void {
+        // one visited list serves every query of the task
+        auto visited_list = this->pool_->getFreeVisitedList();
+        InnerSearchParam search_param;
+        search_param.ef = params.ef_search;
+        search_param.is_inner_id_allowed = filter;
+        for (auto i = begin; i < end; ++i) {
+            const auto* one_query = queries + i * dim_;
+            search_param.ep = entry_points[i];
+            auto search_result = this->search_one_graph(one_query,
+                                                        this->bottom_graph_,
+                                                        this->basic_flatten_codes_,
+                                                        search_param,
+                                                        visited_list);
+            if (use_reorder_) {
+                this->reorder(one_query, this->high_precise_codes_, search_result, k);
+            }
+            while (search_result.size() > k) {
+                search_result.pop();
+            }
+            for (auto j = static_cast<int64_t>(search_result.size()) - 1; j >= 0; --j) {
+                dists[i * k + j] = search_result.top().first;
+                ids[i * k + j] = this->label_table_->GetLabelById(search_result.top().second);
+                search_result.pop();
+            }
+        }
+        this->pool_->releaseVisitedList(visited_list);
+    };
+
+    if (this->search_pool_ != nullptr) {
+        // one task per search thread; a user pool of unknown size gets one per core
+        auto pool_size = this->search_pool_->GetPoolSize();
+        if (pool_size == 0) {
+            pool_size = std::thread::hardware_concurrency();
+        }
+        auto task_count = std::min(static_cast<int64_t>(pool_size), query_count);
+        task_count = std::max(task_count, static_cast<int64_t>(1));
+        auto task_size = (query_count + task_count - 1) / task_count;
+        std::vector<std::future<void>> futures;
+        for (int64_t begin = 0; begin < query_count; begin += task_size) {
+            auto end = std::min(begin + task_size, query_count);
+            futures.emplace_back(this->search_pool_->GeneralEnqueue(search_func, begin, end));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    } else {
+        search_func(0, query_count);
+    }
+    return std::move(dataset_results);
+}
+
+void
+HGraph::batch_search_route_graphs(const float* queries,
+                                  int64_t query_count,
+                                  Vector<InnerIdType>& entry_points) const {
+    if (this->route_graphs_.empty()) {
+        return;
+    }
+    Vector<ComputerInterfacePtr> computers(allocator_);
+    computers.reserve(query_count);
+    for (int64_t i = 0; i < query_count; ++i) {
+        computers.emplace_back(this->basic_flatten_codes_->FactoryComputer(queries + i * dim_));
+    }
+    Vector<float> cur_dists(query_count, allocator_);
+    auto ep = this->entry_point_id_;
+    this->basic_flatten_codes_->QueryBatch(cur_dists.data(), computers.data(), query_count, &ep, 1);
+
+    Vector<int64_t> active(allocator_);
+    Vector<int64_t> next_active(allocator_);
+    Vector<InnerIdType> neighbors(allocator_);
+    Vector<ComputerInterfacePtr> group_computers(allocator_);
+    Vector<float> group_dists(allocator_);
+    for (auto level = static_cast<int64_t>(this->route_graphs_.size()) - 1; level >= 0; --level) {
+        const auto& graph = this->route_graphs_[level];
+        active.resize(query_count);
+        std::iota(active.begin(), active.end(), 0);
+        // greedy descent: every round, the queries sitting on the same node fetch its
+        // neighbors once and score them together, then move to their closest neighbor
+        while (not active.empty()) {
+            std::sort(active.begin(), active.end(), [&](int64_t a, int64_t b) {
+                return entry_points[a] < entry_points[b];
+            });
+            next_active.clear();
+            uint64_t begin = 0;
+            while (begin < active.size()) {
+                auto node = entry_points[active[begin]];
+                auto end = begin + 1;
+                while (end < active.size() and entry_points[active[end]] == node) {
+                    ++end;
+                }
+                {
+                    SharedLock lock(neighbors_mutex_, node);
+                    graph->GetNeighbors(node, neighbors);
+                }
+                auto neighbor_count = neighbors.size();
+                if (neighbor_count != 0) {
+                    auto group_size = end - begin;
+                    group_computers.clear();
+                    for (auto i = begin; i < end; ++i) {
+                        group_computers.emplace_back(computers[active[i]]);
+                    }
+                    group_dists.resize(group_size * neighbor_count);
+                    this->basic_flatten_codes_->QueryBatch(group_dists.data(),
+                                                           group_computers.data(),
+                                                           group_size,
+                                                           neighbors.data(),
+                                                           neighbor_count);
+                    for (uint64_t i = 0; i < group_size; ++i) {
+                        auto query_id = active[begin + i];
+                        const auto* row = group_dists.data() + i * neighbor_count;
+                        bool moved = false;
+                        for (uint64_t j = 0; j < neighbor_count; ++j) {
+                            if (row[j] < cur_dists[query_id]) {
+                                cur_dists[query_id] = row[j];
+                                entry_points[query_id] = neighbors[j];
+                                moved = true;
+                            }
+                        }
+                        if (moved) {
+                            next_active.emplace_back(query_id);
+                        }
+                    }
+                }
+                begin = end;
+            }
+            active.swap(next_active);
+        }
+    }
+}
+
 uint64_t
 HGraph::EstimateMemory(uint64_t num_elements) const {
     uint64_t estimate_memory = 0;
@@ -284,8 +443,15 @@ MaxHeap
 HGraph::search_one_graph(const float* query,
                          const GraphInterfacePtr& graph,
                          const FlattenInterfacePtr& flatten,
-                         InnerSearchParam& inner_search_param) const {
-    auto visited_list = this->pool_->getFreeVisitedList();
+                         InnerSearchParam& inner_search_param,
+                         const hnswlib::VisitedListPtr& visited_list_holder) const {
+    // a caller-provided visited list is owned by the caller and only reset here
+    auto visited_list = visited_list_holder;
+    if (visited_list == nullptr) {
+        visited_list = this->pool_->getFreeVisitedList();
+    } else {
+        visited_list->reset();
+    }
 
     auto* visited_array = visited_list->mass;
     auto visited_array_tag = visited_list->curV;
@@ -382,7 +548,9 @@ HGraph::search_one_graph(const float* query,
             }
         }
     }
-    this->pool_->releaseVisitedList(visited_list);
+    if (visited_list_holder == nullptr) {
+        this->pool_->releaseVisitedList(visited_list);
+    }
     return cur_result;
 }
 
@@ -861,6 +1029,22 @@ static const ConstParamMap EXTERNAL_MAPPING = {
             SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE,
         },
     },
+    {
+        PQ_DIM,
+        {
+            HGRAPH_BASE_CODES_KEY,
+            QUANTIZATION_PARAMS_KEY,
+            PQ_QUANTIZATION_DIM,
+        },
+    },
+    {
+        PQ_USE_OPQ,
+        {
+            HGRAPH_BASE_CODES_KEY,
+            QUANTIZATION_PARAMS_KEY,
+            PQ_QUANTIZATION_USE_OPQ,
+        },
+    },
 };
 
 static const std::string HGRAPH_PARAMS_TEMPLATE =
@@ -885,6 +1069,8 @@ static const std::string HGRAPH_PARAMS_TEMPLATE =
             "{QUANTIZATION_PARAMS_KEY}": {
                 "{QUANTIZATION_TYPE_KEY}": "{QUANTIZATION_TYPE_VALUE_PQ}",
                 "{SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE}": 0.05,
+                "{PQ_QUANTIZATION_DIM}": 0,
+                "{PQ_QUANTIZATION_USE_OPQ}": false,
                 "nbits": 8
             }
         },
@@ -128,7 +128,20 @@ private:
     search_one_graph(const float* query,
                      const GraphInterfacePtr& graph,
                      const FlattenInterfacePtr& flatten,
-                     InnerSearchParam& inner_search_param) const;
+                     InnerSearchParam& inner_search_param,
+                     const hnswlib::VisitedListPtr& visited_list = nullptr) const;
+
+    DatasetPtr
+    batch_knn_search(const DatasetPtr& query,
+                     int64_t k,
+                     const std::string& parameters,
+                     const FilterPtr& filter) const;
+
+    void
+    batch_search_route_graphs(const float* queries,
+                              int64_t query_count,
+                              Vector<InnerIdType>& entry_points) const;
+
     void
     serialize_basic_info(StreamWriter& writer) const;
 
@@ -185,6 +198,8 @@ private:
     std::unique_ptr<progschj::ThreadPool> build_pool_{nullptr};
     uint64_t build_thread_count_{100};
 
+    std::shared_ptr<SafeThreadPool> search_pool_{nullptr};
+
     InnerIdType max_capacity_{0};
 
     const uint64_t resize_increase_count_bit_{10};  // 2^resize_increase_count_bit_ for resize count
@@ -52,6 +52,12 @@ make_instance(const BucketDataCellParamPtr& param, const IndexCommonParam& commo
     if (quantization_string == QUANTIZATION_TYPE_VALUE_SQ8_UNIFORM) {
         return make_instance<SQ8UniformQuantizer<metric>, IOTemp>(param, common_param);
     }
+    if (quantization_string == QUANTIZATION_TYPE_VALUE_PQ) {
+        return make_instance<PQQuantizer<metric>, IOTemp>(param, common_param);
+    }
+    if (quantization_string == QUANTIZATION_TYPE_VALUE_PQ_FASTSCAN) {
+        return make_instance<PQFastScanQuantizer<metric>, IOTemp>(param, common_param);
+    }
     return nullptr;
 }
 
@@ -47,6 +47,13 @@ public:
         this->query(result_dists, comp, idx, id_count);
     }
 
+    void
+    QueryBatch(float* result_dists,
+               const ComputerInterfacePtr* computers,
+               uint64_t computer_count,
+               const InnerIdType* idx,
+               InnerIdType id_count) override;
+
     ComputerInterfacePtr
     FactoryComputer(const float* query) override {
         return this->factory_computer(query);
@@ -345,6 +352,73 @@ FlattenDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
     }
 }
 
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::QueryBatch(float* result_dists,
+                                               const ComputerInterfacePtr* computers,
+                                               uint64_t computer_count,
+                                               const InnerIdType* idx,
+                                               InnerIdType id_count) {
+    if (computer_count == 1) {
+        this->Query(result_dists, computers[0], idx, id_count);
+        return;
+    }
+    if (not force_in_memory_ and not this->io_->InMemory() and id_count > 1) {
+        ByteBuffer codes(id_count * this->code_size_, allocator_);
+        Vector<uint64_t> sizes(id_count, this->code_size_, allocator_);
+        Vector<uint64_t> offsets(id_count, this->code_size_, allocator_);
+        for (int64_t i = 0; i < id_count; ++i) {
+            offsets[i] = idx[i] * code_size_;
+        }
+        this->io_->MultiRead(codes.data, sizes.data(), offsets.data(), id_count);
+        for (uint64_t j = 0; j < computer_count; ++j) {
+            auto* computer = static_cast<Computer<QuantTmpl>*>(computers[j].get());
+            computer->ComputeBatchDists(id_count, codes.data, result_dists + j * id_count);
+        }
+        return;
+    }
+
+    for (uint32_t i = 0; i < this->prefetch_jump_code_size_ and i < id_count; i++) {
+        if (force_in_memory_) {
+            this->force_in_memory_io_->Prefetch(
+                static_cast<uint64_t>(idx[i]) * static_cast<uint64_t>(code_size_),
+                this->prefetch_cache_line_size_);
+        } else {
+            this->io_->Prefetch(static_cast<uint64_t>(idx[i]) * static_cast<uint64_t>(code_size_),
+                                this->prefetch_cache_line_size_);
+        }
+    }
+    for (int64_t i = 0; i < id_count; ++i) {
+        if (i + this->prefetch_jump_code_size_ < id_count) {
+            if (force_in_memory_) {
+                this->force_in_memory_io_->Prefetch(
+                    static_cast<uint64_t>(idx[i + this->prefetch_jump_code_size_]) *
+                        static_cast<uint64_t>(code_size_),
+                    this->prefetch_cache_line_size_);
+            } else {
+                this->io_->Prefetch(static_cast<uint64_t>(idx[i + this->prefetch_jump_code_size_]) *
+                                        static_cast<uint64_t>(code_size_),
+                                    this->prefetch_cache_line_size_);
+            }
+        }
+
+        // one code read is shared by every query of the block
+        bool release = false;
+        const auto* codes = this->GetCodesById(idx[i], release);
+        for (uint64_t j = 0; j < computer_count; ++j) {
+            auto* computer = static_cast<Computer<QuantTmpl>*>(computers[j].get());
+            computer->ComputeDist(codes, result_dists + j * id_count + i);
+        }
+        if (release) {
+            if (force_in_memory_) {
+                this->force_in_memory_io_->Release(codes);
+            } else {
+                this->io_->Release(codes);
+            }
+        }
+    }
+}
+
 template <typename QuantTmpl, typename IOTmpl>
 float
 FlattenDataCell<QuantTmpl, IOTmpl>::ComputePairVectors(InnerIdType id1, InnerIdType id2) {
@@ -55,6 +55,12 @@ make_instance(const FlattenDataCellParamPtr& param, const IndexCommonParam& comm
     if (quantization_string == QUANTIZATION_TYPE_VALUE_BF16) {
         return make_instance<BF16Quantizer<metric>, IOTemp>(param, common_param);
     }
+    if (quantization_string == QUANTIZATION_TYPE_VALUE_PQ) {
+        return make_instance<PQQuantizer<metric>, IOTemp>(param, common_param);
+    }
+    if (quantization_string == QUANTIZATION_TYPE_VALUE_PQ_FASTSCAN) {
+        return make_instance<PQFastScanQuantizer<metric>, IOTemp>(param, common_param);
+    }
     return nullptr;
 }
 
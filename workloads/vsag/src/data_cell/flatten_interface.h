@@ -68,6 +68,22 @@ public:
     GetMetricType() = 0;
 
 public:
+    /**
+     * Compute the distances between `id_count` codes and `computer_count` queries, each
+     * code is fetched once and scored against all queries. result_dists is laid out
+     * query-major: result_dists[i * id_count + j] is the distance of computers[i] to idx[j].
+     */
+    virtual void
+    QueryBatch(float* result_dists,
+               const ComputerInterfacePtr* computers,
+               uint64_t computer_count,
+               const InnerIdType* idx,
+               InnerIdType id_count) {
+        for (uint64_t i = 0; i < computer_count; ++i) {
+            this->Query(result_dists + i * id_count, computers[i], idx, id_count);
+        }
+    }
+
     virtual void
     SetMaxCapacity(InnerIdType capacity) {
         this->max_capacity_ = capacity;
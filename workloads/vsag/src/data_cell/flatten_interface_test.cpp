@@ -55,6 +55,24 @@ FlattenInterfaceTest::BasicTest(int64_t dim, uint64_t base_count, float error) {
         }
     }
 
+    // Test QueryBatch
+    {
+        int64_t batch_count = 4;
+        std::vector<ComputerInterfacePtr> computers;
+        for (int64_t i = 0; i < batch_count; ++i) {
+            computers.emplace_back(flatten_->FactoryComputer(queries.data() + i * dim));
+        }
+        std::vector<float> batch_dists(batch_count * base_count);
+        flatten_->QueryBatch(
+            batch_dists.data(), computers.data(), batch_count, idx.data(), base_count);
+        for (int64_t i = 0; i < batch_count; ++i) {
+            flatten_->Query(dists.data(), computers[i], idx.data(), base_count);
+            for (int64_t j = 0; j < base_count; ++j) {
+                REQUIRE(dists[j] == batch_dists[i * base_count + j]);
+            }
+        }
+    }
+
     for (int64_t i = 0; i < query_count; ++i) {
         auto idx1 = random() % base_count;
         auto idx2 = random() % base_count;
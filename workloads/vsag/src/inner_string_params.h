@@ -51,9 +51,12 @@ const char* const QUANTIZATION_TYPE_VALUE_SQ4_UNIFORM = "sq4_uniform";
 const char* const QUANTIZATION_TYPE_VALUE_FP32 = "fp32";
 const char* const QUANTIZATION_TYPE_VALUE_BF16 = "bf16";
 const char* const QUANTIZATION_TYPE_VALUE_PQ = "pq";
+const char* const QUANTIZATION_TYPE_VALUE_PQ_FASTSCAN = "pq_fastscan";
 const char* const QUANTIZATION_TYPE_VALUE_RABITQ = "rabitq";
 
 const char* const SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE = "sq4_uniform_trunc_rate";
+const char* const PQ_QUANTIZATION_DIM = "pq_dim";
+const char* const PQ_QUANTIZATION_USE_OPQ = "pq_use_opq";
 
 // graph param value
 const char* const GRAPH_PARAM_MAX_DEGREE = "max_degree";
@@ -91,6 +94,8 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"IO_FILE_PATH", IO_FILE_PATH},
     {"DEFAULT_FILE_PATH_VALUE", DEFAULT_FILE_PATH_VALUE},
     {"SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE", SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE},
+    {"PQ_QUANTIZATION_DIM", PQ_QUANTIZATION_DIM},
+    {"PQ_QUANTIZATION_USE_OPQ", PQ_QUANTIZATION_USE_OPQ},
 };
 
 }  // namespace vsag
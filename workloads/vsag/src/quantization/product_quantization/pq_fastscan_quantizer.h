@@ -0,0 +1,378 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "index/index_common_param.h"
+#include "inner_string_params.h"
+#include "pq_fastscan_quantizer_parameter.h"
+#include "product_quantization_codebook.h"
+#include "quantization/quantizer.h"
+#include "simd/fp32_simd.h"
+#include "simd/normalize.h"
+#include "simd/pq_fastscan_simd.h"
+#include "typing.h"
+
+namespace vsag {
+
+/**
+ * Product quantization with 4-bit codes scanned through in-register lookup tables.
+ * code layout: subspace 2b in the low nibble and subspace 2b + 1 in the high nibble of byte b.
+ * The query lookup table is quantized to uint8 per subspace (offset by the subspace minimum,
+ * one global scale), so 32 codes are accumulated at once by byte shuffles.
+ */
+template <MetricType metric = MetricType::METRIC_TYPE_L2SQR>
+class PQFastScanQuantizer : public Quantizer<PQFastScanQuantizer<metric>> {
+public:
+    explicit PQFastScanQuantizer(int dim,
+                                 Allocator* allocator,
+                                 uint64_t pq_dim = 0,
+                                 bool use_opq = false);
+
+    explicit PQFastScanQuantizer(const PQFastScanQuantizerParamPtr& param,
+                                 const IndexCommonParam& common_param);
+
+    explicit PQFastScanQuantizer(const QuantizerParamPtr& param,
+                                 const IndexCommonParam& common_param);
+
+    bool
+    TrainImpl(const DataType* data, uint64_t count);
+
+    bool
+    EncodeOneImpl(const DataType* data, uint8_t* codes) const;
+
+    bool
+    EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count);
+
+    bool
+    DecodeOneImpl(const uint8_t* codes, DataType* data);
+
+    bool
+    DecodeBatchImpl(const uint8_t* codes, DataType* data, uint64_t count);
+
+    inline float
+    ComputeImpl(const uint8_t* codes1, const uint8_t* codes2) const;
+
+    inline void
+    ProcessQueryImpl(const DataType* query, Computer<PQFastScanQuantizer>& computer) const;
+
+    inline void
+    ComputeDistImpl(Computer<PQFastScanQuantizer>& computer,
+                    const uint8_t* codes,
+                    float* dists) const;
+
+    inline void
+    ComputeBatchDistImpl(Computer<PQFastScanQuantizer<metric>>& computer,
+                         uint64_t count,
+                         const uint8_t* codes,
+                         float* dists) const;
+
+    inline void
+    ReleaseComputerImpl(Computer<PQFastScanQuantizer<metric>>& computer) const;
+
+    inline void
+    SerializeImpl(StreamWriter& writer);
+
+    inline void
+    DeserializeImpl(StreamReader& reader);
+
+    [[nodiscard]] std::string
+    NameImpl() const {
+        return QUANTIZATION_TYPE_VALUE_PQ_FASTSCAN;
+    }
+
+public:
+    constexpr static uint64_t PQ_BITS{4};
+
+    constexpr static uint64_t PQ_CENTROID_COUNT{1ULL << PQ_BITS};
+
+    constexpr static uint64_t BLOCK_SIZE{32};
+
+private:
+    static uint64_t
+    resolve_pq_dim(int dim, uint64_t pq_dim) {
+        if (pq_dim == 0) {
+            return (dim + 1) / 2;
+        }
+        return std::min(pq_dim, static_cast<uint64_t>(dim));
+    }
+
+    /***
+     * computer buffer layout: uint8 lookup table (lookup_table_size) + scale(float) + bias(float)
+     * the lookup table holds 16 entries per subspace, padded to an even subspace count
+     */
+    [[nodiscard]] inline uint64_t
+    lookup_table_size() const {
+        return this->code_size_ * 2 * PQ_CENTROID_COUNT;
+    }
+
+    inline float
+    restore_dist(const uint8_t* buf, int32_t sum) const {
+        auto scale = *reinterpret_cast<const float*>(buf + lookup_table_size());
+        auto bias = *reinterpret_cast<const float*>(buf + lookup_table_size() + sizeof(float));
+        float result = bias + scale * static_cast<float>(sum);
+        if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+            return result;
+        } else {
+            return 1 + result;
+        }
+    }
+
+private:
+    ProductQuantizationCodebook codebook_;
+};
+
+template <MetricType metric>
+PQFastScanQuantizer<metric>::PQFastScanQuantizer(int dim,
+                                                 Allocator* allocator,
+                                                 uint64_t pq_dim,
+                                                 bool use_opq)
+    : Quantizer<PQFastScanQuantizer<metric>>(dim, allocator),
+      codebook_(dim, resolve_pq_dim(dim, pq_dim), PQ_BITS, use_opq, allocator) {
+    this->code_size_ = (codebook_.GetPQDim() + 1) / 2;
+}
+
+template <MetricType metric>
+PQFastScanQuantizer<metric>::PQFastScanQuantizer(const PQFastScanQuantizerParamPtr& param,
+                                                 const IndexCommonParam& common_param)
+    : PQFastScanQuantizer<metric>(
+          common_param.dim_, common_param.allocator_.get(), param->pq_dim_, param->use_opq_){};
+
+template <MetricType metric>
+PQFastScanQuantizer<metric>::PQFastScanQuantizer(const QuantizerParamPtr& param,
+                                                 const IndexCommonParam& common_param)
+    : PQFastScanQuantizer<metric>(std::dynamic_pointer_cast<PQFastScanQuantizerParameter>(param),
+                                  common_param){};
+
+template <MetricType metric>
+bool
+PQFastScanQuantizer<metric>::TrainImpl(const DataType* data, uint64_t count) {
+    if (data == nullptr) {
+        return false;
+    }
+
+    if (this->is_trained_) {
+        return true;
+    }
+    codebook_.Train(data, count, metric == MetricType::METRIC_TYPE_COSINE);
+    this->is_trained_ = true;
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQFastScanQuantizer<metric>::EncodeOneImpl(const DataType* data, uint8_t* codes) const {
+    Vector<DataType> norm_data(this->allocator_);
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm_data.resize(this->dim_);
+        Normalize(data, norm_data.data(), this->dim_);
+        data = norm_data.data();
+    }
+    Vector<DataType> transformed(codebook_.GetPaddedDim(), this->allocator_);
+    codebook_.Transform(data, transformed.data());
+
+    Vector<uint8_t> ids(this->code_size_ * 2, 0, this->allocator_);
+    codebook_.Encode(transformed.data(), ids.data());
+    for (uint64_t b = 0; b < this->code_size_; ++b) {
+        codes[b] = ids[2 * b] | (ids[2 * b + 1] << 4);
+    }
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQFastScanQuantizer<metric>::EncodeBatchImpl(const DataType* data,
+                                             uint8_t* codes,
+                                             uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        this->EncodeOneImpl(data + i * this->dim_, codes + i * this->code_size_);
+    }
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQFastScanQuantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
+    Vector<uint8_t> ids(this->code_size_ * 2, this->allocator_);
+    for (uint64_t b = 0; b < this->code_size_; ++b) {
+        ids[2 * b] = codes[b] & 0x0f;
+        ids[2 * b + 1] = codes[b] >> 4;
+    }
+    codebook_.Decode(ids.data(), data);
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQFastScanQuantizer<metric>::DecodeBatchImpl(const uint8_t* codes,
+                                             DataType* data,
+                                             uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        this->DecodeOneImpl(codes + i * this->code_size_, data + i * this->dim_);
+    }
+    return true;
+}
+
+template <MetricType metric>
+inline float
+PQFastScanQuantizer<metric>::ComputeImpl(const uint8_t* codes1, const uint8_t* codes2) const {
+    Vector<uint8_t> ids(this->code_size_ * 2, this->allocator_);
+    Vector<DataType> vec1(this->dim_, this->allocator_);
+    Vector<DataType> vec2(this->dim_, this->allocator_);
+    for (uint64_t b = 0; b < this->code_size_; ++b) {
+        ids[2 * b] = codes1[b] & 0x0f;
+        ids[2 * b + 1] = codes1[b] >> 4;
+    }
+    codebook_.Decode(ids.data(), vec1.data());
+    for (uint64_t b = 0; b < this->code_size_; ++b) {
+        ids[2 * b] = codes2[b] & 0x0f;
+        ids[2 * b + 1] = codes2[b] >> 4;
+    }
+    codebook_.Decode(ids.data(), vec2.data());
+    if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+        return FP32ComputeL2Sqr(vec1.data(), vec2.data(), this->dim_);
+    } else {
+        return 1 - FP32ComputeIP(vec1.data(), vec2.data(), this->dim_);
+    }
+}
+
+template <MetricType metric>
+void
+PQFastScanQuantizer<metric>::ProcessQueryImpl(const DataType* query,
+                                              Computer<PQFastScanQuantizer>& computer) const {
+    try {
+        computer.buf_ = reinterpret_cast<uint8_t*>(
+            this->allocator_->Allocate(lookup_table_size() + 2 * sizeof(float)));
+    } catch (const std::bad_alloc& e) {
+        logger::error("bad alloc when init computer buf");
+        throw std::bad_alloc();
+    }
+
+    Vector<DataType> norm_data(this->allocator_);
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm_data.resize(this->dim_);
+        Normalize(query, norm_data.data(), this->dim_);
+        query = norm_data.data();
+    }
+    Vector<DataType> transformed(codebook_.GetPaddedDim(), this->allocator_);
+    codebook_.Transform(query, transformed.data());
+
+    auto pq_dim = codebook_.GetPQDim();
+    Vector<float> lookup_table(pq_dim * PQ_CENTROID_COUNT, this->allocator_);
+    codebook_.ComputeLookupTable(
+        transformed.data(), lookup_table.data(), metric != MetricType::METRIC_TYPE_L2SQR);
+
+    float bias = 0.0F;
+    float max_range = 0.0F;
+    Vector<float> min_values(pq_dim, this->allocator_);
+    for (uint64_t m = 0; m < pq_dim; ++m) {
+        const auto* table = lookup_table.data() + m * PQ_CENTROID_COUNT;
+        auto [min_value, max_value] = std::minmax_element(table, table + PQ_CENTROID_COUNT);
+        min_values[m] = *min_value;
+        bias += *min_value;
+        max_range = std::max(max_range, *max_value - *min_value);
+    }
+    float scale = max_range > 0 ? max_range / 255.0F : 1.0F;
+
+    auto* quantized = computer.buf_;
+    std::fill(quantized, quantized + lookup_table_size(), 0);
+    for (uint64_t m = 0; m < pq_dim; ++m) {
+        const auto* table = lookup_table.data() + m * PQ_CENTROID_COUNT;
+        for (uint64_t c = 0; c < PQ_CENTROID_COUNT; ++c) {
+            auto value = std::round((table[c] - min_values[m]) / scale);
+            quantized[m * PQ_CENTROID_COUNT + c] =
+                static_cast<uint8_t>(std::min(std::max(value, 0.0F), 255.0F));
+        }
+    }
+    *reinterpret_cast<float*>(computer.buf_ + lookup_table_size()) = scale;
+    *reinterpret_cast<float*>(computer.buf_ + lookup_table_size() + sizeof(float)) = bias;
+}
+
+template <MetricType metric>
+void
+PQFastScanQuantizer<metric>::ComputeDistImpl(Computer<PQFastScanQuantizer>& computer,
+                                             const uint8_t* codes,
+                                             float* dists) const {
+    const auto* lookup_table = computer.buf_;
+    int32_t sum = 0;
+    for (uint64_t b = 0; b < this->code_size_; ++b) {
+        sum += lookup_table[2 * b * PQ_CENTROID_COUNT + (codes[b] & 0x0f)];
+        sum += lookup_table[(2 * b + 1) * PQ_CENTROID_COUNT + (codes[b] >> 4)];
+    }
+    dists[0] = restore_dist(computer.buf_, sum);
+}
+
+template <MetricType metric>
+void
+PQFastScanQuantizer<metric>::ComputeBatchDistImpl(
+    Computer<PQFastScanQuantizer<metric>>& computer,
+    uint64_t count,
+    const uint8_t* codes,
+    float* dists) const {
+    if (count < BLOCK_SIZE) {
+        for (uint64_t i = 0; i < count; ++i) {
+            this->ComputeDistImpl(computer, codes + i * this->code_size_, dists + i);
+        }
+        return;
+    }
+
+    // transpose every 32 codes into rows of 32 bytes for the shuffle based lookup
+    Vector<uint8_t> block(this->code_size_ * BLOCK_SIZE, this->allocator_);
+    int32_t sums[BLOCK_SIZE];
+    for (uint64_t i = 0; i < count; i += BLOCK_SIZE) {
+        auto block_count = std::min(BLOCK_SIZE, count - i);
+        if (block_count < BLOCK_SIZE) {
+            std::fill(block.begin(), block.end(), 0);
+        }
+        for (uint64_t v = 0; v < block_count; ++v) {
+            const auto* code = codes + (i + v) * this->code_size_;
+            for (uint64_t b = 0; b < this->code_size_; ++b) {
+                block[b * BLOCK_SIZE + v] = code[b];
+            }
+        }
+        PQFastScanLookUp32(computer.buf_, block.data(), codebook_.GetPQDim(), sums);
+        for (uint64_t v = 0; v < block_count; ++v) {
+            dists[i + v] = restore_dist(computer.buf_, sums[v]);
+        }
+    }
+}
+
+template <MetricType metric>
+void
+PQFastScanQuantizer<metric>::ReleaseComputerImpl(
+    Computer<PQFastScanQuantizer<metric>>& computer) const {
+    this->allocator_->Deallocate(computer.buf_);
+}
+
+template <MetricType metric>
+void
+PQFastScanQuantizer<metric>::SerializeImpl(StreamWriter& writer) {
+    codebook_.Serialize(writer);
+}
+
+template <MetricType metric>
+void
+PQFastScanQuantizer<metric>::DeserializeImpl(StreamReader& reader) {
+    codebook_.Deserialize(reader);
+}
+
+}  // namespace vsag
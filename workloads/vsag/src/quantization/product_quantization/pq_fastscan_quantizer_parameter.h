@@ -0,0 +1,41 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "quantization/quantizer_parameter.h"
+
+namespace vsag {
+class PQFastScanQuantizerParameter : public QuantizerParameter {
+public:
+    PQFastScanQuantizerParameter();
+
+    ~PQFastScanQuantizerParameter() override = default;
+
+    void
+    FromJson(const JsonType& json) override;
+
+    JsonType
+    ToJson() override;
+
+public:
+    // 0 means the quantizer picks the subspace count from dim
+    uint64_t pq_dim_{0};
+
+    bool use_opq_{false};
+};
+
+using PQFastScanQuantizerParamPtr = std::shared_ptr<PQFastScanQuantizerParameter>;
+}  // namespace vsag
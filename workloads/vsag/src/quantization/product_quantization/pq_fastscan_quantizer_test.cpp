@@ -0,0 +1,113 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pq_fastscan_quantizer.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include "fixtures.h"
+#include "quantization/quantizer_test.h"
+#include "safe_allocator.h"
+
+using namespace vsag;
+
+template <MetricType metric>
+void
+TestEncodeDecodeMetricPQFastScan(uint64_t dim, bool use_opq, float error = 1e-4) {
+    // no more vectors than the 16 centroids, so every vector is reconstructed exactly
+    int count = 10;
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    PQFastScanQuantizer<metric> quantizer(dim, allocator.get(), 0, use_opq);
+    REQUIRE(quantizer.GetCodeSize() == ((dim + 1) / 2 + 1) / 2);
+    TestQuantizerEncodeDecode(quantizer, dim, count, error);
+    TestComputeCodes<PQFastScanQuantizer<metric>, metric>(quantizer, dim, count, error);
+}
+
+TEST_CASE("PQ FastScan Encode and Decode", "[ut][PQFastScanQuantizer]") {
+    auto dims = fixtures::get_common_used_dims();
+    for (auto dim : dims) {
+        TestEncodeDecodeMetricPQFastScan<MetricType::METRIC_TYPE_L2SQR>(dim, false);
+        TestEncodeDecodeMetricPQFastScan<MetricType::METRIC_TYPE_IP>(dim, false);
+    }
+    for (auto dim : {8, 33, 128}) {
+        TestEncodeDecodeMetricPQFastScan<MetricType::METRIC_TYPE_L2SQR>(dim, true);
+    }
+}
+
+template <MetricType metric>
+void
+TestComputerMetricPQFastScan(uint64_t dim, uint64_t pq_dim, int count, float error) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto vecs = fixtures::generate_vectors(count, dim);
+    auto queries = fixtures::generate_vectors(10, dim, true, 165);
+    PQFastScanQuantizer<metric> quantizer(dim, allocator.get(), pq_dim);
+    quantizer.Train(vecs.data(), count);
+
+    auto code_size = quantizer.GetCodeSize();
+    std::vector<uint8_t> codes(code_size * count);
+    quantizer.EncodeBatch(vecs.data(), codes.data(), count);
+    std::vector<float> decoded(dim * count);
+    quantizer.DecodeBatch(codes.data(), decoded.data(), count);
+
+    std::vector<float> dists1(count);
+    std::vector<float> dists2(count);
+    for (int i = 0; i < 10; ++i) {
+        const auto* query = queries.data() + i * dim;
+        auto computer = quantizer.FactoryComputer();
+        computer->SetQuery(query);
+        quantizer.ComputeBatchDists(*computer, count, codes.data(), dists2.data());
+        for (int j = 0; j < count; ++j) {
+            quantizer.ComputeDist(*computer, codes.data() + j * code_size, dists1.data() + j);
+            // the shuffle path must agree with the scalar lookup bit for bit
+            REQUIRE(dists1[j] == dists2[j]);
+
+            // only the uint8 lookup table rounding separates it from the decoded distance
+            float gt;
+            if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+                gt = L2Sqr(query, decoded.data() + j * dim, &dim);
+            } else {
+                gt = 1 - InnerProduct(query, decoded.data() + j * dim, &dim);
+            }
+            REQUIRE(std::abs(gt - dists2[j]) < error);
+        }
+    }
+}
+
+TEST_CASE("PQ FastScan Compute", "[ut][PQFastScanQuantizer]") {
+    auto dims = fixtures::get_common_used_dims(8, 47);
+    float error = 0.05F;
+    for (auto dim : dims) {
+        for (auto count : {31, 101, 1000}) {
+            TestComputerMetricPQFastScan<MetricType::METRIC_TYPE_L2SQR>(dim, 0, count, error);
+            TestComputerMetricPQFastScan<MetricType::METRIC_TYPE_IP>(dim, 0, count, error);
+        }
+    }
+    // odd subspace count leaves the high nibble of the last byte unused
+    TestComputerMetricPQFastScan<MetricType::METRIC_TYPE_L2SQR>(65, 13, 101, error);
+    TestComputerMetricPQFastScan<MetricType::METRIC_TYPE_COSINE>(128, 0, 101, error);
+}
+
+TEST_CASE("PQ FastScan Serialize and Deserialize", "[ut][PQFastScanQuantizer]") {
+    auto dims = fixtures::get_common_used_dims(6, 514);
+    for (auto dim : dims) {
+        auto allocator = SafeAllocator::FactoryDefaultAllocator();
+        PQFastScanQuantizer<MetricType::METRIC_TYPE_L2SQR> quantizer1(dim, allocator.get());
+        PQFastScanQuantizer<MetricType::METRIC_TYPE_L2SQR> quantizer2(0, allocator.get());
+        TestSerializeAndDeserialize<PQFastScanQuantizer<MetricType::METRIC_TYPE_L2SQR>,
+                                    MetricType::METRIC_TYPE_L2SQR>(
+            quantizer1, quantizer2, dim, 10, 0.05F);
+    }
+}
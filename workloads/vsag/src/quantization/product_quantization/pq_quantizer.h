@@ -0,0 +1,268 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "index/index_common_param.h"
+#include "inner_string_params.h"
+#include "pq_quantizer_parameter.h"
+#include "product_quantization_codebook.h"
+#include "quantization/quantizer.h"
+#include "simd/fp32_simd.h"
+#include "simd/normalize.h"
+#include "typing.h"
+
+namespace vsag {
+
+/**
+ * Product quantization with 8-bit codes: every subspace is encoded as one byte choosing one
+ * of 256 centroids, the query is turned into a pq_dim * 256 float lookup table.
+ */
+template <MetricType metric = MetricType::METRIC_TYPE_L2SQR>
+class PQQuantizer : public Quantizer<PQQuantizer<metric>> {
+public:
+    explicit PQQuantizer(int dim, Allocator* allocator, uint64_t pq_dim = 0, bool use_opq = false);
+
+    explicit PQQuantizer(const PQQuantizerParamPtr& param, const IndexCommonParam& common_param);
+
+    explicit PQQuantizer(const QuantizerParamPtr& param, const IndexCommonParam& common_param);
+
+    bool
+    TrainImpl(const DataType* data, uint64_t count);
+
+    bool
+    EncodeOneImpl(const DataType* data, uint8_t* codes) const;
+
+    bool
+    EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count);
+
+    bool
+    DecodeOneImpl(const uint8_t* codes, DataType* data);
+
+    bool
+    DecodeBatchImpl(const uint8_t* codes, DataType* data, uint64_t count);
+
+    inline float
+    ComputeImpl(const uint8_t* codes1, const uint8_t* codes2) const;
+
+    inline void
+    ProcessQueryImpl(const DataType* query, Computer<PQQuantizer>& computer) const;
+
+    inline void
+    ComputeDistImpl(Computer<PQQuantizer>& computer, const uint8_t* codes, float* dists) const;
+
+    inline void
+    ComputeBatchDistImpl(Computer<PQQuantizer<metric>>& computer,
+                         uint64_t count,
+                         const uint8_t* codes,
+                         float* dists) const;
+
+    inline void
+    ReleaseComputerImpl(Computer<PQQuantizer<metric>>& computer) const;
+
+    inline void
+    SerializeImpl(StreamWriter& writer);
+
+    inline void
+    DeserializeImpl(StreamReader& reader);
+
+    [[nodiscard]] std::string
+    NameImpl() const {
+        return QUANTIZATION_TYPE_VALUE_PQ;
+    }
+
+public:
+    constexpr static uint64_t PQ_BITS{8};
+
+    constexpr static uint64_t PQ_CENTROID_COUNT{1ULL << PQ_BITS};
+
+private:
+    static uint64_t
+    resolve_pq_dim(int dim, uint64_t pq_dim) {
+        if (pq_dim == 0) {
+            return (dim + 3) / 4;
+        }
+        return std::min(pq_dim, static_cast<uint64_t>(dim));
+    }
+
+private:
+    ProductQuantizationCodebook codebook_;
+};
+
+template <MetricType metric>
+PQQuantizer<metric>::PQQuantizer(int dim, Allocator* allocator, uint64_t pq_dim, bool use_opq)
+    : Quantizer<PQQuantizer<metric>>(dim, allocator),
+      codebook_(dim, resolve_pq_dim(dim, pq_dim), PQ_BITS, use_opq, allocator) {
+    this->code_size_ = codebook_.GetPQDim();
+}
+
+template <MetricType metric>
+PQQuantizer<metric>::PQQuantizer(const PQQuantizerParamPtr& param,
+                                 const IndexCommonParam& common_param)
+    : PQQuantizer<metric>(
+          common_param.dim_, common_param.allocator_.get(), param->pq_dim_, param->use_opq_){};
+
+template <MetricType metric>
+PQQuantizer<metric>::PQQuantizer(const QuantizerParamPtr& param,
+                                 const IndexCommonParam& common_param)
+    : PQQuantizer<metric>(std::dynamic_pointer_cast<PQQuantizerParameter>(param), common_param){};
+
+template <MetricType metric>
+bool
+PQQuantizer<metric>::TrainImpl(const DataType* data, uint64_t count) {
+    if (data == nullptr) {
+        return false;
+    }
+
+    if (this->is_trained_) {
+        return true;
+    }
+    codebook_.Train(data, count, metric == MetricType::METRIC_TYPE_COSINE);
+    this->is_trained_ = true;
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQQuantizer<metric>::EncodeOneImpl(const DataType* data, uint8_t* codes) const {
+    Vector<DataType> norm_data(this->allocator_);
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm_data.resize(this->dim_);
+        Normalize(data, norm_data.data(), this->dim_);
+        data = norm_data.data();
+    }
+    Vector<DataType> transformed(codebook_.GetPaddedDim(), this->allocator_);
+    codebook_.Transform(data, transformed.data());
+    codebook_.Encode(transformed.data(), codes);
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQQuantizer<metric>::EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        this->EncodeOneImpl(data + i * this->dim_, codes + i * this->code_size_);
+    }
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQQuantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
+    codebook_.Decode(codes, data);
+    return true;
+}
+
+template <MetricType metric>
+bool
+PQQuantizer<metric>::DecodeBatchImpl(const uint8_t* codes, DataType* data, uint64_t count) {
+    for (uint64_t i = 0; i < count; ++i) {
+        this->DecodeOneImpl(codes + i * this->code_size_, data + i * this->dim_);
+    }
+    return true;
+}
+
+template <MetricType metric>
+inline float
+PQQuantizer<metric>::ComputeImpl(const uint8_t* codes1, const uint8_t* codes2) const {
+    Vector<DataType> vec1(this->dim_, this->allocator_);
+    Vector<DataType> vec2(this->dim_, this->allocator_);
+    codebook_.Decode(codes1, vec1.data());
+    codebook_.Decode(codes2, vec2.data());
+    if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+        return FP32ComputeL2Sqr(vec1.data(), vec2.data(), this->dim_);
+    } else {
+        return 1 - FP32ComputeIP(vec1.data(), vec2.data(), this->dim_);
+    }
+}
+
+template <MetricType metric>
+void
+PQQuantizer<metric>::ProcessQueryImpl(const DataType* query,
+                                      Computer<PQQuantizer>& computer) const {
+    try {
+        computer.buf_ = reinterpret_cast<uint8_t*>(this->allocator_->Allocate(
+            codebook_.GetPQDim() * PQ_CENTROID_COUNT * sizeof(float)));
+    } catch (const std::bad_alloc& e) {
+        logger::error("bad alloc when init computer buf");
+        throw std::bad_alloc();
+    }
+
+    Vector<DataType> norm_data(this->allocator_);
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm_data.resize(this->dim_);
+        Normalize(query, norm_data.data(), this->dim_);
+        query = norm_data.data();
+    }
+    Vector<DataType> transformed(codebook_.GetPaddedDim(), this->allocator_);
+    codebook_.Transform(query, transformed.data());
+    codebook_.ComputeLookupTable(transformed.data(),
+                                 reinterpret_cast<float*>(computer.buf_),
+                                 metric != MetricType::METRIC_TYPE_L2SQR);
+}
+
+template <MetricType metric>
+void
+PQQuantizer<metric>::ComputeDistImpl(Computer<PQQuantizer>& computer,
+                                     const uint8_t* codes,
+                                     float* dists) const {
+    const auto* lookup_table = reinterpret_cast<const float*>(computer.buf_);
+    auto pq_dim = codebook_.GetPQDim();
+    float result = 0.0F;
+    for (uint64_t m = 0; m < pq_dim; ++m) {
+        result += lookup_table[m * PQ_CENTROID_COUNT + codes[m]];
+    }
+    if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+        dists[0] = result;
+    } else {
+        dists[0] = 1 + result;
+    }
+}
+
+template <MetricType metric>
+void
+PQQuantizer<metric>::ComputeBatchDistImpl(Computer<PQQuantizer<metric>>& computer,
+                                          uint64_t count,
+                                          const uint8_t* codes,
+                                          float* dists) const {
+    for (uint64_t i = 0; i < count; ++i) {
+        this->ComputeDistImpl(computer, codes + i * this->code_size_, dists + i);
+    }
+}
+
+template <MetricType metric>
+void
+PQQuantizer<metric>::ReleaseComputerImpl(Computer<PQQuantizer<metric>>& computer) const {
+    this->allocator_->Deallocate(computer.buf_);
+}
+
+template <MetricType metric>
+void
+PQQuantizer<metric>::SerializeImpl(StreamWriter& writer) {
+    codebook_.Serialize(writer);
+}
+
+template <MetricType metric>
+void
+PQQuantizer<metric>::DeserializeImpl(StreamReader& reader) {
+    codebook_.Deserialize(reader);
+}
+
+}  // namespace vsag
@@ -0,0 +1,36 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pq_quantizer_parameter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "parameter_test.h"
+
+using namespace vsag;
+
+TEST_CASE("PQ Quantizer Parameter ToJson Test", "[ut][PQQuantizerParameter]") {
+    std::string param_str = R"(
+        {
+            "pq_dim": 16,
+            "pq_use_opq": true
+        }
+    )";
+    auto param = std::make_shared<PQQuantizerParameter>();
+    param->FromJson(JsonType::parse(param_str));
+    REQUIRE(param->pq_dim_ == 16);
+    REQUIRE(param->use_opq_);
+    ParameterTest::TestToJson(param);
+}
@@ -0,0 +1,139 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pq_quantizer.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include "fixtures.h"
+#include "quantization/quantizer_test.h"
+#include "safe_allocator.h"
+
+using namespace vsag;
+
+// no more vectors than centroids, so every training vector is reconstructed exactly
+const auto counts = {10, 101};
+// the opq rotation is a dense dim * dim matrix, keep the dims small
+const auto opq_dims = {8, 33, 128};
+
+template <MetricType metric>
+void
+TestQuantizerEncodeDecodeMetricPQ(uint64_t dim, int count, bool use_opq, float error = 1e-4) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    PQQuantizer<metric> quantizer(dim, allocator.get(), 0, use_opq);
+    REQUIRE(quantizer.GetCodeSize() == (dim + 3) / 4);
+    TestQuantizerEncodeDecode(quantizer, dim, count, error);
+}
+
+TEST_CASE("PQ Encode and Decode", "[ut][PQQuantizer]") {
+    auto dims = fixtures::get_common_used_dims();
+    constexpr MetricType metrics[2] = {MetricType::METRIC_TYPE_L2SQR, MetricType::METRIC_TYPE_IP};
+    for (auto dim : dims) {
+        for (auto count : counts) {
+            TestQuantizerEncodeDecodeMetricPQ<metrics[0]>(dim, count, false);
+            TestQuantizerEncodeDecodeMetricPQ<metrics[1]>(dim, count, false);
+        }
+    }
+}
+
+TEST_CASE("PQ Encode and Decode With OPQ", "[ut][PQQuantizer]") {
+    for (auto dim : opq_dims) {
+        for (auto count : counts) {
+            TestQuantizerEncodeDecodeMetricPQ<MetricType::METRIC_TYPE_L2SQR>(dim, count, true);
+        }
+    }
+}
+
+template <MetricType metric>
+void
+TestComputeMetricPQ(uint64_t dim, int count, float error = 1e-5) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    PQQuantizer<metric> quantizer(dim, allocator.get());
+    TestComputeCodes<PQQuantizer<metric>, metric>(quantizer, dim, count, error);
+    TestComputer<PQQuantizer<metric>, metric>(quantizer, dim, count, error);
+}
+
+TEST_CASE("PQ Compute", "[ut][PQQuantizer]") {
+    auto dims = fixtures::get_common_used_dims(5, 47);
+    constexpr MetricType metrics[3] = {
+        MetricType::METRIC_TYPE_L2SQR, MetricType::METRIC_TYPE_COSINE, MetricType::METRIC_TYPE_IP};
+    float error = 1e-3;
+    for (auto dim : dims) {
+        for (auto count : counts) {
+            TestComputeMetricPQ<metrics[0]>(dim, count, error);
+            TestComputeMetricPQ<metrics[1]>(dim, count, error);
+            TestComputeMetricPQ<metrics[2]>(dim, count, error);
+        }
+    }
+}
+
+TEST_CASE("PQ Compute Lossy", "[ut][PQQuantizer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 128;
+    int64_t count = 2000;
+    auto vecs = fixtures::generate_vectors(count, dim);
+    PQQuantizer<MetricType::METRIC_TYPE_L2SQR> quantizer(dim, allocator.get(), 32);
+    quantizer.Train(vecs.data(), count);
+    REQUIRE(quantizer.GetCodeSize() == 32);
+
+    std::vector<uint8_t> codes(quantizer.GetCodeSize() * count);
+    quantizer.EncodeBatch(vecs.data(), codes.data(), count);
+    std::vector<float> decoded(dim * count);
+    quantizer.DecodeBatch(codes.data(), decoded.data(), count);
+
+    // the lookup table distance equals the distance to the reconstructed vector
+    auto computer = quantizer.FactoryComputer();
+    computer->SetQuery(vecs.data());
+    std::vector<float> dists(count);
+    quantizer.ComputeBatchDists(*computer, count, codes.data(), dists.data());
+    float total_error = 0.0F;
+    for (int64_t i = 0; i < count; ++i) {
+        auto gt = L2Sqr(vecs.data(), decoded.data() + i * dim, &dim);
+        REQUIRE(std::abs(gt - dists[i]) < 1e-3);
+        total_error += L2Sqr(vecs.data() + i * dim, decoded.data() + i * dim, &dim);
+    }
+    // unit vectors, the mean reconstruction error should be far below the vector norm
+    REQUIRE(total_error / count < 0.3F);
+}
+
+template <MetricType metric>
+void
+TestSerializeAndDeserializeMetricPQ(uint64_t dim, int count, bool use_opq, float error = 1e-5) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    PQQuantizer<metric> quantizer1(dim, allocator.get(), 0, use_opq);
+    PQQuantizer<metric> quantizer2(0, allocator.get());
+    TestSerializeAndDeserialize<PQQuantizer<metric>, metric>(
+        quantizer1, quantizer2, dim, count, error);
+}
+
+TEST_CASE("PQ Serialize and Deserialize", "[ut][PQQuantizer]") {
+    auto dims = {9, 65, 129};
+    constexpr MetricType metrics[3] = {
+        MetricType::METRIC_TYPE_L2SQR, MetricType::METRIC_TYPE_COSINE, MetricType::METRIC_TYPE_IP};
+    float error = 1e-3;
+    for (auto dim : dims) {
+        for (auto count : counts) {
+            TestSerializeAndDeserializeMetricPQ<metrics[0]>(dim, count, false, error);
+            TestSerializeAndDeserializeMetricPQ<metrics[1]>(dim, count, false, error);
+            TestSerializeAndDeserializeMetricPQ<metrics[2]>(dim, count, false, error);
+        }
+    }
+    for (auto dim : opq_dims) {
+        for (auto count : counts) {
+            TestSerializeAndDeserializeMetricPQ<metrics[0]>(dim, count, true, error);
+        }
+    }
+}
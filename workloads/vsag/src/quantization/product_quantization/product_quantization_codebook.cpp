@@ -0,0 +1,393 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "product_quantization_codebook.h"
+
+#include <cblas.h>
+#include <lapacke.h>
+
+#include <cstring>
+#include <limits>
+
+#include "impl/random_orthogonal_matrix.h"
+#include "logger.h"
+#include "simd/normalize.h"
+
+namespace vsag {
+
+static inline float
+l2_sqr(const float* x, const float* y, uint64_t dim) {
+    float result = 0.0F;
+    for (uint64_t d = 0; d < dim; ++d) {
+        float diff = x[d] - y[d];
+        result += diff * diff;
+    }
+    return result;
+}
+
+static inline uint64_t
+nearest_centroid(const float* x, const float* centroids, uint64_t count, uint64_t dim) {
+    uint64_t best = 0;
+    float best_dist = std::numeric_limits<float>::max();
+    for (uint64_t c = 0; c < count; ++c) {
+        float dist = l2_sqr(x, centroids + c * dim, dim);
+        if (dist < best_dist) {
+            best_dist = dist;
+            best = c;
+        }
+    }
+    return best;
+}
+
+ProductQuantizationCodebook::ProductQuantizationCodebook(
+    uint64_t dim, uint64_t pq_dim, uint64_t bits, bool use_opq, Allocator* allocator)
+    : dim_(dim),
+      pq_dim_(pq_dim),
+      centroid_count_(1ULL << bits),
+      use_opq_(use_opq),
+      codebooks_(allocator),
+      rotation_(allocator),
+      allocator_(allocator) {
+    if (pq_dim_ > 0) {
+        this->sub_dim_ = (dim_ + pq_dim_ - 1) / pq_dim_;
+    }
+}
+
+void
+ProductQuantizationCodebook::Train(const float* data, uint64_t count, bool need_normalize) {
+    if (count == 0 or pq_dim_ == 0) {
+        return;
+    }
+    auto padded_dim = this->GetPaddedDim();
+    Vector<float> sample_datas(this->allocator_);
+    auto sample_count = this->sample_train_data(data, count, sample_datas, need_normalize);
+
+    if (use_opq_) {
+        this->train_rotation(sample_datas.data(), sample_count);
+        Vector<float> rotated(sample_count * padded_dim, this->allocator_);
+        cblas_sgemm(CblasRowMajor,
+                    CblasNoTrans,
+                    CblasTrans,
+                    static_cast<blasint>(sample_count),
+                    static_cast<blasint>(padded_dim),
+                    static_cast<blasint>(padded_dim),
+                    1.0F,
+                    sample_datas.data(),
+                    static_cast<blasint>(padded_dim),
+                    rotation_.data(),
+                    static_cast<blasint>(padded_dim),
+                    0.0F,
+                    rotated.data(),
+                    static_cast<blasint>(padded_dim));
+        sample_datas.swap(rotated);
+    }
+    this->train_codebooks(sample_datas.data(), sample_count, KMEANS_ITER);
+}
+
+void
+ProductQuantizationCodebook::Transform(const float* data, float* out) const {
+    auto padded_dim = this->GetPaddedDim();
+    if (not use_opq_) {
+        memcpy(out, data, dim_ * sizeof(float));
+        std::fill(out + dim_, out + padded_dim, 0.0F);
+        return;
+    }
+    Vector<float> padded(padded_dim, 0.0F, this->allocator_);
+    memcpy(padded.data(), data, dim_ * sizeof(float));
+    cblas_sgemv(CblasRowMajor,
+                CblasNoTrans,
+                static_cast<blasint>(padded_dim),
+                static_cast<blasint>(padded_dim),
+                1.0F,
+                rotation_.data(),
+                static_cast<blasint>(padded_dim),
+                padded.data(),
+                1,
+                0.0F,
+                out,
+                1);
+}
+
+void
+ProductQuantizationCodebook::Encode(const float* transformed, uint8_t* ids) const {
+    for (uint64_t m = 0; m < pq_dim_; ++m) {
+        ids[m] = static_cast<uint8_t>(
+            nearest_centroid(transformed + m * sub_dim_,
+                             codebooks_.data() + m * centroid_count_ * sub_dim_,
+                             centroid_count_,
+                             sub_dim_));
+    }
+}
+
+void
+ProductQuantizationCodebook::Decode(const uint8_t* ids, float* data) const {
+    auto padded_dim = this->GetPaddedDim();
+    Vector<float> transformed(padded_dim, this->allocator_);
+    this->reconstruct(ids, transformed.data());
+    if (not use_opq_) {
+        memcpy(data, transformed.data(), dim_ * sizeof(float));
+        return;
+    }
+    // the rotation is orthogonal, so x = R^T * x'
+    Vector<float> padded(padded_dim, this->allocator_);
+    cblas_sgemv(CblasRowMajor,
+                CblasTrans,
+                static_cast<blasint>(padded_dim),
+                static_cast<blasint>(padded_dim),
+                1.0F,
+                rotation_.data(),
+                static_cast<blasint>(padded_dim),
+                transformed.data(),
+                1,
+                0.0F,
+                padded.data(),
+                1);
+    memcpy(data, padded.data(), dim_ * sizeof(float));
+}
+
+void
+ProductQuantizationCodebook::ComputeLookupTable(const float* transformed,
+                                                float* lookup_table,
+                                                bool inner_product) const {
+    for (uint64_t m = 0; m < pq_dim_; ++m) {
+        const auto* query = transformed + m * sub_dim_;
+        const auto* centroids = codebooks_.data() + m * centroid_count_ * sub_dim_;
+        auto* table = lookup_table + m * centroid_count_;
+        for (uint64_t c = 0; c < centroid_count_; ++c) {
+            const auto* centroid = centroids + c * sub_dim_;
+            if (inner_product) {
+                float ip = 0.0F;
+                for (uint64_t d = 0; d < sub_dim_; ++d) {
+                    ip += query[d] * centroid[d];
+                }
+                table[c] = -ip;
+            } else {
+                table[c] = l2_sqr(query, centroid, sub_dim_);
+            }
+        }
+    }
+}
+
+void
+ProductQuantizationCodebook::Serialize(StreamWriter& writer) {
+    StreamWriter::WriteObj(writer, this->dim_);
+    StreamWriter::WriteObj(writer, this->pq_dim_);
+    StreamWriter::WriteObj(writer, this->sub_dim_);
+    StreamWriter::WriteObj(writer, this->centroid_count_);
+    StreamWriter::WriteObj(writer, this->use_opq_);
+    StreamWriter::WriteVector(writer, this->codebooks_);
+    StreamWriter::WriteVector(writer, this->rotation_);
+}
+
+void
+ProductQuantizationCodebook::Deserialize(StreamReader& reader) {
+    StreamReader::ReadObj(reader, this->dim_);
+    StreamReader::ReadObj(reader, this->pq_dim_);
+    StreamReader::ReadObj(reader, this->sub_dim_);
+    StreamReader::ReadObj(reader, this->centroid_count_);
+    StreamReader::ReadObj(reader, this->use_opq_);
+    StreamReader::ReadVector(reader, this->codebooks_);
+    StreamReader::ReadVector(reader, this->rotation_);
+}
+
+void
+ProductQuantizationCodebook::train_codebooks(const float* data, uint64_t count, uint64_t iter) {
+    auto padded_dim = this->GetPaddedDim();
+    codebooks_.resize(pq_dim_ * centroid_count_ * sub_dim_);
+
+    Vector<float> sub_datas(count * sub_dim_, this->allocator_);
+    Vector<float> sums(centroid_count_ * sub_dim_, this->allocator_);
+    Vector<uint64_t> sizes(centroid_count_, this->allocator_);
+    Vector<uint64_t> assign(count, this->allocator_);
+    for (uint64_t m = 0; m < pq_dim_; ++m) {
+        for (uint64_t i = 0; i < count; ++i) {
+            memcpy(sub_datas.data() + i * sub_dim_,
+                   data + i * padded_dim + m * sub_dim_,
+                   sub_dim_ * sizeof(float));
+        }
+        auto* centroids = codebooks_.data() + m * centroid_count_ * sub_dim_;
+
+        // spread the initial centroids over the samples, repeat them if there are too few
+        for (uint64_t c = 0; c < centroid_count_; ++c) {
+            auto idx = count >= centroid_count_ ? c * count / centroid_count_ : c % count;
+            memcpy(centroids + c * sub_dim_,
+                   sub_datas.data() + idx * sub_dim_,
+                   sub_dim_ * sizeof(float));
+        }
+
+        for (uint64_t it = 0; it < iter; ++it) {
+            bool changed = false;
+            for (uint64_t i = 0; i < count; ++i) {
+                auto best = nearest_centroid(
+                    sub_datas.data() + i * sub_dim_, centroids, centroid_count_, sub_dim_);
+                if (it == 0 or assign[i] != best) {
+                    assign[i] = best;
+                    changed = true;
+                }
+            }
+            if (not changed) {
+                break;
+            }
+            std::fill(sums.begin(), sums.end(), 0.0F);
+            std::fill(sizes.begin(), sizes.end(), 0);
+            for (uint64_t i = 0; i < count; ++i) {
+                auto* sum = sums.data() + assign[i] * sub_dim_;
+                const auto* x = sub_datas.data() + i * sub_dim_;
+                for (uint64_t d = 0; d < sub_dim_; ++d) {
+                    sum[d] += x[d];
+                }
+                ++sizes[assign[i]];
+            }
+            // an empty cluster keeps its previous centroid
+            for (uint64_t c = 0; c < centroid_count_; ++c) {
+                if (sizes[c] == 0) {
+                    continue;
+                }
+                for (uint64_t d = 0; d < sub_dim_; ++d) {
+                    centroids[c * sub_dim_ + d] = sums[c * sub_dim_ + d] / sizes[c];
+                }
+            }
+        }
+    }
+}
+
+void
+ProductQuantizationCodebook::train_rotation(const float* data, uint64_t count) {
+    auto padded_dim = this->GetPaddedDim();
+    auto n = static_cast<blasint>(padded_dim);
+    auto m = static_cast<blasint>(count);
+
+    rotation_.resize(padded_dim * padded_dim);
+    RandomOrthogonalMatrix orthogonal_matrix(padded_dim, this->allocator_);
+    orthogonal_matrix.CopyOrthogonalMatrix(rotation_.data());
+
+    Vector<float> rotated(count * padded_dim, this->allocator_);
+    Vector<float> reconstructed(count * padded_dim, this->allocator_);
+    Vector<uint8_t> ids(pq_dim_, this->allocator_);
+    Vector<float> correlation(padded_dim * padded_dim, this->allocator_);
+    Vector<float> u(padded_dim * padded_dim, this->allocator_);
+    Vector<float> vt(padded_dim * padded_dim, this->allocator_);
+    Vector<float> singular(padded_dim, this->allocator_);
+    Vector<float> superb(padded_dim, this->allocator_);
+
+    // alternate between the codebooks and the rotation minimizing ||R * x - y||, whose
+    // orthogonal Procrustes solution is R = U * V^T for Y^T * X = U * S * V^T
+    for (uint64_t it = 0; it < OPQ_ITER; ++it) {
+        cblas_sgemm(CblasRowMajor,
+                    CblasNoTrans,
+                    CblasTrans,
+                    m,
+                    n,
+                    n,
+                    1.0F,
+                    data,
+                    n,
+                    rotation_.data(),
+                    n,
+                    0.0F,
+                    rotated.data(),
+                    n);
+        this->train_codebooks(rotated.data(), count, OPQ_KMEANS_ITER);
+        for (uint64_t i = 0; i < count; ++i) {
+            this->Encode(rotated.data() + i * padded_dim, ids.data());
+            this->reconstruct(ids.data(), reconstructed.data() + i * padded_dim);
+        }
+        cblas_sgemm(CblasRowMajor,
+                    CblasTrans,
+                    CblasNoTrans,
+                    n,
+                    n,
+                    m,
+                    1.0F,
+                    reconstructed.data(),
+                    n,
+                    data,
+                    n,
+                    0.0F,
+                    correlation.data(),
+                    n);
+        int ret = LAPACKE_sgesvd(LAPACK_ROW_MAJOR,
+                                 'A',
+                                 'A',
+                                 n,
+                                 n,
+                                 correlation.data(),
+                                 n,
+                                 singular.data(),
+                                 u.data(),
+                                 n,
+                                 vt.data(),
+                                 n,
+                                 superb.data());
+        if (ret != 0) {
+            logger::warn(
+                fmt::format("opq rotation svd failed with {}, keep the last rotation", ret));
+            break;
+        }
+        cblas_sgemm(CblasRowMajor,
+                    CblasNoTrans,
+                    CblasNoTrans,
+                    n,
+                    n,
+                    n,
+                    1.0F,
+                    u.data(),
+                    n,
+                    vt.data(),
+                    n,
+                    0.0F,
+                    rotation_.data(),
+                    n);
+    }
+}
+
+void
+ProductQuantizationCodebook::reconstruct(const uint8_t* ids, float* transformed) const {
+    for (uint64_t m = 0; m < pq_dim_; ++m) {
+        memcpy(transformed + m * sub_dim_,
+               codebooks_.data() + (m * centroid_count_ + ids[m]) * sub_dim_,
+               sub_dim_ * sizeof(float));
+    }
+}
+
+uint64_t
+ProductQuantizationCodebook::sample_train_data(const float* data,
+                                               uint64_t count,
+                                               Vector<float>& sample_datas,
+                                               bool need_normalize) const {
+    uint64_t step = 2147483647UL % count;
+    auto sample_count = max_sample_count_;
+    if (count <= max_sample_count_) {
+        step = 1;
+        sample_count = count;
+    }
+
+    auto padded_dim = this->GetPaddedDim();
+    sample_datas.resize(sample_count * padded_dim);
+    std::fill(sample_datas.begin(), sample_datas.end(), 0.0F);
+    for (uint64_t j = 0; j < sample_count; ++j) {
+        auto new_index = (j * step) % count;
+        if (need_normalize) {
+            Normalize(data + new_index * dim_, sample_datas.data() + j * padded_dim, dim_);
+        } else {
+            memcpy(sample_datas.data() + j * padded_dim,
+                   data + new_index * dim_,
+                   dim_ * sizeof(float));
+        }
+    }
+    return sample_count;
+}
+
+}  // namespace vsag
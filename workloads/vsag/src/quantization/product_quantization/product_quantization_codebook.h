@@ -0,0 +1,137 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "stream_reader.h"
+#include "stream_writer.h"
+#include "typing.h"
+#include "vsag/allocator.h"
+
+namespace vsag {
+
+/**
+ * Codebooks shared by the product quantizers. The (optionally rotated) vector is zero padded
+ * to pq_dim * sub_dim and split into pq_dim subspaces, each subspace is encoded as the id of
+ * its nearest centroid.
+ */
+class ProductQuantizationCodebook {
+public:
+    ProductQuantizationCodebook(
+        uint64_t dim, uint64_t pq_dim, uint64_t bits, bool use_opq, Allocator* allocator);
+
+    void
+    Train(const float* data, uint64_t count, bool need_normalize = false);
+
+    /**
+     * Pad and rotate one vector into the quantization space, out holds GetPaddedDim() floats.
+     */
+    void
+    Transform(const float* data, float* out) const;
+
+    /**
+     * Assign every subspace of a transformed vector to its nearest centroid.
+     */
+    void
+    Encode(const float* transformed, uint8_t* ids) const;
+
+    /**
+     * Reconstruct the original space vector (dim floats) from the centroid ids.
+     */
+    void
+    Decode(const uint8_t* ids, float* data) const;
+
+    /**
+     * Fill pq_dim * centroid_count distances between a transformed query and the centroids,
+     * the squared l2 distance or the negative inner product.
+     */
+    void
+    ComputeLookupTable(const float* transformed, float* lookup_table, bool inner_product) const;
+
+    void
+    Serialize(StreamWriter& writer);
+
+    void
+    Deserialize(StreamReader& reader);
+
+    [[nodiscard]] inline uint64_t
+    GetPQDim() const {
+        return this->pq_dim_;
+    }
+
+    [[nodiscard]] inline uint64_t
+    GetCentroidCount() const {
+        return this->centroid_count_;
+    }
+
+    [[nodiscard]] inline uint64_t
+    GetPaddedDim() const {
+        return this->pq_dim_ * this->sub_dim_;
+    }
+
+    inline void
+    SetSampleCount(uint64_t sample) {
+        this->max_sample_count_ = sample;
+    }
+
+private:
+    void
+    train_codebooks(const float* data, uint64_t count, uint64_t iter);
+
+    void
+    train_rotation(const float* data, uint64_t count);
+
+    void
+    reconstruct(const uint8_t* ids, float* transformed) const;
+
+    uint64_t
+    sample_train_data(const float* data,
+                      uint64_t count,
+                      Vector<float>& sample_datas,
+                      bool need_normalize) const;
+
+private:
+    uint64_t dim_{0};
+
+    uint64_t pq_dim_{0};
+
+    uint64_t sub_dim_{0};
+
+    uint64_t centroid_count_{0};
+
+    bool use_opq_{false};
+
+    // pq_dim * centroid_count * sub_dim, subspace-major
+    Vector<float> codebooks_;
+
+    // padded_dim * padded_dim row-major, x' = R * x, empty if use_opq is false
+    Vector<float> rotation_;
+
+    Allocator* const allocator_{nullptr};
+
+    uint64_t max_sample_count_{MAX_DEFAULT_SAMPLE};
+
+    constexpr static uint64_t MAX_DEFAULT_SAMPLE{65536};
+
+    constexpr static uint64_t KMEANS_ITER{25};
+
+    constexpr static uint64_t OPQ_ITER{4};
+
+    constexpr static uint64_t OPQ_KMEANS_ITER{4};
+};
+
+}  // namespace vsag
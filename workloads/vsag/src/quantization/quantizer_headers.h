@@ -16,5 +16,6 @@
 #pragma once
 
 #include "fp32_quantizer.h"
+#include "product_quantization/pq_headers.h"
 #include "quantizer.h"
 #include "scalar_quantization/sq_headers.h"
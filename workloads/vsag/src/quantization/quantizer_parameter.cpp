@@ -19,6 +19,7 @@
 
 #include "fp32_quantizer_parameter.h"
 #include "inner_string_params.h"
+#include "product_quantization/pq_parameter_headers.h"
 #include "scalar_quantization/sq_parameter_headers.h"
 
 namespace vsag {
@@ -45,6 +46,12 @@ QuantizerParameter::GetQuantizerParameterByJson(const JsonType& json) {
     } else if (type_name == QUANTIZATION_TYPE_VALUE_BF16) {
         quantizer_param = std::make_shared<BF16QuantizerParameter>();
         quantizer_param->FromJson(json);
+    } else if (type_name == QUANTIZATION_TYPE_VALUE_PQ) {
+        quantizer_param = std::make_shared<PQQuantizerParameter>();
+        quantizer_param->FromJson(json);
+    } else if (type_name == QUANTIZATION_TYPE_VALUE_PQ_FASTSCAN) {
+        quantizer_param = std::make_shared<PQFastScanQuantizerParameter>();
+        quantizer_param->FromJson(json);
     } else {
         throw std::invalid_argument(fmt::format("invalid quantizer name {}", type_name));
     }
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "default_thread_pool.h"
 #include "logger.h"
 
@@ -24,12 +26,14 @@ class SafeThreadPool : public ThreadPool {
 public:
     static std::shared_ptr<SafeThreadPool>
     FactoryDefaultThreadPool() {
+        auto pool_size = Options::Instance().num_threads_building();
         return std::make_shared<SafeThreadPool>(
-            new DefaultThreadPool(Options::Instance().num_threads_building()), true);
+            new DefaultThreadPool(pool_size), true, pool_size);
     }
 
 public:
-    SafeThreadPool(ThreadPool* thread_pool, bool owner) : pool_(thread_pool), owner_(owner) {
+    SafeThreadPool(ThreadPool* thread_pool, bool owner, std::size_t pool_size = 0)
+        : pool_(thread_pool), owner_(owner), pool_size_(pool_size) {
     }
     ~SafeThreadPool() override {
         if (owner_) {
@@ -73,11 +77,19 @@ public:
     void
     SetPoolSize(std::size_t limit) override {
         pool_->SetPoolSize(limit);
+        pool_size_ = limit;
+    }
+
+    // number of worker threads, or 0 for a user pool whose size was never set through here
+    std::size_t
+    GetPoolSize() const {
+        return pool_size_;
     }
 
 private:
     ThreadPool* pool_{nullptr};
     bool owner_{false};
+    std::atomic<std::size_t> pool_size_{0};
 };
 
 }  // namespace vsag
@@ -21,7 +21,9 @@ TEST_CASE("SafeThreadPool Basic Test", "[ut][SafeThreadPool]") {
     auto thread_pool = vsag::SafeThreadPool::FactoryDefaultThreadPool();
     int data = 0;
     std::mutex m;
+    REQUIRE(thread_pool->GetPoolSize() == vsag::Options::Instance().num_threads_building());
     thread_pool->SetPoolSize(4);
+    REQUIRE(thread_pool->GetPoolSize() == 4);
     thread_pool->SetQueueSizeLimit(6);
     int round = 10;
     for (int i = 0; i < round; ++i) {
@@ -39,3 +41,11 @@ TEST_CASE("SafeThreadPool Basic Test", "[ut][SafeThreadPool]") {
     thread_pool->WaitUntilEmpty();
     REQUIRE(data == round);
 }
+
+TEST_CASE("SafeThreadPool Unknown Pool Size", "[ut][SafeThreadPool]") {
+    vsag::DefaultThreadPool user_pool(2);
+    vsag::SafeThreadPool thread_pool(&user_pool, false);
+    REQUIRE(thread_pool.GetPoolSize() == 0);
+    thread_pool.SetPoolSize(3);
+    REQUIRE(thread_pool.GetPoolSize() == 3);
+}
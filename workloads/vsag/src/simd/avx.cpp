@@ -556,4 +556,13 @@ Normalize(const float* from, float* to, uint64_t dim) {
     return norm;
 }
 
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result) {
+    sse::PQFastScanLookUp32(lookup_table, codes, pq_dim, result);
+}
+
+
 }  // namespace vsag::avx
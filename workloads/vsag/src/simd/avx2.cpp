@@ -17,6 +17,7 @@
 #include <immintrin.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 
@@ -596,4 +597,54 @@ Normalize(const float* from, float* to, uint64_t dim) {
     return norm;
 }
 
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result) {
+#if defined(ENABLE_AVX2)
+    // u16 lanes hold at most 128 rows * 2 * 255 before they are flushed into result
+    constexpr uint64_t flush_rows = 128;
+    alignas(32) uint16_t temp[32];
+    for (uint64_t i = 0; i < 32; ++i) {
+        result[i] = 0;
+    }
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t rows = (pq_dim + 1) / 2;
+    uint64_t r = 0;
+    while (r < rows) {
+        // acc_lo holds codes [0, 8) and [16, 24), acc_hi holds [8, 16) and [24, 32)
+        __m256i acc_lo = zero;
+        __m256i acc_hi = zero;
+        uint64_t end = std::min(rows, r + flush_rows);
+        for (; r < end; ++r) {
+            auto lut_lo = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((__m128i*)(lookup_table + r * 32)));
+            auto lut_hi = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((__m128i*)(lookup_table + r * 32 + 16)));
+            auto code = _mm256_loadu_si256((__m256i*)(codes + r * 32));
+            auto dist_lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(code, mask));
+            auto dist_hi =
+                _mm256_shuffle_epi8(lut_hi, _mm256_and_si256(_mm256_srli_epi16(code, 4), mask));
+            acc_lo = _mm256_add_epi16(acc_lo, _mm256_unpacklo_epi8(dist_lo, zero));
+            acc_lo = _mm256_add_epi16(acc_lo, _mm256_unpacklo_epi8(dist_hi, zero));
+            acc_hi = _mm256_add_epi16(acc_hi, _mm256_unpackhi_epi8(dist_lo, zero));
+            acc_hi = _mm256_add_epi16(acc_hi, _mm256_unpackhi_epi8(dist_hi, zero));
+        }
+        _mm256_store_si256((__m256i*)temp, acc_lo);
+        _mm256_store_si256((__m256i*)(temp + 16), acc_hi);
+        for (uint64_t i = 0; i < 8; ++i) {
+            result[i] += temp[i];
+            result[i + 8] += temp[i + 16];
+            result[i + 16] += temp[i + 8];
+            result[i + 24] += temp[i + 24];
+        }
+    }
+#else
+    avx::PQFastScanLookUp32(lookup_table, codes, pq_dim, result);
+#endif
+}
+
+
 }  // namespace vsag::avx2
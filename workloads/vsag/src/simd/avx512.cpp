@@ -16,6 +16,7 @@
 #include <immintrin.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 
 #include "simd.h"
@@ -531,4 +532,72 @@ Normalize(const float* from, float* to, uint64_t dim) {
     return norm;
 }
 
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result) {
+#if defined(ENABLE_AVX512)
+    // every zmm register covers two rows; u16 lanes hold at most 128 iterations * 2 * 255
+    constexpr uint64_t flush_rows = 256;
+    uint64_t rows = (pq_dim + 1) / 2;
+    if (rows < 2) {
+        avx2::PQFastScanLookUp32(lookup_table, codes, pq_dim, result);
+        return;
+    }
+    alignas(64) uint16_t temp[64];
+    for (uint64_t i = 0; i < 32; ++i) {
+        result[i] = 0;
+    }
+    const __m512i mask = _mm512_set1_epi8(0x0f);
+    const __m512i zero = _mm512_setzero_si512();
+    uint64_t r = 0;
+    while (r + 1 < rows) {
+        // per 128-bit lane i, acc_lo holds codes [0, 8) or [16, 24) of row r + i / 2
+        __m512i acc_lo = zero;
+        __m512i acc_hi = zero;
+        uint64_t end = std::min(rows, r + flush_rows);
+        for (; r + 1 < end; r += 2) {
+            const auto* lut = lookup_table + r * 32;
+            auto lut_lo = _mm512_inserti64x4(
+                _mm512_castsi256_si512(_mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*)lut))),
+                _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*)(lut + 32))),
+                1);
+            auto lut_hi = _mm512_inserti64x4(
+                _mm512_castsi256_si512(
+                    _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*)(lut + 16)))),
+                _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i*)(lut + 48))),
+                1);
+            auto code = _mm512_loadu_si512((__m512i*)(codes + r * 32));
+            auto dist_lo = _mm512_shuffle_epi8(lut_lo, _mm512_and_si512(code, mask));
+            auto dist_hi =
+                _mm512_shuffle_epi8(lut_hi, _mm512_and_si512(_mm512_srli_epi16(code, 4), mask));
+            acc_lo = _mm512_add_epi16(acc_lo, _mm512_unpacklo_epi8(dist_lo, zero));
+            acc_lo = _mm512_add_epi16(acc_lo, _mm512_unpacklo_epi8(dist_hi, zero));
+            acc_hi = _mm512_add_epi16(acc_hi, _mm512_unpackhi_epi8(dist_lo, zero));
+            acc_hi = _mm512_add_epi16(acc_hi, _mm512_unpackhi_epi8(dist_hi, zero));
+        }
+        _mm512_store_si512((__m512i*)temp, acc_lo);
+        _mm512_store_si512((__m512i*)(temp + 32), acc_hi);
+        for (uint64_t i = 0; i < 8; ++i) {
+            result[i] += temp[i] + temp[i + 16];
+            result[i + 8] += temp[i + 32] + temp[i + 48];
+            result[i + 16] += temp[i + 8] + temp[i + 24];
+            result[i + 24] += temp[i + 40] + temp[i + 56];
+        }
+    }
+    if (r < rows) {
+        const auto* lut_lo = lookup_table + r * 32;
+        const auto* lut_hi = lut_lo + 16;
+        const auto* row = codes + r * 32;
+        for (uint64_t i = 0; i < 32; ++i) {
+            result[i] += lut_lo[row[i] & 0x0f] + lut_hi[row[i] >> 4];
+        }
+    }
+#else
+    avx2::PQFastScanLookUp32(lookup_table, codes, pq_dim, result);
+#endif
+}
+
+
 }  // namespace vsag::avx512
@@ -435,4 +435,24 @@ DivScalar(const float* from, float* to, uint64_t dim, float scalar) {
 void
 Prefetch(const void* data){};
 
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result) {
+    for (uint64_t i = 0; i < 32; ++i) {
+        result[i] = 0;
+    }
+    uint64_t rows = (pq_dim + 1) / 2;
+    for (uint64_t r = 0; r < rows; ++r) {
+        const auto* lut_lo = lookup_table + r * 32;
+        const auto* lut_hi = lut_lo + 16;
+        const auto* row = codes + r * 32;
+        for (uint64_t i = 0; i < 32; ++i) {
+            result[i] += lut_lo[row[i] & 0x0f] + lut_hi[row[i] >> 4];
+        }
+    }
+}
+
+
 }  // namespace vsag::generic
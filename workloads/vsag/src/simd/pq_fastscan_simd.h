@@ -0,0 +1,73 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace vsag {
+namespace generic {
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result);
+}  // namespace generic
+
+namespace sse {
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result);
+}  // namespace sse
+
+namespace avx {
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result);
+}  // namespace avx
+
+namespace avx2 {
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result);
+}  // namespace avx2
+
+namespace avx512 {
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result);
+}  // namespace avx512
+
+/**
+ * Accumulate the 4-bit PQ lookup of 32 codes at once.
+ * lookup_table: 16 uint8 entries per subspace, the subspace count padded to even.
+ * codes: the 32 codes transposed into rows of 32 bytes, row r holds subspace 2r in the
+ *        low nibble and subspace 2r + 1 in the high nibble of each code.
+ * result: 32 int32 sums, overwritten.
+ */
+using PQFastScanLookUp32Type = void (*)(const uint8_t* lookup_table,
+                                        const uint8_t* codes,
+                                        uint64_t pq_dim,
+                                        int32_t* result);
+extern PQFastScanLookUp32Type PQFastScanLookUp32;
+}  // namespace vsag
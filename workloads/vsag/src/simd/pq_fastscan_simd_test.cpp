@@ -0,0 +1,83 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pq_fastscan_simd.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "fixtures.h"
+#include "simd_status.h"
+
+using namespace vsag;
+
+#define TEST_ACCURACY(Func)                                                         \
+    {                                                                               \
+        std::vector<int32_t> gt(32);                                                \
+        std::vector<int32_t> result(32);                                            \
+        generic::Func(lookup_table.data(), codes.data(), pq_dim, gt.data());        \
+        if (SimdStatus::SupportSSE()) {                                             \
+            sse::Func(lookup_table.data(), codes.data(), pq_dim, result.data());    \
+            REQUIRE(gt == result);                                                  \
+        }                                                                           \
+        if (SimdStatus::SupportAVX()) {                                             \
+            avx::Func(lookup_table.data(), codes.data(), pq_dim, result.data());    \
+            REQUIRE(gt == result);                                                  \
+        }                                                                           \
+        if (SimdStatus::SupportAVX2()) {                                            \
+            avx2::Func(lookup_table.data(), codes.data(), pq_dim, result.data());   \
+            REQUIRE(gt == result);                                                  \
+        }                                                                           \
+        if (SimdStatus::SupportAVX512()) {                                          \
+            avx512::Func(lookup_table.data(), codes.data(), pq_dim, result.data()); \
+            REQUIRE(gt == result);                                                  \
+        }                                                                           \
+    }
+
+TEST_CASE("PQ FastScan SIMD LookUp", "[ut][simd]") {
+    // pq_dim 256/257 (128/129 rows) and 512/513 (256/257 rows) cross the points where the
+    // SSE/AVX2 and AVX-512 kernels flush their uint16 accumulators
+    std::vector<uint64_t> pq_dims = {1, 2, 3, 8, 31, 64, 255, 256, 257, 512, 513, 1024};
+    for (const auto& pq_dim : pq_dims) {
+        uint64_t rows = (pq_dim + 1) / 2;
+        auto lookup_table = fixtures::generate_uint8_codes(rows, 32, 114);
+        auto codes = fixtures::generate_uint8_codes(rows, 32, 514);
+        if (pq_dim % 2 == 1) {
+            std::fill(lookup_table.end() - 16, lookup_table.end(), 0);
+        }
+        TEST_ACCURACY(PQFastScanLookUp32);
+    }
+}
+
+#define BENCHMARK_SIMD_COMPUTE(Simd, Comp)                                        \
+    BENCHMARK_ADVANCED(#Simd #Comp) {                                             \
+        for (int i = 0; i < count; ++i) {                                         \
+            Simd::Comp(lookup_table.data(), codes.data(), pq_dim, result.data()); \
+        }                                                                         \
+        return;                                                                   \
+    }
+
+TEST_CASE("PQ FastScan SIMD LookUp Benchmark", "[ut][simd][!benchmark]") {
+    int64_t count = 100;
+    uint64_t pq_dim = 64;
+    auto lookup_table = fixtures::generate_uint8_codes(pq_dim / 2, 32, 114);
+    auto codes = fixtures::generate_uint8_codes(pq_dim / 2, 32, 514);
+    std::vector<int32_t> result(32);
+    BENCHMARK_SIMD_COMPUTE(generic, PQFastScanLookUp32);
+    BENCHMARK_SIMD_COMPUTE(sse, PQFastScanLookUp32);
+    BENCHMARK_SIMD_COMPUTE(avx, PQFastScanLookUp32);
+    BENCHMARK_SIMD_COMPUTE(avx2, PQFastScanLookUp32);
+    BENCHMARK_SIMD_COMPUTE(avx512, PQFastScanLookUp32);
+}
@@ -17,6 +17,7 @@
 #include <x86intrin.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 
 #include "simd.h"
@@ -527,4 +528,52 @@ Prefetch(const void* data) {
 #endif
 };
 
+void
+PQFastScanLookUp32(const uint8_t* lookup_table,
+                   const uint8_t* codes,
+                   uint64_t pq_dim,
+                   int32_t* result) {
+#if defined(ENABLE_SSE)
+    // u16 lanes hold at most 128 rows * 2 * 255 before they are flushed into result
+    constexpr uint64_t flush_rows = 128;
+    alignas(16) uint16_t temp[32];
+    for (uint64_t i = 0; i < 32; ++i) {
+        result[i] = 0;
+    }
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i zero = _mm_setzero_si128();
+    uint64_t rows = (pq_dim + 1) / 2;
+    uint64_t r = 0;
+    while (r < rows) {
+        __m128i acc[4] = {zero, zero, zero, zero};
+        uint64_t end = std::min(rows, r + flush_rows);
+        for (; r < end; ++r) {
+            auto lut_lo = _mm_loadu_si128((__m128i*)(lookup_table + r * 32));
+            auto lut_hi = _mm_loadu_si128((__m128i*)(lookup_table + r * 32 + 16));
+            for (uint64_t half = 0; half < 2; ++half) {
+                auto code = _mm_loadu_si128((__m128i*)(codes + r * 32 + half * 16));
+                auto dist_lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(code, mask));
+                auto dist_hi =
+                    _mm_shuffle_epi8(lut_hi, _mm_and_si128(_mm_srli_epi16(code, 4), mask));
+                acc[half * 2] = _mm_add_epi16(acc[half * 2], _mm_unpacklo_epi8(dist_lo, zero));
+                acc[half * 2] = _mm_add_epi16(acc[half * 2], _mm_unpacklo_epi8(dist_hi, zero));
+                acc[half * 2 + 1] =
+                    _mm_add_epi16(acc[half * 2 + 1], _mm_unpackhi_epi8(dist_lo, zero));
+                acc[half * 2 + 1] =
+                    _mm_add_epi16(acc[half * 2 + 1], _mm_unpackhi_epi8(dist_hi, zero));
+            }
+        }
+        for (uint64_t i = 0; i < 4; ++i) {
+            _mm_store_si128((__m128i*)(temp + i * 8), acc[i]);
+        }
+        for (uint64_t i = 0; i < 32; ++i) {
+            result[i] += temp[i];
+        }
+    }
+#else
+    generic::PQFastScanLookUp32(lookup_table, codes, pq_dim, result);
+#endif
+}
+
+
 }  // namespace vsag::sse
@@ -55,6 +55,7 @@ public:
         {"sq8_uniform,bf16", 0.98},
         {"sq8_uniform,bf16,buffer_io", 0.98},
         {"sq8_uniform,bf16,async_io", 0.98},
+        {"pq_fastscan,fp32", 0.9},
     };
 };
 
@@ -221,7 +222,7 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex,
     }
 
     SECTION("Invalid hgraph param base_quantization_type") {
-        auto base_quantization_types = GENERATE("pq", "fsa");
+        auto base_quantization_types = GENERATE("pq16", "fsa");
         constexpr const char* param_temp =
             R"({{
                 "dtype": "float32",
@@ -313,6 +314,7 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::HgraphTestIndex, "HGraph Build", "[ft][hg
                 TestBuildIndex(index, dataset, true);
                 if (index->CheckFeature(vsag::SUPPORT_KNN_SEARCH)) {
                     TestKnnSearch(index, dataset, search_param, recall, true);
+                    TestBatchKnnSearch(index, dataset, search_param, recall, true);
                     if (index->CheckFeature(vsag::SUPPORT_SEARCH_CONCURRENT)) {
                         TestConcurrentKnnSearch(index, dataset, search_param, recall, true);
                     }
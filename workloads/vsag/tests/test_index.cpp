@@ -318,6 +318,39 @@ TestIndex::TestKnnSearch(const IndexPtr& index,
     REQUIRE(cur_recall > expected_recall * query_count * RECALL_THRESHOLD);
 }
 
+void
+TestIndex::TestBatchKnnSearch(const IndexPtr& index,
+                              const TestDatasetPtr& dataset,
+                              const std::string& search_param,
+                              float expected_recall,
+                              bool expected_success) {
+    auto queries = dataset->query_;
+    auto query_count = queries->GetNumElements();
+    auto gts = dataset->ground_truth_;
+    auto gt_topK = dataset->top_k;
+    float cur_recall = 0.0f;
+    auto topk = gt_topK;
+    auto res = index->KnnSearch(queries, topk, search_param);
+    REQUIRE(res.has_value() == expected_success);
+    if (!expected_success) {
+        return;
+    }
+    REQUIRE(res.value()->GetNumElements() == query_count);
+    REQUIRE(res.value()->GetDim() == topk);
+    for (auto i = 0; i < query_count; ++i) {
+        auto result = res.value()->GetIds() + topk * i;
+        auto gt = gts->GetIds() + gt_topK * i;
+        auto val = Intersection(gt, gt_topK, result, topk);
+        cur_recall += static_cast<float>(val) / static_cast<float>(gt_topK);
+    }
+    if (cur_recall <= expected_recall * query_count) {
+        WARN(fmt::format("cur_result({}) <= expected_recall * query_count({})",
+                         cur_recall,
+                         expected_recall * query_count));
+    }
+    REQUIRE(cur_recall > expected_recall * query_count * RECALL_THRESHOLD);
+}
+
 void
 TestIndex::TestRangeSearch(const IndexPtr& index,
                            const TestDatasetPtr& dataset,
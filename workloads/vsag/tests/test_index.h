@@ -94,6 +94,13 @@ protected:
                   float expected_recall = 0.99,
                   bool expected_success = true);
 
+    static void
+    TestBatchKnnSearch(const IndexPtr& index,
+                       const TestDatasetPtr& dataset,
+                       const std::string& search_param,
+                       float expected_recall = 0.99,
+                       bool expected_success = true);
+
     static void
     TestSearchWithDirtyVector(const IndexPtr& index,
                               const TestDatasetPtr& dataset,
@@ -16,6 +16,7 @@
 #include "./search_eval_case.h"
 
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
@@ -77,8 +78,12 @@ SearchEvalCase::init_monitor() {
 void
 SearchEvalCase::init_latency_monitor() {
     if (config_.enable_latency or config_.enable_tps or config_.enable_percent_latency) {
-        auto latency_monitor =
-            std::make_shared<LatencyMonitor>(this->dataset_ptr_->GetNumberOfQuery());
+        uint64_t query_batch_size = 1;
+        if (this->search_type_ == SearchType::KNN) {
+            query_batch_size = config_.search_batch_size;
+        }
+        auto latency_monitor = std::make_shared<LatencyMonitor>(
+            this->dataset_ptr_->GetNumberOfQuery(), query_batch_size);
         if (config_.enable_qps) {
             latency_monitor->SetMetrics("qps");
         }
@@ -145,6 +150,10 @@ SearchEvalCase::deserialize() {
 }
 void
 SearchEvalCase::do_knn_search() {
+    if (config_.search_batch_size > 1) {
+        this->do_batch_knn_search();
+        return;
+    }
     uint64_t topk = config_.top_k;
     auto query_count = this->dataset_ptr_->GetNumberOfQuery();
     this->logger_->Debug("query count is " + std::to_string(query_count));
@@ -176,6 +185,56 @@ SearchEvalCase::do_knn_search() {
     }
 }
 void
+SearchEvalCase::do_batch_knn_search() {
+    uint64_t topk = config_.top_k;
+    int64_t batch_size = config_.search_batch_size;
+    auto query_count = this->dataset_ptr_->GetNumberOfQuery();
+    auto dim = this->dataset_ptr_->GetDim();
+    if (this->dataset_ptr_->GetTestDataType() != vsag::DATATYPE_FLOAT32) {
+        std::cerr << "batch knn search only supports float32 queries" << std::endl;
+        exit(-1);
+    }
+    this->logger_->Debug("query count is " + std::to_string(query_count) +
+                         ", batch size is " + std::to_string(batch_size));
+    auto min_query = std::max(query_count, 10000L);
+    // only whole batches are sent, the latency monitor splits each one evenly
+    auto batch_count = (min_query + batch_size - 1) / batch_size;
+    std::vector<float> batch_vectors(batch_size * dim);
+    for (auto& monitor : this->monitors_) {
+        monitor->Start();
+        for (int64_t batch_id = 0; batch_id < batch_count; ++batch_id) {
+            auto first = (batch_id * batch_size) % query_count;
+            const auto* query_vectors = (const float*)this->dataset_ptr_->GetOneTest(first);
+            if (first + batch_size > query_count) {
+                for (int64_t j = 0; j < batch_size; ++j) {
+                    auto i = (first + j) % query_count;
+                    std::memcpy(batch_vectors.data() + j * dim,
+                                this->dataset_ptr_->GetOneTest(i),
+                                dim * sizeof(float));
+                }
+                query_vectors = batch_vectors.data();
+            }
+            auto query = vsag::Dataset::Make();
+            query->NumElements(batch_size)->Dim(dim)->Owner(false)->Float32Vectors(query_vectors);
+            auto result = this->index_->KnnSearch(query, topk, config_.search_param);
+            if (not result.has_value()) {
+                std::cerr << "query error: " << result.error().message << std::endl;
+                exit(-1);
+            }
+            for (int64_t j = 0; j < batch_size; ++j) {
+                auto i = (first + j) % query_count;
+                const int64_t* neighbors = result.value()->GetIds() + j * topk;
+                int64_t* ground_truth_neighbors = dataset_ptr_->GetNeighbors(i);
+                const void* query_vector = this->dataset_ptr_->GetOneTest(i);
+                auto record = std::make_tuple(
+                    neighbors, ground_truth_neighbors, dataset_ptr_.get(), query_vector, topk);
+                monitor->Record(&record);
+            }
+        }
+        monitor->Stop();
+    }
+}
+void
 SearchEvalCase::do_range_search() {
 }
 void
@@ -236,6 +295,9 @@ SearchEvalCase::process_result() {
     result["search_mode"] = config_.search_mode;
     result["index_info"] = JsonType::parse(config_.build_param);
     result["search_param"] = config_.search_param;
+    if (this->search_type_ == SearchType::KNN and config_.search_batch_size > 1) {
+        result["search_batch_size"] = config_.search_batch_size;
+    }
     EvalCase::MergeJsonType(this->basic_info_, result);
     return result;
 }
@@ -58,6 +58,9 @@ private:
     void
     do_knn_search();
 
+    void
+    do_batch_knn_search();
+
     void
     do_range_search();
 
@@ -41,6 +41,7 @@ EvalConfig::Load(argparse::ArgumentParser& parser) {
 
     config.top_k = parser.get<int>("--topk");
     config.radius = parser.get<float>("--range");
+    config.search_batch_size = parser.get<int>("--search_batch_size");
 
     config.delete_index_after_search = parser.get<bool>("--delete-index-after-search");
 
@@ -82,6 +83,7 @@ EvalConfig::Load(YAML::Node& yaml_node) {
     check_and_get_value<>(yaml_node, "index_path", config.index_path);
     check_and_get_value<int>(yaml_node, "topk", config.top_k);
     check_and_get_value<float>(yaml_node, "range", config.radius);
+    check_and_get_value<int>(yaml_node, "search_batch_size", config.search_batch_size);
 
     check_and_get_value<bool>(
         yaml_node, "delete_index_after_search", config.delete_index_after_search);
@@ -144,6 +146,7 @@ EvalConfig::CheckKeyAndType(YAML::Node& yaml_node) {
     check_and_get_value<>(yaml_node, "index_path");
     check_and_get_value<int>(yaml_node, "topk");
     check_and_get_value<float>(yaml_node, "range");
+    check_and_get_value<int>(yaml_node, "search_batch_size");
     check_and_get_value<bool>(yaml_node, "disable_recall");
     check_and_get_value<bool>(yaml_node, "disable_percent_recall");
     check_and_get_value<bool>(yaml_node, "disable_qps");
@@ -42,6 +42,7 @@ public:
     std::string search_mode{"knn"};
     int top_k{10};
     float radius{0.5f};
+    int search_batch_size{1};
     bool delete_index_after_search{false};
 
     bool enable_recall{true};
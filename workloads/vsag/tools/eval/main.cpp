@@ -79,6 +79,10 @@ parse_args(argparse::ArgumentParser& parser, int argc, char** argv) {
         .default_value(0.5f)
         .help("The range value for range search or range_filter search")
         .scan<'f', float>();
+    parser.add_argument("--search_batch_size")
+        .default_value(1)
+        .help("The number of queries sent in one knn search call")
+        .scan<'i', int>();
 
     // metrics
     parser.add_argument("--disable_recall")
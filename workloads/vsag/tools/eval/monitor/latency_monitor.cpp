@@ -17,7 +17,8 @@
 
 namespace vsag::eval {
 
-LatencyMonitor::LatencyMonitor(uint64_t max_record_counts) : Monitor("latency_monitor") {
+LatencyMonitor::LatencyMonitor(uint64_t max_record_counts, uint64_t query_batch_size)
+    : Monitor("latency_monitor"), query_batch_size_(std::max<uint64_t>(query_batch_size, 1)) {
     if (max_record_counts > 0) {
         this->latency_records_.reserve(max_record_counts);
     }
@@ -40,10 +41,17 @@ LatencyMonitor::GetResult() {
 }
 void
 LatencyMonitor::Record(void* input) {
-    auto end_time = Clock::now();
-    double duration = std::chrono::duration<double, std::milli>(end_time - cur_time_).count();
-    this->latency_records_.emplace_back(duration);
-    this->cur_time_ = Clock::now();
+    // one batch search is recorded once per query, each query gets an even share of it
+    if (this->batch_pos_ == 0) {
+        auto end_time = Clock::now();
+        double duration = std::chrono::duration<double, std::milli>(end_time - cur_time_).count();
+        this->batch_latency_ = duration / static_cast<double>(this->query_batch_size_);
+    }
+    this->latency_records_.emplace_back(this->batch_latency_);
+    if (++this->batch_pos_ == this->query_batch_size_) {
+        this->batch_pos_ = 0;
+        this->cur_time_ = Clock::now();
+    }
 }
 void
 LatencyMonitor::SetMetrics(std::string metric) {
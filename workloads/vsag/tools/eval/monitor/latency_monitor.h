@@ -22,7 +22,7 @@ namespace vsag::eval {
 
 class LatencyMonitor : public Monitor {
 public:
-    explicit LatencyMonitor(uint64_t max_record_counts = 0);
+    explicit LatencyMonitor(uint64_t max_record_counts = 0, uint64_t query_batch_size = 1);
 
     ~LatencyMonitor() override = default;
 
@@ -60,6 +60,10 @@ private:
     using Clock = std::chrono::high_resolution_clock;
     decltype(Clock::now()) cur_time_;
 
+    uint64_t query_batch_size_{1};
+    uint64_t batch_pos_{0};
+    double batch_latency_{0};
+
     std::vector<std::string> metrics_;
 };
 